@@ -3,7 +3,9 @@
 #include <string>
 #include <DirectXMath.h>
 #include <d3d11.h> // Added for ID3D11ShaderResourceView*
+#include <entt/entt.hpp>
 #include <Jolt/Physics/Body/BodyID.h> // Jolt BodyID
+#include "Engine/NameTable.h"
 
 // Components class is used to define various components for ECS architecture
 
@@ -15,13 +17,22 @@ namespace Engine
         uint64_t id = 0;
     };
 
-    // Human-readable entity name
+    // Human-readable entity name: a NameTable handle, resolved with GetNameTable().CStr(name) when displayed
     struct NameComponent
     {
-        std::string name;
-        bool isActive = true; // Master entity toggle
+        NameHandle name = 0;
     };
 
+    // Activation is stored as empty tags, so hot loops exclude switched-off entities in the view/group itself
+    // instead of looking up and branching per entity. Toggle through Scene::SetEntityActive / SetComponentActive.
+
+    // Entity switched off (master toggle): no rendering, lighting or physics
+    struct DisabledTag {};
+
+    // A single component switched off (T = MeshRendererComponent, LightComponent, RigidBodyComponent)
+    template<typename T>
+    struct ComponentDisabledTag {};
+
     // Local transform (position, rotation as quaternion, scale)
     struct TransformComponent
     {
@@ -30,11 +41,39 @@ namespace Engine
         DirectX::XMFLOAT3 scale{ 1.0f, 1.0f, 1.0f };
     };
 
+    // Exact compare of the transform a cached result was built from (world matrices, edit-mode physics sync)
+    inline bool TransformEquals(const TransformComponent& a, const TransformComponent& b)
+    {
+        return a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z &&
+               a.rotation.x == b.rotation.x && a.rotation.y == b.rotation.y && a.rotation.z == b.rotation.z && a.rotation.w == b.rotation.w &&
+               a.scale.x == b.scale.x && a.scale.y == b.scale.y && a.scale.z == b.scale.z;
+    }
+
+    // Parent/child links: children form an intrusive sibling list under their parent.
+    // Edit only through Scene::SetParent so both ends stay consistent.
+    struct HierarchyComponent
+    {
+        entt::entity parent = entt::null;
+        entt::entity firstChild = entt::null;
+        entt::entity prevSibling = entt::null;
+        entt::entity nextSibling = entt::null;
+        uint32_t childCount = 0;
+    };
+
+    // World matrix (row-major, local TRS composed with the parent chain), managed by TransformHierarchy.
+    // Entities without a parent get their local matrix.
+    struct WorldTransformComponent
+    {
+        DirectX::XMFLOAT4X4 world{ 1.0f, 0.0f, 0.0f, 0.0f,
+                                   0.0f, 1.0f, 0.0f, 0.0f,
+                                   0.0f, 0.0f, 1.0f, 0.0f,
+                                   0.0f, 0.0f, 0.0f, 1.0f };
+        uint32_t version = 0;   // bumped whenever world changes, so dependent caches can skip unchanged entities
+    };
+
     // Placeholder renderer bindings
     struct MeshRendererComponent
     {
-        bool isActive = true;
-
         int meshID = 0;
         int materialID = 0;
         ID3D11ShaderResourceView* texture = nullptr; // texture SRV bound to PS t0
@@ -44,6 +83,25 @@ namespace Engine
         float metallic  = 0.0f; // [0..1]
     };
 
+    // Cached world-space bounds for culling (managed by the render system)
+    // Recomputed only when the world transform or mesh differs from the cached inputs.
+    struct WorldBoundsComponent
+    {
+        DirectX::XMFLOAT3 center{ 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 extents{ 0.0f, 0.0f, 0.0f };  // world AABB half-size
+        float radius = 0.0f;                            // world bounding sphere radius
+
+        // Inputs the bounds were built from
+        uint32_t cachedWorldVersion = 0;
+        int cachedMeshID = -1;
+    };
+
+    // LOD shown last frame (managed by the render system); the next choice is made relative to it (hysteresis)
+    struct MeshLodComponent
+    {
+        uint8_t level = 0;
+    };
+
     // Camera data
     struct CameraComponent
     {
@@ -78,6 +136,13 @@ namespace Engine
         float pitch = 0.0f;
     };
 
+    // Editor camera movement gathered from input this frame, applied to the Transform afterwards (transient, never saved).
+    // Keeps the input system off TransformComponent, so it can run alongside physics.
+    struct EditorCamMotionComponent
+    {
+        DirectX::XMFLOAT3 move{ 0.0f, 0.0f, 0.0f };  // world-space translation not yet applied
+    };
+
     // Light types 
     enum class LightType : unsigned int
     {
@@ -90,8 +155,6 @@ namespace Engine
     // Direction is derived from the entity's Transform rotation.
     struct LightComponent
     {
-        bool isActive = true;
-
         DirectX::XMFLOAT3 color{ 1.0f, 1.0f, 1.0f };
         float intensity = 1.0f;                         // multiplier
         LightType type = LightType::Directional;
@@ -105,8 +168,6 @@ namespace Engine
 
     struct RigidBodyComponent
     {
-        bool isActive = true;
-
         // Config
         RBShape  shape      = RBShape::Box;
         RBMotion motionType = RBMotion::Static;
@@ -126,5 +187,29 @@ namespace Engine
         // Runtime (managed by physics system)
         JPH::BodyID bodyID;         // default invalid BodyID
         bool bodyCreated = false;   // whether registered in Jolt world
+
+        // Body pose before/after the last fixed step; the Transform is blended between them for rendering
+        DirectX::XMFLOAT3 prevPosition{ 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT4 prevRotation{ 0.0f, 0.0f, 0.0f, 1.0f };
+        DirectX::XMFLOAT3 currPosition{ 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT4 currRotation{ 0.0f, 0.0f, 0.0f, 1.0f };
+
+        // Transform last pushed to the body in Edit mode; only a differing Transform is re-synced
+        TransformComponent syncedTransform;
     };
-}
\ No newline at end of file
+
+    // Hot-path owning groups: the owned pools are packed so that active members come first and line up index for index,
+    // and the group iterates them linearly. A type can be owned by one group only, so all users go through these.
+    // Entering or leaving a group (component or tag added/removed) moves owned elements within their pools.
+    inline auto GetRenderableGroup(entt::registry& registry)
+    {
+        return registry.group<MeshRendererComponent, WorldTransformComponent>(
+            entt::get<>, entt::exclude<DisabledTag, ComponentDisabledTag<MeshRendererComponent>>);
+    }
+
+    inline auto GetPhysicsBodyGroup(entt::registry& registry)
+    {
+        return registry.group<RigidBodyComponent, TransformComponent>(
+            entt::get<>, entt::exclude<DisabledTag, ComponentDisabledTag<RigidBodyComponent>>);
+    }
+}
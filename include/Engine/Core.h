@@ -9,6 +9,8 @@
 #include <string>       // For std::string
 #include <vector>       // For std::vector
 #include <cstdint>      // For uint16_t
+#include <cstring>      // For std::strcmp
+#include <cstdlib>      // For std::atoi
 
 // SDL2
 #include <SDL.h>
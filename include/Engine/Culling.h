@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// Culling provides view-frustum tests for world-space bounds (sphere + AABB), 4 objects at a time with DirectXMath.
+// It has no D3D dependency. Flow of a frame: ExtractFrustum(viewProj) -> bounds.Clear() -> bounds.Push()... -> CullBounds()
+
+namespace Engine
+{
+    // Six normalized planes (left, right, bottom, top, near, far); a point is inside when dot(n, p) + d >= 0 for all
+    struct Frustum
+    {
+        DirectX::XMFLOAT4 planes[6];
+    };
+
+    // Structure-of-arrays world bounds, padded to a multiple of 4 so the tests can load 4 lanes at once
+    struct BoundsSoA
+    {
+        std::vector<float> cx, cy, cz;  // shared sphere/AABB center
+        std::vector<float> ex, ey, ez;  // AABB half-size
+        std::vector<float> radius;      // sphere radius
+
+        void Clear();
+        void Push(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents, float r);
+        size_t Size() const { return m_count; }
+
+    private:
+        size_t m_count = 0;
+    };
+
+    namespace Culling
+    {
+        // Gribb/Hartmann plane extraction for row-vector matrices (clip = v * viewProj, D3D depth range [0..1])
+        Frustum ExtractFrustum(DirectX::FXMMATRIX viewProj);
+
+        // Local bounds -> world bounds: center transformed, AABB re-fit with |M|, radius scaled by the largest axis scale
+        void TransformBounds(const DirectX::XMFLOAT3& localCenter, const DirectX::XMFLOAT3& localExtents, float localRadius,
+                             DirectX::FXMMATRIX world,
+                             DirectX::XMFLOAT3& outCenter, DirectX::XMFLOAT3& outExtents, float& outRadius);
+
+        // Appends the indices of visible bounds to outVisible (cleared first); returns the visible count.
+        // Sphere test first, AABB test only for groups where a sphere survived.
+        size_t CullBounds(const Frustum& frustum, const BoundsSoA& bounds, std::vector<uint32_t>& outVisible);
+    }
+}
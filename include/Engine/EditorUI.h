@@ -4,6 +4,7 @@
 #include "Engine/Scene.h"
 #include "Engine/Renderer.h"
 #include "Engine/InputManager.h"
+#include "Engine/Profiler.h"
 
 struct SDL_Window;
 
@@ -26,10 +27,22 @@ namespace Engine
         EditorState GetState() const { return m_state; }
 
     private:
+        // One Hierarchy panel row plus (when expanded) its children
+        void DrawHierarchyNode(Engine::Scene& scene, entt::entity entity, entt::entity& entityToDestroy);
+#ifdef ENGINE_ENABLE_PROFILER
+        // Flame graph of the last completed frame, one lane per thread
+        void DrawProfilerPanel();
+#endif
+
         bool m_scenePanelFocused = false;
 
         entt::entity m_selectedEntity = entt::null;
 
+        // Drag-and-drop reparent requested during the Hierarchy tree walk
+        bool m_pendingReparent = false;
+        entt::entity m_reparentEntity = entt::null;
+        entt::entity m_reparentTarget = entt::null;
+
 		// Used to determine which transformation gizmo to display in the Scene view when an entity is selected.
         int m_gizmoType = 0; // 0 = Translate, 1 = Rotate, 2 = Scale
 
@@ -39,5 +52,10 @@ namespace Engine
 
         std::filesystem::path m_assetPath = "assets";
         std::filesystem::path m_currentDirectory = "assets";
+
+#ifdef ENGINE_ENABLE_PROFILER
+        bool m_profilerPaused = false;
+        Engine::ProfileFrame m_profilerFrame;    // frame shown by the Profiler panel (kept while paused)
+#endif
     };
 }
\ No newline at end of file
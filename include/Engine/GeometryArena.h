@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <d3d11.h>
+#include <wrl/client.h>
+#include "Engine/OffsetAllocator.h"
+
+// GeometryArena keeps the vertices (or indices) of many meshes in one DEFAULT-usage GPU buffer, sub-allocated with
+// OffsetAllocator in fixed-size elements. Meshes in the same arena share the IA binding and are drawn with
+// baseVertex/startIndex. A full arena grows: a larger buffer is created and the old contents are copied on the GPU.
+// Buffers are created on the ID3D11Device; uploads and copies go through IRenderDevice.
+// Flow: Allocate(device, renderDevice, data, count) -> offset ... -> Free(offset) -> (on demand) Defragment(device, renderDevice, moves)
+
+namespace Engine
+{
+    class IRenderDevice;
+
+    class GeometryArena
+    {
+    public:
+        // bindFlag: D3D11_BIND_VERTEX_BUFFER or D3D11_BIND_INDEX_BUFFER. The buffer is created on first use.
+        GeometryArena(uint32_t elementSize, UINT bindFlag, uint32_t initialCapacity);
+
+        // Uploads count elements and returns their first element in outOffset.
+        // False if count is 0 or the buffer could not be created or grown.
+        bool Allocate(ID3D11Device* device, IRenderDevice& renderDevice, const void* data, uint32_t count, uint32_t& outOffset);
+
+        // False if offset is not the start of a live allocation
+        bool Free(uint32_t offset);
+
+        // Packs the live ranges to the front (new buffer, GPU copies); moves tell the owner which offsets changed
+        bool Defragment(ID3D11Device* device, IRenderDevice& renderDevice, std::vector<OffsetAllocator::Move>& moves);
+
+        // Current buffer (changes when the arena grows or is defragmented, so look it up per frame)
+        ID3D11Buffer* GetBuffer() const { return m_buffer.Get(); }
+        const OffsetAllocator& GetAllocator() const { return m_allocator; }
+        uint32_t GetElementSize() const { return m_elementSize; }
+        uint32_t GetGrowCount() const { return m_grows; }
+
+    private:
+        // Creates a buffer of capacity elements holding a copy of the current one (plus moves, if given)
+        bool Reallocate(ID3D11Device* device, IRenderDevice& renderDevice, uint32_t capacity, const std::vector<OffsetAllocator::Move>* moves);
+
+        Microsoft::WRL::ComPtr<ID3D11Buffer> m_buffer;
+        OffsetAllocator m_allocator;
+        uint32_t m_elementSize = 0;
+        UINT m_bindFlag = 0;
+        uint32_t m_initialCapacity = 0;
+        uint32_t m_grows = 0;
+    };
+}
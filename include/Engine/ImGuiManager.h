@@ -26,5 +26,11 @@ namespace Engine
 
 		// Processes an SDL event and updates ImGui's internal state. Returns true if ImGui wants to capture this event (mouse or keyboard).
         bool ProcessEvent(const SDL_Event& e);
+
+		// When false, EndFrame still builds the draw data but does not submit it to the DX11 backend (headless runs).
+        void SetSubmitDrawData(bool submit) { m_submitDrawData = submit; }
+
+    private:
+        bool m_submitDrawData = true;
     };
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include "Engine/RenderQueue.h"
+
+// InstanceBatcher groups sorted draw items that share shader/layout/texture/mesh and packs their per-instance data
+// into one contiguous array, so each group can be drawn with a single DrawIndexedInstanced call.
+// Flow: RenderQueue::Sort() -> Build() -> upload GetInstances() once -> draw each batch in GetBatches()
+
+namespace Engine
+{
+    // Per-instance data streamed through IA slot 1 (must match BasicVS.hlsl INSTANCED input layout, 80 bytes)
+    struct InstanceData
+    {
+        DirectX::XMFLOAT4X4 world;
+        float roughness;
+        float metallic;
+        float padding[2];
+    };
+
+    // A run of consecutive sorted items with identical state
+    struct InstanceBatch
+    {
+        uint32_t firstItem = 0;      // index of the first sorted DrawItem of the run
+        uint32_t itemCount = 0;
+        uint32_t firstInstance = 0;  // offset into GetInstances() (only valid when instanced)
+        bool instanced = false;      // false: run too small, draw items one by one
+    };
+
+    class InstanceBatcher
+    {
+    public:
+        // Items with the same key above the depth bits share every bind and can be instanced together
+        static uint64_t GroupKey(uint64_t sortKey) { return sortKey >> SortKey::kMeshShift; }
+
+        // Splits sorted items into runs; runs of at least minInstances items get their instance data packed via
+        // fill(const DrawItem&, InstanceData&). Smaller runs are left for the regular per-draw path.
+        template<typename FillFn>
+        void Build(const std::vector<DrawItem>& sortedItems, uint32_t minInstances, FillFn&& fill)
+        {
+            m_batches.clear();
+            m_instances.clear();
+
+            const uint32_t count = static_cast<uint32_t>(sortedItems.size());
+            uint32_t i = 0;
+            while (i < count)
+            {
+                // Find the end of the run sharing this group key (an overflowed key is a run of its own)
+                const uint64_t group = GroupKey(sortedItems[i].key);
+                const bool shared = !SortKey::Overflowed(sortedItems[i].key);
+                uint32_t j = i + 1;
+                while (shared && j < count && GroupKey(sortedItems[j].key) == group) ++j;
+
+                InstanceBatch batch{};
+                batch.firstItem = i;
+                batch.itemCount = j - i;
+                batch.instanced = batch.itemCount >= minInstances;
+
+                if (batch.instanced)
+                {
+                    batch.firstInstance = static_cast<uint32_t>(m_instances.size());
+                    m_instances.resize(m_instances.size() + batch.itemCount);
+                    for (uint32_t k = 0; k < batch.itemCount; ++k)
+                        fill(sortedItems[i + k], m_instances[batch.firstInstance + k]);
+                }
+
+                m_batches.push_back(batch);
+                i = j;
+            }
+        }
+
+        const std::vector<InstanceBatch>& GetBatches() const { return m_batches; }
+        const std::vector<InstanceData>& GetInstances() const { return m_instances; }
+
+    private:
+        std::vector<InstanceBatch> m_batches;
+        std::vector<InstanceData> m_instances;
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <entt/entt.hpp>
+
+// JobSystem owns the engine's worker threads (hardware threads - 1, the main thread is the last worker).
+// Every worker has its own task deque: it pushes/pops at the back (LIFO, cache-warm) and idle workers steal
+// from the front of the others (FIFO, oldest = biggest). Waiting threads keep running tasks of the group they wait
+// for instead of blocking, so nested waits cannot deadlock and never pick up unrelated work.
+// Jolt runs on the same threads through JoltJobSystemAdapter.
+// Flow: Run(counter, task)... -> Wait(counter), or ParallelFor(count, grain, fn(begin, end))
+
+namespace Engine
+{
+    // Number of unfinished tasks of a group; Wait() returns once it drops to zero
+    struct JobCounter
+    {
+        std::atomic<uint32_t> pending{ 0 };
+    };
+
+    class JobSystem
+    {
+    public:
+        using Task = std::function<void()>;
+
+        // workerCount 0: hardware_concurrency - 1 (at least 1)
+        bool Initialize(uint32_t workerCount = 0);
+        void Shutdown();
+
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_threads.size()); }
+        // Threads that execute tasks: the workers plus the thread that waits
+        uint32_t GetConcurrency() const { return GetWorkerCount() + 1; }
+
+        // Queue a task on the calling thread's deque; counter is incremented now and decremented when it finished
+        void Run(JobCounter& counter, Task task);
+        // Run queued tasks until counter reaches zero
+        void Wait(JobCounter& counter);
+
+        // Split [0, count) into chunks of at least grain items and run fn(begin, end) on all threads.
+        // The caller runs the first chunk itself and returns when every chunk is done.
+        template<typename Fn>
+        void ParallelFor(uint32_t count, uint32_t grain, Fn&& fn)
+        {
+            if (count == 0) return;
+            grain = grain ? grain : 1;
+
+            // A few chunks per thread so early finishers can steal the rest
+            const uint32_t targetChunks = GetConcurrency() * 4;
+            uint32_t chunk = (count + targetChunks - 1) / targetChunks;
+            chunk = chunk < grain ? grain : chunk;
+
+            if (chunk >= count || m_threads.empty())
+            {
+                fn(0u, count);
+                return;
+            }
+
+            JobCounter counter;
+            for (uint32_t begin = chunk; begin < count; begin += chunk)
+            {
+                const uint32_t end = (begin + chunk < count) ? begin + chunk : count;
+                Run(counter, [&fn, begin, end]() { fn(begin, end); });
+            }
+            fn(0u, chunk);
+            Wait(counter);
+        }
+
+        // ParallelFor over the entities of an EnTT view: fn(entity). fn may read/write the view's components
+        // but must not add or remove components or entities (the pools must stay stable while workers run).
+        template<typename View, typename Fn>
+        void ParallelForEach(const View& view, uint32_t grain, Fn&& fn)
+        {
+            std::vector<entt::entity> entities(view.begin(), view.end());
+            ParallelFor(static_cast<uint32_t>(entities.size()), grain, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) fn(entities[i]);
+            });
+        }
+
+        // Main-thread affinity: tasks that must touch the D3D immediate context (or other main-thread-only state)
+        // are queued from any thread and executed by ExecuteMainThreadTasks() once per frame on the main thread.
+        void RunOnMainThread(Task task);
+        void ExecuteMainThreadTasks();
+        bool IsMainThread() const { return std::this_thread::get_id() == m_mainThread; }
+
+    private:
+        struct QueuedTask
+        {
+            Task task;
+            JobCounter* counter = nullptr;
+        };
+
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<QueuedTask> tasks;
+        };
+
+        // Pop from the own deque, otherwise steal; returns false if nothing was found.
+        // group: only tasks counted by that counter (helping waits), nullptr: any task (idle workers)
+        bool TryRunOne(const JobCounter* group = nullptr);
+        void WorkerLoop(uint32_t queueIndex);
+
+        // Queue 0 belongs to the main (and any external) thread, queue i + 1 to worker i
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::vector<std::thread> m_threads;
+
+        // Idle workers sleep until something is queued
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wake;
+        std::atomic<uint32_t> m_queued{ 0 };
+        std::atomic<bool> m_running{ false };
+
+        std::mutex m_mainMutex;
+        std::vector<Task> m_mainTasks;
+        std::thread::id m_mainThread;
+    };
+}
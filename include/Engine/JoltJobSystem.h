@@ -0,0 +1,32 @@
+#pragma once
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include "Engine/JobSystem.h"
+
+// JoltJobSystemAdapter lets Jolt schedule its physics jobs on the engine JobSystem instead of a private
+// JobSystemThreadPool, so physics and ECS work share one set of threads.
+// Jolt resolves job dependencies itself; the adapter only queues jobs that became ready.
+
+namespace Engine
+{
+    class JoltJobSystemAdapter final : public JPH::JobSystemWithBarrier
+    {
+    public:
+        JoltJobSystemAdapter(JobSystem& jobSystem, JPH::uint maxJobs, JPH::uint maxBarriers);
+        ~JoltJobSystemAdapter() override;
+
+        int GetMaxConcurrency() const override;
+        JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0) override;
+
+    protected:
+        void QueueJob(Job* inJob) override;
+        void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+        void FreeJob(Job* inJob) override;
+
+    private:
+        JobSystem& m_jobSystem;
+        JPH::FixedSizeFreeList<Job> m_jobs;     // job storage, same pool scheme as JobSystemThreadPool
+        JobCounter m_inFlight;                  // queued jobs not yet executed (drained on destruction)
+    };
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// LightClusterer bins point/spot lights into a view-space froxel grid (screen tiles x exponential depth slices) so the
+// pixel shader only evaluates the lights overlapping its cluster. It has no D3D dependency.
+// Flow of a frame: Build(lights, camera) -> upload GetIndexList() + GetClusterRanges() with the light array
+
+namespace Engine
+{
+    class JobSystem;
+
+    // Bounding volume of one local light (world space); spot cones are bounded by their tightest sphere
+    struct ClusterLightBounds
+    {
+        DirectX::XMFLOAT3 position{ 0.0f, 0.0f, 0.0f };
+        float range = 0.0f;
+        DirectX::XMFLOAT3 direction{ 0.0f, 0.0f, 1.0f };  // spot axis (normalized)
+        float spotAngle = 0.0f;                         // half-angle in radians, 0 = point light
+    };
+
+    // Camera data needed for binning
+    struct ClusterCamera
+    {
+        DirectX::XMFLOAT4X4 view;   // world -> view (row-vector convention)
+        float projScaleX = 1.0f;    // proj._11
+        float projScaleY = 1.0f;    // proj._22
+        float nearZ = 0.1f;
+        float farZ = 1000.0f;
+    };
+
+    class LightClusterer
+    {
+    public:
+        static constexpr uint32_t kDefaultDimX = 16;
+        static constexpr uint32_t kDefaultDimY = 9;
+        static constexpr uint32_t kDefaultDimZ = 24;
+        static constexpr uint32_t kDefaultMaxLightsPerCluster = 128;
+
+        // Changes grid resolution / per-cluster capacity (lights beyond capacity are dropped and counted)
+        void Configure(uint32_t dimX, uint32_t dimY, uint32_t dimZ, uint32_t maxLightsPerCluster);
+
+        // Bins lights; indexBase is added to every emitted index (lights are usually stored after the directional ones).
+        // Depth slices are processed in parallel on jobSystem when there are enough lights (nullptr: serial).
+        void Build(const std::vector<ClusterLightBounds>& lights, const ClusterCamera& camera, uint32_t indexBase, JobSystem* jobSystem = nullptr);
+
+        uint32_t GetDimX() const { return m_dimX; }
+        uint32_t GetDimY() const { return m_dimY; }
+        uint32_t GetDimZ() const { return m_dimZ; }
+        uint32_t GetClusterCount() const { return m_dimX * m_dimY * m_dimZ; }
+
+        // Depth slice = floor(log(viewZ) * scale + bias) (same formula as BasicPS.hlsl)
+        float GetSliceScale() const { return m_sliceScale; }
+        float GetSliceBias() const { return m_sliceBias; }
+
+        // Compacted output: per-cluster (offset, count) pairs into the index list
+        const std::vector<uint32_t>& GetIndexList() const { return m_indexList; }
+        const std::vector<uint32_t>& GetClusterRanges() const { return m_clusterRanges; }
+
+        // Light references dropped because a cluster was full during the last Build
+        uint32_t GetOverflowCount() const { return m_overflow; }
+
+    private:
+        // View-space bounding sphere of a light
+        struct ViewSphere
+        {
+            float x, y, z, r;
+        };
+
+        // Bins every sphere overlapping depth slice z into that slice's fixed-size cluster lists
+        void BinSlice(uint32_t z, const ClusterCamera& camera, uint32_t indexBase, uint32_t& overflow);
+
+        uint32_t m_dimX = kDefaultDimX;
+        uint32_t m_dimY = kDefaultDimY;
+        uint32_t m_dimZ = kDefaultDimZ;
+        uint32_t m_maxPerCluster = kDefaultMaxLightsPerCluster;
+
+        float m_sliceScale = 0.0f;
+        float m_sliceBias = 0.0f;
+
+        std::vector<ViewSphere> m_spheres;
+
+        // Fixed-capacity lists (cluster * maxPerCluster) filled in parallel, then compacted
+        std::vector<uint32_t> m_clusterLights;
+        std::vector<uint32_t> m_clusterCounts;
+
+        std::vector<uint32_t> m_indexList;
+        std::vector<uint32_t> m_clusterRanges;
+        std::vector<uint32_t> m_sliceOverflow;  // per depth slice, summed into m_overflow
+        uint32_t m_overflow = 0;
+    };
+}
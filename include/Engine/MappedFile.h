@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// MappedFile maps a whole file read-only into memory; the OS pages it in on first touch, so large cooked files are
+// read at disk (or page cache) speed without an intermediate copy. The view is page-aligned.
+// Flow: Open(path) -> GetData()/GetSize() -> Close() (or destructor)
+
+namespace Engine
+{
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // False if the file is missing, empty or cannot be mapped
+        bool Open(const std::string& path);
+        void Close();
+
+        const uint8_t* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;     // HANDLE
+        void* m_mapping = nullptr;  // HANDLE
+#else
+        int m_fd = -1;
+#endif
+    };
+}
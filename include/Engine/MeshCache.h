@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+#include "Engine/MeshTypes.h"
+
+// MeshCache stores the meshes imported from a model file in a cooked binary file, so later launches skip Assimp:
+// vertex, index and collision-position blobs are laid out exactly as the GPU buffers / physics caches expect them and
+// are used straight from the memory-mapped file. A cache file is valid only for the same source path, modification
+// time, size, import flags and vertex layout; anything else counts as stale and the model is re-imported. A mesh whose
+// content hash does not match or whose indices leave its vertex range marks the file damaged (also re-imported).
+// Flow: MakeKey(source, flags) -> MappedFile::Open(GetCachePath(source)) -> Read(data, size, key, meshes)
+//       (stale or missing: import with Assimp -> Write(GetCachePath(source), key, meshes))
+//
+// File layout: header | source path | padding to 16 | MeshRecord[meshCount] | per mesh: vertices, indices,
+// positions, LOD records, LOD indices (each 16-byte aligned).
+
+namespace Engine
+{
+    struct MeshCacheKey
+    {
+        std::string sourcePath;
+        int64_t sourceMtime = 0;    // filesystem clock ticks
+        uint64_t sourceSize = 0;
+        uint32_t importFlags = 0;   // aiProcess_* flags used for the import
+    };
+
+    // One mesh; the pointers refer to the caller's arrays (Write) or into the mapped file (Read)
+    struct MeshCacheMesh
+    {
+        const Vertex* vertices = nullptr;
+        uint32_t vertexCount = 0;
+        const uint32_t* indices = nullptr;
+        uint32_t indexCount = 0;
+        const DirectX::XMFLOAT3* positions = nullptr;  // collision positions, vertexCount entries
+        MeshBounds bounds;
+        const uint32_t* lodIndices = nullptr;           // every LOD's indices back to back
+        uint32_t lodIndexCount = 0;
+        const MeshLod* lods = nullptr;                  // lodCount entries, firstIndex into lodIndices
+        uint32_t lodCount = 0;
+    };
+
+    namespace MeshCache
+    {
+        // False if the source file does not exist
+        bool MakeKey(const std::string& sourcePath, uint32_t importFlags, MeshCacheKey& out);
+
+        // cache/meshes/<hash of the source path>.mesh
+        std::string GetCachePath(const std::string& sourcePath);
+
+        // Written to a temporary file first, so an interrupted write never leaves a truncated cache behind
+        bool Write(const std::string& cachePath, const MeshCacheKey& key, const std::vector<MeshCacheMesh>& meshes);
+
+        // False if the data is not a cache file for key (stale, other source, other format) or is damaged.
+        // out points into data, which must stay mapped while it is used.
+        bool Read(const uint8_t* data, size_t size, const MeshCacheKey& key, std::vector<MeshCacheMesh>& out);
+    }
+}
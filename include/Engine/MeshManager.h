@@ -1,36 +1,100 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <d3d11.h>
 #include <wrl/client.h>
 #include <DirectXMath.h>
+#include "Engine/GeometryArena.h"
+#include "Engine/MeshTypes.h"
 
 // Assimp - model importing
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
-// MeshManager class handles creation and storage of mesh buffers
-// Flow of model loading: LoadModel() -> ProcessNode() -> ProcessMesh() -> CreateMeshBuffers()
+// MeshManager class handles creation and storage of mesh buffers.
+// Vertices and indices of all meshes live in a few shared GeometryArena buffers (one per vertex format and one per
+// index format); a mesh is a range in them, drawn with baseVertex/startIndex.
+// Meshes also get a chain of simplified LODs (MeshSimplifier) at creation; the LOD index lists follow the base indices
+// in the same index range and reuse the base vertices, so a LOD is just another startIndex/indexCount.
+// Flow of model loading: LoadModel() -> cooked cache hit (MeshCache) -> CreateMesh()
+//                        or LoadModel() -> ProcessNode() -> ProcessMesh() -> MeshCache::Write() -> CreateMesh()
 
 namespace Engine
 {
-    // Vertex format used by BasicVS.hlsl
-    struct Vertex
+    // GPU-side compact vertex (16 bytes, BasicVS.hlsl with COMPACT_VERTEX):
+    // position unorm16 relative to the mesh AABB (w unused), octahedral normal snorm16, UV half floats
+    struct CompactVertex
     {
-        DirectX::XMFLOAT3 position;
-        DirectX::XMFLOAT3 normal;    // per-vertex normal
-        DirectX::XMFLOAT2 texCoord;  // per-vertex UV
+        uint16_t position[4];
+        int16_t normal[2];
+        uint16_t texCoord[2];
     };
 
-    // Structure to hold mesh buffers
+    enum class VertexFormat : uint8_t
+    {
+        Full,       // Vertex, 32 bytes (shader IDs 1/3, also the skybox cube)
+        Compact     // CompactVertex, 16 bytes (shader IDs 4/5), dequantized through VS b5
+    };
+
+    // Dequantization constants of a compact mesh (must match HLSL CB_MeshDequant register(b5))
+    struct MeshDequantConstants
+    {
+        DirectX::XMFLOAT3 positionScale;    // position = unorm * scale + offset
+        float padding0;
+        DirectX::XMFLOAT3 positionOffset;
+        float padding1;
+    };
+
+    // Structure to hold mesh buffers (shared arena buffers plus this mesh's range in them)
     struct MeshBuffers
     {
         ID3D11Buffer* vertexBuffer = nullptr;
         ID3D11Buffer* indexBuffer  = nullptr;
         UINT          indexCount   = 0;
+        UINT          startIndex   = 0;
+        INT           baseVertex   = 0;
         UINT          stride       = 0;
         DXGI_FORMAT   indexFormat  = DXGI_FORMAT_R32_UINT;
+        VertexFormat  vertexFormat = VertexFormat::Full;
+        uint32_t      geometry     = 0;         // vertex/index arena pair: equal values share the IA binding
+        ID3D11Buffer* dequantBuffer = nullptr;  // immutable MeshDequantConstants (compact meshes only)
+    };
+
+    // GPU memory of all meshes, and what it would be with 32-byte vertices and 32-bit indices
+    struct MeshMemoryStats
+    {
+        uint32_t meshes = 0;
+        uint32_t compactMeshes = 0;
+        uint32_t index16Meshes = 0;
+        uint64_t vertexBytes = 0;
+        uint64_t indexBytes = 0;
+        uint64_t uncompressedBytes = 0;
+    };
+
+    // Totals over all geometry arenas
+    struct MeshArenaStats
+    {
+        uint64_t capacityBytes = 0;
+        uint64_t usedBytes = 0;
+        uint32_t freeRanges = 0;
+        uint64_t largestFreeBytes = 0;  // largest single free range of any arena
+        uint32_t grows = 0;
+    };
+
+    struct MeshCacheMesh;
+    struct VertexCacheStats;
+
+    // What the last LoadModel call did
+    struct MeshLoadStats
+    {
+        bool fromCache = false;     // cooked cache used, Assimp skipped
+        uint64_t vertices = 0;
+        uint64_t indices = 0;
+        // Post-transform cache efficiency of the import before/after MeshOptimizer (0 when loaded from the cache)
+        float acmrBefore = 0.0f, acmrAfter = 0.0f;
+        float atvrBefore = 0.0f, atvrAfter = 0.0f;
     };
 
     class MeshManager
@@ -38,16 +102,45 @@ namespace Engine
     public:
         // Procedural primitives
         // Creates a unit cube mesh and stores it as meshID 101. Returns 101. (temporary ID)
-        int InitializeCube(ID3D11Device* device);
-        int CreateSphere(ID3D11Device* device, float radius, int slices, int stacks);
+        int InitializeCube(ID3D11Device* device, IRenderDevice& renderDevice);
+        int CreateSphere(ID3D11Device* device, IRenderDevice& renderDevice, float radius, int slices, int stacks);
         // Capsule (Y-axis aligned). radius = sphere radius, cylinderHeight = straight section height (no caps).
-        int CreateCapsule(ID3D11Device* device, float radius, float cylinderHeight, int slices, int stacks);
+        int CreateCapsule(ID3D11Device* device, IRenderDevice& renderDevice, float radius, float cylinderHeight, int slices, int stacks);
+
+        // Loads a model and returns mesh IDs for all mesh parts. Uses the cooked cache when it matches the source,
+        // otherwise imports with Assimp, optimizes the index/vertex order and (re)writes the cache.
+        std::vector<int> LoadModel(ID3D11Device* device, IRenderDevice& renderDevice, const std::string& filename);
+        const MeshLoadStats& GetLastLoadStats() const { return m_lastLoad; }
+
+        // Retrieves buffers for a mesh ID; lod 1..GetMeshLodCount() selects a simplified index range (clamped)
+        bool GetMesh(int meshID, MeshBuffers& out, uint32_t lod = 0) const;
 
-        // Loads a model with Assimp and returns mesh IDs for all mesh parts
-        std::vector<int> LoadModel(ID3D11Device* device, const std::string& filename);
+        // Simplified levels of a mesh, not counting the base mesh (0 if none or the mesh does not exist)
+        uint32_t GetMeshLodCount(int meshID) const;
 
-        // Retrieves buffers for a mesh ID
-        bool GetMesh(int meshID, MeshBuffers& out) const;
+        // LOD generation stops after MeshLodSelect::kMaxLods levels, at this error (relative to the mesh extent) or
+        // below kMinLodTriangles
+        static constexpr float kMaxLodError = 0.05f;
+        static constexpr uint32_t kMinLodTriangles = 32;
+
+        // Frees the mesh's arena ranges and CPU data. The ID is not reused. False if the mesh does not exist.
+        bool ReleaseMesh(int meshID);
+
+        // Packs every arena so freed ranges become one free block at the end (GPU copies; call between frames).
+        // False if a buffer could not be created; that arena keeps its old layout.
+        bool DefragmentGeometry(ID3D11Device* device, IRenderDevice& renderDevice);
+        MeshArenaStats GetArenaStats() const;
+
+        // Meshes created afterwards use CompactVertex where the position quantization error stays below
+        // kMaxQuantizationError (default on). Off: every mesh keeps the 32-byte Vertex.
+        void SetCompactVertices(bool enabled) { m_compactVertices = enabled; }
+        const MeshMemoryStats& GetMemoryStats() const { return m_memory; }
+
+        // Largest allowed position error of a compact mesh (world units at scale 1, i.e. metres)
+        static constexpr float kMaxQuantizationError = 0.0005f;
+
+        // Local bounds for culling
+        bool GetMeshBounds(int meshID, MeshBounds& out) const;
 
         // Accessors for physics
         const std::vector<DirectX::XMFLOAT3>& GetMeshPositions(int meshID) const;
@@ -57,37 +150,94 @@ namespace Engine
         // Internal structure to hold mesh data
         struct MeshData
         {
-            Microsoft::WRL::ComPtr<ID3D11Buffer> vb;
-            Microsoft::WRL::ComPtr<ID3D11Buffer> ib;
+            uint32_t baseVertex = 0;    // first element in the vertex arena of format
+            uint32_t vertexCount = 0;
+            uint32_t startIndex = 0;    // first element in the index arena
             UINT indexCount = 0;
-            UINT stride     = 0;
-            DXGI_FORMAT idxFmt = DXGI_FORMAT_R32_UINT;  // default to 32-bit indices
+            Microsoft::WRL::ComPtr<ID3D11Buffer> dequant;  // compact meshes only
+            bool index16 = false;       // R16_UINT arena when every index fits
+            VertexFormat format = VertexFormat::Full;
 
             // CPU-side cached data for physics
             std::vector<DirectX::XMFLOAT3> positions;  // vertex positions
             std::vector<uint32_t> indices;             // triangle indices
+
+            MeshBounds bounds;
+            std::vector<MeshLod> lods;      // behind the base indices in the same index range
+            uint32_t lodIndexCount = 0;
+        };
+
+        // Assimp output of one mesh part
+        struct ImportedMesh
+        {
+            std::vector<Vertex> vertices;
+            std::vector<uint32_t> indices;
+            std::vector<DirectX::XMFLOAT3> positions;   // filled by DescribeMesh
+            std::vector<uint32_t> lodIndices;           // filled by BuildLods
+            std::vector<MeshLod> lods;
         };
 
+        // Computes AABB + bounding sphere from vertex positions
+        static MeshBounds ComputeBounds(const std::vector<Vertex>& vertices);
+
+        // Vertex cache, overdraw and vertex fetch ordering (MeshOptimizer), optionally measured before/after.
+        // Every mesh goes through this once before its buffers are created.
+        static void OptimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                 VertexCacheStats* before = nullptr, VertexCacheStats* after = nullptr);
+
+        // LOD chain from the (optimized) base mesh: each level aims at half the previous triangles and is cache-ordered
+        static void BuildLods(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                              std::vector<uint32_t>& lodIndices, std::vector<MeshLod>& lods);
+
+        // Fills positions and bounds; the result points into the vectors
+        static MeshCacheMesh DescribeMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                          std::vector<DirectX::XMFLOAT3>& positions,
+                                          const std::vector<uint32_t>* lodIndices = nullptr, const std::vector<MeshLod>* lods = nullptr);
+
+        // Create buffers from a mesh description and store MeshData under id; returns id or -1.
+        // allowCompact: false keeps the full Vertex layout (meshes drawn by shaders without the compact decode).
+        int CreateMesh(ID3D11Device* device, IRenderDevice& renderDevice, int id, const MeshCacheMesh& mesh, bool allowCompact = true);
+
+        // CompactVertex encoding against the mesh AABB; false if the quantization error would be too large
+        static bool CompactVertices(const MeshCacheMesh& mesh, std::vector<CompactVertex>& out, MeshDequantConstants& dequant);
+
         // Create buffers and store MeshData; returns assigned mesh ID
-        int CreateMeshBuffers(ID3D11Device* device,
+        int CreateMeshBuffers(ID3D11Device* device, IRenderDevice& renderDevice,
                               const std::vector<Vertex>& vertices,
                               const std::vector<uint32_t>& indices);
 
 		// Create buffers with forced ID (used for cube with fixed ID 101)
-        int CreateMeshBuffersWithID(ID3D11Device* device, int forcedID,
+        int CreateMeshBuffersWithID(ID3D11Device* device, IRenderDevice& renderDevice, int forcedID,
                                 const std::vector<Vertex>& vertices,
                                 const std::vector<uint32_t>& indices);
 
         // Process Assimp node recursively
-        void ProcessNode(ID3D11Device* device, aiNode* node, const aiScene* scene, std::vector<int>& outMeshIDs);
+        void ProcessNode(aiNode* node, const aiScene* scene, std::vector<ImportedMesh>& out);
 
-        // Convert Assimp mesh to internal buffers, store and return ID
-        int ProcessMesh(ID3D11Device* device, aiMesh* mesh, const aiScene* scene);
+        // Convert Assimp mesh to engine vertices/indices
+        void ProcessMesh(aiMesh* mesh, ImportedMesh& out);
 
         // Map of meshID to MeshData
         std::unordered_map<int, MeshData> m_meshes;
 
+        // Shared buffers, indexed by VertexFormat and by index size (0: 16-bit, 1: 32-bit); created on first use
+        GeometryArena m_vertexArenas[2] = {
+            GeometryArena(sizeof(Vertex), D3D11_BIND_VERTEX_BUFFER, 1u << 16),
+            GeometryArena(sizeof(CompactVertex), D3D11_BIND_VERTEX_BUFFER, 1u << 16) };
+        GeometryArena m_indexArenas[2] = {
+            GeometryArena(sizeof(uint16_t), D3D11_BIND_INDEX_BUFFER, 1u << 18),
+            GeometryArena(sizeof(uint32_t), D3D11_BIND_INDEX_BUFFER, 1u << 18) };
+
+        // CreateMesh upload staging (compact vertices, base + LOD indices in one range), kept to reuse the allocations
+        std::vector<CompactVertex> m_compactScratch;
+        std::vector<uint16_t> m_indices16Scratch;
+        std::vector<uint32_t> m_indices32Scratch;
+
         // ID allocator (starts after reserved 101)
         int m_nextMeshID = 102;
+
+        MeshLoadStats m_lastLoad;
+        MeshMemoryStats m_memory;
+        bool m_compactVertices = true;
     };
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// MeshOptimizer reorders triangle lists for the GPU at import time (no D3D dependency):
+//  - vertex cache: Forsyth's linear-speed greedy ordering, so triangles reuse recently transformed vertices
+//  - overdraw: splits the cache-optimized order into clusters (Sander et al.) and draws outward-facing clusters first,
+//    as long as the cache efficiency stays within a threshold
+//  - vertex fetch: renumbers vertices in first-use order, so the vertex buffer is read front to back
+// AnalyzeVertexCache simulates a FIFO post-transform cache to report ACMR (transformed vertices per triangle, 0.5 ideal
+// for grids, 3 worst) and ATVR (transformed per unique vertex, 1 ideal).
+// Flow: OptimizeVertexCache(indices) -> OptimizeOverdraw(indices, positions) -> ReorderVertexFetch(vertices, indices)
+
+namespace Engine
+{
+    struct VertexCacheStats
+    {
+        float acmr = 0.0f;
+        float atvr = 0.0f;
+    };
+
+    namespace MeshOptimizer
+    {
+        // Typical post-transform cache size of current GPUs for the FIFO simulation
+        constexpr uint32_t kAnalyzeCacheSize = 16;
+
+        VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                            uint32_t cacheSize = kAnalyzeCacheSize);
+
+        // In place; indexCount must be a multiple of 3 and every index < vertexCount
+        void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+        // In place, on a cache-optimized list. threshold: allowed ACMR growth (1.05 = 5% worse than the input order).
+        void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const DirectX::XMFLOAT3* positions, size_t vertexCount,
+                              float threshold = 1.05f);
+
+        // remap[old vertex] = new vertex: first-use order, unreferenced vertices last. Rewrites indices.
+        void BuildVertexFetchRemap(uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap);
+
+        // Applies BuildVertexFetchRemap to any vertex type
+        template<typename V>
+        void ReorderVertexFetch(std::vector<V>& vertices, std::vector<uint32_t>& indices)
+        {
+            std::vector<uint32_t> remap;
+            BuildVertexFetchRemap(indices.data(), indices.size(), vertices.size(), remap);
+
+            std::vector<V> reordered(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i)
+                reordered[remap[i]] = vertices[i];
+            vertices.swap(reordered);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <DirectXMath.h>
+
+// MeshSimplifier reduces a triangle list by quadric-error edge collapse (Garland & Heckbert) for LOD generation
+// (no D3D dependency). Vertices only ever collapse onto existing vertices, so a simplified index list still indexes the
+// original vertex buffer and every surviving vertex keeps its exact attributes.
+// Vertices are classified once by their open edges (edges without a twin in the index buffer):
+//  - manifold: interior vertex, collapses onto any neighbour
+//  - border: on an open mesh boundary, only slides along it
+//  - seam: two vertices at one position (UV / normal seam); both sides collapse together along the seam
+//  - locked: anything else (corners, UV islands meeting in a point, non-manifold), never moves
+// Borders and seams also get edge quadrics so their outline is preserved.
+// Flow: Simplify(out, indices, positions, target count, target error) -> MeshOptimizer::OptimizeVertexCache(out)
+
+namespace Engine
+{
+    namespace MeshSimplifier
+    {
+        // Writes at most indexCount indices to destination (may alias indices) and returns the new index count.
+        // Stops at targetIndexCount or when the next collapse would move the surface by more than targetError,
+        // relative to the mesh extent (0.01 = 1% of the largest AABB side). resultError: largest relative error committed.
+        size_t Simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                        const DirectX::XMFLOAT3* positions, size_t vertexCount,
+                        size_t targetIndexCount, float targetError, float* resultError = nullptr);
+    }
+}
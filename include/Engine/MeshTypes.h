@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <DirectXMath.h>
+
+// CPU-side mesh data shared by MeshManager (GPU upload), MeshCache (cooked files) and the mesh tools, plus the LOD
+// selection rule; no D3D11 or Assimp types, so they can be used and tested without a device.
+
+namespace Engine
+{
+    // Vertex format used by BasicVS.hlsl
+    struct Vertex
+    {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT3 normal;    // per-vertex normal
+        DirectX::XMFLOAT2 texCoord;  // per-vertex UV
+    };
+
+    // One simplified level of a mesh: an index range over the base vertices
+    struct MeshLod
+    {
+        uint32_t firstIndex = 0;    // relative to the first LOD index (MeshCacheMesh) or the mesh's startIndex (MeshData)
+        uint32_t indexCount = 0;
+        float error = 0.0f;         // accumulated simplification error, relative to the mesh extent
+    };
+
+    // Local-space bounding volumes of a mesh (computed once from its vertices)
+    struct MeshBounds
+    {
+        DirectX::XMFLOAT3 center{ 0.0f, 0.0f, 0.0f };   // AABB center, also the sphere center
+        DirectX::XMFLOAT3 extents{ 0.0f, 0.0f, 0.0f };  // AABB half-size
+        float radius = 0.0f;                            // bounding sphere radius around center
+    };
+
+    // Runtime LOD selection from a projected bounding-sphere diameter (fraction of the viewport height)
+    namespace MeshLodSelect
+    {
+        constexpr uint32_t kMaxLods = 4;
+        constexpr float kScreenSize[kMaxLods] = { 0.4f, 0.2f, 0.1f, 0.05f };
+        constexpr float kHysteresis = 0.15f;
+
+        // Levels switch at kScreenSize with kHysteresis of slack around each threshold, so objects near one do not
+        // flicker. lodCount: simplified levels of the mesh (level 0 is the base mesh).
+        inline uint32_t Select(float screenSize, uint32_t currentLod, uint32_t lodCount)
+        {
+            lodCount = std::min(lodCount, kMaxLods);
+            const uint32_t current = std::min(currentLod, lodCount);
+
+            uint32_t lod = 0;
+            while (lod < lodCount && screenSize < kScreenSize[lod])
+                ++lod;
+
+            // Only cross a threshold once the size is clearly past it, in either direction
+            while (lod > current && screenSize > kScreenSize[lod - 1] * (1.0f - kHysteresis))
+                --lod;
+            while (lod < current && screenSize < kScreenSize[lod] * (1.0f + kHysteresis))
+                ++lod;
+            return lod;
+        }
+    }
+}
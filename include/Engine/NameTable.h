@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// NameTable interns strings: each distinct string is stored once, null-terminated, in large arena blocks and gets a
+// stable 32-bit handle. Handles never change or expire, so components can hold them as plain data (trivially copyable,
+// memcpy'd by snapshots). Handle 0 is the empty string.
+// Handles are process-local: files store the strings (see SceneSerializer). Not thread-safe; names are created and
+// resolved on the main thread (entity creation, editor, scene loading).
+// Flow: GetNameTable().Intern("Cube") -> handle stored in NameComponent -> GetNameTable().CStr(handle) when displayed
+
+namespace Engine
+{
+    using NameHandle = uint32_t;
+
+    class NameTable
+    {
+    public:
+        NameTable();
+        NameTable(const NameTable&) = delete;
+        NameTable& operator=(const NameTable&) = delete;
+
+        // Existing handle for an equal string, or a new one
+        NameHandle Intern(std::string_view s);
+
+        // Unknown handles resolve to ""
+        std::string_view Resolve(NameHandle handle) const;
+        const char* CStr(NameHandle handle) const;
+
+        size_t GetCount() const { return m_entries.size(); }
+        // Arena blocks + handle table + hash index (approximate node overhead)
+        size_t GetMemoryBytes() const;
+
+    private:
+        struct Entry
+        {
+            const char* data;
+            uint32_t length;
+        };
+
+        const char* Store(std::string_view s);
+
+        static constexpr size_t kBlockSize = 64 * 1024;
+
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        size_t m_blockCapacity = 0;         // size of m_blocks.back()
+        size_t m_blockUsed = 0;             // bytes used in m_blocks.back()
+        size_t m_arenaBytes = 0;
+        std::vector<Entry> m_entries;       // indexed by handle
+        std::unordered_map<std::string_view, NameHandle> m_lookup; // views into the arena
+    };
+
+    // The engine-wide table (names are shared by every scene, the Play/Stop backup included)
+    NameTable& GetNameTable();
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// OffsetAllocator hands out variable-size ranges of a fixed-capacity space (elements of a GPU buffer) and takes them
+// back in any order. Free ranges are kept by offset (neighbours coalesce on Free) and by size (best fit on Allocate).
+// Holes left by freed ranges are closed by Defragment, which packs every allocation to the front and reports the
+// moves the owner has to apply to its data. It only tracks offsets, so it has no D3D dependency.
+// Flow: Initialize(capacity) -> Allocate()/Free()... -> (full) Grow(larger) -> (fragmented) Defragment(moves)
+
+namespace Engine
+{
+    class OffsetAllocator
+    {
+    public:
+        struct Allocation
+        {
+            uint32_t offset = 0;    // first element
+            uint32_t size = 0;      // element count
+        };
+
+        // One allocation moved by Defragment (to <= from; moves are in ascending offset order)
+        struct Move
+        {
+            uint32_t from = 0;
+            uint32_t to = 0;
+            uint32_t size = 0;
+        };
+
+        // Drops every allocation; the whole capacity becomes one free range
+        void Initialize(uint32_t capacity);
+
+        // Best fit (smallest free range that holds size, lowest offset on ties). False if size is 0 or nothing fits.
+        bool Allocate(uint32_t size, Allocation& out);
+
+        // False if offset is not the start of a live allocation
+        bool Free(uint32_t offset);
+
+        // Adds [capacity, newCapacity) as free space (merged with a free range at the end); never shrinks
+        void Grow(uint32_t newCapacity);
+
+        // Packs allocations to the front in offset order, leaving one free range at the end.
+        // Copying in the order of moves never overwrites a range before it was moved.
+        void Defragment(std::vector<Move>& moves);
+
+        uint32_t GetCapacity() const { return m_capacity; }
+        uint32_t GetUsed() const { return m_used; }
+        uint32_t GetAllocationCount() const { return static_cast<uint32_t>(m_allocated.size()); }
+        uint32_t GetFreeRangeCount() const { return static_cast<uint32_t>(m_freeByOffset.size()); }
+        uint32_t GetLargestFreeRange() const { return m_freeBySize.empty() ? 0u : m_freeBySize.rbegin()->first; }
+
+        // Consistency check for benchmarks: ranges tile the capacity exactly, free ranges never touch, both free
+        // indices agree and the used count matches
+        bool Validate() const;
+
+    private:
+        void InsertFree(uint32_t offset, uint32_t size);
+        void EraseFree(std::map<uint32_t, uint32_t>::iterator it);
+
+        std::map<uint32_t, uint32_t> m_freeByOffset;            // offset -> size
+        std::set<std::pair<uint32_t, uint32_t>> m_freeBySize;   // (size, offset)
+        std::unordered_map<uint32_t, uint32_t> m_allocated;     // offset -> size
+        std::vector<std::pair<uint32_t, uint32_t>> m_sorted;   // Defragment scratch: allocations by offset
+
+        uint32_t m_capacity = 0;
+        uint32_t m_used = 0;
+    };
+}
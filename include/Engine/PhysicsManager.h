@@ -5,7 +5,6 @@
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 
 // Physics system
 #include <Jolt/Physics/PhysicsSettings.h>
@@ -19,10 +18,13 @@
 #include <Jolt/Physics/Body/MotionType.h>
 
 #include "Engine/MathUtils.h"
+#include "Engine/JoltJobSystem.h"
 #include <entt/entt.hpp>
 
 // for cache
 #include <unordered_map>
+#include <vector>
+#include <mutex>
 
 // PhysicsManager handles Jolt initialization, update, and rigidbody creation/removal
 
@@ -98,6 +100,30 @@ public:
     }
 };
 
+// Activation listener: keeps a dense set of awake bodies so the ECS sync only visits those
+// Jolt calls it from job threads during the step (and from the main thread on add/remove), hence the mutex.
+class BodyActivationListenerImpl final : public JPH::BodyActivationListener {
+public:
+    // Size the index -> slot table for the world's body capacity
+    void Reset(JPH::uint maxBodies);
+
+    void OnBodyActivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override;
+    void OnBodyDeactivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override;
+
+    // Copy of the bodies currently awake
+    void GetAwakeBodies(std::vector<JPH::BodyID>& outBodies) const;
+    // Bodies that fell asleep since the last call (and are still asleep)
+    void TakeDeactivatedBodies(std::vector<JPH::BodyID>& outBodies);
+
+private:
+    static constexpr JPH::uint32 kNotAwake = 0xFFFFFFFFu;
+
+    mutable std::mutex m_mutex;
+    std::vector<JPH::BodyID> m_awake;           // dense, swap-removed
+    std::vector<JPH::uint32> m_slot;            // body index -> position in m_awake
+    std::vector<JPH::BodyID> m_deactivated;
+};
+
 namespace Engine {
 
 // Forward declarations
@@ -105,14 +131,45 @@ struct TransformComponent;
 struct RigidBodyComponent;
 class MeshManager;
 
+// Result of one ray in a batched raycast
+struct RayHit
+{
+    entt::entity entity = entt::null;   // owner of the hit body, null when nothing was hit
+    float distance = 0.0f;              // along the (normalized) ray direction
+};
+
+// Per-frame physics counters (reset by PhysicsSystem each frame)
+struct PhysicsStats
+{
+    uint32_t steps = 0;             // fixed steps simulated
+    uint32_t editSyncedBodies = 0;  // bodies pushed ECS -> Jolt in Edit mode because their Transform changed
+    uint32_t bodiesCreated = 0;      // bodies inserted through the batched path
+    uint32_t awakeBodiesSynced = 0;  // bodies read back Jolt -> ECS in Play mode
+};
+
 class PhysicsManager {
 public:
-	// Initialize Jolt physics system
-    bool Initialize();
+	// Initialize Jolt physics system; Jolt's jobs run on the engine job system
+    bool Initialize(JobSystem& jobSystem);
 	// Shutdown and cleanup
     void Shutdown();
-	// Update physics simulation
-    void Update(float deltaTime);
+	// Update physics simulation: accumulates deltaTime and runs as many fixed steps as fit (up to the substep cap)
+	// returns the number of steps taken; GetInterpolationAlpha() gives the leftover fraction of a step
+    int Update(float deltaTime);
+	// Advance the simulation by exactly one fixed step
+    void Step();
+
+	// Fixed-step configuration (e.g. 60 or 120 Hz); time beyond maxSubsteps steps in one frame is dropped
+    void SetFixedTimestep(float stepsPerSecond, int maxSubsteps);
+    float GetFixedDeltaTime() const { return m_fixedDeltaTime; }
+    int GetMaxSubsteps() const { return m_maxSubsteps; }
+
+	// Number of fixed steps the accumulated frame time is worth this frame (consumes the time, does not step)
+    int ConsumeSteps(float deltaTime);
+	// Fraction [0..1) of a fixed step left in the accumulator, used to blend previous/current body poses
+    float GetInterpolationAlpha() const { return m_accumulator / m_fixedDeltaTime; }
+	// Drop any accumulated time (e.g. when entering Play mode)
+    void ResetAccumulator() { m_accumulator = 0.0f; }
 
 	// Access physics system for advanced usage
     JPH::PhysicsSystem* GetSystem() const { return m_physicsSystem; }
@@ -120,8 +177,15 @@ public:
     JPH::BodyInterface& GetBodyInterface();
 
     // ECS bridge: create/remove bodies from components
-	// Create the base shape first, then apply scaling and create body
-    JPH::BodyID CreateRigidBody(const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager);
+	// Create the base shape first, then apply scaling and create body; the owning entity is kept in the body's user data
+    JPH::BodyID CreateRigidBody(entt::entity entity, const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager);
+
+	// Batched variant: creates the body but defers insertion until FlushPendingBodies (one broadphase update for all)
+    JPH::BodyID QueueRigidBody(entt::entity entity, const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager);
+	// Insert all queued bodies via AddBodiesPrepare/AddBodiesFinalize; optionally rebuild the broadphase tree afterwards
+	// returns the number of bodies inserted
+    uint32_t FlushPendingBodies(bool optimizeBroadPhase);
+    size_t GetPendingBodyCount() const { return m_pendingBodies.size(); }
     
 	// Remove body by ID
     void RemoveRigidBody(JPH::BodyID bodyID);
@@ -129,20 +193,56 @@ public:
 	// Raycast and return hit entity (or null if no hit)
     entt::entity CastRay(const Engine::Math::Ray& ray, entt::registry& registry);
 
+	// Cast many rays at once, spread over the engine job system; outHits[i] is the closest hit of rays[i].
+	// Hits are validated like CastRay (entity alive and still owning the body); the registry must not change meanwhile
+    void CastRays(const std::vector<Engine::Math::Ray>& rays, const entt::registry& registry, std::vector<RayHit>& outHits, float maxDistance = 1000.0f);
+
+	// Entity that owns a body (O(1), read from the body's user data)
+    entt::entity GetBodyEntity(JPH::BodyID bodyID);
+
+	// Awake-body tracking (see BodyActivationListenerImpl); the lists are kept by the manager and overwritten by the next call
+    const std::vector<JPH::BodyID>& GetAwakeBodies() { m_activationListener.GetAwakeBodies(m_awakeBodies); return m_awakeBodies; }
+    const std::vector<JPH::BodyID>& TakeDeactivatedBodies() { m_activationListener.TakeDeactivatedBodies(m_deactivatedBodies); return m_deactivatedBodies; }
+	// Lock-free body access, only valid on the main thread between steps
+    const JPH::BodyInterface& GetBodyInterfaceNoLock() const { return m_physicsSystem->GetBodyInterfaceNoLock(); }
+
+	// Counters for profiling, filled by PhysicsSystem
+    PhysicsStats& GetStats() { return m_stats; }
+    const PhysicsStats& GetStats() const { return m_stats; }
+
     // Teleport a body to match the current TransformComponent, and rebuild it if scale changed
     void ResetBodyTransform(const TransformComponent& tc, RigidBodyComponent& rbc, const MeshManager& meshManager);
 
 private:
     // Helper: build the correct Jolt collision shape using RigidBodyComponent + Transform scale
     JPH::ShapeRefC CreatePhysicsShape(const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager);
+    // Helper: create (but do not add) the body for a component
+    JPH::Body* CreateBody(entt::entity entity, const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager);
 
 private:
 	JPH::TempAllocatorImpl* m_tempAllocator = nullptr;                  // for per-frame temporary allocations
-	JPH::JobSystemThreadPool* m_jobSystem = nullptr;                    // for multithreading
+	JoltJobSystemAdapter* m_jobSystem = nullptr;                        // Jolt jobs -> engine job system
+	JobSystem* m_engineJobs = nullptr;                                  // for batched queries
 	JPH::PhysicsSystem* m_physicsSystem = nullptr;                      // main physics system
 	BPLayerInterfaceImpl* m_bpLayerInterface = nullptr;                 // broadphase layer interface
 	ObjectVsBroadPhaseLayerFilterImpl* m_objVsBpLayerFilter = nullptr;  // object vs broadphase layer filter
 	ObjectLayerPairFilterImpl* m_objLayerPairFilter = nullptr;          // object layer pair filter
+	BodyActivationListenerImpl m_activationListener;                    // awake-body set
+
+    // Fixed-step accumulator
+    float m_fixedDeltaTime = 1.0f / 60.0f;
+    int m_maxSubsteps = 4;
+    int m_collisionSteps = 2;   // collision sub-steps per fixed step (keeps the effective step <= 1/120 s)
+    float m_accumulator = 0.0f;
+
+    PhysicsStats m_stats;
+
+    // Bodies created by QueueRigidBody, waiting for FlushPendingBodies
+    std::vector<JPH::BodyID> m_pendingBodies;
+
+    // Copies handed out by GetAwakeBodies/TakeDeactivatedBodies (reused every frame)
+    std::vector<JPH::BodyID> m_awakeBodies;
+    std::vector<JPH::BodyID> m_deactivatedBodies;
 
     // Cache convex hull shapes per meshID to avoid rebuilding each time
     std::unordered_map<int, JPH::ShapeRefC> m_meshShapeCache;
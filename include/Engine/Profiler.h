@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Profiler records named CPU scopes. Each thread appends finished scopes (name, start/end in nanoseconds, nesting
+// depth) to its own fixed-size ring buffer without locks; readers (Chrome trace export, the editor's flame graph)
+// copy the newest events and drop any the owning thread may have overwritten meanwhile.
+// Only enabled with ENGINE_ENABLE_PROFILER (CMake option): otherwise every macro expands to nothing.
+// Scope names must outlive the profiler (string literals, or strings owned by long-lived objects).
+// Flow: ENGINE_PROFILE_FRAME() once per main loop iteration -> ENGINE_PROFILE_SCOPE("Name") in code of interest
+//       -> GetFrame()/WriteChromeTrace(path)
+
+#ifdef ENGINE_ENABLE_PROFILER
+
+namespace Engine
+{
+    struct ProfileEvent
+    {
+        const char* name = nullptr;
+        uint64_t startNs = 0;
+        uint64_t endNs = 0;
+        uint32_t depth = 0;
+    };
+
+    // Events of one thread inside a captured interval
+    struct ProfileThreadEvents
+    {
+        std::string threadName;
+        uint32_t threadId = 0;
+        uint32_t maxDepth = 0;
+        std::vector<ProfileEvent> events;
+    };
+
+    struct ProfileFrame
+    {
+        uint64_t startNs = 0;
+        uint64_t endNs = 0;
+        std::vector<ProfileThreadEvents> threads;
+    };
+
+    class Profiler
+    {
+    public:
+        static Profiler& Get();
+        static uint64_t NowNs();
+
+        // Main thread: marks the start of a frame
+        void BeginFrame();
+        // Names the calling thread in traces (copied)
+        void SetThreadName(const char* name);
+
+        // Last completed frame, every thread's events overlapping it. False before two frames were marked.
+        // out's event vectors are reused as copy space (keep the same ProfileFrame between calls).
+        bool GetFrame(ProfileFrame& out) const;
+        // Every event still in the buffers, as Chrome trace JSON (chrome://tracing, Perfetto)
+        bool WriteChromeTrace(const std::string& path) const;
+
+        uint64_t GetEventCount() const;             // events recorded since start, all threads
+        double GetLastFrameMs() const;
+        // Cost of one scope (enter + leave) on this machine, measured on the first call (make that one at startup)
+        double GetScopeCostNs();
+
+        // Per-thread ring buffer (public for ProfileScope)
+        struct ThreadBuffer
+        {
+            static constexpr uint32_t kCapacity = 1u << 16;
+
+            // Relaxed atomics (plain loads/stores on x86/ARM) so readers may copy a slot while it is rewritten;
+            // such copies are then discarded through the written count
+            struct Slot
+            {
+                std::atomic<const char*> name{ nullptr };
+                std::atomic<uint64_t> startNs{ 0 };
+                std::atomic<uint64_t> endNs{ 0 };
+                std::atomic<uint32_t> depth{ 0 };
+            };
+
+            std::unique_ptr<Slot[]> slots{ new Slot[kCapacity] };
+            std::atomic<uint64_t> written{ 0 };     // events ever written; slot = index % kCapacity
+            uint32_t depth = 0;                     // open scopes (owning thread only)
+            uint32_t threadId = 0;
+            std::string name;
+        };
+
+        static ThreadBuffer& GetThreadBuffer()
+        {
+            thread_local ThreadBuffer* t_buffer = nullptr;
+            if (!t_buffer) t_buffer = Get().RegisterThread();
+            return *t_buffer;
+        }
+
+    private:
+        ThreadBuffer* RegisterThread();
+        // Copies the events of b that are certainly intact into out (oldest first)
+        static void CopyEvents(const ThreadBuffer& b, std::vector<ProfileEvent>& out);
+
+        static constexpr uint32_t kFrameHistory = 64;
+
+        mutable std::mutex m_threadsMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+        uint64_t m_frameStart[kFrameHistory] = {};  // main thread only
+        uint64_t m_frameCount = 0;
+        double m_scopeCostNs = -1.0;
+        uint64_t m_originNs = NowNs();
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name)
+            : m_buffer(Profiler::GetThreadBuffer()), m_name(name), m_depth(m_buffer.depth++), m_start(Profiler::NowNs())
+        {
+        }
+
+        ~ProfileScope()
+        {
+            const uint64_t end = Profiler::NowNs();
+            --m_buffer.depth;
+
+            // Single writer: fill the slot, then publish it
+            const uint64_t index = m_buffer.written.load(std::memory_order_relaxed);
+            Profiler::ThreadBuffer::Slot& slot = m_buffer.slots[index % Profiler::ThreadBuffer::kCapacity];
+            slot.name.store(m_name, std::memory_order_relaxed);
+            slot.startNs.store(m_start, std::memory_order_relaxed);
+            slot.endNs.store(end, std::memory_order_relaxed);
+            slot.depth.store(m_depth, std::memory_order_relaxed);
+            m_buffer.written.store(index + 1, std::memory_order_release);
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        Profiler::ThreadBuffer& m_buffer;
+        const char* m_name;
+        uint32_t m_depth;
+        uint64_t m_start;
+    };
+}
+
+#define ENGINE_PROFILE_CONCAT_INNER(a, b) a##b
+#define ENGINE_PROFILE_CONCAT(a, b) ENGINE_PROFILE_CONCAT_INNER(a, b)
+#define ENGINE_PROFILE_SCOPE(name) ::Engine::ProfileScope ENGINE_PROFILE_CONCAT(engineProfileScope_, __LINE__)(name)
+#define ENGINE_PROFILE_FUNCTION() ENGINE_PROFILE_SCOPE(__FUNCTION__)
+#define ENGINE_PROFILE_FRAME() ::Engine::Profiler::Get().BeginFrame()
+#define ENGINE_PROFILE_THREAD(name) ::Engine::Profiler::Get().SetThreadName(name)
+
+#else
+
+#define ENGINE_PROFILE_SCOPE(name) ((void)0)
+#define ENGINE_PROFILE_FUNCTION() ((void)0)
+#define ENGINE_PROFILE_FRAME() ((void)0)
+#define ENGINE_PROFILE_THREAD(name) ((void)0)
+
+#endif
@@ -0,0 +1,204 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <unordered_map>
+#include <d3d11.h>
+#include <d3d11_1.h>
+#include <wrl/client.h>
+
+// IRenderDevice is the thin command layer under Renderer: every bind, upload and draw the engine issues goes through it.
+// D3D11RenderDevice forwards to an ID3D11DeviceContext; NullRenderDevice only counts (and optionally logs) the calls,
+// so the CPU side of a frame can be measured without submitting GPU work.
+// Resources are still created on a real ID3D11Device (WARP in headless mode); D3D objects are opaque handles here.
+
+namespace Engine
+{
+    // Per-frame command counts (filled by NullRenderDevice; reset by the caller)
+    struct RenderDeviceStats
+    {
+        uint32_t draws = 0;
+        uint32_t instancedDraws = 0;
+        uint64_t indices = 0;           // indices submitted (x instances for instanced draws)
+        uint32_t shaderBinds = 0;
+        uint32_t layoutBinds = 0;
+        uint32_t vertexBufferBinds = 0;
+        uint32_t indexBufferBinds = 0;
+        uint32_t constantBufferBinds = 0;
+        uint32_t textureBinds = 0;
+        uint32_t samplerBinds = 0;
+        uint32_t stateBinds = 0;        // raster/depth/topology/viewport/render targets
+        uint32_t clears = 0;
+        uint32_t uploads = 0;           // UpdateBuffer + UpdateBufferRange + WriteBuffer calls
+        uint64_t uploadBytes = 0;
+        uint32_t copies = 0;            // CopyBufferRegion calls
+        uint64_t copyBytes = 0;
+        uint32_t discardWrites = 0;     // WriteBuffer calls mapped with DISCARD
+    };
+
+    class IRenderDevice
+    {
+    public:
+        virtual ~IRenderDevice() = default;
+
+        // Output merger / rasterizer
+        virtual void SetRenderTargets(ID3D11RenderTargetView* rtv, ID3D11DepthStencilView* dsv) = 0;
+        virtual void ClearRenderTarget(ID3D11RenderTargetView* rtv, const float color[4]) = 0;
+        virtual void ClearDepthStencil(ID3D11DepthStencilView* dsv) = 0;
+        virtual void SetViewport(const D3D11_VIEWPORT& viewport) = 0;
+        virtual void SetRasterizerState(ID3D11RasterizerState* state) = 0;
+        virtual void SetDepthStencilState(ID3D11DepthStencilState* state) = 0;
+
+        // Pipeline
+        virtual void SetShaders(ID3D11VertexShader* vs, ID3D11PixelShader* ps) = 0;
+        virtual void SetInputLayout(ID3D11InputLayout* layout) = 0;
+        virtual void SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset) = 0;
+        virtual void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format) = 0;
+        virtual void SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology) = 0;
+        virtual void SetVSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* buffers) = 0;
+        virtual void SetPSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* buffers) = 0;
+        // Window of a larger buffer in 16-byte constants (requires SupportsConstantOffsets())
+        virtual void SetVSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants) = 0;
+        virtual void SetPSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants) = 0;
+        virtual void SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* srv) = 0;
+        virtual void SetPSSampler(UINT slot, ID3D11SamplerState* sampler) = 0;
+
+        // Uploads: UpdateSubresource on DEFAULT buffers, Map/memcpy/Unmap on DYNAMIC buffers
+        virtual void UpdateBuffer(ID3D11Buffer* buffer, const void* data, UINT size) = 0;
+        virtual bool WriteBuffer(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size, D3D11_MAP mapType) = 0;
+        // Byte range of a DEFAULT buffer (UpdateSubresource with a box)
+        virtual void UpdateBufferRange(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size) = 0;
+        // GPU-side copy of size bytes between two buffers (CopySubresourceRegion)
+        virtual void CopyBufferRegion(ID3D11Buffer* dst, UINT dstOffset, ID3D11Buffer* src, UINT srcOffset, UINT size) = 0;
+
+        // Draws
+        virtual void DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex) = 0;
+        virtual void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) = 0;
+
+        // Frame fences: SignalFence() marks the end of the submitted work and returns its value,
+        // GetCompletedFence() returns the newest value the GPU has finished (monotonic)
+        virtual uint64_t SignalFence() = 0;
+        virtual uint64_t GetCompletedFence() = 0;
+
+        // True if *ConstantBufferRange and NO_OVERWRITE maps on constant buffers are available
+        virtual bool SupportsConstantOffsets() const = 0;
+
+        // false: commands are not executed (present should be skipped too)
+        virtual bool SubmitsWork() const = 0;
+    };
+
+
+    // Forwards to the immediate context; fences are D3D11 event queries
+    class D3D11RenderDevice final : public IRenderDevice
+    {
+    public:
+        bool Initialize(ID3D11Device* device, ID3D11DeviceContext* context);
+
+        void SetRenderTargets(ID3D11RenderTargetView* rtv, ID3D11DepthStencilView* dsv) override;
+        void ClearRenderTarget(ID3D11RenderTargetView* rtv, const float color[4]) override;
+        void ClearDepthStencil(ID3D11DepthStencilView* dsv) override;
+        void SetViewport(const D3D11_VIEWPORT& viewport) override;
+        void SetRasterizerState(ID3D11RasterizerState* state) override;
+        void SetDepthStencilState(ID3D11DepthStencilState* state) override;
+
+        void SetShaders(ID3D11VertexShader* vs, ID3D11PixelShader* ps) override;
+        void SetInputLayout(ID3D11InputLayout* layout) override;
+        void SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset) override;
+        void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format) override;
+        void SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology) override;
+        void SetVSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* buffers) override;
+        void SetPSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* buffers) override;
+        void SetVSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants) override;
+        void SetPSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants) override;
+        void SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* srv) override;
+        void SetPSSampler(UINT slot, ID3D11SamplerState* sampler) override;
+
+        void UpdateBuffer(ID3D11Buffer* buffer, const void* data, UINT size) override;
+        bool WriteBuffer(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size, D3D11_MAP mapType) override;
+        void UpdateBufferRange(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size) override;
+        void CopyBufferRegion(ID3D11Buffer* dst, UINT dstOffset, ID3D11Buffer* src, UINT srcOffset, UINT size) override;
+
+        void DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex) override;
+        void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) override;
+
+        uint64_t SignalFence() override;
+        uint64_t GetCompletedFence() override;
+
+        bool SupportsConstantOffsets() const override { return m_constantOffsets; }
+        bool SubmitsWork() const override { return true; }
+
+    private:
+        static constexpr UINT kFenceCount = 4; // frames that may be in flight before SignalFence waits on the oldest
+
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_context;
+        Microsoft::WRL::ComPtr<ID3D11DeviceContext1> m_context1;
+        bool m_constantOffsets = false;
+
+        Microsoft::WRL::ComPtr<ID3D11Query> m_fenceQueries[kFenceCount];
+        uint64_t m_submittedFence = 0;
+        uint64_t m_completedFence = 0;
+    };
+
+
+    // Records nothing on the GPU: counts every call and optionally prints one line per call to a log file
+    class NullRenderDevice final : public IRenderDevice
+    {
+    public:
+        // log: optional per-command trace (nullptr = counting only)
+        void SetLog(std::FILE* log) { m_log = log; }
+
+        const RenderDeviceStats& GetStats() const { return m_stats; }
+        void ResetStats() { m_stats = RenderDeviceStats{}; }
+
+        // Bytes the uploads and copies left in buffer's scratch memory (nullptr if it was never written),
+        // so headless checks can read back what the GPU would hold
+        const std::vector<uint8_t>* GetBufferContents(ID3D11Buffer* buffer) const;
+
+        void SetRenderTargets(ID3D11RenderTargetView* rtv, ID3D11DepthStencilView* dsv) override;
+        void ClearRenderTarget(ID3D11RenderTargetView* rtv, const float color[4]) override;
+        void ClearDepthStencil(ID3D11DepthStencilView* dsv) override;
+        void SetViewport(const D3D11_VIEWPORT& viewport) override;
+        void SetRasterizerState(ID3D11RasterizerState* state) override;
+        void SetDepthStencilState(ID3D11DepthStencilState* state) override;
+
+        void SetShaders(ID3D11VertexShader* vs, ID3D11PixelShader* ps) override;
+        void SetInputLayout(ID3D11InputLayout* layout) override;
+        void SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset) override;
+        void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format) override;
+        void SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology) override;
+        void SetVSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* buffers) override;
+        void SetPSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* buffers) override;
+        void SetVSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants) override;
+        void SetPSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants) override;
+        void SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* srv) override;
+        void SetPSSampler(UINT slot, ID3D11SamplerState* sampler) override;
+
+        void UpdateBuffer(ID3D11Buffer* buffer, const void* data, UINT size) override;
+        bool WriteBuffer(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size, D3D11_MAP mapType) override;
+        void UpdateBufferRange(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size) override;
+        void CopyBufferRegion(ID3D11Buffer* dst, UINT dstOffset, ID3D11Buffer* src, UINT srcOffset, UINT size) override;
+
+        void DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex) override;
+        void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) override;
+
+        // Simulated GPU latency: the completed fence trails the signaled one by this many frames (0 = immediate)
+        void SetFenceLatency(uint32_t frames) { m_fenceLatency = frames; }
+
+        uint64_t SignalFence() override { return ++m_fence; }
+        uint64_t GetCompletedFence() override { return m_fence > m_fenceLatency ? m_fence - m_fenceLatency : 0; }
+
+        bool SupportsConstantOffsets() const override { return true; }
+        bool SubmitsWork() const override { return false; }
+
+    private:
+        void Log(const char* fmt, ...);
+
+        RenderDeviceStats m_stats;
+        std::FILE* m_log = nullptr;
+        uint64_t m_fence = 0;
+        uint32_t m_fenceLatency = 0;
+
+        // Map() stand-in: per-buffer scratch memory so uploads still pay their memcpy
+        std::unordered_map<ID3D11Buffer*, std::vector<uint8_t>> m_scratch;
+    };
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+// RenderQueue collects draw requests as packed 64-bit sort keys, radix-sorts them and tracks bound state
+// so the submission loop only emits the binds that actually change. It has no D3D dependency (headless testable).
+// Flow of a frame: Clear() -> Submit()... -> Sort() -> ResetState() -> for each item: Change*() before each bind -> CountDraw()
+
+namespace Engine
+{
+    // Sort key layout (MSB -> LSB): shader(8) | input layout(8) | texture(12) | mesh(16) | depth(20)
+    namespace SortKey
+    {
+        constexpr uint32_t kShaderBits  = 8;
+        constexpr uint32_t kLayoutBits  = 8;
+        constexpr uint32_t kTextureBits = 12;
+        constexpr uint32_t kMeshBits    = 16;
+        constexpr uint32_t kDepthBits   = 20;
+
+        constexpr uint32_t kDepthShift   = 0;
+        constexpr uint32_t kMeshShift    = kDepthShift + kDepthBits;
+        constexpr uint32_t kTextureShift = kMeshShift + kMeshBits;
+        constexpr uint32_t kLayoutShift  = kTextureShift + kTextureBits;
+        constexpr uint32_t kShaderShift  = kLayoutShift + kLayoutBits;
+
+        // Dense texture/mesh keys that no longer fit their field all get the field's last value. Items carrying it never
+        // count as already bound and are never batched, so they fall back to full per-draw binds instead of aliasing.
+        constexpr uint32_t kTextureOverflow = (1u << kTextureBits) - 1u;
+        constexpr uint32_t kMeshOverflow    = (1u << kMeshBits) - 1u;
+
+        // depth01 is a normalized view distance in [0..1] (front-to-back ordering within a state bucket)
+        uint64_t Make(uint32_t shader, uint32_t layout, uint32_t texture, uint32_t mesh, float depth01);
+
+        inline uint32_t Field(uint64_t key, uint32_t shift, uint32_t bits) { return static_cast<uint32_t>((key >> shift) & ((1ull << bits) - 1ull)); }
+        inline uint32_t Shader(uint64_t key)  { return Field(key, kShaderShift, kShaderBits); }
+        inline uint32_t Layout(uint64_t key)  { return Field(key, kLayoutShift, kLayoutBits); }
+        inline uint32_t Texture(uint64_t key) { return Field(key, kTextureShift, kTextureBits); }
+        inline uint32_t Mesh(uint64_t key)    { return Field(key, kMeshShift, kMeshBits); }
+        inline uint32_t Depth(uint64_t key)   { return Field(key, kDepthShift, kDepthBits); }
+        inline bool Overflowed(uint64_t key)  { return Texture(key) == kTextureOverflow || Mesh(key) == kMeshOverflow; }
+    }
+
+    // A queued draw: sort key plus an index into caller-owned per-draw data
+    struct DrawItem
+    {
+        uint64_t key = 0;
+        uint32_t index = 0;
+    };
+
+    // Number of state changes actually emitted during a frame
+    struct RenderQueueStats
+    {
+        uint32_t draws = 0;
+        uint32_t shaderBinds = 0;
+        uint32_t layoutBinds = 0;
+        uint32_t textureBinds = 0;
+        uint32_t meshBinds = 0;
+        uint32_t geometryBinds = 0;     // vertex/index buffer pairs (meshes in one arena share them)
+        uint32_t materialBinds = 0;
+        uint64_t triangles = 0;         // submitted triangles (x instances), after LOD selection
+        uint32_t keyOverflows = 0;      // texture/mesh key lookups past the dense key space
+    };
+
+    class RenderQueue
+    {
+    public:
+        // Drops all queued items, texture/mesh keys and stats (call once per frame)
+        void Clear();
+
+        // Queue a draw with a precomputed key (see SortKey::Make)
+        void Submit(uint64_t key, uint32_t index);
+
+        // Maps a texture pointer to a dense per-frame key so it fits in the sort key texture field
+        // (SortKey::kTextureOverflow once the field is full)
+        uint32_t GetTextureKey(const void* texture);
+
+        // Same for a mesh at one LOD: each (mesh, LOD) pair is its own batch and bind (SortKey::kMeshOverflow when full)
+        uint32_t GetMeshKey(int meshID, uint32_t lod);
+
+        // Sorts queued items by key (LSD radix sort, 8 bits per pass, stable)
+        void Sort();
+
+        const std::vector<DrawItem>& GetItems() const { return m_items; }
+
+        // State tracking: each Change* returns true if the value differs from the currently bound one
+        // (and records it as bound), so the caller only issues the bind when needed.
+        // Overflow texture/mesh keys always return true: they stand for many different resources.
+        void ResetState();
+        bool ChangeShader(uint32_t shader);
+        bool ChangeLayout(uint32_t layout);
+        bool ChangeTexture(uint32_t texture);
+        bool ChangeMesh(uint32_t mesh);
+        bool ChangeGeometry(uint32_t geometry);
+        bool ChangeMaterial(float roughness, float metallic);
+        void CountDraw(uint64_t triangles) { ++m_stats.draws; m_stats.triangles += triangles; }
+
+        const RenderQueueStats& GetStats() const { return m_stats; }
+
+    private:
+        static constexpr uint32_t kUnbound = 0xFFFFFFFFu;
+
+        std::vector<DrawItem> m_items;
+        std::vector<DrawItem> m_scratch; // radix sort ping-pong buffer
+
+        std::unordered_map<const void*, uint32_t> m_textureKeys;
+        std::unordered_map<uint64_t, uint32_t> m_meshKeys;
+
+        // Currently bound state
+        uint32_t m_boundShader = kUnbound;
+        uint32_t m_boundLayout = kUnbound;
+        uint32_t m_boundTexture = kUnbound;
+        uint32_t m_boundMesh = kUnbound;
+        uint32_t m_boundGeometry = kUnbound;
+        bool m_materialBound = false;
+        float m_boundRoughness = 0.0f;
+        float m_boundMetallic = 0.0f;
+
+        RenderQueueStats m_stats;
+    };
+}
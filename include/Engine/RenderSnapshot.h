@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include "Engine/Components.h"
+
+// RenderSnapshot is a plain copy of everything draw submission needs from the scene (camera, renderables, lights),
+// taken once per frame after the simulation. Rendering reads only the snapshot, never the registry, so the next
+// frame's simulation can run while this one is submitted (pipelined mode).
+// Flow: ExtractSnapshot(scene, GetWrite()) -> Publish() -> DrawEntities(GetRead())
+
+namespace Engine
+{
+    struct RenderSnapshot
+    {
+        struct Camera
+        {
+            bool valid = false;
+            DirectX::XMFLOAT4X4 view{};
+            DirectX::XMFLOAT4X4 proj{};
+            TransformComponent transform;
+            CameraComponent camera;
+        };
+
+        // One active mesh renderer with its world bounds (refreshed during extraction)
+        struct Renderable
+        {
+            DirectX::XMFLOAT4X4 world{};   // propagated world matrix (row-major)
+            int meshID = 0;
+            int materialID = 0;
+            ID3D11ShaderResourceView* texture = nullptr;
+            float roughness = 0.5f;
+            float metallic = 0.0f;
+            DirectX::XMFLOAT3 boundsCenter{ 0.0f, 0.0f, 0.0f };
+            DirectX::XMFLOAT3 boundsExtents{ 0.0f, 0.0f, 0.0f };
+            float boundsRadius = 0.0f;
+            uint32_t lod = 0;               // MeshManager LOD (0: base mesh)
+        };
+
+        // Lights and camera carry world-space poses (parent chain already applied)
+        struct Light
+        {
+            TransformComponent transform;
+            LightComponent light;
+        };
+
+        uint64_t frame = 0;     // simulation frame the data was taken from
+        Camera camera;
+        std::vector<Renderable> renderables;
+        std::vector<Light> lights;
+
+        // Keeps vector capacity, so steady-state extraction does not allocate
+        void Clear()
+        {
+            frame = 0;
+            camera = Camera{};
+            renderables.clear();
+            lights.clear();
+        }
+    };
+
+    // Two snapshots: one being filled, one being rendered
+    class RenderSnapshotBuffer
+    {
+    public:
+        RenderSnapshot& GetWrite() { return m_snapshots[m_read ^ 1u]; }
+        const RenderSnapshot& GetRead() const { return m_snapshots[m_read]; }
+
+        // The written snapshot becomes the one rendered
+        void Publish() { m_read ^= 1u; }
+
+    private:
+        RenderSnapshot m_snapshots[2];
+        uint32_t m_read = 0;
+    };
+}
@@ -3,13 +3,18 @@
 #include <dxgi.h>
 #include <wrl/client.h> // For ComPtr
 #include <DirectXMath.h>
+#include <memory>
+#include "Engine/RingAllocator.h"
+#include "Engine/RenderDevice.h"
 
 // The Renderer class encapsulates DirectX 11 rendering functionality
 // Flow of operations: InitD3D11 -> BeginFrame -> [Update... / Bind... / Submit...] -> DrawIndexed -> Present -> Shutdown
+// All context commands go through an IRenderDevice (see RenderDevice.h), so the null backend can stand in for the GPU.
 
 namespace Engine
 {
 struct MeshBuffers;
+struct InstanceData;
 class ShaderManager;
 class MeshManager;
 struct CameraComponent;
@@ -42,15 +47,22 @@ struct LightData
     DirectX::XMFLOAT3 padding;   // Pad to 16-byte alignment
 };
 
-#define MAX_LIGHTS 4 // temporary maximum number of lights
-
 // Light constant buffer layout (must match HLSL CB_Light register(b3))
-// padding added to ensure 16-byte alignment
+// Lights themselves live in a structured buffer (PS t1): directional lights first (applied to every pixel),
+// then point/spot lights referenced through the per-cluster index list (t2) and cluster ranges (t3).
 struct LightConstants
 {
     DirectX::XMFLOAT3 cameraPos;
-    unsigned int lightCount;     // Actual number of active lights
-	LightData lights[MAX_LIGHTS];   // fixed-size array is used since HLSL CBs require known size
+    unsigned int directionalCount;  // lights [0, directionalCount) in t1 are directional
+    DirectX::XMFLOAT3 cameraForward;// view depth = dot(worldPos - cameraPos, cameraForward)
+    unsigned int lightCount;        // total lights in t1
+    unsigned int clusterDimX;
+    unsigned int clusterDimY;
+    unsigned int clusterDimZ;
+    float clusterSliceScale;        // slice = log(viewZ) * scale + bias
+    float clusterSliceBias;
+    DirectX::XMFLOAT2 invViewportSize; // SV_Position -> [0..1] for the tile index
+    float padding;
 };
 
 // Material constant buffer layout (must match HLSL CB_Material register(b4))
@@ -62,11 +74,18 @@ struct MaterialConstants
     float padding[2]; // Pad to 16-byte alignment
 };
 
+// Which IRenderDevice executes the renderer's commands
+enum class RenderBackend
+{
+    D3D11 = 0,  // hardware device, commands submitted to the immediate context
+    Null        // WARP device for resource creation, commands only counted (headless CPU benchmarking)
+};
+
 class Renderer
 {
 public:
     // High-level lifecycle methods
-    bool InitD3D11(HWND hwnd, unsigned width, unsigned height);
+    bool InitD3D11(HWND hwnd, unsigned width, unsigned height, RenderBackend backend = RenderBackend::D3D11);
     void Shutdown();
     void Present(bool vsync);
     bool Resize(unsigned width, unsigned height);
@@ -80,14 +99,32 @@ public:
     void UpdateWorldMatrix(const DirectX::XMMATRIX& world);
     // upload light constants to GPU
     void UpdateLightConstants(const LightConstants& data);
+    // Clustered lighting: uploads lights (PS t1), the cluster light index list (t2) and per-cluster (offset, count)
+    // pairs (t3), then the constants (b3). Buffers grow as needed.
+    bool UpdateClusteredLights(const LightConstants& constants, const LightData* lights, UINT lightCount,
+                               const uint32_t* indices, UINT indexCount, const uint32_t* clusterRanges, UINT clusterCount);
     // upload material constants to GPU
     void UpdateMaterialConstants(const MaterialConstants& material);
     // Binds shaders from ShaderManager
     void BindShader(const Engine::ShaderManager& shaderMan, int shaderID);
-    // Submits mesh buffers for drawing
+    // Submits mesh buffers for drawing (input layout + vertex/index buffers)
     void SubmitMesh(const Engine::MeshBuffers& mesh, ID3D11InputLayout* inputLayout);
-    // Issues the draw call
-    void DrawIndexed(UINT indexCount);
+    // Granular binds used by the render queue to skip redundant state changes
+    void BindInputLayout(ID3D11InputLayout* inputLayout);
+    // IA vertex/index buffers (shared by every mesh of one geometry arena pair)
+    void BindMeshBuffers(const Engine::MeshBuffers& mesh);
+    // Per-mesh VS constants (compact dequantization, b5)
+    void BindMeshConstants(const Engine::MeshBuffers& mesh);
+    // Pixel shader texture/sampler slots
+    void BindPSTexture(UINT slot, ID3D11ShaderResourceView* srv);
+    void BindPSSampler(UINT slot, ID3D11SamplerState* sampler);
+    // Issues the draw call (startIndex/baseVertex: the mesh's range in the geometry arenas)
+    void DrawIndexed(UINT indexCount, UINT startIndex = 0, INT baseVertex = 0);
+
+    // Instancing: uploads the frame's packed instance data (grows the dynamic buffer as needed) and binds it to IA slot 1
+    bool UploadInstanceData(const Engine::InstanceData* instances, UINT count);
+    // Draws instanceCount instances starting at startInstance within the uploaded instance buffer
+    void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startInstance, UINT startIndex = 0, INT baseVertex = 0);
 
     // Framebuffer (Editor Render-to-Texture)
     // creates an off-screen framebuffer with RTV, DSV, and SRV for editor preview rendering
@@ -105,7 +142,10 @@ public:
 
     // Resource Accessors (for Systems to use if needed)
     ID3D11Device* GetDevice() const { return m_dx.device.Get(); }
+    // Raw immediate context: only for third-party backends (ImGui); engine code uses GetRenderDevice()
     ID3D11DeviceContext* GetContext() const { return m_dx.context.Get(); }
+    IRenderDevice& GetRenderDevice() const { return *m_device; }
+    RenderBackend GetBackend() const { return m_backend; }
 
     // Frame Setup Accessors
     ID3D11RenderTargetView* GetRTV() const { return m_dx.rtv.Get(); }
@@ -114,6 +154,10 @@ public:
     ID3D11DepthStencilState* GetDepthStencilState() const { return m_depthStencilState.Get(); }
     ID3D11SamplerState* GetSamplerState() const { return m_samplerState.Get(); }
     ID3D11Buffer* GetLightCB() const { return m_cbLight.Get(); } // light cbuffer
+    bool IsConstantRingEnabled() const { return m_useConstantRing; }
+    // Size of the viewport bound by the last BeginFrame/BindFramebuffer/BindBackBuffer
+    UINT GetViewportWidth() const { return m_viewportWidth; }
+    UINT GetViewportHeight() const { return m_viewportHeight; }
     UINT GetWidth() const { return m_dx.width; }
     UINT GetHeight() const { return m_dx.height; }
 
@@ -130,6 +174,37 @@ private:
     Microsoft::WRL::ComPtr<ID3D11Buffer> m_cbLight;    // light cbuffer (PS b3)
     Microsoft::WRL::ComPtr<ID3D11Buffer> m_cbMaterial; // material cbuffer (PS b4)
 
+    // Per-frame instance data (dynamic vertex buffer, IA slot 1)
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_instanceBuffer;
+    UINT m_instanceCapacity = 0; // in instances
+
+    // Dynamic structured buffer + SRV that grows on demand (clustered lighting inputs)
+    struct StructuredBuffer
+    {
+        Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+        UINT capacity = 0; // in elements
+    };
+    StructuredBuffer m_lightBuffer;          // PS t1
+    StructuredBuffer m_lightIndexBuffer;     // PS t2
+    StructuredBuffer m_clusterRangeBuffer;   // PS t3
+
+    // Currently bound viewport
+    UINT m_viewportWidth = 0;
+    UINT m_viewportHeight = 0;
+
+    // Command layer (D3D11 or null)
+    std::unique_ptr<IRenderDevice> m_device;
+    RenderBackend m_backend = RenderBackend::D3D11;
+
+    // Per-draw constants ring (world, material, light): one DYNAMIC buffer, 256-byte aligned sub-allocations
+    // bound with *SetConstantBuffers1 offsets. Only used when the device supports offsets + NO_OVERWRITE on CBs,
+    // otherwise the UpdateSubresource buffers above are used. Frames are fenced through the device.
+    static constexpr UINT kConstantRingSize = 4u * 1024u * 1024u;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_constantRing;
+    Engine::RingAllocator m_constantRingAlloc;
+    bool m_useConstantRing = false;
+
     // Off-screen framebuffer state (Editor Render-to-Texture)
     Microsoft::WRL::ComPtr<ID3D11Texture2D> m_framebufferTex;
     Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_framebufferRTV;
@@ -157,6 +232,16 @@ private:
 
     // matrix update helper
     void UpdateMatrixCB(ID3D11Buffer* cb, const DirectX::XMMATRIX& m);
+
+    // Uploads count elements into sb (recreating it larger if needed) and binds its SRV to PS slot
+    bool UploadStructuredBuffer(StructuredBuffer& sb, const void* data, UINT elementSize, UINT count, UINT slot);
+
+    // Constant ring helpers
+    bool CreateConstantRing();
+    // Copies data into the ring; outputs the range in 16-byte constants for *SetConstantBuffers1
+    bool WriteRingConstants(const void* data, UINT size, UINT& outFirstConstant, UINT& outNumConstants);
+    // Closes the frame's ring allocations under a GPU fence and frees frames the GPU has finished
+    void AdvanceConstantRing();
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+
+// RingAllocator hands out aligned sub-ranges of one large GPU buffer in linear order and recycles them once the
+// frame that used them is known to be finished (fence). It only tracks offsets, so it has no D3D dependency.
+// Flow of a frame: Allocate()... -> EndFrame(fence) -> later Retire(completedFence)
+
+namespace Engine
+{
+    class RingAllocator
+    {
+    public:
+        struct Allocation
+        {
+            uint32_t offset = 0;    // byte offset into the buffer
+            uint32_t size = 0;      // aligned size in bytes
+            bool discard = false;   // true: previous contents may still be in use, caller must map with DISCARD
+        };
+
+        // alignment must be a power of two (256 = D3D11.1 constant buffer offset granularity).
+        // allowDiscard: when the ring is full, restart at 0 and report discard instead of failing
+        // (D3D11 renames the buffer on DISCARD, so in-flight frames keep their data).
+        void Initialize(uint32_t capacity, uint32_t alignment = 256, bool allowDiscard = true);
+
+        // Returns false only if size exceeds capacity, or the ring is full and discard is not allowed
+        bool Allocate(uint32_t size, Allocation& out);
+
+        // Closes the current frame's allocations under a fence value (monotonically increasing)
+        void EndFrame(uint64_t fence);
+
+        // Frees every frame whose fence is <= completedFence
+        void Retire(uint64_t completedFence);
+
+        uint32_t GetCapacity() const { return m_capacity; }
+        uint32_t GetUsed() const { return m_used; }
+        uint32_t GetDiscardCount() const { return m_discards; }
+
+        static uint32_t AlignUp(uint32_t value, uint32_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+    private:
+        // End offset and byte count (including wrap padding) of a closed frame
+        struct FrameMark
+        {
+            uint64_t fence = 0;
+            uint32_t end = 0;
+            uint32_t bytes = 0;
+        };
+
+        std::deque<FrameMark> m_frames;
+
+        uint32_t m_capacity = 0;
+        uint32_t m_alignment = 256;
+        bool m_allowDiscard = true;
+
+        uint32_t m_head = 0;        // next free byte
+        uint32_t m_tail = 0;        // oldest byte still in use
+        uint32_t m_used = 0;        // bytes between tail and head (disambiguates empty vs full when head == tail)
+        uint32_t m_frameBytes = 0;  // bytes allocated since the last EndFrame
+        bool m_needsDiscard = true; // first map of a fresh buffer must be DISCARD
+        uint32_t m_discards = 0;
+    };
+}
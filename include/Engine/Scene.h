@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <entt/entt.hpp>
 #include "Engine/Components.h"
 
@@ -15,8 +17,8 @@ namespace Engine
         // Exposed by design to allow direct registry access as requested
         entt::registry registry;
 
-        // Backup snapshot registry (used for Play->Edit restore)
-        entt::registry m_backupRegistry;
+        // Binary snapshot of the registry taken on Edit->Play (see SceneSnapshot), restored on Stop
+        std::vector<uint8_t> m_backup;
 
         // Active camera entity used for rendering
         entt::entity m_activeRenderCamera = entt::null;
@@ -64,14 +66,48 @@ namespace Engine
         int GetCapsuleMeshID() const { return m_capsuleMeshID; }
 		int GetDefaultShaderID() const { return m_defaultShaderID; }
 
-        // Safely destroy an entity and unregister any physics bodies (Jolt) first
+        // Activation toggles (DisabledTag / ComponentDisabledTag<T>; no tag means active)
+        bool IsEntityActive(entt::entity entity) const { return !registry.all_of<DisabledTag>(entity); }
+        void SetEntityActive(entt::entity entity, bool active) { SetTag<DisabledTag>(entity, !active); }
+
+        template<typename T>
+        bool IsComponentActive(entt::entity entity) const { return !registry.all_of<ComponentDisabledTag<T>>(entity); }
+        template<typename T>
+        void SetComponentActive(entt::entity entity, bool active) { SetTag<ComponentDisabledTag<T>>(entity, !active); }
+
+        // Parent/child links. parent == entt::null detaches. keepWorldTransform rewrites the local transform so the
+        // entity stays where it is (from its last propagated world matrix). Fails if parent is entity or a descendant of it,
+        // or if entity has a RigidBodyComponent (physics owns its world pose, so it can only be detached).
+        bool SetParent(entt::entity entity, entt::entity parent, bool keepWorldTransform = true);
+        entt::entity GetParent(entt::entity entity) const;
+
+        // Safely destroy an entity (and its children) and unregister any physics bodies (Jolt) first
         void DestroyEntity(entt::entity entity, Engine::PhysicsManager& physicsManager);
 
+        // Binary snapshot of all entities and scene components (SceneSnapshot blob; also the body of cooked scene files)
+        void SaveSnapshot(std::vector<uint8_t>& out);
+        // Replaces the scene with a snapshot (data 16-byte aligned); physics bodies are rebuilt on the next frame.
+        // An invalid snapshot returns false and keeps the current scene. checkHierarchy (untrusted data such as files)
+        // also rejects broken or cyclic HierarchyComponent links.
+        bool LoadSnapshot(const uint8_t* data, size_t size, Engine::PhysicsManager& physicsManager, bool checkHierarchy = false);
+
+        // Removes every entity, unregistering physics bodies first
+        void Clear(Engine::PhysicsManager& physicsManager);
+
         // Backup/restore to support Edit <-> Play state machine
         void CopyToBackup();
-        void RestoreFromBackup(Engine::PhysicsManager& physicsManager);
+        bool RestoreFromBackup(Engine::PhysicsManager& physicsManager);
+        size_t GetBackupSize() const { return m_backup.size(); }
 
     private:
+        template<typename Tag>
+        void SetTag(entt::entity entity, bool present)
+        {
+            if (present == registry.all_of<Tag>(entity)) return;
+            if (present) registry.emplace<Tag>(entity);
+            else registry.remove<Tag>(entity);
+        }
+
 		// Cache default asset IDs for editor-spawned primitives
         int m_defaultShaderID = 0;
         int m_cubeMeshID = 0;
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include "Engine/Scene.h"
+
+// Scene files in two formats:
+// - JSON (.json): human-readable, diff-friendly, streamed out with RapidJSON. Entities are written in id order and
+//   keyed by a file-local "entity" number that "parent" links refer to; loading creates fresh entities.
+// - Cooked (.cooked): the entity name strings followed by the SceneSnapshot blob (per-component columns, raw component
+//   data). Loaded by mapping the file and bulk-inserting each column, so load time is bound by disk/page-cache bandwidth.
+//   Entity ids are preserved; name handles are remapped to this process's NameTable.
+// Mesh/material ids are the runtime ids of the loaded content; texture pointers are not persisted.
+// Loading replaces the whole scene (physics bodies are rebuilt on the next frame) and selects the active camera.
+
+namespace Engine
+{
+    class PhysicsManager;
+
+    namespace SceneSerializer
+    {
+        bool SaveJson(Engine::Scene& scene, const std::string& path);
+        bool LoadJson(Engine::Scene& scene, const std::string& path, Engine::PhysicsManager& physicsManager);
+
+        bool SaveCooked(Engine::Scene& scene, const std::string& path);
+        bool LoadCooked(Engine::Scene& scene, const std::string& path, Engine::PhysicsManager& physicsManager);
+
+        // Picks the format from the extension (.json, anything else cooked)
+        bool Load(Engine::Scene& scene, const std::string& path, Engine::PhysicsManager& physicsManager);
+    }
+}
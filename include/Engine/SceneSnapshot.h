@@ -0,0 +1,300 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <entt/entt.hpp>
+
+// SceneSnapshot saves the registry's entities and registered components into one contiguous binary blob and restores
+// them with the same entity ids. Trivially copyable components are memcpy'd a storage page at a time and bulk-inserted
+// on restore; empty tags store only their entity ids; other components go through registered save/load functions.
+// Components registered as transient (derived caches) are skipped; any other unregistered pool found on Save is
+// reported, never silently lost.
+// Flow: Register<T>(...) once per component type -> Save(registry, blob) -> [Validate(blob)] -> Restore(blob, registry)
+//
+// Blob layout: header | entity ids | per type: { name hash, count, entity ids, payload size, payload (16-byte aligned) }.
+// The same blob is the body of cooked scene files (see SceneSerializer).
+
+namespace Engine
+{
+    // Appends to a byte vector
+    class BinaryWriter
+    {
+    public:
+        explicit BinaryWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+        void Write(const void* data, size_t size)
+        {
+            const size_t at = m_out.size();
+            m_out.resize(at + size);
+            if (size) std::memcpy(m_out.data() + at, data, size);
+        }
+
+        template<typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Write(T) needs a trivially copyable type");
+            Write(&value, sizeof(T));
+        }
+
+        void WriteString(const std::string& s)
+        {
+            Write(static_cast<uint32_t>(s.size()));
+            Write(s.data(), s.size());
+        }
+
+        // Pads so the next write starts at a multiple of alignment (relative to the blob start)
+        void Align(size_t alignment)
+        {
+            const size_t padded = (m_out.size() + alignment - 1) / alignment * alignment;
+            m_out.resize(padded, 0);
+        }
+
+        // Appends size uninitialized bytes, returns their offset (fill through At())
+        size_t Grow(size_t size)
+        {
+            const size_t at = m_out.size();
+            m_out.resize(at + size);
+            return at;
+        }
+
+        size_t Tell() const { return m_out.size(); }
+        uint8_t* At(size_t offset) { return m_out.data() + offset; }
+
+    private:
+        std::vector<uint8_t>& m_out;
+    };
+
+    // Bounds-checked reads from a byte range; every read fails once the data runs out
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+        bool Read(void* out, size_t size)
+        {
+            if (size > m_size - m_pos) return false;
+            if (size) std::memcpy(out, m_data + m_pos, size);
+            m_pos += size;
+            return true;
+        }
+
+        template<typename T>
+        bool Read(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Read(T) needs a trivially copyable type");
+            return Read(&value, sizeof(T));
+        }
+
+        bool ReadString(std::string& s)
+        {
+            uint32_t length = 0;
+            if (!Read(length) || length > m_size - m_pos) return false;
+            s.assign(reinterpret_cast<const char*>(m_data + m_pos), length);
+            m_pos += length;
+            return true;
+        }
+
+        bool Align(size_t alignment)
+        {
+            const size_t padded = (m_pos + alignment - 1) / alignment * alignment;
+            if (padded > m_size) return false;
+            m_pos = padded;
+            return true;
+        }
+
+        // Borrow size bytes in place (no copy)
+        const uint8_t* Skip(size_t size)
+        {
+            if (size > m_size - m_pos) return nullptr;
+            const uint8_t* p = m_data + m_pos;
+            m_pos += size;
+            return p;
+        }
+
+        size_t Tell() const { return m_pos; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        size_t m_pos = 0;
+    };
+
+    class SceneSnapshot
+    {
+    public:
+        template<typename T>
+        using SaveFn = void(*)(BinaryWriter&, const T&);
+        template<typename T>
+        using LoadFn = bool(*)(BinaryReader&, T&);
+
+        // Trivially copyable component: raw copy of the storage pages
+        template<typename T>
+        void Register(const char* name)
+        {
+            static_assert(std::is_trivially_copyable_v<T> && !std::is_empty_v<T>, "Register<T>(name) needs trivially copyable data; pass save/load functions otherwise");
+            static_assert(alignof(T) <= kPayloadAlignment, "payload alignment too small for T");
+
+            ComponentType type;
+            type.name = name;
+            type.id = entt::hashed_string::value(name);
+            type.poolId = entt::type_hash<T>::value();
+            type.save = [](entt::registry& registry, BinaryWriter& out) {
+                auto& storage = registry.storage<T>();
+                const uint32_t count = static_cast<uint32_t>(storage.size());
+                WriteEntities(out, storage.data(), count);
+
+                const size_t bytes = static_cast<size_t>(count) * sizeof(T);
+                out.Write(static_cast<uint64_t>(bytes));
+                out.Align(kPayloadAlignment);
+
+                // Packed index i lives at page i / page_size, slot i % page_size
+                constexpr size_t pageSize = entt::component_traits<T>::page_size;
+                uint8_t* dst = out.At(out.Grow(bytes));
+                for (size_t first = 0; first < count; first += pageSize)
+                {
+                    const size_t n = (count - first < pageSize) ? count - first : pageSize;
+                    std::memcpy(dst + first * sizeof(T), storage.raw()[first / pageSize], n * sizeof(T));
+                }
+            };
+            type.check = [](BinaryReader& in, uint32_t count, uint64_t payloadSize) {
+                return payloadSize == static_cast<uint64_t>(count) * sizeof(T) && in.Align(kPayloadAlignment) &&
+                       in.Skip(static_cast<size_t>(payloadSize)) != nullptr;
+            };
+            type.load = [](entt::registry& registry, BinaryReader& in, const entt::entity* entities, uint32_t count, uint64_t payloadSize) {
+                if (payloadSize != static_cast<uint64_t>(count) * sizeof(T) || !in.Align(kPayloadAlignment)) return false;
+                const uint8_t* payload = in.Skip(static_cast<size_t>(payloadSize));
+                if (!payload) return false;
+
+                // The payload is aligned within the blob (whose storage is new[]-aligned), so it is read as T in place
+                const T* values = reinterpret_cast<const T*>(payload);
+                registry.insert<T>(entities, entities + count, values);
+                return true;
+            };
+            m_types.push_back(std::move(type));
+        }
+
+        // Component with owned data (strings, containers): per-component save/load
+        template<typename T>
+        void Register(const char* name, SaveFn<T> saveFn, LoadFn<T> loadFn)
+        {
+            ComponentType type;
+            type.name = name;
+            type.id = entt::hashed_string::value(name);
+            type.poolId = entt::type_hash<T>::value();
+            type.save = [saveFn](entt::registry& registry, BinaryWriter& out) {
+                auto& storage = registry.storage<T>();
+                const uint32_t count = static_cast<uint32_t>(storage.size());
+                WriteEntities(out, storage.data(), count);
+
+                // Payload size is patched once the entries are written
+                const size_t sizeAt = out.Tell();
+                out.Write(uint64_t{ 0 });
+                out.Align(kPayloadAlignment);
+                const size_t start = out.Tell();
+
+                for (uint32_t i = 0; i < count; ++i)
+                    saveFn(out, storage.get(storage.data()[i]));
+
+                const uint64_t payloadSize = out.Tell() - start;
+                std::memcpy(out.At(sizeAt), &payloadSize, sizeof(payloadSize));
+            };
+            type.check = [loadFn](BinaryReader& in, uint32_t count, uint64_t payloadSize) {
+                if (!in.Align(kPayloadAlignment)) return false;
+                const size_t start = in.Tell();
+
+                // Decode each entry into a throwaway value: Restore must not fail half way through
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    T value{};
+                    if (!loadFn(in, value)) return false;
+                }
+                return in.Tell() - start == payloadSize;
+            };
+            type.load = [loadFn](entt::registry& registry, BinaryReader& in, const entt::entity* entities, uint32_t count, uint64_t payloadSize) {
+                if (!in.Align(kPayloadAlignment)) return false;
+                const size_t start = in.Tell();
+
+                std::vector<T> values(count);
+                for (uint32_t i = 0; i < count; ++i)
+                    if (!loadFn(in, values[i])) return false;
+                if (in.Tell() - start != payloadSize) return false;
+
+                registry.insert<T>(entities, entities + count, std::make_move_iterator(values.begin()));
+                return true;
+            };
+            m_types.push_back(std::move(type));
+        }
+
+        // Empty tag component: only the owning entity ids are stored
+        template<typename T>
+        void RegisterTag(const char* name)
+        {
+            static_assert(std::is_empty_v<T>, "RegisterTag<T> is for empty tag types");
+
+            ComponentType type;
+            type.name = name;
+            type.id = entt::hashed_string::value(name);
+            type.poolId = entt::type_hash<T>::value();
+            type.save = [](entt::registry& registry, BinaryWriter& out) {
+                auto& storage = registry.storage<T>();
+                WriteEntities(out, storage.data(), static_cast<uint32_t>(storage.size()));
+                out.Write(uint64_t{ 0 });
+                out.Align(kPayloadAlignment);
+            };
+            type.check = [](BinaryReader& in, uint32_t, uint64_t payloadSize) {
+                return payloadSize == 0 && in.Align(kPayloadAlignment);
+            };
+            type.load = [](entt::registry& registry, BinaryReader& in, const entt::entity* entities, uint32_t count, uint64_t payloadSize) {
+                if (payloadSize != 0 || !in.Align(kPayloadAlignment)) return false;
+                registry.insert<T>(entities, entities + count);
+                return true;
+            };
+            m_types.push_back(std::move(type));
+        }
+
+        // Derived data rebuilt after a restore (caches): neither saved nor reported
+        template<typename T>
+        void RegisterTransient()
+        {
+            m_transient.push_back(entt::type_hash<T>::value());
+        }
+
+        // Serializes every entity and registered component (registry is non-const: storages are looked up or created)
+        void Save(entt::registry& registry, std::vector<uint8_t>& out) const;
+
+        // Walks the whole blob without touching any registry: header, unique entity ids, every component entry owned by
+        // saved entities (each at most once) and decodable. Restore runs it first; callers that must clear their
+        // registry before restoring call it up front so a bad blob leaves the old contents in place.
+        bool Validate(const uint8_t* data, size_t size) const;
+
+        // Recreates the saved entities (same ids) and components in a registry without entities.
+        // data must be 16-byte aligned (vector storage, file mapping). Fails without changes if Validate fails.
+        bool Restore(const uint8_t* data, size_t size, entt::registry& registry) const;
+        bool Restore(const std::vector<uint8_t>& blob, entt::registry& registry) const { return Restore(blob.data(), blob.size(), registry); }
+
+    private:
+        static constexpr uint32_t kMagic = 0x534E5353;    // 'SSNS'
+        static constexpr uint32_t kVersion = 3;    // 2: Name is a NameTable handle, 3: activation tags
+        static constexpr size_t kPayloadAlignment = 16;
+
+        struct ComponentType
+        {
+            std::string name;
+            entt::id_type id = 0;       // hash of the registered name (stored in the blob, stable across builds)
+            entt::id_type poolId = 0;   // registry pool of the type
+            std::function<void(entt::registry&, BinaryWriter&)> save;
+            std::function<bool(BinaryReader&, uint32_t, uint64_t)> check;     // payload only, no registry access
+            std::function<bool(entt::registry&, BinaryReader&, const entt::entity*, uint32_t, uint64_t)> load;
+        };
+
+        static void WriteEntities(BinaryWriter& out, const entt::entity* entities, uint32_t count);
+
+        std::vector<ComponentType> m_types;
+        std::vector<entt::id_type> m_transient;
+        mutable std::vector<entt::id_type> m_reported;     // unregistered pools Save already warned about
+    };
+}
@@ -9,6 +9,8 @@
 
 namespace Engine
 {
+    class IRenderDevice;
+
     class ShaderManager
     {
     public:
@@ -18,8 +20,15 @@ namespace Engine
         // Compiles SkyboxVS/PS and creates a matching Input Layout. Returns shaderID 2.
         int LoadSkyboxShaders(ID3D11Device* device);
 
+        // Compiles BasicVS/PS with INSTANCED defined; the input layout adds per-instance data in slot 1. Returns shaderID 3.
+        int LoadBasicInstancedShaders(ID3D11Device* device);
+
+        // COMPACT_VERTEX variants for meshes stored as Engine::CompactVertex (16-byte stride). Return shaderID 4 and 5.
+        int LoadBasicCompactShaders(ID3D11Device* device);
+        int LoadBasicInstancedCompactShaders(ID3D11Device* device);
+
         // Binds shaders & input layout for a shader id
-        void Bind(int shaderID, ID3D11DeviceContext* context) const;
+        void Bind(int shaderID, IRenderDevice& device) const;
 
         // Access input layout for IA
         ID3D11InputLayout* GetInputLayout(int shaderID) const;
@@ -33,8 +42,12 @@ namespace Engine
             Microsoft::WRL::ComPtr<ID3D11InputLayout>  inputLayout;
         };
 
-		// Compiles a shader from file
-        static Microsoft::WRL::ComPtr<ID3DBlob> Compile(const std::wstring& path, const std::string& entry, const std::string& target);
+		// Compiles a shader from file (defines: optional null-terminated macro list for shader variants)
+        static Microsoft::WRL::ComPtr<ID3DBlob> Compile(const std::wstring& path, const std::string& entry, const std::string& target, const D3D_SHADER_MACRO* defines = nullptr);
+
+		// Compiles BasicVS/PS with the given defines, creates the input layout and stores it all under shaderID
+        int LoadBasicVariant(ID3D11Device* device, int shaderID, const D3D_SHADER_MACRO* defines,
+                             const D3D11_INPUT_ELEMENT_DESC* layout, UINT layoutCount, const char* name);
 
 		// Map of shaderID to ShaderData
         std::unordered_map<int, ShaderData> m_shaders;
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <entt/entt.hpp>
+#include "Engine/JobSystem.h"
+
+// SystemScheduler runs the registered per-frame systems. Each system declares the components (and engine resources
+// such as the Renderer) it reads and writes; two systems conflict when one writes what the other touches. Every
+// frame the scheduler links each system to the earlier-registered systems it conflicts with, then runs the
+// resulting DAG on the JobSystem, so independent systems overlap. Registration order is the serial order, which
+// is also what the deterministic serial mode (SetSerial(true)) runs.
+// Flow: Register(...) once -> Run(jobs, registry, dt) every frame -> GetTimings()
+
+namespace Engine
+{
+    // Declared access of one system
+    class SystemAccess
+    {
+    public:
+        // Components read/written through the registry (their pools are created up front, so concurrent
+        // systems never race on pool creation)
+        template<typename... T>
+        SystemAccess& Read() { (AddComponent<T>(m_reads), ...); return *this; }
+        template<typename... T>
+        SystemAccess& Write() { (AddComponent<T>(m_writes), ...); return *this; }
+
+        // Engine objects used by the system (Renderer, PhysicsManager, InputManager, ...)
+        template<typename... T>
+        SystemAccess& ReadResource() { (m_reads.push_back(entt::type_hash<T>::value()), ...); return *this; }
+        template<typename... T>
+        SystemAccess& WriteResource() { (m_writes.push_back(entt::type_hash<T>::value()), ...); return *this; }
+
+        // Must run on the thread calling Run() (D3D immediate context, SDL, ImGui)
+        SystemAccess& MainThread() { m_mainThread = true; return *this; }
+        // Adds/removes entities or components: runs alone, ordered against every other system
+        SystemAccess& Exclusive() { m_exclusive = true; return *this; }
+
+        bool ConflictsWith(const SystemAccess& other) const;
+
+    private:
+        friend class SystemScheduler;
+
+        template<typename T>
+        void AddComponent(std::vector<entt::id_type>& ids)
+        {
+            ids.push_back(entt::type_hash<T>::value());
+            m_assurePools.push_back([](entt::registry& registry) { (void)registry.storage<T>(); });
+        }
+
+        std::vector<entt::id_type> m_reads;
+        std::vector<entt::id_type> m_writes;
+        std::vector<void(*)(entt::registry&)> m_assurePools;
+        bool m_mainThread = false;
+        bool m_exclusive = false;
+    };
+
+    // Last frame's cost of one system
+    struct SystemTiming
+    {
+        std::string name;
+        double ms = 0.0;
+        bool mainThread = false;
+    };
+
+    class SystemScheduler
+    {
+    public:
+        using SystemFn = std::function<void(float dt)>;
+
+        // Returns the system index (also its position in GetTimings())
+        uint32_t Register(const char* name, const SystemAccess& access, SystemFn fn);
+
+        // Run every system once for this frame; returns when all finished
+        void Run(JobSystem& jobs, entt::registry& registry, float dt);
+
+        // Deterministic fallback for debugging: registration order on the calling thread
+        void SetSerial(bool serial) { m_serial = serial; }
+        bool IsSerial() const { return m_serial; }
+
+        const std::vector<SystemTiming>& GetTimings() const { return m_timings; }
+        double GetLastFrameMs() const { return m_lastFrameMs; }
+
+    private:
+        struct System
+        {
+            std::string name;
+            SystemAccess access;
+            SystemFn fn;
+            std::vector<uint32_t> dependents;   // systems that must wait for this one
+            uint32_t dependencyCount = 0;
+        };
+
+        void BuildGraph();
+        void RunSystem(uint32_t index, float dt);
+        // Called after a system finished: releases its dependents
+        void Finish(uint32_t index, JobSystem& jobs, JobCounter& counter, float dt);
+        void Schedule(uint32_t index, JobSystem& jobs, JobCounter& counter, float dt);
+
+        std::vector<System> m_systems;
+        std::vector<SystemTiming> m_timings;
+        bool m_graphDirty = true;
+        bool m_serial = false;
+        double m_lastFrameMs = 0.0;
+
+        // Per-frame execution state
+        std::unique_ptr<std::atomic<uint32_t>[]> m_remaining;
+        std::mutex m_mainReadyMutex;
+        std::vector<uint32_t> m_mainReady;      // main-thread systems whose dependencies are done
+    };
+}
@@ -8,6 +8,14 @@
 #include "Engine/Renderer.h"
 #include "Engine/PhysicsManager.h"
 #include "Engine/TextureManager.h"
+#include "Engine/RenderQueue.h"
+#include "Engine/JobSystem.h"
+#include "Engine/SystemScheduler.h"
+#include "Engine/RenderSnapshot.h"
+#include "Engine/InstanceBatcher.h"
+#include "Engine/Culling.h"
+#include "Engine/LightClustering.h"
+#include <vector>
 
 // Systems for the engine, including various update and rendering systems
 
@@ -15,18 +23,47 @@ namespace Engine
 {
     namespace RenderSystem
     {
+        // Per-draw data gathered before sorting (indexed by DrawItem::index)
+        struct DrawPacket
+        {
+            uint32_t renderable = 0;    // index into RenderSnapshot::renderables
+            MeshBuffers mesh{};
+            ID3D11InputLayout* layout = nullptr;
+            ID3D11ShaderResourceView* texture = nullptr;
+        };
+
+        // DrawEntities' working buffers, owned by the caller and reused every frame so a warm frame does not allocate
+        struct FrameScratch
+        {
+            std::vector<LightData> directional;         // directional lights, then the local ones (light buffer order)
+            std::vector<LightData> localLights;
+            std::vector<ClusterLightBounds> localBounds;
+            LightClusterer clusterer;
+            BoundsSoA bounds;                           // cull input, one entry per snapshot renderable
+            std::vector<uint32_t> visible;
+            std::vector<DrawPacket> packets;
+            InstanceBatcher batcher;
+        };
+
+        // Copy camera, active renderables (with refreshed world bounds) and lights out of the scene.
+        // Runs while the simulation is idle; everything after it only reads the snapshot.
+        void ExtractSnapshot(Engine::Scene& scene, const MeshManager& meshManager, Engine::RenderSnapshot& out, uint64_t frame);
+
         // pass Renderer to access context and sampler
-        void DrawEntities(Engine::Scene& scene, MeshManager& meshManager, ShaderManager& shaderManager, Engine::Renderer& renderer, Engine::TextureManager& textureManager);
+        // Renderables are gathered into the RenderQueue, sorted by state, and submitted with redundant binds skipped
+        // jobSystem runs the CPU-heavy per-frame passes (light clustering) across the worker threads
+        // Uploads the snapshot camera's view/projection, so submission never depends on the registry
+        void DrawEntities(const Engine::RenderSnapshot& snapshot, MeshManager& meshManager, ShaderManager& shaderManager, Engine::Renderer& renderer, Engine::TextureManager& textureManager, Engine::RenderQueue& renderQueue, FrameScratch& scratch, Engine::JobSystem& jobSystem);
     }
 
     // demo rotation logic
     void DemoRotationSystem(Engine::Scene& scene, entt::entity sampleEntity, float dt);
 
-    // input-driven camera movement and look
+    // input-driven camera look (yaw/pitch) and movement, gathered into EditorCamMotionComponent
     void EditorCameraInputSystem(Engine::Scene& scene, const Engine::InputManager& input, float dt, bool isSceneFocused);
 
-    // build view/projection matrices for active camera and upload via renderer
-    void CameraMatrixSystem(Engine::Scene& scene, Engine::Renderer& renderer);
+    // applies the gathered editor camera movement and yaw/pitch to the camera Transform
+    void EditorCameraTransformSystem(Engine::Scene& scene);
 
     // physics update system: initialize bodies, step simulation, sync back transforms
     void PhysicsSystem(Engine::Scene& scene, Engine::PhysicsManager& physicsManager, const Engine::MeshManager& meshManager, float dt, bool isPlaying);
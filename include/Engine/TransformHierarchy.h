@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include "Engine/Components.h"
+
+// TransformHierarchy propagates local transforms down the parent/child links (HierarchyComponent) into
+// WorldTransformComponent. Nodes are kept in flat arrays in propagation order: every tree (a root and its
+// descendants, breadth-first so parents come before children) is one contiguous range, and consecutive trees are
+// grouped into batches of similar node count that run in parallel. Each frame only subtrees whose local transform
+// changed are recomputed; the order is rebuilt only after structural changes (reported through registry signals).
+// Flow: Connect(registry) once -> Update(registry, jobs) every frame before world transforms are read
+
+namespace Engine
+{
+    class JobSystem;
+
+    struct TransformHierarchyStats
+    {
+        uint32_t nodes = 0;
+        uint32_t trees = 0;
+        uint32_t batches = 0;
+        uint32_t maxDepth = 0;
+        uint32_t recomputed = 0;    // world matrices rewritten by the last Update
+        bool rebuilt = false;       // last Update rebuilt the propagation order
+        double ms = 0.0;
+    };
+
+    class TransformHierarchy
+    {
+    public:
+        // Structural changes (transforms/links added or removed, SetParent, owning-group membership) mark the order for
+        // rebuild. Also creates the owning groups (Components.h) up front.
+        void Connect(entt::registry& registry);
+        void Disconnect(entt::registry& registry);
+
+        // Recompute world matrices of changed subtrees. Must not run while other threads add or remove components.
+        void Update(entt::registry& registry, JobSystem& jobs);
+
+        const TransformHierarchyStats& GetStats() const { return m_stats; }
+
+    private:
+        static constexpr uint32_t kNoParent = UINT32_MAX;
+        // Trees are packed into batches of at least this many nodes (one job each)
+        static constexpr uint32_t kBatchNodes = 2048;
+
+        void OnStructureChanged(entt::registry&, entt::entity) { m_structureDirty = true; }
+
+        // Adding/removing T changes owning-group membership
+        template<typename T>
+        void ConnectMembership(entt::registry& registry, bool connect)
+        {
+            if (connect)
+            {
+                registry.on_construct<T>().template connect<&TransformHierarchy::OnStructureChanged>(*this);
+                registry.on_destroy<T>().template connect<&TransformHierarchy::OnStructureChanged>(*this);
+            }
+            else
+            {
+                registry.on_construct<T>().template disconnect<&TransformHierarchy::OnStructureChanged>(*this);
+                registry.on_destroy<T>().template disconnect<&TransformHierarchy::OnStructureChanged>(*this);
+            }
+        }
+
+        void Rebuild(entt::registry& registry);
+        uint32_t PropagateRange(uint32_t begin, uint32_t end, bool force);
+
+        // Propagation order (SoA, index = node)
+        std::vector<uint32_t> m_parent;                         // node index of the parent, kNoParent for roots
+        std::vector<const TransformComponent*> m_local;         // registry storage (stable until a structural change)
+        std::vector<WorldTransformComponent*> m_worldOut;
+        std::vector<TransformComponent> m_cachedLocal;          // local transform the world matrix was built from
+        std::vector<DirectX::XMFLOAT4X4> m_world;               // parents are read from here, not from the registry
+        std::vector<uint8_t> m_changed;                         // set when this node's world matrix changed this frame
+        std::vector<uint32_t> m_batchStart;                     // batch i spans nodes [m_batchStart[i], m_batchStart[i + 1])
+
+        // Rebuild scratch (node entity and depth), kept to reuse the allocations
+        std::vector<entt::entity> m_entities;
+        std::vector<uint32_t> m_depth;
+
+        bool m_structureDirty = true;
+        TransformHierarchyStats m_stats;
+    };
+}
@@ -26,10 +26,13 @@ struct PSInput
     float3 normal : NORMAL;
     float2 texCoord : TEXCOORD;
     float3 worldPos : POSITION; // match VSOutput
+#ifdef INSTANCED
+    nointerpolation float2 material : MATERIAL; // per-instance roughness/metallic
+#endif
 };
 
 
-// Must match C++ LightConstants layout exactly (register b3)
+// Must match C++ LightData layout exactly (StructuredBuffer t1)
 struct LightData
 {
     float3 position;    // For Point/Spot
@@ -43,12 +46,27 @@ struct LightData
 };
 
 
-// the number of lights is hardcoded for now since HLSL needs to know array sizes at compile time
+// Clustered light lists: directional lights come first in g_Lights and always apply,
+// point/spot lights are looked up through the cluster the pixel falls in
+StructuredBuffer<LightData> g_Lights : register(t1);
+StructuredBuffer<uint> g_LightIndices : register(t2);     // indices into g_Lights
+StructuredBuffer<uint2> g_ClusterRanges : register(t3);   // per cluster: (offset into g_LightIndices, count)
+
+
+// Must match C++ LightConstants layout exactly (register b3)
 cbuffer CB_Light : register(b3)
 {
     float3 g_CameraPos;
+    uint g_DirectionalCount;
+    float3 g_CameraForward;
     uint g_LightCount;
-    LightData g_Lights[4]; // MUST MATCH MAX_LIGHTS
+    uint g_ClusterDimX;
+    uint g_ClusterDimY;
+    uint g_ClusterDimZ;
+    float g_ClusterSliceScale;  // slice = log(viewZ) * scale + bias
+    float g_ClusterSliceBias;
+    float2 g_InvViewportSize;
+    float g_LightPadding;
 }
 
 
@@ -133,110 +151,138 @@ float ComputeAttenuation(float distance, float range)
 }
 
 
+// Cook-Torrance contribution of a single light at this surface point
+float3 ShadeLight(LightData light, float3 worldPos, float3 N, float3 V, float3 albedo, float3 F0, float roughness, float metallic)
+{
+    // Compute direction towards light (L) and attenuation depending on light type
+    float3 L = float3(0, 0, 0);
+    float attenuation = 1.0;
+
+    if (light.type == 0) // Directional
+    {
+        // negative because surface to light
+        L = normalize(-light.direction);
+        attenuation = 1.0;
+    }
+    // Point or Spot
+    else
+    {
+        // vector from surface point to light position
+        float3 toLight = light.position - worldPos;
+        // distance to light
+        float dist = length(toLight);
+
+        // normalize to get light direction
+        // if very close to light, set L to zero vector to avoid NaNs
+        // 1e-4 is arbitrary small threshold
+        L = (dist > 1e-4) ? (toLight / dist) : float3(0, 0, 0);
+
+        // compute attenuation based on distance and range
+        attenuation = ComputeAttenuation(dist, light.range);
+
+        if (light.type == 2) // Spot
+        {
+            // test cone: compare angle between spotlight direction and L
+            // dot product gives cos of angle between vectors
+            float theta = dot(normalize(-light.direction), L);
+            // inside cone if angle less than spotAngle (use cos for comparison)
+            // if outside cone, set attenuation to zero, effectively turning off light contribution
+            if (theta <= cos(light.spotAngle))
+            {
+                attenuation = 0.0;
+            }
+        }
+    }
+
+    // Radiance per light
+    float3 radiance = light.color * light.intensity * attenuation;
+
+    // Cook-Torrance BRDF terms per-light
+
+    // half-vector, calculated as the normalized sum of view and light directions
+    float3 H = normalize(V + L);
+    // Distribution term, describes microfacet orientation
+    float D = DistributionGGX(N, H, roughness);
+    // Geometry term, accounts for shadowing/masking
+    float G = GeometrySmith(N, V, L, roughness);
+    // cosine of angle between normal and view direction, for energy conservation
+    float NdotV = saturate(dot(N, V));
+    // cosine of angle between normal and light direction, for energy conservation
+    float NdotL = saturate(dot(N, L));
+    // Fresnel term, describes reflectance at different angles
+    float3 F = FresnelSchlick(saturate(dot(H, V)), F0);
+
+    // numerator of Cook-Torrance BRDF is the product of D, G, and F
+    float3 numerator = D * G * F;
+    // denominator is 4 * NdotV * NdotL, clamped to avoid division by zero
+    float denom = max(4.0 * NdotV * NdotL, 1e-4);
+    // final specular term is numerator divided by denominator
+    float3 specular = numerator / denom;
+
+    // Energy conservation; ensures that the surface does not reflect more light than it receives
+    float3 kS = F;                          // specular reflection component
+    float3 kD = 1.0 - kS;                   // diffuse reflection component
+    kD *= (1.0 - saturate(metallic));       // metals have no diffuse
+
+    // Lambertian diffuse term, scaled by albedo and PI
+    float3 diffuse = (kD * albedo) / PI;
+
+    return (diffuse + specular) * radiance * NdotL;
+}
+
+
+// Flat cluster index of a pixel: screen tile from SV_Position, depth slice from exponential view-depth slicing
+uint ComputeClusterIndex(float2 pixelPos, float3 worldPos)
+{
+    uint2 tile = min(uint2(pixelPos * g_InvViewportSize * float2(g_ClusterDimX, g_ClusterDimY)),
+                     uint2(g_ClusterDimX - 1, g_ClusterDimY - 1));
+
+    float viewZ = max(dot(worldPos - g_CameraPos, g_CameraForward), 1e-4);
+    float slice = floor(log(viewZ) * g_ClusterSliceScale + g_ClusterSliceBias);
+    uint z = (uint)clamp(slice, 0.0, (float)(g_ClusterDimZ - 1));
+
+    return (z * g_ClusterDimY + tile.y) * g_ClusterDimX + tile.x;
+}
+
+
 float4 main(PSInput input) : SV_Target
 {
     // step 1: Sample base color (albedo)
     float4 albedoTex = g_Texture.Sample(g_Sampler, input.texCoord);
     float3 albedo = albedoTex.rgb;
 
+    // material parameters: per-instance when instanced, otherwise from CB_Material
+#ifdef INSTANCED
+    float roughness = input.material.x;
+    float metallic = input.material.y;
+#else
+    float roughness = g_Roughness;
+    float metallic = g_Metallic;
+#endif
+
     // step 2: compute base vectors
     float3 N = normalize(input.normal);                     // normal
     float3 V = normalize(g_CameraPos - input.worldPos);     // view (camera) direction
 
     // step 3: compute base reflectivity F0: ~0.04 for dielectrics, albedo for metals
     // For non-metals, use constant 0.04; for metals, use albedo color
-    float3 F0 = lerp(float3(0.04, 0.04, 0.04), albedo, saturate(g_Metallic));
+    float3 F0 = lerp(float3(0.04, 0.04, 0.04), albedo, saturate(metallic));
 
-    // step 4: accumulate lighting from all active lights
+    // step 4: accumulate lighting, directional lights first, then the lights binned into this pixel's cluster
     float3 Lo = float3(0.0, 0.0, 0.0); // outgoing light
 
     [loop]
-    for (uint i = 0; i < g_LightCount; ++i)
+    for (uint i = 0; i < g_DirectionalCount; ++i)
     {
-        LightData light = g_Lights[i];
+        Lo += ShadeLight(g_Lights[i], input.worldPos, N, V, albedo, F0, roughness, metallic);
+    }
 
-        // Compute direction towards light (L) and attenuation depending on light type
-        float3 L = float3(0, 0, 0);
-        float attenuation = 1.0;
+    uint2 range = g_ClusterRanges[ComputeClusterIndex(input.position.xy, input.worldPos)];
 
-        if (light.type == 0) // Directional
-        {
-            // negative because surface to light
-            L = normalize(-light.direction);
-            attenuation = 1.0;
-        }
-        // Point or Spot
-        else
-        {
-            // vector from surface point to light position
-            float3 toLight = light.position - input.worldPos;
-            // distance to light
-            float dist = length(toLight);
-            
-            // normalize to get light direction
-            // if very close to light, set L to zero vector to avoid NaNs
-            // 1e-4 is arbitrary small threshold
-            L = (dist > 1e-4) ? (toLight / dist) : float3(0, 0, 0);
-            
-            // compute attenuation based on distance and range
-            attenuation = ComputeAttenuation(dist, light.range);
-
-            if (light.type == 2) // Spot
-            {
-                // test cone: compare angle between spotlight direction and L
-                // dot product gives cos of angle between vectors
-                float theta = dot(normalize(-light.direction), L);
-                // inside cone if angle less than spotAngle (use cos for comparison)
-                // if outside cone, set attenuation to zero, effectively turning off light contribution
-                if (theta <= cos(light.spotAngle))
-                {
-                    attenuation = 0.0;
-                }
-                // edge smoothening
-                //else
-                //{
-                //    float epsilon = 0.1; // softness of edge
-                //    float spotEffect = saturate((theta - cos(light.spotAngle)) / epsilon);
-                //    attenuation *= spotEffect;
-                //}
-            }
-        }
-
-        // Radiance per light
-        float3 radiance = light.color * light.intensity * attenuation;
-
-        // Cook-Torrance BRDF terms per-light
-        
-        // half-vector, calculated as the normalized sum of view and light directions
-        float3 H = normalize(V + L);
-        // Distribution term, describes microfacet orientation
-        float D = DistributionGGX(N, H, g_Roughness);
-        // Geometry term, accounts for shadowing/masking
-        float G = GeometrySmith(N, V, L, g_Roughness);
-        // cosine of angle between normal and view direction, for energy conservation
-        float NdotV = saturate(dot(N, V));
-        // cosine of angle between normal and light direction, for energy conservation
-        float NdotL = saturate(dot(N, L));
-        // Fresnel term, describes reflectance at different angles
-        float3 F = FresnelSchlick(saturate(dot(H, V)), F0);
-
-        // numerator of Cook-Torrance BRDF is the product of D, G, and F
-        float3 numerator = D * G * F;
-        // denominator is 4 * NdotV * NdotL, clamped to avoid division by zero
-        float denom = max(4.0 * NdotV * NdotL, 1e-4);
-        // final specular term is numerator divided by denominator
-        float3 specular = numerator / denom;
-
-        // Energy conservation; ensures that the surface does not reflect more light than it receives
-        float3 kS = F;                          // specular reflection component
-        float3 kD = 1.0 - kS;                   // diffuse reflection component
-        kD *= (1.0 - saturate(g_Metallic));     // metals have no diffuse
-
-        // Lambertian diffuse term, scaled by albedo and PI 
-        float3 diffuse = (kD * albedo) / PI;
-
-        // Accumulate contribution of this light
-        Lo += (diffuse + specular) * radiance * NdotL;
+    [loop]
+    for (uint j = 0; j < range.y; ++j)
+    {
+        Lo += ShadeLight(g_Lights[g_LightIndices[range.x + j]], input.worldPos, N, V, albedo, F0, roughness, metallic);
     }
 
     // step 5: add a small ambient term to avoid pure black in unlit areas
@@ -244,4 +290,4 @@ float4 main(PSInput input) : SV_Target
     float3 color = ambient + Lo;
 
     return float4(color, albedoTex.a);
-}
\ No newline at end of file
+}
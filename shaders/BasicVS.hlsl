@@ -10,13 +10,39 @@ cbuffer CB_Object : register(b2) // World
 {
     row_major float4x4 g_World;
 };
+#ifdef COMPACT_VERTEX
+cbuffer CB_MeshDequant : register(b5) // per-mesh position dequantization
+{
+    float3 g_DequantScale;
+    float pad0;
+    float3 g_DequantOffset;
+    float pad1;
+};
+#endif
 
 
+// INSTANCED variant (compiled with the INSTANCED define): world matrix and material come from
+// per-instance vertex data in IA slot 1 instead of CB_Object / CB_Material.
+// COMPACT_VERTEX variant: 16-byte CompactVertex (unorm16 position, octahedral normal, half UVs), see MeshManager.h.
+
 struct VSInput
 {
+#ifdef COMPACT_VERTEX
+    float4 position : POSITION;         // unorm16 within the mesh AABB
+    float2 normal : NORMAL;             // octahedral, snorm16
+    float2 texCoord : TEXCOORD;         // half floats
+#else
     float3 position : POSITION;
     float3 normal : NORMAL;
     float2 texCoord : TEXCOORD;
+#endif
+#ifdef INSTANCED
+    float4 world0 : WORLD0;             // world matrix rows
+    float4 world1 : WORLD1;
+    float4 world2 : WORLD2;
+    float4 world3 : WORLD3;
+    float2 material : MATERIAL;         // x = roughness, y = metallic
+#endif
 };
 
 
@@ -26,22 +52,49 @@ struct VSOutput
     float3 normal : NORMAL;
     float2 texCoord : TEXCOORD;
     float3 worldPos : POSITION; // pass world space pos
+#ifdef INSTANCED
+    nointerpolation float2 material : MATERIAL;
+#endif
 };
 
 
+#ifdef COMPACT_VERTEX
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy += n.xy >= 0.0f ? -t : t;
+    return normalize(n);
+}
+#endif
+
+
 VSOutput main(VSInput input)
 {
     VSOutput o;
+#ifdef COMPACT_VERTEX
+    float4 pos = float4(input.position.xyz * g_DequantScale + g_DequantOffset, 1.0f);
+    float3 normal = DecodeOctahedral(input.normal);
+#else
     float4 pos = float4(input.position, 1.0f);
+    float3 normal = input.normal;
+#endif
+
+#ifdef INSTANCED
+    float4x4 world = float4x4(input.world0, input.world1, input.world2, input.world3);
+    o.material = input.material;
+#else
+    float4x4 world = g_World;
+#endif
 
     // Row-major path: vector is row, matrices are row-major. Use mul(row, M).
-    float4 worldPos4 = mul(pos, g_World);
+    float4 worldPos4 = mul(pos, world);
     float4 viewPos = mul(worldPos4, g_View);
     o.position = mul(viewPos, g_Projection);
 
     // Transform normal by World's upper-left 3x3 (rotation/scale) and normalize
     // Pass through texCoord (no tangent basis transform yet)
-    o.normal = normalize(mul(input.normal, (float3x3) g_World));
+    o.normal = normalize(mul(normal, (float3x3) world));
     o.texCoord = input.texCoord;
 
     // world position for view direction
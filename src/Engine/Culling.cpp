@@ -0,0 +1,144 @@
+#include "Engine/Culling.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace Engine
+{
+    void BoundsSoA::Clear()
+    {
+        cx.clear(); cy.clear(); cz.clear();
+        ex.clear(); ey.clear(); ez.clear();
+        radius.clear();
+        m_count = 0;
+    }
+
+
+    void BoundsSoA::Push(const XMFLOAT3& center, const XMFLOAT3& extents, float r)
+    {
+        // Arrays stay padded to 4: overwrite a padding slot if there is one, otherwise grow by a full group
+        if (m_count == cx.size())
+        {
+            const size_t padded = m_count + 4;
+            for (std::vector<float>* v : { &cx, &cy, &cz, &ex, &ey, &ez, &radius })
+                v->resize(padded, 0.0f);
+        }
+
+        cx[m_count] = center.x;  cy[m_count] = center.y;  cz[m_count] = center.z;
+        ex[m_count] = extents.x; ey[m_count] = extents.y; ez[m_count] = extents.z;
+        radius[m_count] = r;
+        ++m_count;
+    }
+
+
+    namespace Culling
+    {
+        Frustum ExtractFrustum(FXMMATRIX viewProj)
+        {
+            // Rows of the transpose are the columns of viewProj
+            const XMMATRIX t = XMMatrixTranspose(viewProj);
+            const XMVECTOR c0 = t.r[0], c1 = t.r[1], c2 = t.r[2], c3 = t.r[3];
+
+            const XMVECTOR planes[6] = {
+                XMVectorAdd(c3, c0),        // left   (-w <= x)
+                XMVectorSubtract(c3, c0),   // right  (x <= w)
+                XMVectorAdd(c3, c1),        // bottom (-w <= y)
+                XMVectorSubtract(c3, c1),   // top    (y <= w)
+                c2,                         // near   (0 <= z)
+                XMVectorSubtract(c3, c2),   // far    (z <= w)
+            };
+
+            Frustum f{};
+            for (int i = 0; i < 6; ++i)
+                XMStoreFloat4(&f.planes[i], XMPlaneNormalize(planes[i]));
+            return f;
+        }
+
+
+        void TransformBounds(const XMFLOAT3& localCenter, const XMFLOAT3& localExtents, float localRadius,
+                             FXMMATRIX world,
+                             XMFLOAT3& outCenter, XMFLOAT3& outExtents, float& outRadius)
+        {
+            XMStoreFloat3(&outCenter, XMVector3TransformCoord(XMLoadFloat3(&localCenter), world));
+
+            // World extents: sum of |basis axis| * local extent (row-vector convention, rows are the axes)
+            const XMVECTOR e =
+                XMVectorAdd(XMVectorScale(XMVectorAbs(world.r[0]), localExtents.x),
+                XMVectorAdd(XMVectorScale(XMVectorAbs(world.r[1]), localExtents.y),
+                            XMVectorScale(XMVectorAbs(world.r[2]), localExtents.z)));
+            XMStoreFloat3(&outExtents, e);
+
+            const float sx = XMVectorGetX(XMVector3Length(world.r[0]));
+            const float sy = XMVectorGetX(XMVector3Length(world.r[1]));
+            const float sz = XMVectorGetX(XMVector3Length(world.r[2]));
+            outRadius = localRadius * std::max(sx, std::max(sy, sz));
+        }
+
+
+        size_t CullBounds(const Frustum& frustum, const BoundsSoA& bounds, std::vector<uint32_t>& outVisible)
+        {
+            outVisible.clear();
+            const size_t count = bounds.Size();
+            if (count == 0) return 0;
+
+            // Splat plane components once
+            XMVECTOR pa[6], pb[6], pc[6], pd[6], absA[6], absB[6], absC[6];
+            for (int p = 0; p < 6; ++p)
+            {
+                const XMFLOAT4& pl = frustum.planes[p];
+                pa[p] = XMVectorReplicate(pl.x);
+                pb[p] = XMVectorReplicate(pl.y);
+                pc[p] = XMVectorReplicate(pl.z);
+                pd[p] = XMVectorReplicate(pl.w);
+                absA[p] = XMVectorAbs(pa[p]);
+                absB[p] = XMVectorAbs(pb[p]);
+                absC[p] = XMVectorAbs(pc[p]);
+            }
+
+            // Arrays are padded to a multiple of 4, so full-width loads are always in range
+            auto load4 = [](const std::vector<float>& v, size_t i) {
+                return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&v[i]));
+            };
+
+            for (size_t i = 0; i < count; i += 4)
+            {
+                const XMVECTOR x = load4(bounds.cx, i);
+                const XMVECTOR y = load4(bounds.cy, i);
+                const XMVECTOR z = load4(bounds.cz, i);
+
+                // Per-plane signed distances of the 4 centers (shared by both tests)
+                XMVECTOR dist[6];
+                for (int p = 0; p < 6; ++p)
+                    dist[p] = XMVectorMultiplyAdd(pa[p], x, XMVectorMultiplyAdd(pb[p], y, XMVectorMultiplyAdd(pc[p], z, pd[p])));
+
+                // Sphere: inside unless dist < -r on some plane
+                const XMVECTOR negR = XMVectorNegate(load4(bounds.radius, i));
+                XMVECTOR inside = XMVectorTrueInt();
+                for (int p = 0; p < 6; ++p)
+                    inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(dist[p], negR));
+
+                if (XMVector4EqualInt(inside, XMVectorZero()))
+                    continue; // all 4 spheres outside
+
+                // AABB: projected radius |n| . e
+                const XMVECTOR bx = load4(bounds.ex, i);
+                const XMVECTOR by = load4(bounds.ey, i);
+                const XMVECTOR bz = load4(bounds.ez, i);
+                for (int p = 0; p < 6; ++p)
+                {
+                    const XMVECTOR r = XMVectorMultiplyAdd(absA[p], bx, XMVectorMultiplyAdd(absB[p], by, XMVectorMultiply(absC[p], bz)));
+                    inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(dist[p], XMVectorNegate(r)));
+                }
+
+                uint32_t mask[4];
+                XMStoreInt4(mask, inside);
+                const size_t lanes = std::min<size_t>(4, count - i);
+                for (size_t l = 0; l < lanes; ++l)
+                    if (mask[l]) outVisible.push_back(static_cast<uint32_t>(i + l));
+            }
+
+            return outVisible.size();
+        }
+    }
+}
@@ -2,6 +2,7 @@
 #include "Engine/Components.h"
 #include "Engine/MathUtils.h"
 #include "Engine/PhysicsManager.h"
+#include "Engine/SceneSerializer.h"
 #include <imgui.h>
 #include <imgui_internal.h>
 #include <ImGuizmo.h>
@@ -12,6 +13,8 @@ namespace Engine
 {
     void EditorUI::Render(Engine::Scene& scene, Engine::Renderer& renderer, Engine::InputManager& input, Engine::PhysicsManager& physicsManager, SDL_Window* window)
     {
+        ENGINE_PROFILE_FUNCTION();
+
         // Cache the Editor Camera so we can always revert to it
         if (m_editorCamera == entt::null)
         {
@@ -70,6 +73,7 @@ namespace Engine
             ImGui::DockBuilderDockWindow("Hierarchy", dock_id_left);
             ImGui::DockBuilderDockWindow("Inspector", dock_id_right);
             ImGui::DockBuilderDockWindow("Content Browser", dock_id_bottom);
+            ImGui::DockBuilderDockWindow("Profiler", dock_id_bottom);
             ImGui::DockBuilderDockWindow("Toolbar", dock_id_top);
             ImGui::DockBuilderDockWindow("Scene", dock_main_id); // Scene takes whatever is left in the center
 
@@ -181,13 +185,13 @@ namespace Engine
         ImGuizmo::AllowAxisFlip(false);
         ImGuizmo::SetRect(imagePos.x, imagePos.y, viewportSize.x, viewportSize.y);
 
-        // Generate Screen-to-World ray based on the active camera using the same math as CameraMatrixSystem
+        // Camera matrices for the gizmo and the Screen-to-World picking ray
         // NOTE: ImGuizmo needs the camera matrices every single frame to render handles.
         DirectX::XMMATRIX view = DirectX::XMMatrixIdentity();
         DirectX::XMMATRIX proj = DirectX::XMMatrixIdentity();
         DirectX::XMFLOAT4X4 view4x4{}, proj4x4{};
 
-        // Generate Screen-to-World ray based on the active camera using the same math as CameraMatrixSystem
+        // Mirrors the renderer's BuildActiveCameraMatrices (Systems.cpp), minus camera scale and with the Scene viewport aspect
         if (scene.m_activeRenderCamera != entt::null &&
             scene.registry.valid(scene.m_activeRenderCamera) &&
             scene.registry.all_of<Engine::TransformComponent, Engine::CameraComponent>(scene.m_activeRenderCamera))
@@ -243,11 +247,8 @@ namespace Engine
                         continue;
 
                     // Skip inactive entities (master toggle)
-                    if (scene.registry.all_of<Engine::NameComponent>(entity))
-                    {
-                        if (!scene.registry.get<Engine::NameComponent>(entity).isActive)
-                            continue;
-                    }
+                    if (!scene.IsEntityActive(entity))
+                        continue;
 
                     auto& tc = view.get<Engine::TransformComponent>(entity);
 
@@ -321,12 +322,16 @@ namespace Engine
             if (m_gizmoType == 1) op = ImGuizmo::ROTATE;
             if (m_gizmoType == 2) op = ImGuizmo::SCALE;
 
-            // Build the selected entity's world matrix
+            // Build the selected entity's world matrix (local TRS under the parent's propagated world matrix)
             DirectX::XMMATRIX S = DirectX::XMMatrixScaling(tc.scale.x, tc.scale.y, tc.scale.z);
             DirectX::XMVECTOR qn = DirectX::XMQuaternionNormalize(DirectX::XMLoadFloat4(&tc.rotation));
             DirectX::XMMATRIX R = DirectX::XMMatrixRotationQuaternion(qn);
             DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(tc.position.x, tc.position.y, tc.position.z);
-            DirectX::XMMATRIX world = S * R * T;
+            DirectX::XMMATRIX parentWorld = DirectX::XMMatrixIdentity();
+            const entt::entity parent = scene.GetParent(m_selectedEntity);
+            if (parent != entt::null && scene.registry.all_of<Engine::WorldTransformComponent>(parent))
+                parentWorld = DirectX::XMLoadFloat4x4(&scene.registry.get<Engine::WorldTransformComponent>(parent).world);
+            DirectX::XMMATRIX world = S * R * T * parentWorld;
 
             DirectX::XMFLOAT4X4 world4x4;
             DirectX::XMStoreFloat4x4(&world4x4, world);
@@ -337,9 +342,11 @@ namespace Engine
             if (ImGuizmo::IsUsing())
             {
                 // Use DirectX native decomposition to avoid ImGuizmo's Euler angle bugs
+                // Back to the parent's space before decomposing into the local transform
                 DirectX::XMMATRIX modifiedWorld = DirectX::XMLoadFloat4x4(&world4x4);
+                DirectX::XMMATRIX modifiedLocal = modifiedWorld * DirectX::XMMatrixInverse(nullptr, parentWorld);
                 DirectX::XMVECTOR vScale, vRotQuat, vTrans;
-                DirectX::XMMatrixDecompose(&vScale, &vRotQuat, &vTrans, modifiedWorld);
+                DirectX::XMMatrixDecompose(&vScale, &vRotQuat, &vTrans, modifiedLocal);
 
                 DirectX::XMStoreFloat3(&tc.position, vTrans);
                 DirectX::XMStoreFloat3(&tc.scale, vScale);
@@ -390,55 +397,65 @@ namespace Engine
                         ImGui::EndMenu();
                     }
 
+                    // SCENE FILES (Edit mode only: Play mode runs on a temporary copy of the scene)
+                    if (ImGui::BeginMenu("Scene", m_state == EditorState::Edit))
+                    {
+                        const std::filesystem::path sceneDir = m_assetPath / "scenes";
+                        const std::string jsonPath = (sceneDir / "scene.json").string();
+                        const std::string cookedPath = (sceneDir / "scene.cooked").string();
+                        std::error_code ec;
+
+                        bool loaded = false;
+                        if (ImGui::MenuItem("Save JSON")) {
+                            std::filesystem::create_directories(sceneDir, ec);
+                            Engine::SceneSerializer::SaveJson(scene, jsonPath);
+                        }
+                        if (ImGui::MenuItem("Save Cooked")) {
+                            std::filesystem::create_directories(sceneDir, ec);
+                            Engine::SceneSerializer::SaveCooked(scene, cookedPath);
+                        }
+                        ImGui::Separator();
+                        if (ImGui::MenuItem("Load JSON", nullptr, false, std::filesystem::exists(jsonPath, ec))) {
+                            loaded = Engine::SceneSerializer::LoadJson(scene, jsonPath, physicsManager);
+                        }
+                        if (ImGui::MenuItem("Load Cooked", nullptr, false, std::filesystem::exists(cookedPath, ec))) {
+                            loaded = Engine::SceneSerializer::LoadCooked(scene, cookedPath, physicsManager);
+                        }
+
+                        // Entities handed out before the load are gone; the editor camera is re-cached next frame
+                        if (loaded) {
+                            m_selectedEntity = entt::null;
+                            m_editorCamera = entt::null;
+                            m_pendingReparent = false;
+                        }
+                        ImGui::EndMenu();
+                    }
+
                     ImGui::EndPopup();
                 }
 
 				// We cannot destroy entities while iterating over the view, so we defer destruction until after the loop
                 entt::entity entityToDestroy = entt::null;
 
-                // List all entities with a NameComponent in the hierarchy
+                // List root entities with a NameComponent; children are drawn under their parent
                 auto view = scene.registry.view<Engine::NameComponent>();
                 for (auto entity : view)
                 {
-                    auto& nameComp = view.get<Engine::NameComponent>(entity);
-
                     // Prevent editor camera from showing in the hierarchy
                     if (scene.registry.all_of<Engine::EditorCamControlComponent>(entity))
                         continue;
 
-                    // Grey-out inactive entities in the list so state is obvious
-                    if (!nameComp.isActive) {
-                        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
-                    }
-
-                    // Set tree node flags: leaf because parent-child relationships are not implemented yet, and span width for better clickability
-                    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_SpanAvailWidth;
-                    // Note: Leaf because entities do not have children yet
-                    if (m_selectedEntity == entity)
-                        flags |= ImGuiTreeNodeFlags_Selected;
-
-                    // Use the entity ID as the ImGui tree node ID to ensure uniqueness
-                    bool opened = ImGui::TreeNodeEx((void*)(uint32_t)entity, flags, "%s", nameComp.name.c_str());
-                    // Handle selection: clicking on the item selects it
-                    if (ImGui::IsItemClicked()) { m_selectedEntity = entity; }
-
-                    if (!nameComp.isActive) {
-                        ImGui::PopStyleColor();
-                    }
+                    if (scene.GetParent(entity) != entt::null)
+                        continue;
 
-                    if (ImGui::BeginPopupContextItem())
-                    {
-                        if (ImGui::MenuItem("Delete Entity"))
-                        {
-                            if (m_selectedEntity == entity) m_selectedEntity = entt::null;
-                            // Defer the destruction until after the view loop completes
-                            entityToDestroy = entity;
-                        }
-                        ImGui::EndPopup();
-                    }
+                    DrawHierarchyNode(scene, entity, entityToDestroy);
+                }
 
-                    // No child nodes for now, but they would go here
-                    if (opened) { ImGui::TreePop(); }
+                // Apply a drag-and-drop reparent now that the tree walk is done (it follows the sibling links)
+                if (m_pendingReparent)
+                {
+                    scene.SetParent(m_reparentEntity, m_reparentTarget);
+                    m_pendingReparent = false;
                 }
 
                 // Safely destroy the flagged entity now that iterators are no longer in use
@@ -476,20 +493,38 @@ namespace Engine
                         auto& nameComp = scene.registry.get<Engine::NameComponent>(m_selectedEntity);
 
                         // Master active toggle next to name (entity-wide active state)
-                        ImGui::Checkbox("##EntityActive", &nameComp.isActive);
+                        bool entityActive = scene.IsEntityActive(m_selectedEntity);
+                        if (ImGui::Checkbox("##EntityActive", &entityActive))
+                            scene.SetEntityActive(m_selectedEntity, entityActive);
                         ImGui::SameLine();
 
-                        static char buffer[256] = {};
+                        // Edit buffer of the selected entity, refilled when the selection or its stored name changes
+                        static entt::entity s_nameEntity = entt::null;
+                        static Engine::NameHandle s_nameHandle = 0;
+                        static char s_nameBuffer[256] = {};
+                        if (s_nameEntity != m_selectedEntity || s_nameHandle != nameComp.name)
+                        {
+                            s_nameEntity = m_selectedEntity;
+                            s_nameHandle = nameComp.name;
+                            const char* name = Engine::GetNameTable().CStr(nameComp.name);
 #ifdef _MSC_VER
-                        strncpy_s(buffer, nameComp.name.c_str(), sizeof(buffer) - 1);
+                            strncpy_s(s_nameBuffer, name, sizeof(s_nameBuffer) - 1);
 #else
-                        std::strncpy(buffer, nameComp.name.c_str(), sizeof(buffer) - 1);
+                            std::strncpy(s_nameBuffer, name, sizeof(s_nameBuffer) - 1);
+                            s_nameBuffer[sizeof(s_nameBuffer) - 1] = '\0';
 #endif
+                        }
 
-                        if (ImGui::InputText("##Name", buffer, sizeof(buffer)))
+                        // Interned once the edit is committed (Enter or focus lost), not per keystroke. The ID is
+                        // per entity so an edit cut short by a selection change never lands on the new selection.
+                        ImGui::PushID(static_cast<int>(entt::to_integral(m_selectedEntity)));
+                        ImGui::InputText("##Name", s_nameBuffer, sizeof(s_nameBuffer));
+                        if (ImGui::IsItemDeactivatedAfterEdit())
                         {
-                            nameComp.name = buffer;
+                            nameComp.name = Engine::GetNameTable().Intern(s_nameBuffer);
+                            s_nameHandle = nameComp.name;
                         }
+                        ImGui::PopID();
                     }
 
                     // TransformComponent UI
@@ -538,11 +573,13 @@ namespace Engine
                     // LightComponent UI
                     if (scene.registry.all_of<Engine::LightComponent>(m_selectedEntity))
                     {
-                        auto& lc = scene.registry.get<Engine::LightComponent>(m_selectedEntity);
-
                         ImGui::PushID("Light");
-                        ImGui::Checkbox("##Active", &lc.isActive);
+                        bool componentActive = scene.IsComponentActive<Engine::LightComponent>(m_selectedEntity);
+                        if (ImGui::Checkbox("##Active", &componentActive))
+                            scene.SetComponentActive<Engine::LightComponent>(m_selectedEntity, componentActive);
                         ImGui::SameLine();
+
+                        auto& lc = scene.registry.get<Engine::LightComponent>(m_selectedEntity);
                         bool treeOpen = ImGui::TreeNodeEx("Light", ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Framed);
 
                         bool removeComponent = false;
@@ -580,11 +617,14 @@ namespace Engine
                     // RigidbodyComponent UI
                     if (scene.registry.all_of<Engine::RigidBodyComponent>(m_selectedEntity))
                     {
-                        auto& rb = scene.registry.get<Engine::RigidBodyComponent>(m_selectedEntity);
-
                         ImGui::PushID("Rigidbody");
-                        ImGui::Checkbox("##Active", &rb.isActive);
+                        bool componentActive = scene.IsComponentActive<Engine::RigidBodyComponent>(m_selectedEntity);
+                        if (ImGui::Checkbox("##Active", &componentActive))
+                            scene.SetComponentActive<Engine::RigidBodyComponent>(m_selectedEntity, componentActive);
                         ImGui::SameLine();
+
+                        // Fetched after the toggle: tags move group-owned components within their pool
+                        auto& rb = scene.registry.get<Engine::RigidBodyComponent>(m_selectedEntity);
                         bool treeOpen = ImGui::TreeNodeEx("Rigidbody", ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Framed);
 
                         bool removeComponent = false;
@@ -667,11 +707,14 @@ namespace Engine
                     // MeshRendererComponent UI
                     if (scene.registry.all_of<Engine::MeshRendererComponent>(m_selectedEntity))
                     {
-                        auto& mr = scene.registry.get<Engine::MeshRendererComponent>(m_selectedEntity);
-
                         ImGui::PushID("MeshRenderer");
-                        ImGui::Checkbox("##Active", &mr.isActive);
+                        bool componentActive = scene.IsComponentActive<Engine::MeshRendererComponent>(m_selectedEntity);
+                        if (ImGui::Checkbox("##Active", &componentActive))
+                            scene.SetComponentActive<Engine::MeshRendererComponent>(m_selectedEntity, componentActive);
                         ImGui::SameLine();
+
+                        // Fetched after the toggle: tags move group-owned components within their pool
+                        auto& mr = scene.registry.get<Engine::MeshRendererComponent>(m_selectedEntity);
                         bool treeOpen = ImGui::TreeNodeEx("Mesh Renderer", ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Framed);
 
                         bool removeComponent = false;
@@ -726,7 +769,8 @@ namespace Engine
                         if (!scene.registry.all_of<Engine::LightComponent>(m_selectedEntity)) {
                             if (ImGui::MenuItem("Light")) scene.registry.emplace<Engine::LightComponent>(m_selectedEntity);
                         }
-                        if (!scene.registry.all_of<Engine::RigidBodyComponent>(m_selectedEntity)) {
+                        // Rigid bodies are root-only (see Scene::SetParent)
+                        if (!scene.registry.all_of<Engine::RigidBodyComponent>(m_selectedEntity) && scene.GetParent(m_selectedEntity) == entt::null) {
                             if (ImGui::MenuItem("Rigidbody")) scene.registry.emplace<Engine::RigidBodyComponent>(m_selectedEntity);
                         }
                         // Add other components like CameraComponent, etc.
@@ -774,5 +818,171 @@ namespace Engine
             }
             ImGui::End();
         }
+
+#ifdef ENGINE_ENABLE_PROFILER
+        DrawProfilerPanel();
+#endif
+    }
+
+
+#ifdef ENGINE_ENABLE_PROFILER
+    void EditorUI::DrawProfilerPanel()
+    {
+        ImGui::Begin("Profiler");
+
+        Engine::Profiler& profiler = Engine::Profiler::Get();
+        if (!m_profilerPaused)
+            profiler.GetFrame(m_profilerFrame);
+
+        ImGui::Checkbox("Pause", &m_profilerPaused);
+        ImGui::SameLine();
+        if (ImGui::Button("Save Trace"))
+            profiler.WriteChromeTrace("trace.json");
+        ImGui::SameLine();
+        const double frameMs = double(m_profilerFrame.endNs - m_profilerFrame.startNs) / 1e6;
+        ImGui::Text("Frame %.3f ms | scope cost %.1f ns", frameMs, profiler.GetScopeCostNs());
+
+        // Lanes: thread name, then one row per nesting depth; x maps the frame interval onto the panel width
+        const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float width = ImGui::GetContentRegionAvail().x;
+        const double span = m_profilerFrame.endNs > m_profilerFrame.startNs ? double(m_profilerFrame.endNs - m_profilerFrame.startNs) : 1.0;
+        const double scale = double(width) / span;
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const ImVec2 mouse = ImGui::GetMousePos();
+        const Engine::ProfileEvent* hovered = nullptr;
+        float y = origin.y;
+
+        for (const Engine::ProfileThreadEvents& thread : m_profilerFrame.threads)
+        {
+            drawList->AddText(ImVec2(origin.x, y), ImGui::GetColorU32(ImGuiCol_Text), thread.threadName.c_str());
+            y += rowHeight;
+
+            for (const Engine::ProfileEvent& e : thread.events)
+            {
+                // Clip events that started before / ended after the captured frame
+                const uint64_t start = e.startNs > m_profilerFrame.startNs ? e.startNs : m_profilerFrame.startNs;
+                const uint64_t end = e.endNs < m_profilerFrame.endNs ? e.endNs : m_profilerFrame.endNs;
+                const float x0 = origin.x + float(double(start - m_profilerFrame.startNs) * scale);
+                const float x1 = origin.x + float(double(end - m_profilerFrame.startNs) * scale);
+                const float y0 = y + float(e.depth) * rowHeight;
+                const ImVec2 min(x0, y0), max(x1 > x0 + 1.0f ? x1 : x0 + 1.0f, y0 + rowHeight - 1.0f);
+
+                // Stable colour per name (pointer hash), darker with depth
+                const uint32_t hash = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(e.name) * 2654435761u);
+                const float shade = 1.0f - 0.08f * float(e.depth % 6);
+                const ImU32 color = ImGui::GetColorU32(ImVec4(
+                    (0.45f + 0.4f * float((hash >> 8) & 0xFF) / 255.0f) * shade,
+                    (0.35f + 0.3f * float((hash >> 16) & 0xFF) / 255.0f) * shade,
+                    0.25f * shade, 1.0f));
+                drawList->AddRectFilled(min, max, color);
+
+                // Label only when it fits
+                const ImVec2 textSize = ImGui::CalcTextSize(e.name);
+                if (textSize.x + 4.0f < max.x - min.x)
+                    drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), e.name);
+
+                if (ImGui::IsWindowHovered() && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+                    hovered = &e;
+            }
+            y += float(thread.maxDepth + 1) * rowHeight + 4.0f;
+        }
+
+        // Reserve the drawn area so the window scrolls
+        ImGui::Dummy(ImVec2(width, y - origin.y));
+
+        if (hovered)
+        {
+            ImGui::BeginTooltip();
+            ImGui::Text("%s", hovered->name);
+            ImGui::Text("%.3f ms", double(hovered->endNs - hovered->startNs) / 1e6);
+            ImGui::EndTooltip();
+        }
+
+        ImGui::End();
+    }
+#endif
+
+
+    void EditorUI::DrawHierarchyNode(Engine::Scene& scene, entt::entity entity, entt::entity& entityToDestroy)
+    {
+        const auto* nameComp = scene.registry.try_get<Engine::NameComponent>(entity);
+        const char* name = nameComp ? Engine::GetNameTable().CStr(nameComp->name) : "Entity";
+        const bool isActive = scene.IsEntityActive(entity);
+
+        const auto* node = scene.registry.try_get<Engine::HierarchyComponent>(entity);
+        const bool hasChildren = node && node->firstChild != entt::null;
+
+        // Grey-out inactive entities in the list so state is obvious
+        if (!isActive) {
+            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
+        }
+
+        // Leaf only when there is nothing below; span width for better clickability
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
+        if (!hasChildren)
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        if (m_selectedEntity == entity)
+            flags |= ImGuiTreeNodeFlags_Selected;
+
+        // Use the entity ID as the ImGui tree node ID to ensure uniqueness
+        bool opened = ImGui::TreeNodeEx((void*)(uintptr_t)(uint32_t)entity, flags, "%s", name);
+        // Handle selection: clicking on the item selects it
+        if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) { m_selectedEntity = entity; }
+
+        if (!isActive) {
+            ImGui::PopStyleColor();
+        }
+
+        // Drag an entity onto another one to make it a child (applied after the tree walk)
+        if (ImGui::BeginDragDropSource())
+        {
+            ImGui::SetDragDropPayload("HIERARCHY_ENTITY", &entity, sizeof(entity));
+            ImGui::Text("%s", name);
+            ImGui::EndDragDropSource();
+        }
+        if (ImGui::BeginDragDropTarget())
+        {
+            if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("HIERARCHY_ENTITY"))
+            {
+                // Rigid bodies stay at the root (physics writes their world pose into the Transform)
+                const entt::entity dragged = *static_cast<const entt::entity*>(payload->Data);
+                if (!scene.registry.all_of<Engine::RigidBodyComponent>(dragged))
+                {
+                    m_reparentEntity = dragged;
+                    m_reparentTarget = entity;
+                    m_pendingReparent = true;
+                }
+            }
+            ImGui::EndDragDropTarget();
+        }
+
+        if (ImGui::BeginPopupContextItem())
+        {
+            if (node && node->parent != entt::null && ImGui::MenuItem("Clear Parent"))
+            {
+                m_reparentEntity = entity;
+                m_reparentTarget = entt::null;
+                m_pendingReparent = true;
+            }
+            if (ImGui::MenuItem("Delete Entity"))
+            {
+                if (m_selectedEntity == entity) m_selectedEntity = entt::null;
+                // Defer the destruction until after the tree walk completes
+                entityToDestroy = entity;
+            }
+            ImGui::EndPopup();
+        }
+
+        if (opened)
+        {
+            for (entt::entity child = hasChildren ? node->firstChild : entt::null; child != entt::null;
+                 child = scene.registry.get<Engine::HierarchyComponent>(child).nextSibling)
+            {
+                DrawHierarchyNode(scene, child, entityToDestroy);
+            }
+            ImGui::TreePop();
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "Engine/GeometryArena.h"
+#include "Engine/RenderDevice.h"
+#include <algorithm>
+#include <cstdio>
+
+using Microsoft::WRL::ComPtr;
+
+namespace Engine
+{
+    GeometryArena::GeometryArena(uint32_t elementSize, UINT bindFlag, uint32_t initialCapacity)
+        : m_elementSize(elementSize), m_bindFlag(bindFlag), m_initialCapacity(initialCapacity)
+    {
+    }
+
+
+    bool GeometryArena::Reallocate(ID3D11Device* device, IRenderDevice& renderDevice, uint32_t capacity, const std::vector<OffsetAllocator::Move>* moves)
+    {
+        if (uint64_t(capacity) * m_elementSize > UINT32_MAX)
+        {
+            std::fprintf(stderr, "GeometryArena: %u elements of %u bytes exceed the buffer size limit\n", capacity, m_elementSize);
+            return false;
+        }
+
+        D3D11_BUFFER_DESC desc{};
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.ByteWidth = capacity * m_elementSize;
+        desc.BindFlags = m_bindFlag;
+
+        ComPtr<ID3D11Buffer> buffer;
+        if (FAILED(device->CreateBuffer(&desc, nullptr, buffer.GetAddressOf())))
+            return false;
+
+        if (m_buffer)
+        {
+            // Everything at its old offset first, then the moved ranges (source and destination never alias)
+            renderDevice.CopyBufferRegion(buffer.Get(), 0, m_buffer.Get(), 0, m_allocator.GetCapacity() * m_elementSize);
+            if (moves)
+            {
+                for (const OffsetAllocator::Move& move : *moves)
+                    renderDevice.CopyBufferRegion(buffer.Get(), move.to * m_elementSize, m_buffer.Get(), move.from * m_elementSize, move.size * m_elementSize);
+            }
+        }
+
+        m_buffer = buffer;
+        return true;
+    }
+
+
+    bool GeometryArena::Allocate(ID3D11Device* device, IRenderDevice& renderDevice, const void* data, uint32_t count, uint32_t& outOffset)
+    {
+        if (count == 0) return false;
+
+        OffsetAllocator::Allocation alloc;
+        if (!m_allocator.Allocate(count, alloc))
+        {
+            // Grow by at least count so the new tail range always fits it
+            const uint32_t capacity = m_allocator.GetCapacity();
+            const uint32_t grown = std::max({ m_initialCapacity, capacity * 2, capacity + count });
+            if (!Reallocate(device, renderDevice, grown, nullptr))
+                return false;
+
+            m_allocator.Grow(grown);
+            if (capacity > 0) ++m_grows;
+            if (!m_allocator.Allocate(count, alloc))
+                return false;
+        }
+
+        renderDevice.UpdateBufferRange(m_buffer.Get(), alloc.offset * m_elementSize, data, count * m_elementSize);
+
+        outOffset = alloc.offset;
+        return true;
+    }
+
+
+    bool GeometryArena::Free(uint32_t offset)
+    {
+        return m_allocator.Free(offset);
+    }
+
+
+    bool GeometryArena::Defragment(ID3D11Device* device, IRenderDevice& renderDevice, std::vector<OffsetAllocator::Move>& moves)
+    {
+        moves.clear();
+        if (!m_buffer)
+            return true;
+
+        // Plan on a copy so a failed buffer creation leaves the arena untouched
+        OffsetAllocator packed = m_allocator;
+        packed.Defragment(moves);
+        if (moves.empty())
+            return true;
+
+        if (!Reallocate(device, renderDevice, m_allocator.GetCapacity(), &moves))
+        {
+            moves.clear();
+            return false;
+        }
+        m_allocator = std::move(packed);
+        return true;
+    }
+}
@@ -49,7 +49,8 @@ namespace Engine
     {
 		// Finalize the ImGui frame and render the draw data using the DirectX 11 backend.
         ImGui::Render();
-        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        if (m_submitDrawData)
+            ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
     }
 
 
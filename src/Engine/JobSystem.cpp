@@ -0,0 +1,178 @@
+#include "Engine/JobSystem.h"
+#include "Engine/Profiler.h"
+#include <algorithm>
+#include <iterator>
+
+namespace Engine
+{
+    // Deque owned by the current thread (0 for the main thread and threads outside the pool)
+    static thread_local uint32_t t_queueIndex = 0;
+
+
+    bool JobSystem::Initialize(uint32_t workerCount)
+    {
+        if (m_running) return true;
+
+        if (workerCount == 0)
+        {
+            const uint32_t hw = std::thread::hardware_concurrency();
+            workerCount = hw > 1 ? hw - 1 : 1;
+        }
+
+        m_mainThread = std::this_thread::get_id();
+        t_queueIndex = 0;
+
+        m_queues.clear();
+        for (uint32_t i = 0; i < workerCount + 1; ++i)
+            m_queues.push_back(std::make_unique<WorkerQueue>());
+
+        m_running = true;
+        m_threads.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+            m_threads.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+
+        return true;
+    }
+
+
+    void JobSystem::Shutdown()
+    {
+        if (!m_running) return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+
+        for (auto& t : m_threads) t.join();
+        m_threads.clear();
+        m_queues.clear();
+
+        // Anything still aimed at the main thread runs now so nothing is silently lost
+        ExecuteMainThreadTasks();
+    }
+
+
+    void JobSystem::Run(JobCounter& counter, Task task)
+    {
+        counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+        // Without workers (not initialized), run inline
+        if (m_queues.empty())
+        {
+            task();
+            counter.pending.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+
+        {
+            WorkerQueue& queue = *m_queues[t_queueIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(QueuedTask{ std::move(task), &counter });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_queued.fetch_add(1, std::memory_order_release);
+        }
+        m_wake.notify_one();
+    }
+
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        while (counter.pending.load(std::memory_order_acquire) > 0)
+        {
+            // Help out instead of blocking, but only with this group's tasks: an unrelated task picked up here
+            // (e.g. the pipelined Update) would run inline on the waiting thread. Yield when none is queued.
+            if (!TryRunOne(&counter))
+                std::this_thread::yield();
+        }
+    }
+
+
+    bool JobSystem::TryRunOne(const JobCounter* group)
+    {
+        if (m_queues.empty()) return false;
+
+        QueuedTask job;
+        bool found = false;
+        auto matches = [group](const QueuedTask& t) { return !group || t.counter == group; };
+
+        // Own deque first, newest task (LIFO)
+        {
+            WorkerQueue& own = *m_queues[t_queueIndex];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            auto it = std::find_if(own.tasks.rbegin(), own.tasks.rend(), matches);
+            if (it != own.tasks.rend())
+            {
+                job = std::move(*it);
+                own.tasks.erase(std::next(it).base());
+                found = true;
+            }
+        }
+
+        // Steal the oldest task of another deque (FIFO), starting next to our own to spread contention
+        const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+        for (uint32_t i = 1; !found && i < queueCount; ++i)
+        {
+            WorkerQueue& victim = *m_queues[(t_queueIndex + i) % queueCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            auto it = std::find_if(victim.tasks.begin(), victim.tasks.end(), matches);
+            if (it != victim.tasks.end())
+            {
+                job = std::move(*it);
+                victim.tasks.erase(it);
+                found = true;
+            }
+        }
+
+        if (!found) return false;
+
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        job.task();
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+
+    void JobSystem::WorkerLoop(uint32_t queueIndex)
+    {
+        t_queueIndex = queueIndex;
+        ENGINE_PROFILE_THREAD(("Worker " + std::to_string(queueIndex)).c_str());
+
+        while (true)
+        {
+            if (TryRunOne()) continue;
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wake.wait(lock, [this]() { return !m_running || m_queued.load(std::memory_order_acquire) > 0; });
+            if (!m_running) break;
+        }
+    }
+
+
+    void JobSystem::RunOnMainThread(Task task)
+    {
+        if (IsMainThread())
+        {
+            task();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mainMutex);
+        m_mainTasks.push_back(std::move(task));
+    }
+
+
+    void JobSystem::ExecuteMainThreadTasks()
+    {
+        std::vector<Task> tasks;
+        {
+            std::lock_guard<std::mutex> lock(m_mainMutex);
+            tasks.swap(m_mainTasks);
+        }
+        for (auto& task : tasks) task();
+    }
+}
@@ -0,0 +1,74 @@
+#include "Engine/JoltJobSystem.h"
+#include <chrono>
+#include <thread>
+
+namespace Engine
+{
+    JoltJobSystemAdapter::JoltJobSystemAdapter(JobSystem& jobSystem, JPH::uint maxJobs, JPH::uint maxBarriers)
+        : JPH::JobSystemWithBarrier(maxBarriers), m_jobSystem(jobSystem)
+    {
+        m_jobs.Init(maxJobs, maxJobs);
+    }
+
+
+    JoltJobSystemAdapter::~JoltJobSystemAdapter()
+    {
+        // Jobs still queued reference this adapter (and its pool)
+        m_jobSystem.Wait(m_inFlight);
+    }
+
+
+    int JoltJobSystemAdapter::GetMaxConcurrency() const
+    {
+        return static_cast<int>(m_jobSystem.GetConcurrency());
+    }
+
+
+    JPH::JobSystem::JobHandle JoltJobSystemAdapter::CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies)
+    {
+        // Allocate from the pool; if exhausted, wait for running jobs to free a slot
+        JPH::uint32 index;
+        for (;;)
+        {
+            index = m_jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+            if (index != decltype(m_jobs)::cInvalidObjectIndex)
+                break;
+            JPH_ASSERT(false, "No jobs available!");
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        Job* job = &m_jobs.Get(index);
+
+        // Handle keeps the job alive until the caller is done with it
+        JobHandle handle(job);
+
+        // Jobs without dependencies can run right away; the others are queued by Jolt when their last dependency finishes
+        if (inNumDependencies == 0)
+            QueueJob(job);
+
+        return handle;
+    }
+
+
+    void JoltJobSystemAdapter::QueueJob(Job* inJob)
+    {
+        // Reference held by the queued task, released after execution
+        inJob->AddRef();
+        m_jobSystem.Run(m_inFlight, [inJob]() {
+            inJob->Execute();
+            inJob->Release();
+        });
+    }
+
+
+    void JoltJobSystemAdapter::QueueJobs(Job** inJobs, JPH::uint inNumJobs)
+    {
+        for (JPH::uint i = 0; i < inNumJobs; ++i)
+            QueueJob(inJobs[i]);
+    }
+
+
+    void JoltJobSystemAdapter::FreeJob(Job* inJob)
+    {
+        m_jobs.DestructObject(inJob);
+    }
+}
@@ -0,0 +1,162 @@
+#include "Engine/LightClustering.h"
+#include "Engine/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace Engine
+{
+    // Below this many lights, scheduling jobs costs more than binning on the calling thread
+    static constexpr size_t kParallelLightThreshold = 64;
+
+
+    void LightClusterer::Configure(uint32_t dimX, uint32_t dimY, uint32_t dimZ, uint32_t maxLightsPerCluster)
+    {
+        m_dimX = std::max(1u, dimX);
+        m_dimY = std::max(1u, dimY);
+        m_dimZ = std::max(1u, dimZ);
+        m_maxPerCluster = std::max(1u, maxLightsPerCluster);
+    }
+
+
+    void LightClusterer::Build(const std::vector<ClusterLightBounds>& lights, const ClusterCamera& camera, uint32_t indexBase, JobSystem* jobSystem)
+    {
+        const uint32_t clusterCount = GetClusterCount();
+        const float nearZ = std::max(camera.nearZ, 1e-4f);
+        const float farZ = std::max(camera.farZ, nearZ * 1.001f);
+
+        // Exponential slicing: slice = log(z / near) / log(far / near) * dimZ
+        const float logRatio = std::log(farZ / nearZ);
+        m_sliceScale = static_cast<float>(m_dimZ) / logRatio;
+        m_sliceBias = -static_cast<float>(m_dimZ) * std::log(nearZ) / logRatio;
+
+        // Light bounds -> view-space spheres (spot cones use their tightest bounding sphere)
+        const XMMATRIX view = XMLoadFloat4x4(&camera.view);
+        m_spheres.resize(lights.size());
+        for (size_t i = 0; i < lights.size(); ++i)
+        {
+            const ClusterLightBounds& l = lights[i];
+            XMVECTOR center = XMLoadFloat3(&l.position);
+            float radius = l.range;
+
+            if (l.spotAngle > 0.0f)
+            {
+                const XMVECTOR dir = XMVector3Normalize(XMLoadFloat3(&l.direction));
+                const float cosA = std::cos(l.spotAngle);
+                if (l.spotAngle > XM_PIDIV4)
+                {
+                    center = XMVectorAdd(center, XMVectorScale(dir, cosA * l.range));
+                    radius = std::sin(l.spotAngle) * l.range;
+                }
+                else
+                {
+                    radius = l.range / (2.0f * cosA);
+                    center = XMVectorAdd(center, XMVectorScale(dir, radius));
+                }
+            }
+
+            XMFLOAT3 vc;
+            XMStoreFloat3(&vc, XMVector3TransformCoord(center, view));
+            m_spheres[i] = ViewSphere{ vc.x, vc.y, vc.z, radius };
+        }
+
+        m_clusterCounts.assign(clusterCount, 0u);
+        m_clusterLights.resize(static_cast<size_t>(clusterCount) * m_maxPerCluster);
+
+        // Slices are independent (disjoint cluster ranges), so they bin in parallel without locks
+        m_sliceOverflow.assign(m_dimZ, 0u);
+        if (jobSystem && lights.size() >= kParallelLightThreshold)
+        {
+            jobSystem->ParallelFor(m_dimZ, 1, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t z = begin; z < end; ++z)
+                    BinSlice(z, camera, indexBase, m_sliceOverflow[z]);
+            });
+        }
+        else
+        {
+            for (uint32_t z = 0; z < m_dimZ; ++z)
+                BinSlice(z, camera, indexBase, m_sliceOverflow[z]);
+        }
+
+        m_overflow = 0;
+        for (uint32_t o : m_sliceOverflow) m_overflow += o;
+
+        // Compaction: prefix sum of counts -> (offset, count) per cluster + tightly packed index list
+        m_clusterRanges.resize(static_cast<size_t>(clusterCount) * 2);
+        uint32_t total = 0;
+        for (uint32_t c = 0; c < clusterCount; ++c)
+        {
+            m_clusterRanges[c * 2 + 0] = total;
+            m_clusterRanges[c * 2 + 1] = m_clusterCounts[c];
+            total += m_clusterCounts[c];
+        }
+
+        m_indexList.resize(total);
+        for (uint32_t c = 0; c < clusterCount; ++c)
+        {
+            const uint32_t* src = &m_clusterLights[static_cast<size_t>(c) * m_maxPerCluster];
+            std::copy(src, src + m_clusterCounts[c], m_indexList.begin() + m_clusterRanges[c * 2]);
+        }
+    }
+
+
+    void LightClusterer::BinSlice(uint32_t z, const ClusterCamera& camera, uint32_t indexBase, uint32_t& overflow)
+    {
+        const float nearZ = std::max(camera.nearZ, 1e-4f);
+        const float farZ = std::max(camera.farZ, nearZ * 1.001f);
+        const float ratio = farZ / nearZ;
+        const float zn = nearZ * std::pow(ratio, static_cast<float>(z) / static_cast<float>(m_dimZ));
+        const float zf = nearZ * std::pow(ratio, static_cast<float>(z + 1) / static_cast<float>(m_dimZ));
+
+        const float dimX = static_cast<float>(m_dimX);
+        const float dimY = static_cast<float>(m_dimY);
+        auto tileOf = [](float t, float dim, uint32_t maxIndex) {
+            const int i = static_cast<int>(std::floor(t * dim));
+            return static_cast<uint32_t>(std::clamp(i, 0, static_cast<int>(maxIndex)));
+        };
+
+        for (uint32_t li = 0; li < static_cast<uint32_t>(m_spheres.size()); ++li)
+        {
+            const ViewSphere& s = m_spheres[li];
+            if (s.z + s.r < zn || s.z - s.r > zf) continue;
+
+            // Largest cross-section of the sphere inside the slab [zn, zf]
+            float d = 0.0f;
+            if (s.z < zn) d = zn - s.z;
+            else if (s.z > zf) d = s.z - zf;
+            const float rs = std::sqrt(std::max(s.r * s.r - d * d, 0.0f));
+
+            // Depth extent of the sphere within the slab (always >= near > 0)
+            const float z0 = std::max(zn, s.z - s.r);
+            const float z1 = std::min(zf, s.z + s.r);
+
+            // Conservative NDC bounds: x/z is monotonic in z, so the extremes sit at z0 or z1
+            const float xMin = s.x - rs, xMax = s.x + rs;
+            const float yMin = s.y - rs, yMax = s.y + rs;
+            const float ndcMinX = camera.projScaleX * (xMin >= 0.0f ? xMin / z1 : xMin / z0);
+            const float ndcMaxX = camera.projScaleX * (xMax >= 0.0f ? xMax / z0 : xMax / z1);
+            const float ndcMinY = camera.projScaleY * (yMin >= 0.0f ? yMin / z1 : yMin / z0);
+            const float ndcMaxY = camera.projScaleY * (yMax >= 0.0f ? yMax / z0 : yMax / z1);
+            if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f) continue;
+
+            // Tiles: x left -> right, y top -> bottom (matches SV_Position)
+            const uint32_t tx0 = tileOf(ndcMinX * 0.5f + 0.5f, dimX, m_dimX - 1);
+            const uint32_t tx1 = tileOf(ndcMaxX * 0.5f + 0.5f, dimX, m_dimX - 1);
+            const uint32_t ty0 = tileOf(0.5f - ndcMaxY * 0.5f, dimY, m_dimY - 1);
+            const uint32_t ty1 = tileOf(0.5f - ndcMinY * 0.5f, dimY, m_dimY - 1);
+
+            for (uint32_t ty = ty0; ty <= ty1; ++ty)
+            {
+                for (uint32_t tx = tx0; tx <= tx1; ++tx)
+                {
+                    const uint32_t cluster = (z * m_dimY + ty) * m_dimX + tx;
+                    uint32_t& count = m_clusterCounts[cluster];
+                    if (count >= m_maxPerCluster) { ++overflow; continue; }
+                    m_clusterLights[static_cast<size_t>(cluster) * m_maxPerCluster + count] = indexBase + li;
+                    ++count;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "Engine/MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine
+{
+#ifdef _WIN32
+    bool MappedFile::Open(const std::string& path)
+    {
+        Close();
+
+        // Sequential scan hint: the cooked loader walks the file front to back once
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        m_file = file;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { Close(); return false; }
+
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) { Close(); return false; }
+
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data) { Close(); return false; }
+
+        m_size = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+
+    void MappedFile::Close()
+    {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file) CloseHandle(m_file);
+        m_data = nullptr;
+        m_mapping = nullptr;
+        m_file = nullptr;
+        m_size = 0;
+    }
+#else
+    bool MappedFile::Open(const std::string& path)
+    {
+        Close();
+
+        m_fd = open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) return false;
+
+        struct stat st{};
+        if (fstat(m_fd, &st) != 0 || st.st_size == 0) { Close(); return false; }
+
+        void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (data == MAP_FAILED) { Close(); return false; }
+        madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = static_cast<size_t>(st.st_size);
+        return true;
+    }
+
+
+    void MappedFile::Close()
+    {
+        if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+        if (m_fd >= 0) close(m_fd);
+        m_data = nullptr;
+        m_size = 0;
+        m_fd = -1;
+    }
+#endif
+}
@@ -0,0 +1,253 @@
+#include "Engine/MeshCache.h"
+#include "Engine/SceneSnapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace Engine
+{
+    namespace MeshCache
+    {
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vertexStride;      // sizeof(Vertex) when written
+            uint32_t importFlags;
+            int64_t sourceMtime;
+            uint64_t sourceSize;
+            uint32_t meshCount;
+            uint32_t pathLength;
+        };
+
+        // Offsets are from the start of the file
+        struct MeshRecord
+        {
+            uint32_t vertexCount;
+            uint32_t indexCount;
+            uint64_t vertexOffset;
+            uint64_t indexOffset;
+            uint64_t positionOffset;
+            MeshBounds bounds;
+            uint32_t lodCount;
+            uint64_t lodOffset;
+            uint64_t lodIndexOffset;
+            uint32_t lodIndexCount;
+            uint32_t reserved;
+            uint64_t contentHash;       // HashMesh: every blob of the mesh and its bounds
+        };
+
+        static constexpr uint32_t kMagic = 0x444B434D;     // 'MCKD'
+        static constexpr uint32_t kVersion = 4;            // 2: meshes are stored MeshOptimizer-ordered, 3: LOD chains, 4: content hash
+
+
+        // 64-bit words folded with a multiply-xorshift (several GB/s), the tail byte by byte. Catches damaged or
+        // partially rewritten files; it is not meant to resist deliberate tampering.
+        static uint64_t HashBytes(uint64_t hash, const void* data, size_t bytes)
+        {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (; bytes >= 8; bytes -= 8, p += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, p, sizeof(word));
+                hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+                hash ^= hash >> 29;
+            }
+            for (; bytes > 0; --bytes, ++p)
+                hash = (hash ^ *p) * 1099511628211ull;
+            return hash;
+        }
+
+
+        static uint64_t HashMesh(const MeshCacheMesh& mesh)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            hash = HashBytes(hash, mesh.vertices, size_t(mesh.vertexCount) * sizeof(Vertex));
+            hash = HashBytes(hash, mesh.indices, size_t(mesh.indexCount) * sizeof(uint32_t));
+            hash = HashBytes(hash, mesh.positions, size_t(mesh.vertexCount) * sizeof(DirectX::XMFLOAT3));
+            hash = HashBytes(hash, mesh.lods, size_t(mesh.lodCount) * sizeof(MeshLod));
+            hash = HashBytes(hash, mesh.lodIndices, size_t(mesh.lodIndexCount) * sizeof(uint32_t));
+            hash = HashBytes(hash, &mesh.bounds, sizeof(mesh.bounds));
+            return hash;
+        }
+
+
+        // Indices are drawn as they are: every one must lie inside the mesh's vertex range
+        static bool IndicesInRange(const uint32_t* indices, uint32_t count, uint32_t vertexCount)
+        {
+            uint32_t maxIndex = 0;
+            for (uint32_t i = 0; i < count; ++i)
+                maxIndex = indices[i] > maxIndex ? indices[i] : maxIndex;
+            return count == 0 || maxIndex < vertexCount;
+        }
+
+
+        bool MakeKey(const std::string& sourcePath, uint32_t importFlags, MeshCacheKey& out)
+        {
+            std::error_code ec;
+            const auto mtime = std::filesystem::last_write_time(sourcePath, ec);
+            if (ec) return false;
+            const auto size = std::filesystem::file_size(sourcePath, ec);
+            if (ec) return false;
+
+            out.sourcePath = sourcePath;
+            out.sourceMtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+            out.sourceSize = static_cast<uint64_t>(size);
+            out.importFlags = importFlags;
+            return true;
+        }
+
+
+        std::string GetCachePath(const std::string& sourcePath)
+        {
+            // FNV-1a of the path as given (the key check in Read catches the rare collision)
+            uint64_t hash = 14695981039346656037ull;
+            for (unsigned char c : sourcePath)
+                hash = (hash ^ c) * 1099511628211ull;
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.mesh", static_cast<unsigned long long>(hash));
+            return std::string("cache/meshes/") + name;
+        }
+
+
+        bool Write(const std::string& cachePath, const MeshCacheKey& key, const std::vector<MeshCacheMesh>& meshes)
+        {
+            std::vector<uint8_t> out;
+            BinaryWriter writer(out);
+            writer.Write(Header{ kMagic, kVersion, static_cast<uint32_t>(sizeof(Vertex)), key.importFlags, key.sourceMtime,
+                                 key.sourceSize, static_cast<uint32_t>(meshes.size()), static_cast<uint32_t>(key.sourcePath.size()) });
+            writer.Write(key.sourcePath.data(), key.sourcePath.size());
+            writer.Align(16);
+
+            // Records first (offsets patched below), then the blobs
+            const size_t recordsAt = out.size();
+            out.resize(recordsAt + meshes.size() * sizeof(MeshRecord));
+            for (size_t i = 0; i < meshes.size(); ++i)
+            {
+                const MeshCacheMesh& mesh = meshes[i];
+                MeshRecord record{ mesh.vertexCount, mesh.indexCount, 0, 0, 0, mesh.bounds, mesh.lodCount, 0, 0, mesh.lodIndexCount, 0, HashMesh(mesh) };
+
+                writer.Align(16);
+                record.vertexOffset = out.size();
+                writer.Write(mesh.vertices, size_t(mesh.vertexCount) * sizeof(Vertex));
+                writer.Align(16);
+                record.indexOffset = out.size();
+                writer.Write(mesh.indices, size_t(mesh.indexCount) * sizeof(uint32_t));
+                writer.Align(16);
+                record.positionOffset = out.size();
+                writer.Write(mesh.positions, size_t(mesh.vertexCount) * sizeof(DirectX::XMFLOAT3));
+                writer.Align(16);
+                record.lodOffset = out.size();
+                writer.Write(mesh.lods, size_t(mesh.lodCount) * sizeof(MeshLod));
+                writer.Align(16);
+                record.lodIndexOffset = out.size();
+                writer.Write(mesh.lodIndices, size_t(mesh.lodIndexCount) * sizeof(uint32_t));
+
+                std::memcpy(out.data() + recordsAt + i * sizeof(MeshRecord), &record, sizeof(record));
+            }
+
+            std::error_code ec;
+            const std::filesystem::path path(cachePath);
+            if (path.has_parent_path())
+                std::filesystem::create_directories(path.parent_path(), ec);
+
+            const std::string tempPath = cachePath + ".tmp";
+            std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+            if (!file)
+            {
+                std::fprintf(stderr, "MeshCache: cannot write %s\n", tempPath.c_str());
+                return false;
+            }
+            const bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+            const bool closed = std::fclose(file) == 0;
+            if (!written || !closed)
+            {
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+
+            std::filesystem::rename(tempPath, path, ec);
+            if (ec)
+            {
+                std::fprintf(stderr, "MeshCache: cannot replace %s (%s)\n", cachePath.c_str(), ec.message().c_str());
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+            return true;
+        }
+
+
+        // True if [offset, offset + bytes) lies in the file and starts 16-byte aligned
+        static bool BlobInFile(uint64_t offset, uint64_t bytes, size_t size)
+        {
+            return offset % 16 == 0 && offset <= size && bytes <= size - offset;
+        }
+
+
+        bool Read(const uint8_t* data, size_t size, const MeshCacheKey& key, std::vector<MeshCacheMesh>& out)
+        {
+            out.clear();
+
+            BinaryReader reader(data, size);
+            Header header{};
+            if (!reader.Read(header) || header.magic != kMagic || header.version != kVersion ||
+                header.vertexStride != sizeof(Vertex) || header.importFlags != key.importFlags ||
+                header.sourceMtime != key.sourceMtime || header.sourceSize != key.sourceSize ||
+                header.pathLength != key.sourcePath.size())
+                return false;
+
+            std::string path;
+            path.resize(header.pathLength);
+            if (!reader.Read(path.data(), path.size()) || path != key.sourcePath || !reader.Align(16))
+                return false;
+
+            // Every mesh has a record here, so a damaged count cannot ask for more than the file holds
+            if (header.meshCount > (size - reader.Tell()) / sizeof(MeshRecord))
+                return false;
+            out.reserve(header.meshCount);
+            for (uint32_t i = 0; i < header.meshCount; ++i)
+            {
+                MeshRecord record{};
+                if (!reader.Read(record) ||
+                    !BlobInFile(record.vertexOffset, uint64_t(record.vertexCount) * sizeof(Vertex), size) ||
+                    !BlobInFile(record.indexOffset, uint64_t(record.indexCount) * sizeof(uint32_t), size) ||
+                    !BlobInFile(record.positionOffset, uint64_t(record.vertexCount) * sizeof(DirectX::XMFLOAT3), size) ||
+                    !BlobInFile(record.lodOffset, uint64_t(record.lodCount) * sizeof(MeshLod), size) ||
+                    !BlobInFile(record.lodIndexOffset, uint64_t(record.lodIndexCount) * sizeof(uint32_t), size))
+                {
+                    out.clear();
+                    return false;
+                }
+
+                MeshCacheMesh mesh;
+                mesh.vertices = reinterpret_cast<const Vertex*>(data + record.vertexOffset);
+                mesh.vertexCount = record.vertexCount;
+                mesh.indices = reinterpret_cast<const uint32_t*>(data + record.indexOffset);
+                mesh.indexCount = record.indexCount;
+                mesh.positions = reinterpret_cast<const DirectX::XMFLOAT3*>(data + record.positionOffset);
+                mesh.bounds = record.bounds;
+                mesh.lodIndices = reinterpret_cast<const uint32_t*>(data + record.lodIndexOffset);
+                mesh.lodIndexCount = record.lodIndexCount;
+                mesh.lods = reinterpret_cast<const MeshLod*>(data + record.lodOffset);
+                mesh.lodCount = record.lodCount;
+
+                // Damaged data never reaches the GPU: any mismatch makes the caller re-import and rewrite the file
+                bool valid = HashMesh(mesh) == record.contentHash &&
+                             IndicesInRange(mesh.indices, mesh.indexCount, mesh.vertexCount) &&
+                             IndicesInRange(mesh.lodIndices, mesh.lodIndexCount, mesh.vertexCount);
+                // LOD ranges are used as draw ranges as they are
+                for (uint32_t l = 0; valid && l < record.lodCount; ++l)
+                    valid = uint64_t(mesh.lods[l].firstIndex) + mesh.lods[l].indexCount <= record.lodIndexCount;
+                if (!valid)
+                {
+                    out.clear();
+                    return false;
+                }
+                out.push_back(mesh);
+            }
+            return true;
+        }
+    }
+}
@@ -1,5 +1,12 @@
 #include "Engine/MeshManager.h"
+#include "Engine/MappedFile.h"
+#include "Engine/MeshCache.h"
+#include "Engine/MeshOptimizer.h"
+#include "Engine/MeshSimplifier.h"
+#include "Engine/Profiler.h"
 #include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+#include <algorithm>
 #include <cmath>
 
 using Microsoft::WRL::ComPtr;
@@ -7,7 +14,7 @@ using namespace DirectX;
 
 namespace Engine
 {
-    int MeshManager::InitializeCube(ID3D11Device* device)
+    int MeshManager::InitializeCube(ID3D11Device* device, IRenderDevice& renderDevice)
     {
         const float s = 0.5f;
 		// 24 vertices (4 per face * 6 faces), with positions, normals, and UVs
@@ -60,139 +67,349 @@ namespace Engine
             indices.push_back(base + 0); indices.push_back(base + 3); indices.push_back(base + 2);
         }
 
-        // Create VB/IB through the common path (now always 32-bit index buffers)
-        return CreateMeshBuffersWithID(device, 101, vertices, indices);
+        // Create the mesh through the common path (arena ranges, 16-bit indices)
+        OptimizeMesh(vertices, indices);
+        return CreateMeshBuffersWithID(device, renderDevice, 101, vertices, indices);
     }
 
 
-    // Helper: Creates VB/IB for given data, stores MeshData, returns new ID
-    int MeshManager::CreateMeshBuffers(ID3D11Device* device,
+    // Helper: Uploads the given data into the arenas, stores MeshData, returns new ID
+    int MeshManager::CreateMeshBuffers(ID3D11Device* device, IRenderDevice& renderDevice,
                                        const std::vector<Vertex>& vertices,
                                        const std::vector<uint32_t>& indices)
     {
         if (vertices.empty() || indices.empty())
             return -1;
 
-        // VB
-        D3D11_BUFFER_DESC vbDesc{};
-        vbDesc.Usage = D3D11_USAGE_DEFAULT;
-        vbDesc.ByteWidth = static_cast<UINT>(vertices.size() * sizeof(Vertex));
-        vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        std::vector<uint32_t> lodIndices;
+        std::vector<MeshLod> lods;
+        BuildLods(vertices, indices, lodIndices, lods);
 
-        D3D11_SUBRESOURCE_DATA vbData{};
-        vbData.pSysMem = vertices.data();
+        std::vector<XMFLOAT3> positions;
+        const MeshCacheMesh mesh = DescribeMesh(vertices, indices, positions, &lodIndices, &lods);
+        return CreateMesh(device, renderDevice, m_nextMeshID, mesh);
+    }
 
-        ComPtr<ID3D11Buffer> vb;
-        HRESULT hr = device->CreateBuffer(&vbDesc, &vbData, vb.GetAddressOf());
-        if (FAILED(hr)) return -1;
 
-		// IB (always 32-bit indices to support large meshes)
-        ComPtr<ID3D11Buffer> ib;
-        {
-            D3D11_BUFFER_DESC ibDesc{};
-            ibDesc.Usage = D3D11_USAGE_DEFAULT;
-            ibDesc.ByteWidth = static_cast<UINT>(indices.size() * sizeof(uint32_t));
-            ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+    void MeshManager::OptimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                   VertexCacheStats* before, VertexCacheStats* after)
+    {
+        if (before) *before = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
 
-            D3D11_SUBRESOURCE_DATA ibData{};
-            ibData.pSysMem = indices.data();
+        // Cache order first, then cluster sorting for overdraw (bounded ACMR loss), then vertices in first-use order
+        std::vector<XMFLOAT3> positions;
+        positions.reserve(vertices.size());
+        for (const auto& v : vertices) positions.push_back(v.position);
 
-            hr = device->CreateBuffer(&ibDesc, &ibData, ib.GetAddressOf());
-            if (FAILED(hr)) return -1;
+        MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+        MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), positions.data(), positions.size());
+        MeshOptimizer::ReorderVertexFetch(vertices, indices);
+
+        if (after) *after = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+    }
+
+
+    void MeshManager::BuildLods(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                std::vector<uint32_t>& lodIndices, std::vector<MeshLod>& lods)
+    {
+        lodIndices.clear();
+        lods.clear();
+
+        std::vector<XMFLOAT3> positions;
+        positions.reserve(vertices.size());
+        for (const auto& v : vertices) positions.push_back(v.position);
+
+        // Each level simplifies the previous one; its error adds on top of the previous level's
+        std::vector<uint32_t> previous = indices;
+        std::vector<uint32_t> level;
+        float error = 0.0f;
+        while (lods.size() < MeshLodSelect::kMaxLods)
+        {
+            const size_t target = previous.size() / 6 * 3;
+            if (target < size_t(kMinLodTriangles) * 3 || error >= kMaxLodError)
+                break;
+
+            float levelError = 0.0f;
+            level.resize(previous.size());
+            const size_t count = MeshSimplifier::Simplify(level.data(), previous.data(), previous.size(),
+                                                          positions.data(), positions.size(), target, kMaxLodError - error, &levelError);
+
+            // Less than 20% fewer triangles is not worth a level (seams/borders left nothing more to collapse)
+            if (count == 0 || count * 5 > previous.size() * 4)
+                break;
+            level.resize(count);
+            MeshOptimizer::OptimizeVertexCache(level.data(), level.size(), vertices.size());
+
+            error += levelError;
+            lods.push_back(MeshLod{ static_cast<uint32_t>(lodIndices.size()), static_cast<uint32_t>(count), error });
+            lodIndices.insert(lodIndices.end(), level.begin(), level.end());
+            previous.swap(level);
         }
+    }
 
-        MeshData md{};
-        md.vb = vb;
-        md.ib = ib;
-        md.indexCount = static_cast<UINT>(indices.size());
-        md.stride = sizeof(Vertex);
-        md.idxFmt = DXGI_FORMAT_R32_UINT;   // enforce 32-bit index format
 
+    MeshCacheMesh MeshManager::DescribeMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                            std::vector<XMFLOAT3>& positions,
+                                            const std::vector<uint32_t>* lodIndices, const std::vector<MeshLod>* lods)
+    {
         // CPU-side caches for physics
-        md.positions.reserve(vertices.size());
-        for (const auto& v : vertices) md.positions.push_back(v.position);
+        positions.clear();
+        positions.reserve(vertices.size());
+        for (const auto& v : vertices) positions.push_back(v.position);
+
+        MeshCacheMesh mesh;
+        mesh.vertices = vertices.data();
+        mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+        mesh.indices = indices.data();
+        mesh.indexCount = static_cast<uint32_t>(indices.size());
+        mesh.positions = positions.data();
+        mesh.bounds = ComputeBounds(vertices);
+        if (lodIndices && lods && !lods->empty())
+        {
+            mesh.lodIndices = lodIndices->data();
+            mesh.lodIndexCount = static_cast<uint32_t>(lodIndices->size());
+            mesh.lods = lods->data();
+            mesh.lodCount = static_cast<uint32_t>(lods->size());
+        }
+        return mesh;
+    }
 
-        md.indices = indices;
 
-        const int id = m_nextMeshID++;
-        m_meshes.emplace(id, std::move(md));
-        return id;
+    // Octahedral mapping of a unit normal to [-1, 1]^2 (lower hemisphere folded over the diagonals)
+    static void EncodeOctahedral(const XMFLOAT3& n, int16_t out[2])
+    {
+        const float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+        float x = l1 > 0.0f ? n.x / l1 : 0.0f;
+        float y = l1 > 0.0f ? n.y / l1 : 0.0f;
+        if (n.z < 0.0f)
+        {
+            const float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = fx;
+            y = fy;
+        }
+        out[0] = static_cast<int16_t>(std::lround(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+        out[1] = static_cast<int16_t>(std::lround(std::clamp(y, -1.0f, 1.0f) * 32767.0f));
     }
 
-    int MeshManager::CreateMeshBuffersWithID(
-        ID3D11Device* device,
-        int forcedID,
-        const std::vector<Vertex>& vertices,
-        const std::vector<uint32_t>& indices)
+
+    bool MeshManager::CompactVertices(const MeshCacheMesh& mesh, std::vector<CompactVertex>& out, MeshDequantConstants& dequant)
     {
-        if (vertices.empty() || indices.empty())
-            return -1;
+        // unorm16 over the AABB: the error is half a step of the largest axis
+        const XMFLOAT3& c = mesh.bounds.center;
+        const XMFLOAT3& e = mesh.bounds.extents;
+        const float largest = std::max(e.x, std::max(e.y, e.z)) * 2.0f;
+        if (largest * 0.5f / 65535.0f > kMaxQuantizationError)
+            return false;
+
+        // Flat axes (planes) get a non-zero scale so the inverse stays finite
+        const XMFLOAT3 size(std::max(e.x * 2.0f, 1e-6f), std::max(e.y * 2.0f, 1e-6f), std::max(e.z * 2.0f, 1e-6f));
+        const XMFLOAT3 minCorner(c.x - e.x, c.y - e.y, c.z - e.z);
+        dequant = MeshDequantConstants{ XMFLOAT3(size.x / 65535.0f, size.y / 65535.0f, size.z / 65535.0f), 0.0f, minCorner, 0.0f };
+
+        auto quantize = [](float v, float origin, float extent) {
+            return static_cast<uint16_t>(std::lround(std::clamp((v - origin) / extent, 0.0f, 1.0f) * 65535.0f));
+        };
 
-        // Prevent accidental overwrite
-		if (m_meshes.find(forcedID) != m_meshes.end())
-            return -1;
+        out.resize(mesh.vertexCount);
+        for (uint32_t i = 0; i < mesh.vertexCount; ++i)
+        {
+            const Vertex& v = mesh.vertices[i];
+            CompactVertex& cv = out[i];
+            cv.position[0] = quantize(v.position.x, minCorner.x, size.x);
+            cv.position[1] = quantize(v.position.y, minCorner.y, size.y);
+            cv.position[2] = quantize(v.position.z, minCorner.z, size.z);
+            cv.position[3] = 0;
+            EncodeOctahedral(v.normal, cv.normal);
+            cv.texCoord[0] = PackedVector::XMConvertFloatToHalf(v.texCoord.x);
+            cv.texCoord[1] = PackedVector::XMConvertFloatToHalf(v.texCoord.y);
+        }
+        return true;
+    }
 
-        // --- VB ---
-        D3D11_BUFFER_DESC vbDesc{};
-        vbDesc.Usage = D3D11_USAGE_DEFAULT;
-        vbDesc.ByteWidth = UINT(vertices.size() * sizeof(Vertex));
-        vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 
-        D3D11_SUBRESOURCE_DATA vbData{};
-        vbData.pSysMem = vertices.data();
+    int MeshManager::CreateMesh(ID3D11Device* device, IRenderDevice& renderDevice, int id, const MeshCacheMesh& mesh, bool allowCompact)
+    {
+        if (mesh.vertexCount == 0 || mesh.indexCount == 0)
+            return -1;
+        if (m_meshes.count(id))
+            return id;
+
+        // Vertex format: compact when allowed and precise enough
+        MeshDequantConstants dequant{};
+        const bool compact = allowCompact && m_compactVertices && CompactVertices(mesh, m_compactScratch, dequant);
+        const void* vertexData = compact ? static_cast<const void*>(m_compactScratch.data()) : static_cast<const void*>(mesh.vertices);
+        const uint32_t stride = compact ? sizeof(CompactVertex) : sizeof(Vertex);
+
+        // Index size: 16-bit whenever every index fits (65535 stays free, it is the strip-cut value).
+        // The LOD indices follow the base ones, so the whole chain is one index range.
+        const bool index16 = mesh.vertexCount < 0xFFFF;
+        const uint32_t totalIndices = mesh.indexCount + mesh.lodIndexCount;
+        const void* indexData = mesh.indices;
+        if (index16)
+        {
+            m_indices16Scratch.assign(mesh.indices, mesh.indices + mesh.indexCount);
+            m_indices16Scratch.insert(m_indices16Scratch.end(), mesh.lodIndices, mesh.lodIndices + mesh.lodIndexCount);
+            indexData = m_indices16Scratch.data();
+        }
+        else if (mesh.lodIndexCount > 0)
+        {
+            m_indices32Scratch.assign(mesh.indices, mesh.indices + mesh.indexCount);
+            m_indices32Scratch.insert(m_indices32Scratch.end(), mesh.lodIndices, mesh.lodIndices + mesh.lodIndexCount);
+            indexData = m_indices32Scratch.data();
+        }
+        const UINT indexSize = index16 ? sizeof(uint16_t) : sizeof(uint32_t);
 
-        ComPtr<ID3D11Buffer> vb;
-        if (FAILED(device->CreateBuffer(&vbDesc, &vbData, vb.GetAddressOf())))
+        // Ranges in the shared arenas; indices stay mesh-relative (baseVertex is added at draw time)
+        GeometryArena& vertexArena = m_vertexArenas[static_cast<int>(compact ? VertexFormat::Compact : VertexFormat::Full)];
+        GeometryArena& indexArena = m_indexArenas[index16 ? 0 : 1];
+        uint32_t baseVertex = 0, startIndex = 0;
+        if (!vertexArena.Allocate(device, renderDevice, vertexData, mesh.vertexCount, baseVertex))
+            return -1;
+        if (!indexArena.Allocate(device, renderDevice, indexData, totalIndices, startIndex))
+        {
+            vertexArena.Free(baseVertex);
             return -1;
+        }
 
-        // --- IB ---
-        D3D11_BUFFER_DESC ibDesc{};
-        ibDesc.Usage = D3D11_USAGE_DEFAULT;
-        ibDesc.ByteWidth = UINT(indices.size() * sizeof(uint32_t));
-        ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+        // Dequantization constants never change: one immutable cbuffer per compact mesh, bound on mesh changes
+        ComPtr<ID3D11Buffer> dequantBuffer;
+        if (compact)
+        {
+            D3D11_BUFFER_DESC cbDesc{};
+            cbDesc.Usage = D3D11_USAGE_IMMUTABLE;
+            cbDesc.ByteWidth = sizeof(MeshDequantConstants);
+            cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
 
-        D3D11_SUBRESOURCE_DATA ibData{};
-        ibData.pSysMem = indices.data();
+            D3D11_SUBRESOURCE_DATA cbData{};
+            cbData.pSysMem = &dequant;
 
-        ComPtr<ID3D11Buffer> ib;
-        if (FAILED(device->CreateBuffer(&ibDesc, &ibData, ib.GetAddressOf())))
-            return -1;
+            if (FAILED(device->CreateBuffer(&cbDesc, &cbData, dequantBuffer.GetAddressOf())))
+            {
+                vertexArena.Free(baseVertex);
+                indexArena.Free(startIndex);
+                return -1;
+            }
+        }
 
         MeshData md{};
-        md.vb = vb;
-        md.ib = ib;
-        md.indexCount = UINT(indices.size());
-        md.stride = sizeof(Vertex);
-        md.idxFmt = DXGI_FORMAT_R32_UINT;
+        md.baseVertex = baseVertex;
+        md.vertexCount = mesh.vertexCount;
+        md.startIndex = startIndex;
+        md.indexCount = static_cast<UINT>(mesh.indexCount);
+        md.dequant = dequantBuffer;
+        md.index16 = index16;
+        md.format = compact ? VertexFormat::Compact : VertexFormat::Full;
+
+        // CPU-side caches for physics (straight copies; the source may be a mapped cache file)
+        md.positions.assign(mesh.positions, mesh.positions + mesh.vertexCount);
+        md.indices.assign(mesh.indices, mesh.indices + mesh.indexCount);
+        md.bounds = mesh.bounds;
+        for (uint32_t l = 0; l < mesh.lodCount; ++l)
+            md.lods.push_back(MeshLod{ mesh.indexCount + mesh.lods[l].firstIndex, mesh.lods[l].indexCount, mesh.lods[l].error });
+        md.lodIndexCount = mesh.lodIndexCount;
 
-        md.positions.reserve(vertices.size());
+        m_meshes.emplace(id, std::move(md));
+
+        m_memory.meshes += 1;
+        m_memory.compactMeshes += compact ? 1 : 0;
+        m_memory.index16Meshes += index16 ? 1 : 0;
+        m_memory.vertexBytes += uint64_t(mesh.vertexCount) * stride;
+        m_memory.indexBytes += uint64_t(totalIndices) * indexSize;
+        m_memory.uncompressedBytes += uint64_t(mesh.vertexCount) * sizeof(Vertex) + uint64_t(totalIndices) * sizeof(uint32_t);
+
+        // Keep auto IDs from colliding later
+        m_nextMeshID = std::max(m_nextMeshID, id + 1);
+        return id;
+    }
+
+    MeshBounds MeshManager::ComputeBounds(const std::vector<Vertex>& vertices)
+    {
+        MeshBounds b{};
+        if (vertices.empty()) return b;
+
+        XMVECTOR vMin = XMLoadFloat3(&vertices[0].position);
+        XMVECTOR vMax = vMin;
         for (const auto& v : vertices)
-            md.positions.push_back(v.position);
+        {
+            const XMVECTOR p = XMLoadFloat3(&v.position);
+            vMin = XMVectorMin(vMin, p);
+            vMax = XMVectorMax(vMax, p);
+        }
 
-        md.indices = indices;
+        const XMVECTOR center = XMVectorScale(XMVectorAdd(vMin, vMax), 0.5f);
+        XMStoreFloat3(&b.center, center);
+        XMStoreFloat3(&b.extents, XMVectorScale(XMVectorSubtract(vMax, vMin), 0.5f));
 
-        m_meshes.emplace(forcedID, std::move(md));
+        // Sphere around the AABB center: farthest vertex (tighter than the half diagonal)
+        XMVECTOR maxDistSq = XMVectorZero();
+        for (const auto& v : vertices)
+            maxDistSq = XMVectorMax(maxDistSq, XMVector3LengthSq(XMVectorSubtract(XMLoadFloat3(&v.position), center)));
+        b.radius = std::sqrt(XMVectorGetX(maxDistSq));
 
-        // Keep auto IDs from colliding later
-        m_nextMeshID = std::max(m_nextMeshID, forcedID + 1);
+        return b;
+    }
+
+
+    int MeshManager::CreateMeshBuffersWithID(
+        ID3D11Device* device,
+        IRenderDevice& renderDevice,
+        int forcedID,
+        const std::vector<Vertex>& vertices,
+        const std::vector<uint32_t>& indices)
+    {
+        if (vertices.empty() || indices.empty())
+            return -1;
 
-        return forcedID;
+        // Prevent accidental overwrite
+		if (m_meshes.find(forcedID) != m_meshes.end())
+            return -1;
+
+        // Full vertex layout: the skybox draws this cube with the uncompressed input layout
+        std::vector<XMFLOAT3> positions;
+        const MeshCacheMesh mesh = DescribeMesh(vertices, indices, positions);
+        return CreateMesh(device, renderDevice, forcedID, mesh, false);
     }
 
 
-    std::vector<int> MeshManager::LoadModel(ID3D11Device* device, const std::string& filename)
+    std::vector<int> MeshManager::LoadModel(ID3D11Device* device, IRenderDevice& renderDevice, const std::string& filename)
     {
+        ENGINE_PROFILE_FUNCTION();
         std::vector<int> meshIDs;
+        m_lastLoad = MeshLoadStats{};
 
-		Assimp::Importer importer;  // create an instance of the Importer class
-
-		// Set import flags
+		// Set import flags (part of the cache key: other flags produce other meshes)
         const unsigned int flags =
             aiProcess_Triangulate |
             aiProcess_FlipUVs |
             aiProcess_MakeLeftHanded |
             aiProcess_FlipWindingOrder;
 
+        // Warm path: a cooked file for this exact source (path, mtime, size, flags) is uploaded straight from the mapping
+        MeshCacheKey key;
+        const bool keyed = MeshCache::MakeKey(filename, flags, key);
+        const std::string cachePath = MeshCache::GetCachePath(filename);
+        if (keyed)
+        {
+            MappedFile file;
+            std::vector<MeshCacheMesh> cached;
+            if (file.Open(cachePath) && MeshCache::Read(file.GetData(), file.GetSize(), key, cached))
+            {
+                for (const MeshCacheMesh& mesh : cached)
+                {
+                    const int id = CreateMesh(device, renderDevice, m_nextMeshID, mesh);
+                    if (id == -1) continue;
+                    meshIDs.push_back(id);
+                    m_lastLoad.vertices += mesh.vertexCount;
+                    m_lastLoad.indices += mesh.indexCount;
+                }
+                m_lastLoad.fromCache = true;
+                return meshIDs;
+            }
+        }
+
+		Assimp::Importer importer;  // create an instance of the Importer class
+
 		// Read the file and obtain the scene object
 		// aiScene is the root object for the imported data
         const aiScene* scene = importer.ReadFile(filename, flags);
@@ -206,37 +423,79 @@ namespace Engine
         // The scene contains all the data, node is just to keep stuff organized (like relations between nodes).
 
 		// Process the root node recursively to extract meshes
-        ProcessNode(device, scene->mRootNode, scene, meshIDs);
+        std::vector<ImportedMesh> imported;
+        ProcessNode(scene->mRootNode, scene, imported);
+
+        // Reorder for the GPU before cooking, so cached loads get the optimized order for free
+        std::vector<MeshCacheMesh> meshes;
+        meshes.reserve(imported.size());
+        double acmrBefore = 0.0, acmrAfter = 0.0, atvrBefore = 0.0, atvrAfter = 0.0;
+        for (ImportedMesh& im : imported)
+        {
+            VertexCacheStats before, after;
+            OptimizeMesh(im.vertices, im.indices, &before, &after);
+            BuildLods(im.vertices, im.indices, im.lodIndices, im.lods);
+            const double triangles = double(im.indices.size() / 3);
+            acmrBefore += before.acmr * triangles;
+            acmrAfter += after.acmr * triangles;
+            atvrBefore += before.atvr * triangles;
+            atvrAfter += after.atvr * triangles;
+            meshes.push_back(DescribeMesh(im.vertices, im.indices, im.positions, &im.lodIndices, &im.lods));
+        }
+
+        // Cook for the next launch (a failed write only costs the next launch another import)
+        if (keyed && !meshes.empty())
+            MeshCache::Write(cachePath, key, meshes);
+
+        for (const MeshCacheMesh& mesh : meshes)
+        {
+            const int id = CreateMesh(device, renderDevice, m_nextMeshID, mesh);
+            if (id == -1) continue;
+            meshIDs.push_back(id);
+            m_lastLoad.vertices += mesh.vertexCount;
+            m_lastLoad.indices += mesh.indexCount;
+        }
         if (meshIDs.empty())
             std::fprintf(stderr, "Assimp: scene loaded but produced no meshes for '%s'\n", filename.c_str());
 
+        // Triangle-weighted over all parts
+        if (m_lastLoad.indices > 0)
+        {
+            const double triangles = double(m_lastLoad.indices / 3);
+            m_lastLoad.acmrBefore = float(acmrBefore / triangles);
+            m_lastLoad.acmrAfter = float(acmrAfter / triangles);
+            m_lastLoad.atvrBefore = float(atvrBefore / triangles);
+            m_lastLoad.atvrAfter = float(atvrAfter / triangles);
+        }
+
         return meshIDs;
     }
 
 
-    void MeshManager::ProcessNode(ID3D11Device* device, aiNode* node, const aiScene* scene, std::vector<int>& outMeshIDs)
+    void MeshManager::ProcessNode(aiNode* node, const aiScene* scene, std::vector<ImportedMesh>& out)
     {
         // Process all meshes at this node
         for (unsigned int i = 0; i < node->mNumMeshes; ++i)
         {   
 			// Get the mesh object from the scene
             aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            int id = ProcessMesh(device, mesh, scene);
-            if (id != -1)
-                outMeshIDs.push_back(id);
+            ImportedMesh im;
+            ProcessMesh(mesh, im);
+            if (!im.vertices.empty() && !im.indices.empty())
+                out.push_back(std::move(im));
         }
 
 		// Then recurse into children nodes
         for (unsigned int i = 0; i < node->mNumChildren; ++i)
         {
-            ProcessNode(device, node->mChildren[i], scene, outMeshIDs);
+            ProcessNode(node->mChildren[i], scene, out);
         }
     }
 
 
-    int MeshManager::ProcessMesh(ID3D11Device* device, aiMesh* mesh, const aiScene* /*scene*/)
+    void MeshManager::ProcessMesh(aiMesh* mesh, ImportedMesh& out)
     {
-        std::vector<Vertex> vertices;
+        std::vector<Vertex>& vertices = out.vertices;
 		vertices.reserve(mesh->mNumVertices);   // reserve space
 
         // Extract vertex data
@@ -275,7 +534,7 @@ namespace Engine
         }
 
         // Indices (triangulated)
-        std::vector<uint32_t> indices;
+        std::vector<uint32_t>& indices = out.indices;
         indices.reserve(mesh->mNumFaces * 3);
         for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
         {
@@ -287,22 +546,131 @@ namespace Engine
             }
         }
 
-        // Create buffers and store (always 32-bit indices)
-        return CreateMeshBuffers(device, vertices, indices);
     }
 
 
-    bool MeshManager::GetMesh(int meshID, MeshBuffers& out) const
+    bool MeshManager::GetMesh(int meshID, MeshBuffers& out, uint32_t lod) const
     {
         auto it = m_meshes.find(meshID);
         if (it == m_meshes.end()) return false;
 
         const MeshData& md = it->second;
-        out.vertexBuffer = md.vb.Get();
-        out.indexBuffer  = md.ib.Get();
+        const int vertexArena = static_cast<int>(md.format);
+        const int indexArena = md.index16 ? 0 : 1;
+        out.vertexBuffer = m_vertexArenas[vertexArena].GetBuffer();
+        out.indexBuffer  = m_indexArenas[indexArena].GetBuffer();
         out.indexCount   = md.indexCount;
-        out.stride       = md.stride;
-        out.indexFormat  = md.idxFmt;
+        out.startIndex   = md.startIndex;
+        out.baseVertex   = static_cast<INT>(md.baseVertex);
+        out.stride       = m_vertexArenas[vertexArena].GetElementSize();
+        out.indexFormat  = md.index16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+        out.vertexFormat = md.format;
+        out.geometry     = static_cast<uint32_t>(vertexArena * 2 + indexArena);
+        out.dequantBuffer = md.dequant.Get();
+
+        // Same vertices and arenas, another index range
+        if (lod > 0 && !md.lods.empty())
+        {
+            const MeshLod& level = md.lods[std::min<size_t>(lod, md.lods.size()) - 1];
+            out.indexCount = level.indexCount;
+            out.startIndex = md.startIndex + level.firstIndex;
+        }
+        return true;
+    }
+
+
+    uint32_t MeshManager::GetMeshLodCount(int meshID) const
+    {
+        auto it = m_meshes.find(meshID);
+        if (it == m_meshes.end()) return 0;
+        return static_cast<uint32_t>(it->second.lods.size());
+    }
+
+
+    bool MeshManager::ReleaseMesh(int meshID)
+    {
+        auto it = m_meshes.find(meshID);
+        if (it == m_meshes.end()) return false;
+
+        const MeshData& md = it->second;
+        GeometryArena& vertexArena = m_vertexArenas[static_cast<int>(md.format)];
+        GeometryArena& indexArena = m_indexArenas[md.index16 ? 0 : 1];
+        vertexArena.Free(md.baseVertex);
+        indexArena.Free(md.startIndex);
+
+        m_memory.meshes -= 1;
+        m_memory.compactMeshes -= md.format == VertexFormat::Compact ? 1 : 0;
+        m_memory.index16Meshes -= md.index16 ? 1 : 0;
+        m_memory.vertexBytes -= uint64_t(md.vertexCount) * vertexArena.GetElementSize();
+        const uint64_t totalIndices = uint64_t(md.indexCount) + md.lodIndexCount;
+        m_memory.indexBytes -= totalIndices * indexArena.GetElementSize();
+        m_memory.uncompressedBytes -= uint64_t(md.vertexCount) * sizeof(Vertex) + totalIndices * sizeof(uint32_t);
+
+        m_meshes.erase(it);
+        return true;
+    }
+
+
+    bool MeshManager::DefragmentGeometry(ID3D11Device* device, IRenderDevice& renderDevice)
+    {
+        ENGINE_PROFILE_FUNCTION();
+        bool ok = true;
+        std::vector<OffsetAllocator::Move> moves;
+        std::unordered_map<uint32_t, uint32_t> remap;
+
+        // Moves are keyed by old offset, which is unique within an arena
+        auto apply = [&](auto arenaOf, auto offsetOf)
+        {
+            remap.clear();
+            for (const OffsetAllocator::Move& move : moves)
+                remap.emplace(move.from, move.to);
+            for (auto& [id, md] : m_meshes)
+            {
+                if (!arenaOf(md)) continue;
+                auto moved = remap.find(offsetOf(md));
+                if (moved != remap.end()) offsetOf(md) = moved->second;
+            }
+        };
+
+        for (int a = 0; a < 2; ++a)
+        {
+            ok &= m_vertexArenas[a].Defragment(device, renderDevice, moves);
+            apply([a](const MeshData& md) { return static_cast<int>(md.format) == a; },
+                  [](MeshData& md) -> uint32_t& { return md.baseVertex; });
+
+            ok &= m_indexArenas[a].Defragment(device, renderDevice, moves);
+            apply([a](const MeshData& md) { return (md.index16 ? 0 : 1) == a; },
+                  [](MeshData& md) -> uint32_t& { return md.startIndex; });
+        }
+        return ok;
+    }
+
+
+    MeshArenaStats MeshManager::GetArenaStats() const
+    {
+        MeshArenaStats stats;
+        for (const GeometryArena* arenas : { m_vertexArenas, m_indexArenas })
+        {
+            for (int a = 0; a < 2; ++a)
+            {
+                const GeometryArena& arena = arenas[a];
+                const OffsetAllocator& alloc = arena.GetAllocator();
+                stats.capacityBytes += uint64_t(alloc.GetCapacity()) * arena.GetElementSize();
+                stats.usedBytes += uint64_t(alloc.GetUsed()) * arena.GetElementSize();
+                stats.freeRanges += alloc.GetFreeRangeCount();
+                stats.largestFreeBytes = std::max(stats.largestFreeBytes, uint64_t(alloc.GetLargestFreeRange()) * arena.GetElementSize());
+                stats.grows += arena.GetGrowCount();
+            }
+        }
+        return stats;
+    }
+
+
+    bool MeshManager::GetMeshBounds(int meshID, MeshBounds& out) const
+    {
+        auto it = m_meshes.find(meshID);
+        if (it == m_meshes.end()) return false;
+        out = it->second.bounds;
         return true;
     }
 
@@ -325,7 +693,7 @@ namespace Engine
     }
 
 
-    int MeshManager::CreateSphere(ID3D11Device* device, float radius, int slices, int stacks)
+    int MeshManager::CreateSphere(ID3D11Device* device, IRenderDevice& renderDevice, float radius, int slices, int stacks)
     {
         if (radius <= 0.0f || slices < 3 || stacks < 2) return -1;
 
@@ -382,11 +750,12 @@ namespace Engine
             }
         }
 
-        return CreateMeshBuffers(device, vertices, indices);
+        OptimizeMesh(vertices, indices);
+        return CreateMeshBuffers(device, renderDevice, vertices, indices);
     }
 
     
-    int MeshManager::CreateCapsule(ID3D11Device* device, float radius, float cylinderHeight, int slices, int stacks)
+    int MeshManager::CreateCapsule(ID3D11Device* device, IRenderDevice& renderDevice, float radius, float cylinderHeight, int slices, int stacks)
     {
         if (radius <= 0.0f || cylinderHeight < 0.0f || slices < 3 || stacks < 2) return -1;
 
@@ -506,6 +875,7 @@ namespace Engine
             }
         }
 
-        return CreateMeshBuffers(device, vertices, indices);
+        OptimizeMesh(vertices, indices);
+        return CreateMeshBuffers(device, renderDevice, vertices, indices);
     }
 }
\ No newline at end of file
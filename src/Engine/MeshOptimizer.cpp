@@ -0,0 +1,328 @@
+#include "Engine/MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace Engine
+{
+    namespace MeshOptimizer
+    {
+        // FIFO cache simulation: returns the number of misses of one triangle
+        struct FifoCache
+        {
+            explicit FifoCache(size_t vertexCount, uint32_t size) : timestamps(vertexCount, 0), cacheSize(size) {}
+
+            uint32_t Touch(uint32_t a, uint32_t b, uint32_t c)
+            {
+                uint32_t misses = 0;
+                for (uint32_t v : { a, b, c })
+                {
+                    // A vertex is in the cache if it was inserted less than cacheSize insertions ago
+                    if (timestamps[v] == 0 || time - timestamps[v] >= cacheSize)
+                    {
+                        timestamps[v] = ++time;
+                        ++misses;
+                    }
+                }
+                return misses;
+            }
+
+            // Empties the cache without touching every vertex
+            void Reset() { time += cacheSize; }
+
+            std::vector<uint32_t> timestamps;   // insertion time (1-based), 0 = never
+            uint32_t time = 0;
+            uint32_t cacheSize;
+        };
+
+
+        VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+        {
+            VertexCacheStats stats;
+            if (indexCount < 3 || vertexCount == 0) return stats;
+
+            FifoCache cache(vertexCount, cacheSize);
+            size_t transformed = 0;
+            for (size_t i = 0; i + 2 < indexCount; i += 3)
+                transformed += cache.Touch(indices[i], indices[i + 1], indices[i + 2]);
+
+            size_t unique = 0;
+            for (uint32_t t : cache.timestamps)
+                unique += t != 0 ? 1 : 0;
+
+            stats.acmr = float(transformed) / float(indexCount / 3);
+            stats.atvr = unique > 0 ? float(transformed) / float(unique) : 0.0f;
+            return stats;
+        }
+
+
+        // ---- Vertex cache (Forsyth) ----
+
+        static constexpr uint32_t kCacheSize = 32;          // modelled LRU cache
+        static constexpr float kLastTriangleScore = 0.75f;  // the last triangle's vertices are slightly penalized
+        static constexpr float kCacheDecayPower = 1.5f;
+        static constexpr float kValenceBoostScale = 2.0f;   // favours vertices with few triangles left (no orphans)
+        static constexpr float kValenceBoostPower = 0.5f;
+
+        static float ComputeVertexScore(int cachePosition, uint32_t remainingTriangles)
+        {
+            if (remainingTriangles == 0) return -1.0f;
+
+            float score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                if (cachePosition < 3)
+                    score = kLastTriangleScore;
+                else
+                    score = std::pow(1.0f - float(cachePosition - 3) / float(kCacheSize - 3), kCacheDecayPower);
+            }
+            return score + kValenceBoostScale * std::pow(float(remainingTriangles), -kValenceBoostPower);
+        }
+
+        // Scores for the common cases, indexed [cache position + 1][remaining triangles] (pow is the hot spot otherwise)
+        static constexpr uint32_t kScoreTableValence = 32;
+        struct ScoreTable
+        {
+            ScoreTable()
+            {
+                for (int p = -1; p < int(kCacheSize); ++p)
+                    for (uint32_t r = 0; r < kScoreTableValence; ++r)
+                        scores[p + 1][r] = ComputeVertexScore(p, r);
+            }
+            float scores[kCacheSize + 1][kScoreTableValence];
+        };
+
+        static float VertexScore(int cachePosition, uint32_t remainingTriangles)
+        {
+            static const ScoreTable s_table;
+            if (remainingTriangles < kScoreTableValence)
+                return s_table.scores[cachePosition + 1][remainingTriangles];
+            return ComputeVertexScore(cachePosition, remainingTriangles);
+        }
+
+
+        void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount)
+        {
+            const size_t triangleCount = indexCount / 3;
+            if (triangleCount == 0 || vertexCount == 0) return;
+
+            // Vertex -> triangles adjacency (CSR)
+            std::vector<uint32_t> offsets(vertexCount + 1, 0);
+            for (size_t i = 0; i < triangleCount * 3; ++i) ++offsets[indices[i] + 1];
+            for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+            std::vector<uint32_t> adjacency(triangleCount * 3);
+            {
+                std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                for (size_t t = 0; t < triangleCount; ++t)
+                    for (size_t k = 0; k < 3; ++k)
+                        adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+
+            std::vector<uint32_t> remaining(vertexCount);      // triangles not yet emitted per vertex
+            std::vector<float> vertexScore(vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v)
+            {
+                remaining[v] = offsets[v + 1] - offsets[v];
+                vertexScore[v] = VertexScore(-1, remaining[v]);
+            }
+
+            std::vector<float> triangleScore(triangleCount);
+            std::vector<uint8_t> emitted(triangleCount, 0);
+            for (size_t t = 0; t < triangleCount; ++t)
+                triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+            std::vector<uint32_t> output;
+            output.reserve(triangleCount * 3);
+
+            uint32_t cache[kCacheSize + 3];
+            uint32_t cacheCount = 0;
+            size_t scanPosition = 0;    // fallback scan for the next unemitted triangle
+
+            // Start with the best triangle overall
+            uint32_t best = 0;
+            for (size_t t = 1; t < triangleCount; ++t)
+                if (triangleScore[t] > triangleScore[best]) best = static_cast<uint32_t>(t);
+
+            for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+            {
+                if (best == UINT32_MAX)
+                {
+                    // Nothing adjacent to the cache left: next unemitted triangle in input order
+                    while (emitted[scanPosition]) ++scanPosition;
+                    best = static_cast<uint32_t>(scanPosition);
+                }
+
+                const uint32_t* tri = indices + size_t(best) * 3;
+                output.insert(output.end(), tri, tri + 3);
+                emitted[best] = 1;
+
+                // New LRU cache: the triangle's vertices in front, then the previous contents minus duplicates
+                uint32_t newCache[kCacheSize + 3];
+                uint32_t newCount = 0;
+                for (size_t k = 0; k < 3; ++k) newCache[newCount++] = tri[k];
+                for (uint32_t i = 0; i < cacheCount; ++i)
+                {
+                    const uint32_t v = cache[i];
+                    if (v != tri[0] && v != tri[1] && v != tri[2]) newCache[newCount++] = v;
+                }
+
+                // The emitted triangle leaves its vertices' adjacency lists
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const uint32_t v = tri[k];
+                    uint32_t* begin = adjacency.data() + offsets[v];
+                    uint32_t* end = begin + remaining[v];
+                    *std::find(begin, end, best) = end[-1];
+                    --remaining[v];
+                }
+
+                // Rescore the vertices that were or are in the cache and find the best adjacent triangle
+                for (uint32_t i = 0; i < newCount; ++i)
+                {
+                    const uint32_t v = newCache[i];
+                    const int position = i < kCacheSize ? int(i) : -1;
+                    const float score = VertexScore(position, remaining[v]);
+                    const float delta = score - vertexScore[v];
+                    vertexScore[v] = score;
+                    for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+                        triangleScore[adjacency[a]] += delta;
+                }
+
+                best = UINT32_MAX;
+                float bestScore = -1.0f;
+                for (uint32_t i = 0; i < newCount && i < kCacheSize; ++i)
+                {
+                    const uint32_t v = newCache[i];
+                    for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+                    {
+                        const uint32_t t = adjacency[a];
+                        if (triangleScore[t] > bestScore)
+                        {
+                            bestScore = triangleScore[t];
+                            best = t;
+                        }
+                    }
+                }
+
+                cacheCount = std::min(newCount, kCacheSize);
+                std::copy(newCache, newCache + cacheCount, cache);
+            }
+
+            std::copy(output.begin(), output.end(), indices);
+        }
+
+
+        // ---- Overdraw (Sander, Nehab, Barczak: "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw") ----
+
+        void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const XMFLOAT3* positions, size_t vertexCount, float threshold)
+        {
+            const size_t triangleCount = indexCount / 3;
+            if (triangleCount < 2 || vertexCount == 0) return;
+
+            // Hard boundaries: the (simulated) cache restarts, i.e. a triangle misses all three vertices
+            FifoCache cache(vertexCount, kAnalyzeCacheSize);
+            std::vector<uint32_t> clusters;
+            for (size_t t = 0; t < triangleCount; ++t)
+                if (cache.Touch(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]) == 3)
+                    clusters.push_back(static_cast<uint32_t>(t));
+            clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+            // Soft boundaries: split hard clusters further wherever the prefix ACMR stays within threshold of the cluster's
+            std::vector<uint32_t> split;
+            for (size_t c = 0; c + 1 < clusters.size(); ++c)
+            {
+                const uint32_t begin = clusters[c], end = clusters[c + 1];
+                cache.Reset();
+                uint32_t misses = 0;
+                for (uint32_t t = begin; t < end; ++t)
+                    misses += cache.Touch(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]);
+                const float limit = float(misses) / float(end - begin) * threshold;
+
+                split.push_back(begin);
+                cache.Reset();
+                uint32_t start = begin;
+                misses = 0;
+                for (uint32_t t = begin; t < end; ++t)
+                {
+                    misses += cache.Touch(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]);
+                    // Clusters below 8 triangles are not worth a boundary (sorting them gains nothing)
+                    if (t + 1 < end && t + 1 - start >= 8 && float(misses) / float(t + 1 - start) <= limit)
+                    {
+                        split.push_back(t + 1);
+                        start = t + 1;
+                        misses = 0;
+                        cache.Reset();
+                    }
+                }
+            }
+            split.push_back(static_cast<uint32_t>(triangleCount));
+
+            // Mesh centroid (area weighted)
+            XMVECTOR meshCentroid = XMVectorZero();
+            float meshArea = 0.0f;
+            for (size_t t = 0; t < triangleCount; ++t)
+            {
+                const XMVECTOR a = XMLoadFloat3(&positions[indices[t * 3]]);
+                const XMVECTOR b = XMLoadFloat3(&positions[indices[t * 3 + 1]]);
+                const XMVECTOR c = XMLoadFloat3(&positions[indices[t * 3 + 2]]);
+                const float area = XMVectorGetX(XMVector3Length(XMVector3Cross(XMVectorSubtract(b, a), XMVectorSubtract(c, a))));
+                meshCentroid = XMVectorAdd(meshCentroid, XMVectorScale(XMVectorAdd(XMVectorAdd(a, b), c), area / 3.0f));
+                meshArea += area;
+            }
+            if (meshArea > 0.0f) meshCentroid = XMVectorScale(meshCentroid, 1.0f / meshArea);
+
+            // Sort key: how much the cluster faces away from the mesh centre (outer surfaces drawn first occlude the rest)
+            struct ClusterKey { float key; uint32_t begin, end; };
+            std::vector<ClusterKey> keys;
+            keys.reserve(split.size());
+            for (size_t c = 0; c + 1 < split.size(); ++c)
+            {
+                XMVECTOR centroid = XMVectorZero(), normal = XMVectorZero();
+                float area = 0.0f;
+                for (uint32_t t = split[c]; t < split[c + 1]; ++t)
+                {
+                    const XMVECTOR a = XMLoadFloat3(&positions[indices[t * 3]]);
+                    const XMVECTOR b = XMLoadFloat3(&positions[indices[t * 3 + 1]]);
+                    const XMVECTOR cc = XMLoadFloat3(&positions[indices[t * 3 + 2]]);
+                    const XMVECTOR n = XMVector3Cross(XMVectorSubtract(b, a), XMVectorSubtract(cc, a));   // length = 2 * area
+                    const float w = XMVectorGetX(XMVector3Length(n));
+                    centroid = XMVectorAdd(centroid, XMVectorScale(XMVectorAdd(XMVectorAdd(a, b), cc), w / 3.0f));
+                    normal = XMVectorAdd(normal, n);
+                    area += w;
+                }
+                if (area > 0.0f) centroid = XMVectorScale(centroid, 1.0f / area);
+                const float key = XMVectorGetX(XMVector3Dot(XMVectorSubtract(centroid, meshCentroid), XMVector3Normalize(normal)));
+                keys.push_back({ std::isfinite(key) ? key : 0.0f, split[c], split[c + 1] });
+            }
+            if (keys.size() < 2) return;
+
+            std::stable_sort(keys.begin(), keys.end(), [](const ClusterKey& a, const ClusterKey& b) { return a.key > b.key; });
+
+            std::vector<uint32_t> output;
+            output.reserve(triangleCount * 3);
+            for (const ClusterKey& k : keys)
+                output.insert(output.end(), indices + size_t(k.begin) * 3, indices + size_t(k.end) * 3);
+            std::copy(output.begin(), output.end(), indices);
+        }
+
+
+        // ---- Vertex fetch ----
+
+        void BuildVertexFetchRemap(uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap)
+        {
+            remap.assign(vertexCount, UINT32_MAX);
+            uint32_t next = 0;
+            for (size_t i = 0; i < indexCount; ++i)
+            {
+                uint32_t& target = remap[indices[i]];
+                if (target == UINT32_MAX) target = next++;
+                indices[i] = target;
+            }
+
+            // Unreferenced vertices keep their relative order at the end
+            for (uint32_t& target : remap)
+                if (target == UINT32_MAX) target = next++;
+        }
+    }
+}
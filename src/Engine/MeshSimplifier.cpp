@@ -0,0 +1,444 @@
+#include "Engine/MeshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+using namespace DirectX;
+
+namespace Engine
+{
+    namespace MeshSimplifier
+    {
+        static constexpr uint32_t kNone = ~0u;
+        static constexpr uint32_t kMultiple = ~1u;
+
+        // Boundary edges weigh this much more than surface area, so outlines and seams move last
+        static constexpr float kEdgeWeight = 10.0f;
+
+        enum VertexKind : uint8_t { Manifold, Border, Seam, Locked, KindCount };
+
+        // kCanCollapse[from][to]: border and seam vertices only collapse onto their own kind (and only along the loop)
+        static constexpr bool kCanCollapse[KindCount][KindCount] =
+        {
+            { true,  true,  true,  true  },
+            { false, true,  false, false },
+            { false, false, true,  false },
+            { false, false, false, false },
+        };
+
+        // The edge also exists as the opposite half-edge (in position space), so it is visited twice
+        static constexpr bool kHasOpposite[KindCount][KindCount] =
+        {
+            { true,  true,  true,  true  },
+            { true,  false, true,  false },
+            { true,  true,  true,  true  },
+            { true,  false, true,  false },
+        };
+
+
+        struct Vec3
+        {
+            float x, y, z;
+            Vec3 operator-(const Vec3& o) const { return { x - o.x, y - o.y, z - o.z }; }
+        };
+
+        static Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+        static float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+        static float Normalize(Vec3& v)
+        {
+            const float length = std::sqrt(Dot(v, v));
+            if (length > 0.0f) { v.x /= length; v.y /= length; v.z /= length; }
+            return length;
+        }
+
+
+        // Sum of squared distances to weighted planes: v^T A v + 2 b.v + c (A symmetric, stored as 6 floats)
+        struct Quadric
+        {
+            float a00 = 0, a11 = 0, a22 = 0, a10 = 0, a20 = 0, a21 = 0;
+            float b0 = 0, b1 = 0, b2 = 0, c = 0;
+            float w = 0;
+
+            void AddPlane(const Vec3& n, float d, float weight)
+            {
+                a00 += n.x * n.x * weight; a11 += n.y * n.y * weight; a22 += n.z * n.z * weight;
+                a10 += n.y * n.x * weight; a20 += n.z * n.x * weight; a21 += n.z * n.y * weight;
+                b0 += n.x * d * weight; b1 += n.y * d * weight; b2 += n.z * d * weight;
+                c += d * d * weight;
+                w += weight;
+            }
+
+            void Add(const Quadric& q)
+            {
+                a00 += q.a00; a11 += q.a11; a22 += q.a22; a10 += q.a10; a20 += q.a20; a21 += q.a21;
+                b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c; w += q.w;
+            }
+
+            // Weighted mean squared distance of v to the planes
+            float Error(const Vec3& v) const
+            {
+                const float e = a00 * v.x * v.x + a11 * v.y * v.y + a22 * v.z * v.z +
+                                2.0f * (a10 * v.x * v.y + a20 * v.x * v.z + a21 * v.y * v.z) +
+                                2.0f * (b0 * v.x + b1 * v.y + b2 * v.z) + c;
+                return w > 0.0f ? std::fabs(e) / w : 0.0f;
+            }
+        };
+
+
+        // Triangles around each vertex as (next, prev) corners, i.e. the outgoing half-edge vertex -> next
+        struct Adjacency
+        {
+            struct Corner { uint32_t next, prev; };
+            std::vector<uint32_t> offsets;
+            std::vector<Corner> corners;
+
+            void Build(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+            {
+                offsets.assign(vertexCount + 1, 0);
+                for (size_t i = 0; i < indexCount; ++i)
+                    ++offsets[indices[i] + 1];
+                for (size_t v = 0; v < vertexCount; ++v)
+                    offsets[v + 1] += offsets[v];
+
+                corners.resize(indexCount);
+                std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indexCount; i += 3)
+                {
+                    const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+                    corners[cursor[a]++] = { b, c };
+                    corners[cursor[b]++] = { c, a };
+                    corners[cursor[c]++] = { a, b };
+                }
+            }
+
+            bool HasEdge(uint32_t from, uint32_t to) const
+            {
+                for (uint32_t i = offsets[from]; i < offsets[from + 1]; ++i)
+                    if (corners[i].next == to) return true;
+                return false;
+            }
+        };
+
+
+        struct Collapse
+        {
+            uint32_t v0, v1;        // v0 moves onto v1
+            bool bidirectional;     // v1 -> v0 is allowed too (ranked, cheaper direction kept)
+            float error;
+        };
+
+
+        // remap[v]: first vertex with the same position; wedge: circular list of the vertices sharing it
+        static void BuildPositionRemap(const XMFLOAT3* positions, size_t vertexCount, std::vector<uint32_t>& remap, std::vector<uint32_t>& wedge)
+        {
+            struct Key
+            {
+                uint32_t x, y, z;
+                bool operator==(const Key& o) const { return x == o.x && y == o.y && z == o.z; }
+            };
+            struct KeyHash
+            {
+                size_t operator()(const Key& k) const { return (size_t(k.x) * 73856093u) ^ (size_t(k.y) * 19349663u) ^ (size_t(k.z) * 83492791u); }
+            };
+            auto bits = [](float f) { f += 0.0f; uint32_t u; std::memcpy(&u, &f, sizeof(u)); return u; };  // -0 == +0
+
+            std::unordered_map<Key, uint32_t, KeyHash> first;
+            first.reserve(vertexCount);
+            remap.resize(vertexCount);
+            wedge.resize(vertexCount);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                const XMFLOAT3& p = positions[v];
+                const uint32_t r = first.emplace(Key{ bits(p.x), bits(p.y), bits(p.z) }, v).first->second;
+                remap[v] = r;
+                wedge[v] = v;
+                if (r != v)
+                {
+                    wedge[v] = wedge[r];
+                    wedge[r] = v;
+                }
+            }
+        }
+
+
+        // Kinds from the open half-edges of each vertex; loop[v] / loopback[v] = the open edge leaving / entering v
+        static void ClassifyVertices(const Adjacency& adj, const std::vector<uint32_t>& remap, const std::vector<uint32_t>& wedge,
+                                     std::vector<uint8_t>& kind, std::vector<uint32_t>& loop, std::vector<uint32_t>& loopback)
+        {
+            const size_t vertexCount = remap.size();
+            loop.assign(vertexCount, kNone);
+            loopback.assign(vertexCount, kNone);
+
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                for (uint32_t i = adj.offsets[v]; i < adj.offsets[v + 1]; ++i)
+                {
+                    const uint32_t target = adj.corners[i].next;
+                    if (adj.HasEdge(target, v)) continue;
+
+                    loop[v] = (loop[v] == kNone || loop[v] == target) ? target : kMultiple;
+                    loopback[target] = (loopback[target] == kNone || loopback[target] == v) ? v : kMultiple;
+                }
+            }
+
+            auto single = [](uint32_t e) { return e != kNone && e != kMultiple; };
+
+            kind.assign(vertexCount, Locked);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                if (remap[v] != v)
+                {
+                    kind[v] = kind[remap[v]];   // the first vertex of a position was classified already
+                    continue;
+                }
+
+                if (wedge[v] == v)
+                {
+                    if (loop[v] == kNone && loopback[v] == kNone)
+                        kind[v] = Manifold;
+                    else if (single(loop[v]) && single(loopback[v]))
+                        kind[v] = Border;
+                }
+                else if (wedge[wedge[v]] == v)
+                {
+                    // Two wedges whose open edges are twins in position space form a seam
+                    const uint32_t w = wedge[v];
+                    if (single(loop[v]) && single(loopback[v]) && single(loop[w]) && single(loopback[w]) &&
+                        remap[loop[v]] == remap[loopback[w]] && remap[loopback[v]] == remap[loop[w]])
+                        kind[v] = Seam;
+                }
+            }
+
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                if (kind[v] != Border && kind[v] != Seam)
+                    loop[v] = loopback[v] = kNone;
+            }
+        }
+
+
+        static void FillQuadrics(const uint32_t* indices, size_t indexCount, const std::vector<Vec3>& pos, const Adjacency& adj,
+                                 const std::vector<uint32_t>& remap, std::vector<Quadric>& quadrics)
+        {
+            for (size_t i = 0; i < indexCount; i += 3)
+            {
+                const uint32_t tri[3] = { indices[i], indices[i + 1], indices[i + 2] };
+                const Vec3& p0 = pos[tri[0]];
+
+                // Plane of the triangle, weighted by sqrt(area) so its units match the edge weights below
+                Vec3 normal = Cross(pos[tri[1]] - p0, pos[tri[2]] - p0);
+                const float area = Normalize(normal) * 0.5f;
+                if (area > 0.0f)
+                {
+                    Quadric q;
+                    q.AddPlane(normal, -Dot(normal, p0), std::sqrt(area));
+                    for (uint32_t v : tri)
+                        quadrics[remap[v]].Add(q);
+                }
+
+                // Open edges: plane through the edge, perpendicular to the triangle
+                for (int e = 0; e < 3; ++e)
+                {
+                    const uint32_t i0 = tri[e], i1 = tri[(e + 1) % 3], i2 = tri[(e + 2) % 3];
+                    if (adj.HasEdge(i1, i0)) continue;
+
+                    Vec3 edge = pos[i1] - pos[i0];
+                    const float length = Normalize(edge);
+                    const Vec3 p20 = pos[i2] - pos[i0];
+                    const float along = Dot(p20, edge);
+                    Vec3 perpendicular = { p20.x - edge.x * along, p20.y - edge.y * along, p20.z - edge.z * along };
+                    if (Normalize(perpendicular) == 0.0f || length == 0.0f) continue;
+
+                    Quadric q;
+                    q.AddPlane(perpendicular, -Dot(perpendicular, pos[i0]), length * kEdgeWeight);
+                    quadrics[remap[i0]].Add(q);
+                    quadrics[remap[i1]].Add(q);
+                }
+            }
+        }
+
+
+        // True if moving i0 onto i1 turns any remaining triangle around i0 upside down
+        static bool HasTriangleFlips(const Adjacency& adj, const std::vector<Vec3>& pos, const std::vector<uint32_t>& collapseRemap,
+                                     uint32_t i0, uint32_t i1)
+        {
+            const Vec3& v0 = pos[i0];
+            const Vec3& v1 = pos[i1];
+            for (uint32_t i = adj.offsets[i0]; i < adj.offsets[i0 + 1]; ++i)
+            {
+                const uint32_t a = collapseRemap[adj.corners[i].next];
+                const uint32_t b = collapseRemap[adj.corners[i].prev];
+
+                // Triangles on the collapsing edge disappear; ones collapsed earlier in this pass are gone already
+                if (a == i1 || b == i1 || a == b) continue;
+
+                const Vec3 eb = pos[b] - pos[a];
+                if (Dot(Cross(eb, v0 - pos[a]), Cross(eb, v1 - pos[a])) <= 0.0f)
+                    return true;
+            }
+            return false;
+        }
+
+
+        static void RemapEdgeLoops(std::vector<uint32_t>& loop, const std::vector<uint32_t>& collapseRemap)
+        {
+            for (uint32_t v = 0; v < loop.size(); ++v)
+            {
+                if (loop[v] == kNone) continue;
+                const uint32_t l = loop[v];
+                const uint32_t r = collapseRemap[l];
+
+                // v == r: the loop edge itself collapsed onto v, continue with the collapsed vertex's loop
+                loop[v] = (v == r) ? loop[l] : r;
+            }
+        }
+
+
+        size_t Simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                        const XMFLOAT3* positions, size_t vertexCount,
+                        size_t targetIndexCount, float targetError, float* resultError)
+        {
+            if (resultError) *resultError = 0.0f;
+            if (destination != indices)
+                std::memmove(destination, indices, indexCount * sizeof(uint32_t));
+            if (indexCount < 3 || vertexCount == 0 || targetIndexCount >= indexCount)
+                return indexCount;
+
+            // Work in a unit cube, so errors are relative to the mesh extent
+            Vec3 minP{ FLT_MAX, FLT_MAX, FLT_MAX }, maxP{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+            for (size_t v = 0; v < vertexCount; ++v)
+            {
+                minP = { std::min(minP.x, positions[v].x), std::min(minP.y, positions[v].y), std::min(minP.z, positions[v].z) };
+                maxP = { std::max(maxP.x, positions[v].x), std::max(maxP.y, positions[v].y), std::max(maxP.z, positions[v].z) };
+            }
+            const float extent = std::max({ maxP.x - minP.x, maxP.y - minP.y, maxP.z - minP.z });
+            const float scale = extent > 0.0f ? 1.0f / extent : 0.0f;
+            std::vector<Vec3> pos(vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v)
+                pos[v] = { (positions[v].x - minP.x) * scale, (positions[v].y - minP.y) * scale, (positions[v].z - minP.z) * scale };
+
+            std::vector<uint32_t> remap, wedge, loop, loopback;
+            BuildPositionRemap(positions, vertexCount, remap, wedge);
+
+            Adjacency adj;
+            adj.Build(destination, indexCount, vertexCount);
+
+            std::vector<uint8_t> kind;
+            ClassifyVertices(adj, remap, wedge, kind, loop, loopback);
+
+            std::vector<Quadric> quadrics(vertexCount);
+            FillQuadrics(destination, indexCount, pos, adj, remap, quadrics);
+
+            std::vector<Collapse> collapses;
+            std::vector<uint32_t> collapseRemap(vertexCount);
+            std::vector<uint8_t> collapseLocked(vertexCount);
+            const float errorLimit = targetError * targetError;
+            float maxError = 0.0f;
+            size_t count = indexCount;
+
+            // Each pass collapses a batch of independent edges, cheapest first
+            while (count > targetIndexCount)
+            {
+                adj.Build(destination, count, vertexCount);
+
+                collapses.clear();
+                for (size_t i = 0; i < count; i += 3)
+                {
+                    for (int e = 0; e < 3; ++e)
+                    {
+                        const uint32_t i0 = destination[i + e], i1 = destination[i + (e + 1) % 3];
+                        if (remap[i0] == remap[i1]) continue;
+
+                        const uint8_t k0 = kind[i0], k1 = kind[i1];
+                        if (k0 == k1 && (k0 == Border || k0 == Seam) && loop[i0] != i1) continue;
+
+                        if (kCanCollapse[k0][k1] && kCanCollapse[k1][k0])
+                        {
+                            // Both half-edges exist: keep one
+                            if (kHasOpposite[k0][k1] && remap[i1] > remap[i0]) continue;
+                            collapses.push_back({ i0, i1, true, 0.0f });
+                        }
+                        else if (kCanCollapse[k0][k1])
+                            collapses.push_back({ i0, i1, false, 0.0f });
+                        else if (kCanCollapse[k1][k0])
+                            collapses.push_back({ i1, i0, false, 0.0f });
+                    }
+                }
+                if (collapses.empty()) break;
+
+                for (Collapse& c : collapses)
+                {
+                    const float forward = quadrics[remap[c.v0]].Error(pos[c.v1]);
+                    const float backward = c.bidirectional ? quadrics[remap[c.v1]].Error(pos[c.v0]) : FLT_MAX;
+                    if (backward < forward) std::swap(c.v0, c.v1);
+                    c.error = std::min(forward, backward);
+                }
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+                // Many candidates get blocked by their neighbours, so allow some slack over the goal's error
+                const size_t triangleGoal = (count - targetIndexCount) / 3;
+                const size_t edgeGoal = triangleGoal / 2;
+                const float errorGoal = edgeGoal < collapses.size() ? 1.5f * collapses[edgeGoal].error : FLT_MAX;
+
+                std::iota(collapseRemap.begin(), collapseRemap.end(), 0u);
+                std::fill(collapseLocked.begin(), collapseLocked.end(), uint8_t(0));
+
+                size_t triangleCollapses = 0, edgeCollapses = 0;
+                for (const Collapse& c : collapses)
+                {
+                    if (c.error > errorLimit) break;
+                    if (triangleCollapses >= triangleGoal) break;
+                    if (c.error > errorGoal && triangleCollapses > triangleGoal / 10) break;
+
+                    const uint32_t r0 = remap[c.v0], r1 = remap[c.v1];
+                    if (collapseLocked[r0] || collapseLocked[r1]) continue;
+
+                    // The other side of a seam moves along with it, onto the matching wedge of the target
+                    uint32_t s0 = kNone, s1 = kNone;
+                    if (kind[c.v0] == Seam)
+                    {
+                        s0 = wedge[c.v0];
+                        s1 = loop[c.v0] == c.v1 ? loopback[s0] : loop[s0];
+                        if (s1 == kNone || s1 == kMultiple || remap[s1] != r1) continue;
+                    }
+
+                    if (HasTriangleFlips(adj, pos, collapseRemap, c.v0, c.v1)) continue;
+                    if (s0 != kNone && HasTriangleFlips(adj, pos, collapseRemap, s0, s1)) continue;
+
+                    quadrics[r1].Add(quadrics[r0]);
+                    collapseRemap[c.v0] = c.v1;
+                    if (s0 != kNone) collapseRemap[s0] = s1;
+
+                    collapseLocked[r0] = collapseLocked[r1] = 1;
+                    triangleCollapses += kind[c.v0] == Border ? 1 : 2;
+                    ++edgeCollapses;
+                    maxError = std::max(maxError, c.error);
+                }
+                if (edgeCollapses == 0) break;
+
+                RemapEdgeLoops(loop, collapseRemap);
+                RemapEdgeLoops(loopback, collapseRemap);
+
+                // Apply and drop the triangles that became degenerate
+                size_t write = 0;
+                for (size_t i = 0; i < count; i += 3)
+                {
+                    const uint32_t a = collapseRemap[destination[i]], b = collapseRemap[destination[i + 1]], c = collapseRemap[destination[i + 2]];
+                    if (a == b || a == c || b == c) continue;
+                    destination[write++] = a;
+                    destination[write++] = b;
+                    destination[write++] = c;
+                }
+                count = write;
+            }
+
+            if (resultError) *resultError = std::sqrt(maxError);
+            return count;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include "Engine/NameTable.h"
+#include <cstring>
+
+namespace Engine
+{
+    NameTable::NameTable()
+    {
+        // Handle 0: the empty string
+        m_entries.push_back(Entry{ Store(std::string_view()), 0 });
+        m_lookup.emplace(std::string_view(m_entries[0].data, 0), 0);
+    }
+
+
+    const char* NameTable::Store(std::string_view s)
+    {
+        const size_t bytes = s.size() + 1;
+
+        // Strings never straddle blocks; an oversized one gets a block of its own
+        if (m_blockCapacity - m_blockUsed < bytes)
+        {
+            const size_t blockSize = bytes > kBlockSize ? bytes : kBlockSize;
+            m_blocks.push_back(std::make_unique<char[]>(blockSize));
+            m_blockCapacity = blockSize;
+            m_blockUsed = 0;
+            m_arenaBytes += blockSize;
+        }
+
+        char* dst = m_blocks.back().get() + m_blockUsed;
+        if (!s.empty()) std::memcpy(dst, s.data(), s.size());
+        dst[s.size()] = '\0';
+        m_blockUsed += bytes;
+        return dst;
+    }
+
+
+    NameHandle NameTable::Intern(std::string_view s)
+    {
+        auto it = m_lookup.find(s);
+        if (it != m_lookup.end())
+            return it->second;
+
+        const char* stored = Store(s);
+        const NameHandle handle = static_cast<NameHandle>(m_entries.size());
+        m_entries.push_back(Entry{ stored, static_cast<uint32_t>(s.size()) });
+        m_lookup.emplace(std::string_view(stored, s.size()), handle);
+        return handle;
+    }
+
+
+    std::string_view NameTable::Resolve(NameHandle handle) const
+    {
+        const Entry& e = handle < m_entries.size() ? m_entries[handle] : m_entries[0];
+        return std::string_view(e.data, e.length);
+    }
+
+
+    const char* NameTable::CStr(NameHandle handle) const
+    {
+        return handle < m_entries.size() ? m_entries[handle].data : m_entries[0].data;
+    }
+
+
+    size_t NameTable::GetMemoryBytes() const
+    {
+        // unordered_map: one bucket pointer per bucket, one heap node (value + next + cached hash) per entry
+        const size_t nodeBytes = sizeof(std::pair<const std::string_view, NameHandle>) + 2 * sizeof(void*);
+        return m_arenaBytes + m_entries.capacity() * sizeof(Entry) +
+               m_lookup.bucket_count() * sizeof(void*) + m_lookup.size() * nodeBytes;
+    }
+
+
+    NameTable& GetNameTable()
+    {
+        static NameTable s_table;
+        return s_table;
+    }
+}
@@ -0,0 +1,174 @@
+#include "Engine/OffsetAllocator.h"
+#include <algorithm>
+#include <iterator>
+
+namespace Engine
+{
+    void OffsetAllocator::Initialize(uint32_t capacity)
+    {
+        m_freeByOffset.clear();
+        m_freeBySize.clear();
+        m_allocated.clear();
+        m_capacity = capacity;
+        m_used = 0;
+        if (capacity > 0)
+            InsertFree(0, capacity);
+    }
+
+
+    void OffsetAllocator::InsertFree(uint32_t offset, uint32_t size)
+    {
+        m_freeByOffset.emplace(offset, size);
+        m_freeBySize.emplace(size, offset);
+    }
+
+
+    void OffsetAllocator::EraseFree(std::map<uint32_t, uint32_t>::iterator it)
+    {
+        m_freeBySize.erase({ it->second, it->first });
+        m_freeByOffset.erase(it);
+    }
+
+
+    bool OffsetAllocator::Allocate(uint32_t size, Allocation& out)
+    {
+        if (size == 0) return false;
+
+        auto best = m_freeBySize.lower_bound({ size, 0u });
+        if (best == m_freeBySize.end()) return false;
+
+        const uint32_t rangeSize = best->first;
+        const uint32_t offset = best->second;
+        EraseFree(m_freeByOffset.find(offset));
+
+        // The remainder stays free behind the allocation
+        if (rangeSize > size)
+            InsertFree(offset + size, rangeSize - size);
+
+        m_allocated.emplace(offset, size);
+        m_used += size;
+        out.offset = offset;
+        out.size = size;
+        return true;
+    }
+
+
+    bool OffsetAllocator::Free(uint32_t offset)
+    {
+        auto alloc = m_allocated.find(offset);
+        if (alloc == m_allocated.end()) return false;
+
+        uint32_t start = offset;
+        uint32_t end = offset + alloc->second;
+        m_used -= alloc->second;
+        m_allocated.erase(alloc);
+
+        // Coalesce with the free neighbours on both sides
+        auto next = m_freeByOffset.lower_bound(offset);
+        if (next != m_freeByOffset.end() && next->first == end)
+        {
+            end += next->second;
+            auto after = std::next(next);
+            EraseFree(next);
+            next = after;
+        }
+        if (next != m_freeByOffset.begin())
+        {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == start)
+            {
+                start = prev->first;
+                EraseFree(prev);
+            }
+        }
+
+        InsertFree(start, end - start);
+        return true;
+    }
+
+
+    void OffsetAllocator::Grow(uint32_t newCapacity)
+    {
+        if (newCapacity <= m_capacity) return;
+
+        uint32_t start = m_capacity;
+        if (!m_freeByOffset.empty())
+        {
+            auto last = std::prev(m_freeByOffset.end());
+            if (last->first + last->second == m_capacity)
+            {
+                start = last->first;
+                EraseFree(last);
+            }
+        }
+
+        InsertFree(start, newCapacity - start);
+        m_capacity = newCapacity;
+    }
+
+
+    void OffsetAllocator::Defragment(std::vector<Move>& moves)
+    {
+        moves.clear();
+
+        // Walk allocations by offset and slide each one down to the end of the previous
+        m_sorted.assign(m_allocated.begin(), m_allocated.end());
+        std::sort(m_sorted.begin(), m_sorted.end());
+
+        m_allocated.clear();
+        uint32_t cursor = 0;
+        for (const auto& [offset, size] : m_sorted)
+        {
+            if (offset != cursor)
+                moves.push_back(Move{ offset, cursor, size });
+            m_allocated.emplace(cursor, size);
+            cursor += size;
+        }
+
+        m_freeByOffset.clear();
+        m_freeBySize.clear();
+        if (cursor < m_capacity)
+            InsertFree(cursor, m_capacity - cursor);
+    }
+
+
+    bool OffsetAllocator::Validate() const
+    {
+        if (m_freeByOffset.size() != m_freeBySize.size()) return false;
+
+        // Merge both range lists by offset; they must tile [0, capacity) without gaps or overlaps
+        std::vector<std::pair<uint32_t, uint32_t>> ranges(m_allocated.begin(), m_allocated.end());
+        std::sort(ranges.begin(), ranges.end());
+
+        uint64_t used = 0;
+        for (const auto& [offset, size] : ranges)
+            used += size;
+        if (used != m_used) return false;
+
+        auto freeIt = m_freeByOffset.begin();
+        size_t allocIndex = 0;
+        uint64_t cursor = 0;
+        bool lastWasFree = false;
+        while (freeIt != m_freeByOffset.end() || allocIndex < ranges.size())
+        {
+            const bool takeFree = allocIndex == ranges.size() ||
+                                  (freeIt != m_freeByOffset.end() && freeIt->first < ranges[allocIndex].first);
+            const uint32_t offset = takeFree ? freeIt->first : ranges[allocIndex].first;
+            const uint32_t size = takeFree ? freeIt->second : ranges[allocIndex].second;
+            if (offset != cursor || size == 0) return false;
+
+            if (takeFree)
+            {
+                if (lastWasFree || m_freeBySize.count({ size, offset }) == 0) return false;
+                ++freeIt;
+            }
+            else
+            {
+                ++allocIndex;
+            }
+            lastWasFree = takeFree;
+            cursor += size;
+        }
+        return cursor == m_capacity;
+    }
+}
@@ -1,8 +1,10 @@
 #include "Engine/PhysicsManager.h"
-#include <thread>
+#include <cmath>
+#include <algorithm>
 #include <DirectXMath.h>
 #include "Engine/Components.h"
 #include "Engine/MeshManager.h"
+#include "Engine/Profiler.h"
 
 // Jolt shapes for meshes
 #include <Jolt/Physics/Collision/Shape/MeshShape.h>
@@ -15,9 +17,62 @@
 
 using namespace JPH;
 
+void BodyActivationListenerImpl::Reset(JPH::uint maxBodies) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_awake.clear();
+    m_deactivated.clear();
+    m_slot.assign(maxBodies, kNotAwake);
+}
+
+
+void BodyActivationListenerImpl::OnBodyActivated(const BodyID& inBodyID, uint64) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint32 index = inBodyID.GetIndex();
+    if (index >= m_slot.size()) m_slot.resize(index + 1, kNotAwake);
+    if (m_slot[index] != kNotAwake) return;
+
+    m_slot[index] = static_cast<uint32>(m_awake.size());
+    m_awake.push_back(inBodyID);
+
+    // Woke up again before anyone saw it sleep
+    auto it = std::find(m_deactivated.begin(), m_deactivated.end(), inBodyID);
+    if (it != m_deactivated.end()) m_deactivated.erase(it);
+}
+
+
+void BodyActivationListenerImpl::OnBodyDeactivated(const BodyID& inBodyID, uint64) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint32 index = inBodyID.GetIndex();
+    if (index >= m_slot.size() || m_slot[index] == kNotAwake) return;
+
+    // Swap-remove from the dense array
+    const uint32 slot = m_slot[index];
+    const BodyID last = m_awake.back();
+    m_awake[slot] = last;
+    m_slot[last.GetIndex()] = slot;
+    m_awake.pop_back();
+    m_slot[index] = kNotAwake;
+
+    m_deactivated.push_back(inBodyID);
+}
+
+
+void BodyActivationListenerImpl::GetAwakeBodies(std::vector<BodyID>& outBodies) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    outBodies.assign(m_awake.begin(), m_awake.end());
+}
+
+
+void BodyActivationListenerImpl::TakeDeactivatedBodies(std::vector<BodyID>& outBodies) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    outBodies.swap(m_deactivated);
+    m_deactivated.clear();
+}
+
+
 namespace Engine {
 
-bool PhysicsManager::Initialize() {
+bool PhysicsManager::Initialize(JobSystem& jobSystem) {
     // Register allocator and factory/types
     RegisterDefaultAllocator();
     Factory::sInstance = new Factory();
@@ -27,11 +82,9 @@ bool PhysicsManager::Initialize() {
     const uint32_t tempSize = 128 * 1024 * 1024;
     m_tempAllocator = new TempAllocatorImpl(tempSize);
 
-    // Job system: use hardware_concurrency - 1 worker threads (minimum 1)
-	// here we are using the maximum number of cpu cores (at least 1 minumum) for physics minus one to leave one core free for the main thread
-    const uint32_t workerThreads = std::max(1u, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() - 1 : 1u);
-	// create the multi-threaded job system
-    m_jobSystem = new JobSystemThreadPool(cMaxPhysicsJobs, cMaxPhysicsBarriers, workerThreads);
+    // Job system: Jolt shares the engine worker threads (no second pool competing for the cores)
+    m_engineJobs = &jobSystem;
+    m_jobSystem = new JoltJobSystemAdapter(jobSystem, cMaxPhysicsJobs, cMaxPhysicsBarriers);
 
     // Layer helpers
     m_bpLayerInterface   = new BPLayerInterfaceImpl();
@@ -47,8 +100,8 @@ bool PhysicsManager::Initialize() {
     const uint32_t maxBodyPairs = 65536;
     const uint32_t maxContactConstraints = 65536;
 
-    // No activation listener for now
-    BodyActivationListener* activationListener = nullptr;
+    // Activation listener tracks awake bodies for the ECS sync
+    m_activationListener.Reset(maxBodies);
 
     // Settings (default is fine initially)
     PhysicsSettings settings;
@@ -66,8 +119,8 @@ bool PhysicsManager::Initialize() {
     // Optionally set gravity (default is (0, -9.81f, 0))
     m_physicsSystem->SetGravity(Vec3(0.0f, -9.81f, 0.0f));
 
-    // Activation listener can be set if needed later
-    m_physicsSystem->SetBodyActivationListener(activationListener);
+    // Activation listener: awake/asleep notifications drive the Play mode sync
+    m_physicsSystem->SetBodyActivationListener(&m_activationListener);
 
     return true;
 }
@@ -76,6 +129,8 @@ bool PhysicsManager::Initialize() {
 void PhysicsManager::Shutdown() {
     // Clear cached shapes before tearing down Jolt to avoid leaks / asserts
     m_meshShapeCache.clear();
+    m_pendingBodies.clear();
+    m_activationListener.Reset(0);
 
     // Destroy physics system and helpers in reverse order
     if (m_physicsSystem)      { delete m_physicsSystem;      m_physicsSystem = nullptr; }
@@ -83,6 +138,7 @@ void PhysicsManager::Shutdown() {
     if (m_objVsBpLayerFilter) { delete m_objVsBpLayerFilter; m_objVsBpLayerFilter = nullptr; }
     if (m_bpLayerInterface)   { delete m_bpLayerInterface;   m_bpLayerInterface = nullptr; }
     if (m_jobSystem)          { delete m_jobSystem;          m_jobSystem = nullptr; }
+    m_engineJobs = nullptr;
     if (m_tempAllocator)      { delete m_tempAllocator;      m_tempAllocator = nullptr; }
 
     // Unregister factory/types
@@ -93,13 +149,45 @@ void PhysicsManager::Shutdown() {
 }
 
 
-void PhysicsManager::Update(float deltaTime) {
+void PhysicsManager::SetFixedTimestep(float stepsPerSecond, int maxSubsteps) {
+    m_fixedDeltaTime = 1.0f / std::max(stepsPerSecond, 1.0f);
+    m_maxSubsteps = std::max(maxSubsteps, 1);
+    // Increase collision steps to reduce tunneling at higher speeds (at least one per 1/120 s)
+    m_collisionSteps = std::max(1, static_cast<int>(std::ceil(m_fixedDeltaTime * 120.0f - 1e-3f)));
+    m_accumulator = 0.0f;
+}
+
+
+int PhysicsManager::ConsumeSteps(float deltaTime) {
+    m_accumulator += std::max(deltaTime, 0.0f);
+
+    int steps = static_cast<int>(m_accumulator / m_fixedDeltaTime);
+    if (steps > m_maxSubsteps) {
+        // Spiral-of-death guard: keep only the leftover fraction, the rest of a long frame is dropped
+        steps = m_maxSubsteps;
+        m_accumulator = std::fmod(m_accumulator, m_fixedDeltaTime);
+    } else {
+        m_accumulator -= steps * m_fixedDeltaTime;
+    }
+    return steps;
+}
+
+
+void PhysicsManager::Step() {
     if (!m_physicsSystem) return;
+    ENGINE_PROFILE_FUNCTION();
+    m_physicsSystem->Update(m_fixedDeltaTime, m_collisionSteps, m_tempAllocator, m_jobSystem);
+}
+
 
-	// Clamp deltaTime to avoid large steps
-    float safeDT = std::min(deltaTime, 1.0f / 30.0f);
-    // Increase collision steps to reduce tunneling at higher speeds
-    m_physicsSystem->Update(safeDT, 4, m_tempAllocator, m_jobSystem);
+int PhysicsManager::Update(float deltaTime) {
+    if (!m_physicsSystem) return 0;
+    ENGINE_PROFILE_FUNCTION();
+
+    const int steps = ConsumeSteps(deltaTime);
+    for (int i = 0; i < steps; ++i)
+        Step();
+    return steps;
 }
 
 
@@ -108,6 +196,30 @@ JPH::BodyInterface& PhysicsManager::GetBodyInterface() {
 }
 
 
+// Body user data holds the owning entity (see CreateRigidBody)
+static inline entt::entity EntityFromUserData(JPH::uint64 userData)
+{
+    return static_cast<entt::entity>(static_cast<entt::id_type>(userData));
+}
+
+// Guards against stale bodies: the entity must be alive and still own exactly this body
+static bool OwnsBody(const entt::registry& registry, entt::entity ent, JPH::BodyID bodyID)
+{
+    if (!registry.valid(ent)) return false;
+    const Engine::RigidBodyComponent* rb = registry.try_get<Engine::RigidBodyComponent>(ent);
+    return rb && rb->bodyID == bodyID;
+}
+
+
+entt::entity PhysicsManager::GetBodyEntity(JPH::BodyID bodyID)
+{
+    if (!m_physicsSystem || bodyID.IsInvalid())
+        return entt::null;
+
+    return EntityFromUserData(m_physicsSystem->GetBodyInterface().GetUserData(bodyID));
+}
+
+
 entt::entity PhysicsManager::CastRay(const Engine::Math::Ray& ray, entt::registry& registry)
 {
     if (!m_physicsSystem)
@@ -123,20 +235,46 @@ entt::entity PhysicsManager::CastRay(const Engine::Math::Ray& ray, entt::registr
 	// Perform raycast against the physics world
     if (m_physicsSystem->GetNarrowPhaseQuery().CastRay(joltRay, hit))
     {
-        JPH::BodyID hitID = hit.mBodyID;
+        // Resolve the owner from user data, guarding against stale bodies of destroyed entities
+        const entt::entity ent = GetBodyEntity(hit.mBodyID);
+        if (OwnsBody(registry, ent, hit.mBodyID))
+            return ent;
+    }
+
+    return entt::null;
+}
+
 
-		// Iterate through entities with RigidBodyComponent to find matching BodyID
-        auto view = registry.view<Engine::RigidBodyComponent>();
-        for (auto ent : view)
+void PhysicsManager::CastRays(const std::vector<Engine::Math::Ray>& rays, const entt::registry& registry, std::vector<RayHit>& outHits, float maxDistance)
+{
+    outHits.assign(rays.size(), RayHit{});
+    if (!m_physicsSystem || rays.empty())
+        return;
+
+    const NarrowPhaseQuery& query = m_physicsSystem->GetNarrowPhaseQuery();
+    const BodyInterface& bi = m_physicsSystem->GetBodyInterface();
+
+    // Each chunk casts a contiguous range of rays and writes only its own slots of outHits
+    m_engineJobs->ParallelFor(static_cast<uint32_t>(rays.size()), 32, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; ++i)
         {
-            if (view.get<Engine::RigidBodyComponent>(ent).bodyID == hitID)
+            const Engine::Math::Ray& ray = rays[i];
+            const Vec3 direction(ray.direction.x, ray.direction.y, ray.direction.z);
+            RRayCast joltRay{ RVec3(ray.origin.x, ray.origin.y, ray.origin.z), direction * maxDistance };
+            RayCastResult hit;
+            if (query.CastRay(joltRay, hit))
             {
-                return ent; // Match found
+                // Same stale-body check as CastRay: a destroyed (or recycled) entity is never returned
+                const entt::entity ent = EntityFromUserData(bi.GetUserData(hit.mBodyID));
+                if (OwnsBody(registry, ent, hit.mBodyID))
+                {
+                    outHits[i].entity = ent;
+                    outHits[i].distance = hit.mFraction * maxDistance * direction.Length();
+                }
             }
         }
-    }
-
-    return entt::null;
+    });
 }
 
 
@@ -305,8 +443,9 @@ void PhysicsManager::ResetBodyTransform(const TransformComponent& tc, RigidBodyC
 
     if (scaleChanged) {
         // Fully rebuild the body to perfectly recalculate mass and inertia properties
+        const entt::entity entity = GetBodyEntity(rbc.bodyID);
         RemoveRigidBody(rbc.bodyID);
-        rbc.bodyID = CreateRigidBody(tc, rbc, meshManager);
+        rbc.bodyID = CreateRigidBody(entity, tc, rbc, meshManager);
         return; // CreateRigidBody automatically positions it, so we can exit early
     }
 
@@ -316,11 +455,11 @@ void PhysicsManager::ResetBodyTransform(const TransformComponent& tc, RigidBodyC
 }
 
 
-JPH::BodyID PhysicsManager::CreateRigidBody(const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager) {
-    if (!m_physicsSystem) return JPH::BodyID(); // invalid
+JPH::Body* PhysicsManager::CreateBody(entt::entity entity, const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager) {
+    if (!m_physicsSystem) return nullptr;
 
     JPH::ShapeRefC finalShape = CreatePhysicsShape(tc, rbc, meshManager);
-    if (!finalShape) return JPH::BodyID();
+    if (!finalShape) return nullptr;
 
     // Step 3: Instantiate Body
     BodyCreationSettings creation(
@@ -336,6 +475,9 @@ JPH::BodyID PhysicsManager::CreateRigidBody(const TransformComponent& tc, const
     creation.mRestitution = rbc.restitution;
     creation.mLinearDamping = rbc.linearDamping;
 
+    // Owning entity, so hits resolve without scanning the registry
+    creation.mUserData = static_cast<JPH::uint64>(entt::to_integral(entity));
+
     // Mass properties (only relevant for dynamic bodies)
     if (rbc.motionType == RBMotion::Dynamic) {
         // Let Jolt compute mass properties from the shape, then override mass
@@ -343,24 +485,63 @@ JPH::BodyID PhysicsManager::CreateRigidBody(const TransformComponent& tc, const
         creation.mMassPropertiesOverride.mMass = rbc.mass;
     }
 
-    BodyInterface& bi = m_physicsSystem->GetBodyInterface();
+	// Create body (not yet part of the broadphase)
+    return m_physicsSystem->GetBodyInterface().CreateBody(creation);
+}
+
 
-	// Create body
-    Body* body = bi.CreateBody(creation);
+JPH::BodyID PhysicsManager::CreateRigidBody(entt::entity entity, const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager) {
+    Body* body = CreateBody(entity, tc, rbc, meshManager);
     if (!body)
         return JPH::BodyID();
 
     // Add to world and activate
-    bi.AddBody(body->GetID(), EActivation::Activate);
+    m_physicsSystem->GetBodyInterface().AddBody(body->GetID(), EActivation::Activate);
+
+    return body->GetID();
+}
+
+
+JPH::BodyID PhysicsManager::QueueRigidBody(entt::entity entity, const TransformComponent& tc, const RigidBodyComponent& rbc, const MeshManager& meshManager) {
+    Body* body = CreateBody(entity, tc, rbc, meshManager);
+    if (!body)
+        return JPH::BodyID();
 
+    m_pendingBodies.push_back(body->GetID());
     return body->GetID();
 }
 
 
+uint32_t PhysicsManager::FlushPendingBodies(bool optimizeBroadPhase) {
+    if (!m_physicsSystem || m_pendingBodies.empty()) return 0;
+    ENGINE_PROFILE_FUNCTION();
+
+    BodyInterface& bi = m_physicsSystem->GetBodyInterface();
+    const int count = static_cast<int>(m_pendingBodies.size());
+
+    // Prepare builds the broadphase nodes for the whole batch (no locks held), Finalize links them in one go
+    BodyInterface::AddState state = bi.AddBodiesPrepare(m_pendingBodies.data(), count);
+    bi.AddBodiesFinalize(m_pendingBodies.data(), count, state, EActivation::Activate);
+    m_pendingBodies.clear();
+
+    // Large batches leave an unbalanced tree; a rebuild makes subsequent queries and steps faster
+    if (optimizeBroadPhase)
+        m_physicsSystem->OptimizeBroadPhase();
+
+    return static_cast<uint32_t>(count);
+}
+
+
 void PhysicsManager::RemoveRigidBody(JPH::BodyID bodyID) {
     if (!m_physicsSystem || bodyID.IsInvalid()) return;
     BodyInterface& bi = m_physicsSystem->GetBodyInterface();
-    bi.RemoveBody(bodyID);
+
+    // A queued body that was never flushed is only destroyed
+    auto pending = std::find(m_pendingBodies.begin(), m_pendingBodies.end(), bodyID);
+    if (pending != m_pendingBodies.end())
+        m_pendingBodies.erase(pending);
+    else
+        bi.RemoveBody(bodyID);
     bi.DestroyBody(bodyID);
 }
 
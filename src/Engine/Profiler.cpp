@@ -0,0 +1,198 @@
+#include "Engine/Profiler.h"
+
+#ifdef ENGINE_ENABLE_PROFILER
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace Engine
+{
+    Profiler& Profiler::Get()
+    {
+        static Profiler s_profiler;
+        return s_profiler;
+    }
+
+
+    uint64_t Profiler::NowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+
+    Profiler::ThreadBuffer* Profiler::RegisterThread()
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        m_threads.push_back(std::make_unique<ThreadBuffer>());
+        ThreadBuffer* buffer = m_threads.back().get();
+        buffer->threadId = static_cast<uint32_t>(m_threads.size());
+        buffer->name = "Thread " + std::to_string(buffer->threadId);
+        return buffer;
+    }
+
+
+    void Profiler::SetThreadName(const char* name)
+    {
+        ThreadBuffer& buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        buffer.name = name;
+    }
+
+
+    void Profiler::BeginFrame()
+    {
+        m_frameStart[m_frameCount % kFrameHistory] = NowNs();
+        ++m_frameCount;
+    }
+
+
+    void Profiler::CopyEvents(const ThreadBuffer& b, std::vector<ProfileEvent>& out)
+    {
+        const uint64_t end = b.written.load(std::memory_order_acquire);
+        const uint64_t begin = end > ThreadBuffer::kCapacity ? end - ThreadBuffer::kCapacity : 0;
+
+        const size_t first = out.size();
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            const ThreadBuffer::Slot& slot = b.slots[i % ThreadBuffer::kCapacity];
+            out.push_back(ProfileEvent{ slot.name.load(std::memory_order_relaxed), slot.startNs.load(std::memory_order_relaxed),
+                                        slot.endNs.load(std::memory_order_relaxed), slot.depth.load(std::memory_order_relaxed) });
+        }
+
+        // The writer kept going while we copied: slots it reused (and the one it may be filling) are dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t now = b.written.load(std::memory_order_relaxed);
+        const uint64_t firstIntact = now >= ThreadBuffer::kCapacity ? now - ThreadBuffer::kCapacity + 1 : 0;
+        if (firstIntact > begin)
+        {
+            const size_t drop = static_cast<size_t>(std::min<uint64_t>(firstIntact - begin, end - begin));
+            out.erase(out.begin() + first, out.begin() + first + drop);
+        }
+    }
+
+
+    bool Profiler::GetFrame(ProfileFrame& out) const
+    {
+        if (m_frameCount < 2) return false;
+        out.startNs = m_frameStart[(m_frameCount - 2) % kFrameHistory];
+        out.endNs = m_frameStart[(m_frameCount - 1) % kFrameHistory];
+
+        // Each thread's events are copied into out's own vectors and trimmed to the frame there, so a caller that
+        // keeps its ProfileFrame reuses their capacity
+        size_t used = 0;
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (const auto& buffer : m_threads)
+        {
+            if (used == out.threads.size()) out.threads.emplace_back();
+            ProfileThreadEvents& thread = out.threads[used];
+            thread.events.clear();
+            CopyEvents(*buffer, thread.events);
+
+            const uint64_t startNs = out.startNs, endNs = out.endNs;
+            thread.events.erase(std::remove_if(thread.events.begin(), thread.events.end(),
+                [startNs, endNs](const ProfileEvent& e) { return e.endNs <= startNs || e.startNs >= endNs; }), thread.events.end());
+            if (thread.events.empty()) continue;
+
+            thread.threadName = buffer->name;
+            thread.threadId = buffer->threadId;
+            thread.maxDepth = 0;
+            for (const ProfileEvent& e : thread.events)
+                thread.maxDepth = std::max(thread.maxDepth, e.depth);
+            ++used;
+        }
+        out.threads.resize(used);
+        return true;
+    }
+
+
+    // Scope names are identifiers or literals; escape what JSON requires anyway
+    static void WriteJsonString(std::FILE* f, const char* s)
+    {
+        std::fputc('"', f);
+        for (; *s; ++s)
+        {
+            if (*s == '"' || *s == '\\') std::fputc('\\', f);
+            if (static_cast<unsigned char>(*s) >= 0x20) std::fputc(*s, f);
+        }
+        std::fputc('"', f);
+    }
+
+
+    bool Profiler::WriteChromeTrace(const std::string& path) const
+    {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f)
+        {
+            std::fprintf(stderr, "Profiler: cannot write %s\n", path.c_str());
+            return false;
+        }
+
+        std::fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        bool first = true;
+        std::vector<ProfileEvent> events;
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (const auto& buffer : m_threads)
+        {
+            std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", buffer->threadId);
+            WriteJsonString(f, buffer->name.c_str());
+            std::fprintf(f, "}}");
+            first = false;
+
+            // Complete events ("X"), microseconds since the profiler started
+            events.clear();
+            CopyEvents(*buffer, events);
+            for (const ProfileEvent& e : events)
+            {
+                std::fprintf(f, ",\n{\"name\":");
+                WriteJsonString(f, e.name);
+                std::fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer->threadId, double(e.startNs - m_originNs) / 1000.0, double(e.endNs - e.startNs) / 1000.0);
+            }
+        }
+        std::fprintf(f, "\n]}\n");
+
+        const bool ok = std::ferror(f) == 0;
+        std::fclose(f);
+        return ok;
+    }
+
+
+    uint64_t Profiler::GetEventCount() const
+    {
+        uint64_t total = 0;
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (const auto& buffer : m_threads)
+            total += buffer->written.load(std::memory_order_relaxed);
+        return total;
+    }
+
+
+    double Profiler::GetLastFrameMs() const
+    {
+        if (m_frameCount < 2) return 0.0;
+        const uint64_t start = m_frameStart[(m_frameCount - 2) % kFrameHistory];
+        const uint64_t end = m_frameStart[(m_frameCount - 1) % kFrameHistory];
+        return double(end - start) / 1e6;
+    }
+
+
+    double Profiler::GetScopeCostNs()
+    {
+        if (m_scopeCostNs < 0.0)
+        {
+            // Call at startup: the calibration events fill the calling thread's ring
+            constexpr int kSamples = 100000;
+            const uint64_t start = NowNs();
+            for (int i = 0; i < kSamples; ++i)
+            {
+                ENGINE_PROFILE_SCOPE("Profiler calibration");
+            }
+            m_scopeCostNs = double(NowNs() - start) / kSamples;
+        }
+        return m_scopeCostNs;
+    }
+}
+
+#endif
@@ -0,0 +1,390 @@
+#include "Engine/RenderDevice.h"
+#include <cstdarg>
+#include <cstring>
+
+using Microsoft::WRL::ComPtr;
+
+namespace Engine
+{
+    // ---------------------------------------------------------------- D3D11RenderDevice
+
+    bool D3D11RenderDevice::Initialize(ID3D11Device* device, ID3D11DeviceContext* context)
+    {
+        if (!device || !context) return false;
+        m_context = context;
+
+        // D3D11.1: constant buffer offsets + NO_OVERWRITE maps on dynamic constant buffers (optional)
+        m_constantOffsets = false;
+        if (SUCCEEDED(m_context.As(&m_context1)))
+        {
+            D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+            if (SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))))
+                m_constantOffsets = options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer;
+        }
+
+        // Event queries act as frame fences
+        D3D11_QUERY_DESC qd{};
+        qd.Query = D3D11_QUERY_EVENT;
+        for (auto& q : m_fenceQueries)
+        {
+            if (FAILED(device->CreateQuery(&qd, q.ReleaseAndGetAddressOf())))
+                return false;
+        }
+
+        m_submittedFence = m_completedFence = 0;
+        return true;
+    }
+
+
+    void D3D11RenderDevice::SetRenderTargets(ID3D11RenderTargetView* rtv, ID3D11DepthStencilView* dsv)
+    {
+        m_context->OMSetRenderTargets(rtv ? 1 : 0, rtv ? &rtv : nullptr, dsv);
+    }
+
+    void D3D11RenderDevice::ClearRenderTarget(ID3D11RenderTargetView* rtv, const float color[4])
+    {
+        m_context->ClearRenderTargetView(rtv, color);
+    }
+
+    void D3D11RenderDevice::ClearDepthStencil(ID3D11DepthStencilView* dsv)
+    {
+        m_context->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    }
+
+    void D3D11RenderDevice::SetViewport(const D3D11_VIEWPORT& viewport)
+    {
+        m_context->RSSetViewports(1, &viewport);
+    }
+
+    void D3D11RenderDevice::SetRasterizerState(ID3D11RasterizerState* state)
+    {
+        m_context->RSSetState(state);
+    }
+
+    void D3D11RenderDevice::SetDepthStencilState(ID3D11DepthStencilState* state)
+    {
+        m_context->OMSetDepthStencilState(state, 0);
+    }
+
+    void D3D11RenderDevice::SetShaders(ID3D11VertexShader* vs, ID3D11PixelShader* ps)
+    {
+        m_context->VSSetShader(vs, nullptr, 0);
+        m_context->PSSetShader(ps, nullptr, 0);
+    }
+
+    void D3D11RenderDevice::SetInputLayout(ID3D11InputLayout* layout)
+    {
+        m_context->IASetInputLayout(layout);
+    }
+
+    void D3D11RenderDevice::SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset)
+    {
+        m_context->IASetVertexBuffers(slot, 1, &buffer, &stride, &offset);
+    }
+
+    void D3D11RenderDevice::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format)
+    {
+        m_context->IASetIndexBuffer(buffer, format, 0);
+    }
+
+    void D3D11RenderDevice::SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+    {
+        m_context->IASetPrimitiveTopology(topology);
+    }
+
+    void D3D11RenderDevice::SetVSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* buffers)
+    {
+        m_context->VSSetConstantBuffers(startSlot, count, buffers);
+    }
+
+    void D3D11RenderDevice::SetPSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* buffers)
+    {
+        m_context->PSSetConstantBuffers(startSlot, count, buffers);
+    }
+
+    void D3D11RenderDevice::SetVSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants)
+    {
+        m_context1->VSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &numConstants);
+    }
+
+    void D3D11RenderDevice::SetPSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants)
+    {
+        m_context1->PSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &numConstants);
+    }
+
+    void D3D11RenderDevice::SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* srv)
+    {
+        m_context->PSSetShaderResources(slot, 1, &srv);
+    }
+
+    void D3D11RenderDevice::SetPSSampler(UINT slot, ID3D11SamplerState* sampler)
+    {
+        m_context->PSSetSamplers(slot, 1, &sampler);
+    }
+
+    void D3D11RenderDevice::UpdateBuffer(ID3D11Buffer* buffer, const void* data, UINT /*size*/)
+    {
+        m_context->UpdateSubresource(buffer, 0, nullptr, data, 0, 0);
+    }
+
+    bool D3D11RenderDevice::WriteBuffer(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size, D3D11_MAP mapType)
+    {
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        if (FAILED(m_context->Map(buffer, 0, mapType, 0, &mapped)))
+            return false;
+        std::memcpy(static_cast<uint8_t*>(mapped.pData) + offset, data, size);
+        m_context->Unmap(buffer, 0);
+        return true;
+    }
+
+    void D3D11RenderDevice::UpdateBufferRange(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size)
+    {
+        D3D11_BOX box{};
+        box.left = offset;
+        box.right = offset + size;
+        box.bottom = 1;
+        box.back = 1;
+        m_context->UpdateSubresource(buffer, 0, &box, data, 0, 0);
+    }
+
+    void D3D11RenderDevice::CopyBufferRegion(ID3D11Buffer* dst, UINT dstOffset, ID3D11Buffer* src, UINT srcOffset, UINT size)
+    {
+        D3D11_BOX box{};
+        box.left = srcOffset;
+        box.right = srcOffset + size;
+        box.bottom = 1;
+        box.back = 1;
+        m_context->CopySubresourceRegion(dst, 0, dstOffset, 0, 0, src, 0, &box);
+    }
+
+    void D3D11RenderDevice::DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex)
+    {
+        m_context->DrawIndexed(indexCount, startIndex, baseVertex);
+    }
+
+    void D3D11RenderDevice::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+    {
+        m_context->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+    }
+
+
+    uint64_t D3D11RenderDevice::SignalFence()
+    {
+        // All query slots busy: wait for the oldest frame before reusing its query
+        if (m_submittedFence - m_completedFence >= kFenceCount)
+        {
+            ID3D11Query* oldest = m_fenceQueries[(m_completedFence + 1) % kFenceCount].Get();
+            while (m_context->GetData(oldest, nullptr, 0, 0) == S_FALSE) {}
+            ++m_completedFence;
+        }
+
+        ++m_submittedFence;
+        m_context->End(m_fenceQueries[m_submittedFence % kFenceCount].Get());
+        return m_submittedFence;
+    }
+
+
+    uint64_t D3D11RenderDevice::GetCompletedFence()
+    {
+        // Non-blocking poll of finished frames (in order)
+        while (m_completedFence < m_submittedFence)
+        {
+            ID3D11Query* q = m_fenceQueries[(m_completedFence + 1) % kFenceCount].Get();
+            if (m_context->GetData(q, nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+                break;
+            ++m_completedFence;
+        }
+        return m_completedFence;
+    }
+
+
+    // ---------------------------------------------------------------- NullRenderDevice
+
+    void NullRenderDevice::Log(const char* fmt, ...)
+    {
+        if (!m_log) return;
+
+        va_list args;
+        va_start(args, fmt);
+        std::vfprintf(m_log, fmt, args);
+        va_end(args);
+        std::fputc('\n', m_log);
+    }
+
+    void NullRenderDevice::SetRenderTargets(ID3D11RenderTargetView* rtv, ID3D11DepthStencilView* dsv)
+    {
+        ++m_stats.stateBinds;
+        Log("SetRenderTargets rtv=%p dsv=%p", static_cast<void*>(rtv), static_cast<void*>(dsv));
+    }
+
+    void NullRenderDevice::ClearRenderTarget(ID3D11RenderTargetView* rtv, const float color[4])
+    {
+        ++m_stats.clears;
+        Log("ClearRenderTarget rtv=%p (%.2f %.2f %.2f %.2f)", static_cast<void*>(rtv), color[0], color[1], color[2], color[3]);
+    }
+
+    void NullRenderDevice::ClearDepthStencil(ID3D11DepthStencilView* dsv)
+    {
+        ++m_stats.clears;
+        Log("ClearDepthStencil dsv=%p", static_cast<void*>(dsv));
+    }
+
+    void NullRenderDevice::SetViewport(const D3D11_VIEWPORT& viewport)
+    {
+        ++m_stats.stateBinds;
+        Log("SetViewport %.0fx%.0f", viewport.Width, viewport.Height);
+    }
+
+    void NullRenderDevice::SetRasterizerState(ID3D11RasterizerState* state)
+    {
+        ++m_stats.stateBinds;
+        Log("SetRasterizerState %p", static_cast<void*>(state));
+    }
+
+    void NullRenderDevice::SetDepthStencilState(ID3D11DepthStencilState* state)
+    {
+        ++m_stats.stateBinds;
+        Log("SetDepthStencilState %p", static_cast<void*>(state));
+    }
+
+    void NullRenderDevice::SetShaders(ID3D11VertexShader* vs, ID3D11PixelShader* ps)
+    {
+        ++m_stats.shaderBinds;
+        Log("SetShaders vs=%p ps=%p", static_cast<void*>(vs), static_cast<void*>(ps));
+    }
+
+    void NullRenderDevice::SetInputLayout(ID3D11InputLayout* layout)
+    {
+        ++m_stats.layoutBinds;
+        Log("SetInputLayout %p", static_cast<void*>(layout));
+    }
+
+    void NullRenderDevice::SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset)
+    {
+        ++m_stats.vertexBufferBinds;
+        Log("SetVertexBuffer slot=%u %p stride=%u offset=%u", slot, static_cast<void*>(buffer), stride, offset);
+    }
+
+    void NullRenderDevice::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format)
+    {
+        ++m_stats.indexBufferBinds;
+        Log("SetIndexBuffer %p format=%d", static_cast<void*>(buffer), static_cast<int>(format));
+    }
+
+    void NullRenderDevice::SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+    {
+        ++m_stats.stateBinds;
+        Log("SetTopology %d", static_cast<int>(topology));
+    }
+
+    void NullRenderDevice::SetVSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* /*buffers*/)
+    {
+        m_stats.constantBufferBinds += count;
+        Log("SetVSConstantBuffers b%u x%u", startSlot, count);
+    }
+
+    void NullRenderDevice::SetPSConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* /*buffers*/)
+    {
+        m_stats.constantBufferBinds += count;
+        Log("SetPSConstantBuffers b%u x%u", startSlot, count);
+    }
+
+    void NullRenderDevice::SetVSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants)
+    {
+        ++m_stats.constantBufferBinds;
+        Log("SetVSConstantBufferRange b%u %p first=%u num=%u", slot, static_cast<void*>(buffer), firstConstant, numConstants);
+    }
+
+    void NullRenderDevice::SetPSConstantBufferRange(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants)
+    {
+        ++m_stats.constantBufferBinds;
+        Log("SetPSConstantBufferRange b%u %p first=%u num=%u", slot, static_cast<void*>(buffer), firstConstant, numConstants);
+    }
+
+    void NullRenderDevice::SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* srv)
+    {
+        ++m_stats.textureBinds;
+        Log("SetPSShaderResource t%u %p", slot, static_cast<void*>(srv));
+    }
+
+    void NullRenderDevice::SetPSSampler(UINT slot, ID3D11SamplerState* sampler)
+    {
+        ++m_stats.samplerBinds;
+        Log("SetPSSampler s%u %p", slot, static_cast<void*>(sampler));
+    }
+
+    void NullRenderDevice::UpdateBuffer(ID3D11Buffer* buffer, const void* data, UINT size)
+    {
+        ++m_stats.uploads;
+        m_stats.uploadBytes += size;
+
+        std::vector<uint8_t>& scratch = m_scratch[buffer];
+        if (scratch.size() < size) scratch.resize(size);
+        std::memcpy(scratch.data(), data, size);
+
+        Log("UpdateBuffer %p %u bytes", static_cast<void*>(buffer), size);
+    }
+
+    bool NullRenderDevice::WriteBuffer(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size, D3D11_MAP mapType)
+    {
+        ++m_stats.uploads;
+        m_stats.uploadBytes += size;
+        m_stats.discardWrites += mapType == D3D11_MAP_WRITE_DISCARD ? 1 : 0;
+
+        std::vector<uint8_t>& scratch = m_scratch[buffer];
+        if (scratch.size() < static_cast<size_t>(offset) + size) scratch.resize(static_cast<size_t>(offset) + size);
+        std::memcpy(scratch.data() + offset, data, size);
+
+        Log("WriteBuffer %p +%u %u bytes %s", static_cast<void*>(buffer), offset, size,
+            mapType == D3D11_MAP_WRITE_DISCARD ? "DISCARD" : "NO_OVERWRITE");
+        return true;
+    }
+
+    void NullRenderDevice::UpdateBufferRange(ID3D11Buffer* buffer, UINT offset, const void* data, UINT size)
+    {
+        ++m_stats.uploads;
+        m_stats.uploadBytes += size;
+
+        std::vector<uint8_t>& scratch = m_scratch[buffer];
+        if (scratch.size() < static_cast<size_t>(offset) + size) scratch.resize(static_cast<size_t>(offset) + size);
+        std::memcpy(scratch.data() + offset, data, size);
+
+        Log("UpdateBufferRange %p +%u %u bytes", static_cast<void*>(buffer), offset, size);
+    }
+
+    void NullRenderDevice::CopyBufferRegion(ID3D11Buffer* dst, UINT dstOffset, ID3D11Buffer* src, UINT srcOffset, UINT size)
+    {
+        ++m_stats.copies;
+        m_stats.copyBytes += size;
+
+        // Never-written source bytes read as zero (both references stay valid: map nodes do not move)
+        std::vector<uint8_t>& from = m_scratch[src];
+        std::vector<uint8_t>& to = m_scratch[dst];
+        if (from.size() < static_cast<size_t>(srcOffset) + size) from.resize(static_cast<size_t>(srcOffset) + size);
+        if (to.size() < static_cast<size_t>(dstOffset) + size) to.resize(static_cast<size_t>(dstOffset) + size);
+        std::memmove(to.data() + dstOffset, from.data() + srcOffset, size);
+
+        Log("CopyBufferRegion %p +%u <- %p +%u %u bytes", static_cast<void*>(dst), dstOffset, static_cast<void*>(src), srcOffset, size);
+    }
+
+    const std::vector<uint8_t>* NullRenderDevice::GetBufferContents(ID3D11Buffer* buffer) const
+    {
+        auto it = m_scratch.find(buffer);
+        return it != m_scratch.end() ? &it->second : nullptr;
+    }
+
+    void NullRenderDevice::DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex)
+    {
+        ++m_stats.draws;
+        m_stats.indices += indexCount;
+        Log("DrawIndexed %u start=%u base=%d", indexCount, startIndex, baseVertex);
+    }
+
+    void NullRenderDevice::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+    {
+        ++m_stats.draws;
+        ++m_stats.instancedDraws;
+        m_stats.indices += static_cast<uint64_t>(indexCount) * instanceCount;
+        Log("DrawIndexedInstanced %u x%u start=%u base=%d firstInstance=%u", indexCount, instanceCount, startIndex, baseVertex, startInstance);
+    }
+}
@@ -0,0 +1,209 @@
+#include "Engine/RenderQueue.h"
+#include <algorithm>
+
+namespace Engine
+{
+    uint64_t SortKey::Make(uint32_t shader, uint32_t layout, uint32_t texture, uint32_t mesh, float depth01)
+    {
+        // Quantize depth to the available bits (clamped so far/behind objects don't wrap)
+        const float d = std::clamp(depth01, 0.0f, 1.0f);
+        const uint32_t depthMax = (1u << kDepthBits) - 1u;
+        const uint64_t depth = static_cast<uint64_t>(d * static_cast<float>(depthMax));
+
+        auto pack = [](uint32_t value, uint32_t shift, uint32_t bits) {
+            return (static_cast<uint64_t>(value) & ((1ull << bits) - 1ull)) << shift;
+        };
+
+        return pack(shader, kShaderShift, kShaderBits) |
+               pack(layout, kLayoutShift, kLayoutBits) |
+               pack(texture, kTextureShift, kTextureBits) |
+               pack(mesh, kMeshShift, kMeshBits) |
+               (depth << kDepthShift);
+    }
+
+
+    void RenderQueue::Clear()
+    {
+        m_items.clear();
+        m_textureKeys.clear();
+        m_meshKeys.clear();
+        m_stats = RenderQueueStats{};
+    }
+
+
+    void RenderQueue::Submit(uint64_t key, uint32_t index)
+    {
+        m_items.push_back(DrawItem{ key, index });
+    }
+
+
+    uint32_t RenderQueue::GetTextureKey(const void* texture)
+    {
+        auto it = m_textureKeys.find(texture);
+        if (it != m_textureKeys.end()) return it->second;
+        if (m_textureKeys.size() >= SortKey::kTextureOverflow)
+        {
+            ++m_stats.keyOverflows;
+            return SortKey::kTextureOverflow;
+        }
+
+        const uint32_t key = static_cast<uint32_t>(m_textureKeys.size());
+        m_textureKeys.emplace(texture, key);
+        return key;
+    }
+
+
+    uint32_t RenderQueue::GetMeshKey(int meshID, uint32_t lod)
+    {
+        const uint64_t mesh = (uint64_t(static_cast<uint32_t>(meshID)) << 8) | (lod & 0xFFu);
+        auto it = m_meshKeys.find(mesh);
+        if (it != m_meshKeys.end()) return it->second;
+        if (m_meshKeys.size() >= SortKey::kMeshOverflow)
+        {
+            ++m_stats.keyOverflows;
+            return SortKey::kMeshOverflow;
+        }
+
+        const uint32_t key = static_cast<uint32_t>(m_meshKeys.size());
+        m_meshKeys.emplace(mesh, key);
+        return key;
+    }
+
+
+    void RenderQueue::Sort()
+    {
+        const size_t count = m_items.size();
+        if (count < 2) return;
+
+        // Small queues: a comparison sort beats 8 histogram passes
+        if (count < 64)
+        {
+            std::stable_sort(m_items.begin(), m_items.end(),
+                [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+            return;
+        }
+
+        // Build all 8 byte histograms in a single sweep
+        uint32_t histograms[8][256] = {};
+        for (const DrawItem& item : m_items)
+        {
+            for (uint32_t pass = 0; pass < 8; ++pass)
+                ++histograms[pass][(item.key >> (pass * 8)) & 0xFF];
+        }
+
+        m_scratch.resize(count);
+        DrawItem* src = m_items.data();
+        DrawItem* dst = m_scratch.data();
+
+        for (uint32_t pass = 0; pass < 8; ++pass)
+        {
+            uint32_t* hist = histograms[pass];
+
+            // Skip passes where every key shares the same byte (common for shader/layout bytes)
+            const uint32_t firstByte = static_cast<uint32_t>((src[0].key >> (pass * 8)) & 0xFF);
+            if (hist[firstByte] == count) continue;
+
+            // Exclusive prefix sum -> bucket offsets
+            uint32_t offset = 0;
+            for (uint32_t b = 0; b < 256; ++b)
+            {
+                const uint32_t c = hist[b];
+                hist[b] = offset;
+                offset += c;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t byte = static_cast<uint32_t>((src[i].key >> (pass * 8)) & 0xFF);
+                dst[hist[byte]++] = src[i];
+            }
+
+            std::swap(src, dst);
+        }
+
+        // Result lives in whichever buffer the last executed pass wrote
+        if (src != m_items.data())
+            std::copy(src, src + count, m_items.data());
+    }
+
+
+    void RenderQueue::ResetState()
+    {
+        m_boundShader = kUnbound;
+        m_boundLayout = kUnbound;
+        m_boundTexture = kUnbound;
+        m_boundMesh = kUnbound;
+        m_boundGeometry = kUnbound;
+        m_materialBound = false;
+    }
+
+
+    bool RenderQueue::ChangeShader(uint32_t shader)
+    {
+        if (m_boundShader == shader) return false;
+        m_boundShader = shader;
+        // Binding a shader program also binds its default input layout, so layout tracking is stale
+        m_boundLayout = kUnbound;
+        ++m_stats.shaderBinds;
+        return true;
+    }
+
+
+    bool RenderQueue::ChangeLayout(uint32_t layout)
+    {
+        if (m_boundLayout == layout) return false;
+        m_boundLayout = layout;
+        ++m_stats.layoutBinds;
+        return true;
+    }
+
+
+    bool RenderQueue::ChangeTexture(uint32_t texture)
+    {
+        if (texture == SortKey::kTextureOverflow)
+        {
+            m_boundTexture = kUnbound;
+            ++m_stats.textureBinds;
+            return true;
+        }
+        if (m_boundTexture == texture) return false;
+        m_boundTexture = texture;
+        ++m_stats.textureBinds;
+        return true;
+    }
+
+
+    bool RenderQueue::ChangeMesh(uint32_t mesh)
+    {
+        if (mesh == SortKey::kMeshOverflow)
+        {
+            m_boundMesh = kUnbound;
+            ++m_stats.meshBinds;
+            return true;
+        }
+        if (m_boundMesh == mesh) return false;
+        m_boundMesh = mesh;
+        ++m_stats.meshBinds;
+        return true;
+    }
+
+
+    bool RenderQueue::ChangeGeometry(uint32_t geometry)
+    {
+        if (m_boundGeometry == geometry) return false;
+        m_boundGeometry = geometry;
+        ++m_stats.geometryBinds;
+        return true;
+    }
+
+
+    bool RenderQueue::ChangeMaterial(float roughness, float metallic)
+    {
+        if (m_materialBound && m_boundRoughness == roughness && m_boundMetallic == metallic) return false;
+        m_materialBound = true;
+        m_boundRoughness = roughness;
+        m_boundMetallic = metallic;
+        ++m_stats.materialBinds;
+        return true;
+    }
+}
@@ -2,21 +2,36 @@
 #include "Engine/ShaderManager.h"
 #include "Engine/MeshManager.h"
 #include "Engine/Components.h" // for CameraComponent & TransformComponent
+#include "Engine/InstanceBatcher.h" // for InstanceData
 
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 
 namespace Engine
 {
-    bool Renderer::InitD3D11(HWND hwnd, unsigned width, unsigned height)
+    bool Renderer::InitD3D11(HWND hwnd, unsigned width, unsigned height, RenderBackend backend)
     {
         m_dx.width = width;
         m_dx.height = height;
+        m_backend = backend;
 
         // Create device, context, and swap chain
         if (!CreateDeviceAndSwapChain(hwnd))
             return false;
 
+        // Command layer on top of the context
+        if (m_backend == RenderBackend::Null)
+        {
+            m_device = std::make_unique<NullRenderDevice>();
+        }
+        else
+        {
+            auto d3dDevice = std::make_unique<D3D11RenderDevice>();
+            if (!d3dDevice->Initialize(m_dx.device.Get(), m_dx.context.Get()))
+                return false;
+            m_device = std::move(d3dDevice);
+        }
+
         // Create the render target view for the back buffer
         if (!CreateViews())
             return false;
@@ -44,11 +59,20 @@ namespace Engine
 
         m_cbLight.Reset();
         m_cbMaterial.Reset();
+        m_instanceBuffer.Reset();
+        m_instanceCapacity = 0;
+        m_lightBuffer = StructuredBuffer{};
+        m_lightIndexBuffer = StructuredBuffer{};
+        m_clusterRangeBuffer = StructuredBuffer{};
 
         m_cbWorld.Reset();
         m_cbView.Reset();
         m_cbProjection.Reset();
 
+        // constant ring
+        m_constantRing.Reset();
+        m_useConstantRing = false;
+
         // framebuffer state
         m_framebufferDSV.Reset();
         m_framebufferDepthTex.Reset();
@@ -58,6 +82,8 @@ namespace Engine
 
         ReleaseViews();
 
+        m_device.reset();
+
         m_dx.swapChain.Reset();
         m_dx.context.Reset();
         m_dx.device.Reset();
@@ -66,9 +92,12 @@ namespace Engine
 
     void Renderer::Present(bool vsync)
     {
-        // Present back buffer
-        if (m_dx.swapChain)
+        // Present back buffer (the null backend never submitted anything to show)
+        if (m_dx.swapChain && m_device && m_device->SubmitsWork())
             m_dx.swapChain->Present(vsync ? 1 : 0, 0);
+
+        // Frame boundary for the constant ring
+        AdvanceConstantRing();
     }
 
 
@@ -84,7 +113,7 @@ namespace Engine
         m_dx.height = height;
 
         // Unbind and release current views
-        m_dx.context->OMSetRenderTargets(0, nullptr, nullptr);
+        m_device->SetRenderTargets(nullptr, nullptr);
         ReleaseViews();
 
         // Resize the swap chain buffers
@@ -103,11 +132,11 @@ namespace Engine
     void Renderer::BeginFrame()
     {
         // Bind RTV/DSV and clear them
-        m_dx.context->OMSetRenderTargets(1, m_dx.rtv.GetAddressOf(), m_dx.dsv.Get());
+        m_device->SetRenderTargets(m_dx.rtv.Get(), m_dx.dsv.Get());
 
         const float clearColor[4] = { 0.10f, 0.18f, 0.28f, 1.0f };
-        m_dx.context->ClearRenderTargetView(m_dx.rtv.Get(), clearColor);
-        m_dx.context->ClearDepthStencilView(m_dx.dsv.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+        m_device->ClearRenderTarget(m_dx.rtv.Get(), clearColor);
+        m_device->ClearDepthStencil(m_dx.dsv.Get());
 
         // viewport
         D3D11_VIEWPORT vp{};
@@ -117,15 +146,17 @@ namespace Engine
         vp.Height   = static_cast<float>(m_dx.height);
         vp.MinDepth = 0.0f;
         vp.MaxDepth = 1.0f;
-        m_dx.context->RSSetViewports(1, &vp);
+        m_device->SetViewport(vp);
+        m_viewportWidth = static_cast<UINT>(vp.Width);
+        m_viewportHeight = static_cast<UINT>(vp.Height);
 
         // basic states
-        if (m_rasterState)       m_dx.context->RSSetState(m_rasterState.Get());
-        if (m_depthStencilState) m_dx.context->OMSetDepthStencilState(m_depthStencilState.Get(), 0);
+        if (m_rasterState)       m_device->SetRasterizerState(m_rasterState.Get());
+        if (m_depthStencilState) m_device->SetDepthStencilState(m_depthStencilState.Get());
 
         // Bind per-frame CBs (b0=Proj, b1=View, b2=World)
         ID3D11Buffer* vscbs[] = { m_cbProjection.Get(), m_cbView.Get(), m_cbWorld.Get() };
-        m_dx.context->VSSetConstantBuffers(0, 3, vscbs);
+        m_device->SetVSConstantBuffers(0, 3, vscbs);
     }
 
 
@@ -133,7 +164,7 @@ namespace Engine
     {
         XMFLOAT4X4 rm;
         XMStoreFloat4x4(&rm, m);
-        m_dx.context->UpdateSubresource(cb, 0, nullptr, &rm, 0, 0);
+        m_device->UpdateBuffer(cb, &rm, sizeof(rm));
     }
 
 
@@ -151,30 +182,124 @@ namespace Engine
 
     void Renderer::UpdateWorldMatrix(const XMMATRIX& world)
     {
-        if (m_cbWorld) UpdateMatrixCB(m_cbWorld.Get(), world);
+        if (m_useConstantRing)
+        {
+            XMFLOAT4X4 rm;
+            XMStoreFloat4x4(&rm, world);
+
+            UINT first = 0, num = 0;
+            if (WriteRingConstants(&rm, sizeof(rm), first, num))
+            {
+                // Bind the ring window to VS b2 (matches HLSL CB_Object : register(b2))
+                m_device->SetVSConstantBufferRange(2, m_constantRing.Get(), first, num);
+                return;
+            }
+        }
+
+        if (m_cbWorld)
+        {
+            UpdateMatrixCB(m_cbWorld.Get(), world);
+            // Rebind the fixed buffer in case a ring window was bound to b2
+            ID3D11Buffer* cbs[] = { m_cbWorld.Get() };
+            m_device->SetVSConstantBuffers(2, 1, cbs);
+        }
     }
 
 
     void Renderer::BindShader(const Engine::ShaderManager& shaderMan, int shaderID)
     {
-        shaderMan.Bind(shaderID, m_dx.context.Get());
+        shaderMan.Bind(shaderID, *m_device);
     }
 
 
     void Renderer::SubmitMesh(const Engine::MeshBuffers& mesh, ID3D11InputLayout* inputLayout)
     {
-        UINT stride = mesh.stride;
-        UINT offset = 0;
-        m_dx.context->IASetInputLayout(inputLayout);
-        m_dx.context->IASetVertexBuffers(0, 1, &mesh.vertexBuffer, &stride, &offset);
-        m_dx.context->IASetIndexBuffer(mesh.indexBuffer, mesh.indexFormat, 0);
-		m_dx.context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);    // specifies how to interpret vertex data; every 3 vertices form a triangle
+        BindInputLayout(inputLayout);
+        BindMeshBuffers(mesh);
+        BindMeshConstants(mesh);
     }
 
 
-    void Renderer::DrawIndexed(UINT indexCount)
+    void Renderer::BindInputLayout(ID3D11InputLayout* inputLayout)
     {
-        m_dx.context->DrawIndexed(indexCount, 0, 0);
+        m_device->SetInputLayout(inputLayout);
+    }
+
+
+    void Renderer::BindMeshBuffers(const Engine::MeshBuffers& mesh)
+    {
+        m_device->SetVertexBuffer(0, mesh.vertexBuffer, mesh.stride, 0);
+        m_device->SetIndexBuffer(mesh.indexBuffer, mesh.indexFormat);
+		m_device->SetTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);    // specifies how to interpret vertex data; every 3 vertices form a triangle
+    }
+
+
+    void Renderer::BindMeshConstants(const Engine::MeshBuffers& mesh)
+    {
+        // Compact meshes carry their own dequantization constants (VS b5)
+        if (mesh.dequantBuffer)
+        {
+            ID3D11Buffer* cbs[] = { mesh.dequantBuffer };
+            m_device->SetVSConstantBuffers(5, 1, cbs);
+        }
+    }
+
+
+    void Renderer::BindPSTexture(UINT slot, ID3D11ShaderResourceView* srv)
+    {
+        m_device->SetPSShaderResource(slot, srv);
+    }
+
+
+    void Renderer::BindPSSampler(UINT slot, ID3D11SamplerState* sampler)
+    {
+        m_device->SetPSSampler(slot, sampler);
+    }
+
+
+    void Renderer::DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex)
+    {
+        m_device->DrawIndexed(indexCount, startIndex, baseVertex);
+    }
+
+
+    bool Renderer::UploadInstanceData(const Engine::InstanceData* instances, UINT count)
+    {
+        if (count == 0) return true;
+
+        // Grow (power of two) so the buffer is recreated rarely
+        if (count > m_instanceCapacity)
+        {
+            UINT capacity = m_instanceCapacity ? m_instanceCapacity : 256u;
+            while (capacity < count) capacity *= 2;
+
+            D3D11_BUFFER_DESC desc{};
+            desc.Usage = D3D11_USAGE_DYNAMIC;
+            desc.ByteWidth = capacity * static_cast<UINT>(sizeof(Engine::InstanceData));
+            desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+            ComPtr<ID3D11Buffer> buf;
+            if (FAILED(m_dx.device->CreateBuffer(&desc, nullptr, buf.GetAddressOf())))
+                return false;
+
+            m_instanceBuffer = buf;
+            m_instanceCapacity = capacity;
+        }
+
+        // Whole-buffer rewrite once per frame: DISCARD lets the driver rename instead of stalling
+        if (!m_device->WriteBuffer(m_instanceBuffer.Get(), 0, instances, count * static_cast<UINT>(sizeof(Engine::InstanceData)), D3D11_MAP_WRITE_DISCARD))
+            return false;
+
+        // Slot 1 is ignored by non-instanced input layouts, so it can stay bound for the whole frame
+        m_device->SetVertexBuffer(1, m_instanceBuffer.Get(), sizeof(Engine::InstanceData), 0);
+        return true;
+    }
+
+
+    void Renderer::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startInstance, UINT startIndex, INT baseVertex)
+    {
+        m_device->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
     }
 
 
@@ -214,9 +339,12 @@ namespace Engine
         ComPtr<ID3D11DeviceContext> context;
         ComPtr<IDXGISwapChain> swapChain;
 
+        // Null backend: WARP (software) device so resources can be created on machines without a GPU
+        const D3D_DRIVER_TYPE driverType = (m_backend == RenderBackend::Null) ? D3D_DRIVER_TYPE_WARP : D3D_DRIVER_TYPE_HARDWARE;
+
         HRESULT hr = D3D11CreateDeviceAndSwapChain(
             nullptr,                        // Use default adapter
-            D3D_DRIVER_TYPE_HARDWARE,       // Hardware driver
+            driverType,                     // Hardware driver (WARP for the null backend)
             nullptr,                        // No software rasterizer
             createDeviceFlags,
             featureLevels,
@@ -301,27 +429,102 @@ namespace Engine
 
     void Renderer::UpdateLightConstants(const LightConstants& data)
     {
+        if (m_useConstantRing)
+        {
+            UINT first = 0, num = 0;
+            if (WriteRingConstants(&data, sizeof(data), first, num))
+            {
+                m_device->SetPSConstantBufferRange(3, m_constantRing.Get(), first, num);
+                return;
+            }
+        }
+
         if (m_cbLight)
         {
 			// Upload light data to GPU
-            m_dx.context->UpdateSubresource(m_cbLight.Get(), 0, nullptr, &data, 0, 0);
+            m_device->UpdateBuffer(m_cbLight.Get(), &data, sizeof(data));
             // Bind to PS at slot b3 (matches HLSL CB_Light : register(b3))
             ID3D11Buffer* cbs[] = { m_cbLight.Get() };
-            m_dx.context->PSSetConstantBuffers(3, 1, cbs);
+            m_device->SetPSConstantBuffers(3, 1, cbs);
         }
     }
 
     void Renderer::UpdateMaterialConstants(const MaterialConstants& material)
     {
+        if (m_useConstantRing)
+        {
+            UINT first = 0, num = 0;
+            if (WriteRingConstants(&material, sizeof(material), first, num))
+            {
+                m_device->SetPSConstantBufferRange(4, m_constantRing.Get(), first, num);
+                return;
+            }
+        }
+
         if (m_cbMaterial)
         {
-            m_dx.context->UpdateSubresource(m_cbMaterial.Get(), 0, nullptr, &material, 0, 0);
+            m_device->UpdateBuffer(m_cbMaterial.Get(), &material, sizeof(material));
             // Bind to PS at slot b4 (matches HLSL CB_Material : register(b4))
             ID3D11Buffer* cbs[] = { m_cbMaterial.Get() };
-            m_dx.context->PSSetConstantBuffers(4, 1, cbs);
+            m_device->SetPSConstantBuffers(4, 1, cbs);
         }
     }
 
+    bool Renderer::UpdateClusteredLights(const LightConstants& constants, const LightData* lights, UINT lightCount,
+                                         const uint32_t* indices, UINT indexCount, const uint32_t* clusterRanges, UINT clusterCount)
+    {
+        if (!UploadStructuredBuffer(m_lightBuffer, lights, sizeof(LightData), lightCount, 1)) return false;
+        if (!UploadStructuredBuffer(m_lightIndexBuffer, indices, sizeof(uint32_t), indexCount, 2)) return false;
+        if (!UploadStructuredBuffer(m_clusterRangeBuffer, clusterRanges, sizeof(uint32_t) * 2, clusterCount, 3)) return false;
+
+        UpdateLightConstants(constants);
+        return true;
+    }
+
+
+    bool Renderer::UploadStructuredBuffer(StructuredBuffer& sb, const void* data, UINT elementSize, UINT count, UINT slot)
+    {
+        // Grow (power of two, at least 1 element so the SRV is always valid)
+        if (count > sb.capacity || !sb.buffer)
+        {
+            UINT capacity = sb.capacity ? sb.capacity : 64u;
+            while (capacity < count) capacity *= 2;
+
+            D3D11_BUFFER_DESC desc{};
+            desc.Usage = D3D11_USAGE_DYNAMIC;
+            desc.ByteWidth = capacity * elementSize;
+            desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+            desc.StructureByteStride = elementSize;
+
+            ComPtr<ID3D11Buffer> buf;
+            if (FAILED(m_dx.device->CreateBuffer(&desc, nullptr, buf.GetAddressOf())))
+                return false;
+
+            D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+            srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+            srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+            srvDesc.Buffer.FirstElement = 0;
+            srvDesc.Buffer.NumElements = capacity;
+
+            ComPtr<ID3D11ShaderResourceView> srv;
+            if (FAILED(m_dx.device->CreateShaderResourceView(buf.Get(), &srvDesc, srv.GetAddressOf())))
+                return false;
+
+            sb.buffer = buf;
+            sb.srv = srv;
+            sb.capacity = capacity;
+        }
+
+        if (count > 0 && !m_device->WriteBuffer(sb.buffer.Get(), 0, data, count * elementSize, D3D11_MAP_WRITE_DISCARD))
+            return false;
+
+        m_device->SetPSShaderResource(slot, sb.srv.Get());
+        return true;
+    }
+
+
     bool Renderer::CreateInitialResources()
     {
         // Rasterizer state
@@ -410,9 +613,59 @@ namespace Engine
             if (FAILED(hr)) return false;
         }
 
+        // Optional: per-draw constants ring (falls back to the buffers above when unsupported)
+        m_useConstantRing = CreateConstantRing();
+
         return true;
     }
 
+
+    bool Renderer::CreateConstantRing()
+    {
+        // Needs CB offsets + NO_OVERWRITE maps on constant buffers (D3D11.1 options)
+        if (!m_device || !m_device->SupportsConstantOffsets())
+            return false;
+
+        D3D11_BUFFER_DESC desc{};
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.ByteWidth = kConstantRingSize;
+        desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        if (FAILED(m_dx.device->CreateBuffer(&desc, nullptr, m_constantRing.ReleaseAndGetAddressOf())))
+            return false;
+
+        // 256-byte alignment = 16 constants, the offset granularity of *SetConstantBuffers1
+        m_constantRingAlloc.Initialize(kConstantRingSize, 256, true);
+        return true;
+    }
+
+
+    bool Renderer::WriteRingConstants(const void* data, UINT size, UINT& outFirstConstant, UINT& outNumConstants)
+    {
+        RingAllocator::Allocation alloc{};
+        if (!m_constantRingAlloc.Allocate(size, alloc))
+            return false;
+
+        // NO_OVERWRITE: the range is known unused by the GPU. DISCARD: ring restarted, let the driver rename.
+        const D3D11_MAP mapType = alloc.discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+        if (!m_device->WriteBuffer(m_constantRing.Get(), alloc.offset, data, size, mapType))
+            return false;
+
+        outFirstConstant = alloc.offset / 16;
+        outNumConstants = alloc.size / 16;
+        return true;
+    }
+
+
+    void Renderer::AdvanceConstantRing()
+    {
+        if (!m_useConstantRing) return;
+
+        // Fence the frame just submitted, then free whatever the GPU has finished
+        m_constantRingAlloc.EndFrame(m_device->SignalFence());
+        m_constantRingAlloc.Retire(m_device->GetCompletedFence());
+    }
+
     bool Renderer::CreateFramebuffer(UINT width, UINT height)
     {
         // Track framebuffer size independently from the OS window (used by BindFramebuffer viewport)
@@ -481,7 +734,7 @@ namespace Engine
         if (!m_dx.context || !m_framebufferRTV || !m_framebufferDSV)
             return;
 
-        m_dx.context->OMSetRenderTargets(1, m_framebufferRTV.GetAddressOf(), m_framebufferDSV.Get());
+        m_device->SetRenderTargets(m_framebufferRTV.Get(), m_framebufferDSV.Get());
 
         // viewport (match framebuffer)
         D3D11_VIEWPORT vp{};
@@ -491,20 +744,22 @@ namespace Engine
         vp.Height   = static_cast<float>(m_framebufferHeight);
         vp.MinDepth = 0.0f;
         vp.MaxDepth = 1.0f;
-        m_dx.context->RSSetViewports(1, &vp);
+        m_device->SetViewport(vp);
+        m_viewportWidth = static_cast<UINT>(vp.Width);
+        m_viewportHeight = static_cast<UINT>(vp.Height);
 
         // clear to a dark grey editor background
         const float clearColor[4] = { 0.08f, 0.08f, 0.09f, 1.0f };
-        m_dx.context->ClearRenderTargetView(m_framebufferRTV.Get(), clearColor);
-        m_dx.context->ClearDepthStencilView(m_framebufferDSV.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+        m_device->ClearRenderTarget(m_framebufferRTV.Get(), clearColor);
+        m_device->ClearDepthStencil(m_framebufferDSV.Get());
 
         // keep states consistent with BeginFrame()
-        if (m_rasterState)       m_dx.context->RSSetState(m_rasterState.Get());
-        if (m_depthStencilState) m_dx.context->OMSetDepthStencilState(m_depthStencilState.Get(), 0);
+        if (m_rasterState)       m_device->SetRasterizerState(m_rasterState.Get());
+        if (m_depthStencilState) m_device->SetDepthStencilState(m_depthStencilState.Get());
 
         // Bind per-frame CBs (b0=Proj, b1=View, b2=World)
         ID3D11Buffer* vscbs[] = { m_cbProjection.Get(), m_cbView.Get(), m_cbWorld.Get() };
-        m_dx.context->VSSetConstantBuffers(0, 3, vscbs);
+        m_device->SetVSConstantBuffers(0, 3, vscbs);
     }
 
 
@@ -513,7 +768,7 @@ namespace Engine
         if (!m_dx.context || !m_dx.rtv || !m_dx.dsv)
             return;
 
-        m_dx.context->OMSetRenderTargets(1, m_dx.rtv.GetAddressOf(), m_dx.dsv.Get());
+        m_device->SetRenderTargets(m_dx.rtv.Get(), m_dx.dsv.Get());
 
         // viewport (match window)
         D3D11_VIEWPORT vp{};
@@ -523,20 +778,22 @@ namespace Engine
         vp.Height   = static_cast<float>(m_dx.height);
         vp.MinDepth = 0.0f;
         vp.MaxDepth = 1.0f;
-        m_dx.context->RSSetViewports(1, &vp);
+        m_device->SetViewport(vp);
+        m_viewportWidth = static_cast<UINT>(vp.Width);
+        m_viewportHeight = static_cast<UINT>(vp.Height);
 
         // clear main back buffer to pure black
         const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-        m_dx.context->ClearRenderTargetView(m_dx.rtv.Get(), clearColor);
-        m_dx.context->ClearDepthStencilView(m_dx.dsv.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+        m_device->ClearRenderTarget(m_dx.rtv.Get(), clearColor);
+        m_device->ClearDepthStencil(m_dx.dsv.Get());
 
         // keep states consistent with BeginFrame()
-        if (m_rasterState)       m_dx.context->RSSetState(m_rasterState.Get());
-        if (m_depthStencilState) m_dx.context->OMSetDepthStencilState(m_depthStencilState.Get(), 0);
+        if (m_rasterState)       m_device->SetRasterizerState(m_rasterState.Get());
+        if (m_depthStencilState) m_device->SetDepthStencilState(m_depthStencilState.Get());
 
         // Bind per-frame CBs (b0=Proj, b1=View, b2=World)
         ID3D11Buffer* vscbs[] = { m_cbProjection.Get(), m_cbView.Get(), m_cbWorld.Get() };
-        m_dx.context->VSSetConstantBuffers(0, 3, vscbs);
+        m_device->SetVSConstantBuffers(0, 3, vscbs);
     }
 
 
@@ -544,11 +801,9 @@ namespace Engine
     {
         if (!m_skyboxSRV) return;
 
-        auto* ctx = m_dx.context.Get();
-
         // States for skybox
-        if (m_skyboxDepthState) ctx->OMSetDepthStencilState(m_skyboxDepthState.Get(), 0);
-        if (m_skyboxRasterState) ctx->RSSetState(m_skyboxRasterState.Get());
+        if (m_skyboxDepthState) m_device->SetDepthStencilState(m_skyboxDepthState.Get());
+        if (m_skyboxRasterState) m_device->SetRasterizerState(m_skyboxRasterState.Get());
 
 		// Skybox world: identity (scaled to ensure it's not clipped by near plane)
         DirectX::XMMATRIX world = DirectX::XMMatrixScaling(50.0f, 50.0f, 50.0f);
@@ -569,13 +824,12 @@ namespace Engine
         UpdateProjectionMatrix(proj);
 
         // Bind skybox shaders (shaderID 2 reserved for skybox)
-        shaderMan.Bind(2, ctx);
+        shaderMan.Bind(2, *m_device);
 
         // Bind sampler and cubemap SRV
         ID3D11SamplerState* sampler = GetSamplerState();
-        if (sampler) ctx->PSSetSamplers(0, 1, &sampler);
-        ID3D11ShaderResourceView* srv = m_skyboxSRV.Get();
-        ctx->PSSetShaderResources(0, 1, &srv);
+        if (sampler) m_device->SetPSSampler(0, sampler);
+        m_device->SetPSShaderResource(0, m_skyboxSRV.Get());
 
         // Draw cube mesh (ID 101)
         Engine::MeshBuffers cube{};
@@ -583,14 +837,14 @@ namespace Engine
         {
             ID3D11InputLayout* layout = shaderMan.GetInputLayout(2);
             SubmitMesh(cube, layout);
-            DrawIndexed(cube.indexCount);
+            DrawIndexed(cube.indexCount, cube.startIndex, cube.baseVertex);
         }
         else {
 			throw std::runtime_error("Skybox cube mesh (ID 101) not found in MeshManager.");
         }
 
         // Restore default states (so subsequent draws aren't affected)
-        if (m_depthStencilState) ctx->OMSetDepthStencilState(m_depthStencilState.Get(), 0);
-        if (m_rasterState)       ctx->RSSetState(m_rasterState.Get());
+        if (m_depthStencilState) m_device->SetDepthStencilState(m_depthStencilState.Get());
+        if (m_rasterState)       m_device->SetRasterizerState(m_rasterState.Get());
     }
 }
\ No newline at end of file
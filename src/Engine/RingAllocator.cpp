@@ -0,0 +1,92 @@
+#include "Engine/RingAllocator.h"
+
+namespace Engine
+{
+    void RingAllocator::Initialize(uint32_t capacity, uint32_t alignment, bool allowDiscard)
+    {
+        m_alignment = alignment ? alignment : 1u;
+        m_capacity = capacity & ~(m_alignment - 1);
+        m_allowDiscard = allowDiscard;
+
+        m_frames.clear();
+        m_head = m_tail = m_used = m_frameBytes = 0;
+        m_needsDiscard = true;
+        m_discards = 0;
+    }
+
+
+    bool RingAllocator::Allocate(uint32_t size, Allocation& out)
+    {
+        const uint32_t aligned = AlignUp(size ? size : 1u, m_alignment);
+        if (aligned > m_capacity) return false;
+
+        // Everything retired: restart at the front for the largest contiguous run
+        if (m_used == 0)
+            m_head = m_tail = 0;
+
+        bool fits = false;
+        uint32_t offset = 0;
+        uint32_t padding = 0; // unusable bytes skipped at the end when wrapping
+
+        if (m_used < m_capacity)
+        {
+            if (m_head >= m_tail)
+            {
+                // Free space is [head, capacity) and [0, tail)
+                if (m_head + aligned <= m_capacity)      { offset = m_head; fits = true; }
+                else if (aligned <= m_tail)              { offset = 0; padding = m_capacity - m_head; fits = true; }
+            }
+            else if (m_head + aligned <= m_tail)
+            {
+                // Wrapped: free space is [head, tail)
+                offset = m_head;
+                fits = true;
+            }
+        }
+
+        bool discard = m_needsDiscard;
+        if (!fits)
+        {
+            if (!m_allowDiscard) return false;
+
+            // Drop all in-flight tracking; the caller's DISCARD map gives it a fresh buffer
+            m_frames.clear();
+            m_head = m_tail = m_used = m_frameBytes = 0;
+            offset = 0;
+            padding = 0;
+            discard = true;
+            ++m_discards;
+        }
+
+        m_needsDiscard = false;
+        m_head = offset + aligned;
+        m_used += aligned + padding;
+        m_frameBytes += aligned + padding;
+
+        out.offset = offset;
+        out.size = aligned;
+        out.discard = discard;
+        return true;
+    }
+
+
+    void RingAllocator::EndFrame(uint64_t fence)
+    {
+        if (m_frameBytes == 0) return;
+
+        m_frames.push_back(FrameMark{ fence, m_head, m_frameBytes });
+        m_frameBytes = 0;
+    }
+
+
+    void RingAllocator::Retire(uint64_t completedFence)
+    {
+        while (!m_frames.empty() && m_frames.front().fence <= completedFence)
+        {
+            const FrameMark& f = m_frames.front();
+            m_tail = f.end;
+            m_used -= f.bytes;
+            m_frames.pop_front();
+        }
+    }
+}
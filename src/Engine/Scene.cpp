@@ -1,7 +1,9 @@
 #include "Engine/Scene.h"
 #include "Engine/Components.h"
 #include "Engine/PhysicsManager.h"
+#include "Engine/SceneSnapshot.h"
 #include <DirectXMath.h>
+#include <cstdio>
 
 using namespace DirectX;
 
@@ -13,7 +15,7 @@ namespace Engine
 
         static uint64_t s_NextID = 1;
         registry.emplace<IDComponent>(e, IDComponent{ s_NextID++ });
-        registry.emplace<NameComponent>(e, NameComponent{ name });
+        registry.emplace<NameComponent>(e, NameComponent{ GetNameTable().Intern(name) });
         registry.emplace<TransformComponent>(e, TransformComponent{});
 
         return e;
@@ -115,7 +117,7 @@ namespace Engine
     entt::entity Scene::CreateDirectionalLight(const char* name)
     {
         entt::entity e = registry.create();
-        registry.emplace<NameComponent>(e, std::string(name));
+        registry.emplace<NameComponent>(e, NameComponent{ GetNameTable().Intern(name) });
 
         // Direction from Transform's rotation (identity then pitch down)
         TransformComponent tc{};
@@ -143,7 +145,7 @@ namespace Engine
                                          float range)
     {
         entt::entity e = registry.create();
-        registry.emplace<NameComponent>(e, std::string(name));
+        registry.emplace<NameComponent>(e, NameComponent{ GetNameTable().Intern(name) });
 
         TransformComponent tc{};
         tc.position = position;
@@ -172,7 +174,7 @@ namespace Engine
                                         float spotAngleRadians)
     {
         entt::entity e = registry.create();
-        registry.emplace<NameComponent>(e, std::string(name));
+        registry.emplace<NameComponent>(e, NameComponent{ GetNameTable().Intern(name) });
 
         // Build a quaternion that aligns +Z with desired direction (LH)
         // Compute basis from forward and world up
@@ -211,10 +213,91 @@ namespace Engine
     }
 
 
+    entt::entity Scene::GetParent(entt::entity entity) const
+    {
+        const auto* h = registry.try_get<HierarchyComponent>(entity);
+        return h ? h->parent : entt::null;
+    }
+
+
+    bool Scene::SetParent(entt::entity entity, entt::entity parent, bool keepWorldTransform)
+    {
+        if (!registry.valid(entity)) return false;
+        if (parent != entt::null && !registry.valid(parent)) return false;
+        if (GetParent(entity) == parent) return true;
+
+        // Reject cycles: the new parent must not be the entity itself or below it
+        for (entt::entity p = parent; p != entt::null; p = GetParent(p))
+        {
+            if (p == entity) return false;
+        }
+
+        // Physics writes world poses straight into TransformComponent, so rigid bodies must stay at the root
+        if (parent != entt::null && registry.all_of<RigidBodyComponent>(entity)) return false;
+
+        // Local transform that keeps the current world pose under the new parent
+        if (keepWorldTransform && registry.all_of<TransformComponent, WorldTransformComponent>(entity))
+        {
+            XMMATRIX local = XMLoadFloat4x4(&registry.get<WorldTransformComponent>(entity).world);
+            if (parent != entt::null && registry.all_of<WorldTransformComponent>(parent))
+                local = local * XMMatrixInverse(nullptr, XMLoadFloat4x4(&registry.get<WorldTransformComponent>(parent).world));
+
+            XMVECTOR scale, rotation, translation;
+            if (XMMatrixDecompose(&scale, &rotation, &translation, local))
+            {
+                auto& tc = registry.get<TransformComponent>(entity);
+                XMStoreFloat3(&tc.scale, scale);
+                XMStoreFloat4(&tc.rotation, rotation);
+                XMStoreFloat3(&tc.position, translation);
+            }
+        }
+
+        auto& node = registry.get_or_emplace<HierarchyComponent>(entity);
+
+        // Unlink from the old parent's child list
+        if (node.parent != entt::null)
+        {
+            auto& oldParent = registry.get<HierarchyComponent>(node.parent);
+            if (node.prevSibling != entt::null) registry.get<HierarchyComponent>(node.prevSibling).nextSibling = node.nextSibling;
+            else oldParent.firstChild = node.nextSibling;
+            if (node.nextSibling != entt::null) registry.get<HierarchyComponent>(node.nextSibling).prevSibling = node.prevSibling;
+            --oldParent.childCount;
+        }
+        node.parent = entt::null;
+        node.prevSibling = entt::null;
+        node.nextSibling = entt::null;
+
+        // Link as the new parent's first child
+        if (parent != entt::null)
+        {
+            auto& newParent = registry.get_or_emplace<HierarchyComponent>(parent);
+            // get_or_emplace may have grown the pool; re-fetch the entity's node
+            auto& child = registry.get<HierarchyComponent>(entity);
+            child.parent = parent;
+            child.nextSibling = newParent.firstChild;
+            if (newParent.firstChild != entt::null) registry.get<HierarchyComponent>(newParent.firstChild).prevSibling = entity;
+            newParent.firstChild = entity;
+            ++newParent.childCount;
+        }
+
+        // Signals the structural change to TransformHierarchy
+        registry.patch<HierarchyComponent>(entity);
+        return true;
+    }
+
+
     void Scene::DestroyEntity(entt::entity entity, Engine::PhysicsManager& physicsManager)
     {
         if (!registry.valid(entity)) return;
 
+        // Children go with their parent; detach first so the parent's child list stays consistent
+        if (registry.all_of<HierarchyComponent>(entity))
+        {
+            while (registry.get<HierarchyComponent>(entity).firstChild != entt::null)
+                DestroyEntity(registry.get<HierarchyComponent>(entity).firstChild, physicsManager);
+            SetParent(entity, entt::null, false);
+        }
+
         // Safely remove physics body from Jolt world before destroying the entity
         if (registry.all_of<RigidBodyComponent>(entity))
         {
@@ -230,30 +313,96 @@ namespace Engine
     }
 
 
-    void Scene::CopyToBackup()
+    // Every component that is part of the scene state; derived caches are transient and rebuilt after a restore
+    static const SceneSnapshot& GetSnapshotFormat()
     {
-		// Clear backup registry and copy all entities and core components from main registry
-        m_backupRegistry.clear();
-        for (auto entity : registry.view<entt::entity>())
+        static const SceneSnapshot s_format = []() {
+            SceneSnapshot format;
+            format.Register<IDComponent>("ID");
+            format.Register<NameComponent>("Name");  // NameTable handles (cooked files carry the strings)
+            format.Register<TransformComponent>("Transform");
+            format.Register<HierarchyComponent>("Hierarchy");
+            format.Register<RigidBodyComponent>("RigidBody");
+            format.Register<MeshRendererComponent>("MeshRenderer");
+            format.Register<LightComponent>("Light");
+            format.Register<CameraComponent>("Camera");
+            format.Register<ViewportComponent>("Viewport");
+            format.Register<EditorCamControlComponent>("EditorCamControl");
+            format.RegisterTag<DisabledTag>("Disabled");
+            format.RegisterTag<ComponentDisabledTag<MeshRendererComponent>>("MeshRendererDisabled");
+            format.RegisterTag<ComponentDisabledTag<LightComponent>>("LightDisabled");
+            format.RegisterTag<ComponentDisabledTag<RigidBodyComponent>>("RigidBodyDisabled");
+
+            format.RegisterTransient<WorldTransformComponent>();
+            format.RegisterTransient<WorldBoundsComponent>();
+            format.RegisterTransient<MeshLodComponent>();
+            format.RegisterTransient<EditorCamMotionComponent>();
+            return format;
+        }();
+        return s_format;
+    }
+
+
+    // Every link names a live entity with a HierarchyComponent, parent/child/sibling links agree with each other and
+    // every node is reachable from a root (no parent cycles). Restored blobs are copied as-is, so a cooked file can
+    // hold anything here.
+    static bool HierarchyLinksValid(entt::registry& registry)
+    {
+        auto view = registry.view<HierarchyComponent>();
+        auto linked = [&registry](entt::entity e) {
+            return e == entt::null || (registry.valid(e) && registry.all_of<HierarchyComponent>(e));
+        };
+
+        size_t nodes = 0;
+        std::vector<entt::entity> queue;
+        for (auto [entity, h] : view.each())
+        {
+            ++nodes;
+            if (!linked(h.parent) || !linked(h.firstChild) || !linked(h.prevSibling) || !linked(h.nextSibling)) return false;
+            if (h.parent == entity) return false;
+
+            // Sibling lists are doubly linked and start at the parent's firstChild
+            if (h.prevSibling != entt::null)
+            {
+                const auto& prev = registry.get<HierarchyComponent>(h.prevSibling);
+                if (prev.nextSibling != entity || prev.parent != h.parent) return false;
+            }
+            else if (h.parent != entt::null && registry.get<HierarchyComponent>(h.parent).firstChild != entity)
+            {
+                return false;
+            }
+            if (h.nextSibling != entt::null && registry.get<HierarchyComponent>(h.nextSibling).prevSibling != entity) return false;
+            if (h.firstChild != entt::null && registry.get<HierarchyComponent>(h.firstChild).parent != entity) return false;
+
+            if (h.parent == entt::null) queue.push_back(entity);
+        }
+
+        // Walk down from the roots; each list is bounded by childCount, so damaged links cannot loop here
+        for (size_t i = 0; i < queue.size(); ++i)
         {
-            // Create the exact same entity ID in the backup registry
-            auto copy = m_backupRegistry.create(entity);
-
-            // Copy all core components if they exist
-            if (registry.all_of<IDComponent>(entity)) m_backupRegistry.emplace<IDComponent>(copy, registry.get<IDComponent>(entity));
-            if (registry.all_of<NameComponent>(entity)) m_backupRegistry.emplace<NameComponent>(copy, registry.get<NameComponent>(entity));
-            if (registry.all_of<TransformComponent>(entity)) m_backupRegistry.emplace<TransformComponent>(copy, registry.get<TransformComponent>(entity));
-            if (registry.all_of<RigidBodyComponent>(entity)) m_backupRegistry.emplace<RigidBodyComponent>(copy, registry.get<RigidBodyComponent>(entity));
-            if (registry.all_of<MeshRendererComponent>(entity)) m_backupRegistry.emplace<MeshRendererComponent>(copy, registry.get<MeshRendererComponent>(entity));
-            if (registry.all_of<LightComponent>(entity)) m_backupRegistry.emplace<LightComponent>(copy, registry.get<LightComponent>(entity));
-            if (registry.all_of<CameraComponent>(entity)) m_backupRegistry.emplace<CameraComponent>(copy, registry.get<CameraComponent>(entity));
-            if (registry.all_of<ViewportComponent>(entity)) m_backupRegistry.emplace<ViewportComponent>(copy, registry.get<ViewportComponent>(entity));
-            if (registry.all_of<EditorCamControlComponent>(entity)) m_backupRegistry.emplace<EditorCamControlComponent>(copy, registry.get<EditorCamControlComponent>(entity));
+            const auto& h = registry.get<HierarchyComponent>(queue[i]);
+            uint32_t count = 0;
+            for (entt::entity child = h.firstChild; child != entt::null; child = registry.get<HierarchyComponent>(child).nextSibling)
+            {
+                if (++count > h.childCount || registry.get<HierarchyComponent>(child).parent != queue[i]) return false;
+                queue.push_back(child);
+            }
+            if (count != h.childCount) return false;
         }
+
+        // Nodes on a parent cycle are never reached from a root
+        return queue.size() == nodes;
     }
 
 
-    void Scene::RestoreFromBackup(Engine::PhysicsManager& physicsManager)
+    void Scene::SaveSnapshot(std::vector<uint8_t>& out)
+    {
+        // One contiguous blob; trivially copyable components are copied page by page
+        GetSnapshotFormat().Save(registry, out);
+    }
+
+
+    void Scene::Clear(Engine::PhysicsManager& physicsManager)
     {
         // Completely destroy all current Jolt bodies before resetting the registry
         auto physView = registry.view<RigidBodyComponent>();
@@ -262,30 +411,54 @@ namespace Engine
             physicsManager.RemoveRigidBody(physView.get<RigidBodyComponent>(entity).bodyID);
         }
 
-		// Clear main registry and copy all entities and core components from backup registry
         registry.clear();
-        for (auto entity : m_backupRegistry.view<entt::entity>())
+    }
+
+
+    bool Scene::LoadSnapshot(const uint8_t* data, size_t size, Engine::PhysicsManager& physicsManager, bool checkHierarchy)
+    {
+        // A bad blob (e.g. a corrupt cooked file) must leave the current scene alone
+        if (!GetSnapshotFormat().Validate(data, size)) return false;
+
+        // Links are only checkable once restored: try a scratch registry (no hierarchy signals attached) first
+        if (checkHierarchy)
         {
-            auto restored = registry.create(entity);
-            // Manually copy all core components back from the backup
-            if (m_backupRegistry.all_of<IDComponent>(entity)) registry.emplace<IDComponent>(restored, m_backupRegistry.get<IDComponent>(entity));
-            if (m_backupRegistry.all_of<NameComponent>(entity)) registry.emplace<NameComponent>(restored, m_backupRegistry.get<NameComponent>(entity));
-            if (m_backupRegistry.all_of<TransformComponent>(entity)) registry.emplace<TransformComponent>(restored, m_backupRegistry.get<TransformComponent>(entity));
-            if (m_backupRegistry.all_of<RigidBodyComponent>(entity)) 
-            {
-                auto rb = m_backupRegistry.get<RigidBodyComponent>(entity);
-                // Invalidate the runtime state so Jolt creates a fresh body next frame
-                rb.bodyID = JPH::BodyID();
-                rb.bodyCreated = false;
-                registry.emplace<RigidBodyComponent>(restored, rb);
-            }
-            if (m_backupRegistry.all_of<MeshRendererComponent>(entity)) registry.emplace<MeshRendererComponent>(restored, m_backupRegistry.get<MeshRendererComponent>(entity));
-            if (m_backupRegistry.all_of<LightComponent>(entity)) registry.emplace<LightComponent>(restored, m_backupRegistry.get<LightComponent>(entity));
-            if (m_backupRegistry.all_of<CameraComponent>(entity)) registry.emplace<CameraComponent>(restored, m_backupRegistry.get<CameraComponent>(entity));
-            if (m_backupRegistry.all_of<ViewportComponent>(entity)) registry.emplace<ViewportComponent>(restored, m_backupRegistry.get<ViewportComponent>(entity));
-            if (m_backupRegistry.all_of<EditorCamControlComponent>(entity)) registry.emplace<EditorCamControlComponent>(restored, m_backupRegistry.get<EditorCamControlComponent>(entity));
+            entt::registry scratch;
+            if (!GetSnapshotFormat().Restore(data, size, scratch) || !HierarchyLinksValid(scratch)) return false;
+        }
+
+        Clear(physicsManager);
+        if (!GetSnapshotFormat().Restore(data, size, registry))
+        {
+            registry.clear();
+            return false;
+        }
+
+        // Invalidate the runtime state so Jolt creates a fresh body next frame
+        for (auto [entity, rb] : registry.view<RigidBodyComponent>().each())
+        {
+            rb.bodyID = JPH::BodyID();
+            rb.bodyCreated = false;
         }
 
         // NOTE: Bodies are rebuilt by PhysicsSystem on the next frame from restored ECS state.
+        return true;
+    }
+
+
+    void Scene::CopyToBackup()
+    {
+        SaveSnapshot(m_backup);
+    }
+
+
+    bool Scene::RestoreFromBackup(Engine::PhysicsManager& physicsManager)
+    {
+        if (!LoadSnapshot(m_backup.data(), m_backup.size(), physicsManager))
+        {
+            std::fprintf(stderr, "Scene: failed to restore the Play-mode backup\n");
+            return false;
+        }
+        return true;
     }
 }
\ No newline at end of file
@@ -0,0 +1,527 @@
+#include "Engine/SceneSerializer.h"
+#include "Engine/Components.h"
+#include "Engine/MappedFile.h"
+#include "Engine/PhysicsManager.h"
+#include "Engine/SceneSnapshot.h"
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/filewritestream.h>
+#include <rapidjson/prettywriter.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace DirectX;
+
+namespace Engine
+{
+    namespace SceneSerializer
+    {
+        static constexpr const char* kJsonFormat = "DX11GameEngine.Scene";
+        static constexpr unsigned kJsonVersion = 1;
+
+        using JsonWriter = rapidjson::PrettyWriter<rapidjson::FileWriteStream>;
+        using JsonValue = rapidjson::Value;
+
+        // Editor camera if there is one, otherwise the first camera
+        static void SelectActiveCamera(Engine::Scene& scene)
+        {
+            scene.m_activeRenderCamera = entt::null;
+            for (auto entity : scene.registry.view<CameraComponent, EditorCamControlComponent>())
+            {
+                scene.m_activeRenderCamera = entity;
+                return;
+            }
+            for (auto entity : scene.registry.view<CameraComponent>())
+            {
+                scene.m_activeRenderCamera = entity;
+                return;
+            }
+        }
+
+
+        // ---- JSON writing ----
+
+        static void WriteFloats(JsonWriter& w, const char* key, const float* values, int count)
+        {
+            w.Key(key);
+            w.StartArray();
+            for (int i = 0; i < count; ++i) w.Double(values[i]);
+            w.EndArray();
+        }
+
+
+        static void WriteEntity(JsonWriter& w, const entt::registry& registry, entt::entity entity)
+        {
+            w.StartObject();
+            w.Key("entity"); w.Uint(entt::to_integral(entity));
+
+            if (const auto* id = registry.try_get<IDComponent>(entity)) {
+                w.Key("id"); w.Uint64(id->id);
+            }
+            if (const auto* name = registry.try_get<NameComponent>(entity)) {
+                const std::string_view text = GetNameTable().Resolve(name->name);
+                w.Key("name"); w.String(text.data(), static_cast<rapidjson::SizeType>(text.size()));
+            }
+            w.Key("active"); w.Bool(!registry.all_of<DisabledTag>(entity));
+            if (const auto* node = registry.try_get<HierarchyComponent>(entity); node && node->parent != entt::null) {
+                w.Key("parent"); w.Uint(entt::to_integral(node->parent));
+            }
+            if (const auto* tc = registry.try_get<TransformComponent>(entity)) {
+                w.Key("Transform");
+                w.StartObject();
+                WriteFloats(w, "position", &tc->position.x, 3);
+                WriteFloats(w, "rotation", &tc->rotation.x, 4);
+                WriteFloats(w, "scale", &tc->scale.x, 3);
+                w.EndObject();
+            }
+            if (const auto* mr = registry.try_get<MeshRendererComponent>(entity)) {
+                w.Key("MeshRenderer");
+                w.StartObject();
+                w.Key("active"); w.Bool(!registry.all_of<ComponentDisabledTag<MeshRendererComponent>>(entity));
+                w.Key("mesh"); w.Int(mr->meshID);
+                w.Key("material"); w.Int(mr->materialID);
+                w.Key("roughness"); w.Double(mr->roughness);
+                w.Key("metallic"); w.Double(mr->metallic);
+                w.EndObject();
+            }
+            if (const auto* lc = registry.try_get<LightComponent>(entity)) {
+                w.Key("Light");
+                w.StartObject();
+                w.Key("active"); w.Bool(!registry.all_of<ComponentDisabledTag<LightComponent>>(entity));
+                w.Key("type"); w.Uint(static_cast<unsigned>(lc->type));
+                WriteFloats(w, "color", &lc->color.x, 3);
+                w.Key("intensity"); w.Double(lc->intensity);
+                w.Key("range"); w.Double(lc->range);
+                w.Key("spotAngle"); w.Double(lc->spotAngle);
+                w.EndObject();
+            }
+            if (const auto* cam = registry.try_get<CameraComponent>(entity)) {
+                w.Key("Camera");
+                w.StartObject();
+                w.Key("fov"); w.Double(cam->FOV);
+                w.Key("near"); w.Double(cam->nearClip);
+                w.Key("far"); w.Double(cam->farClip);
+                w.Key("invertY"); w.Bool(cam->invertY);
+                w.EndObject();
+            }
+            if (const auto* vp = registry.try_get<ViewportComponent>(entity)) {
+                w.Key("Viewport");
+                w.StartObject();
+                w.Key("width"); w.Uint(vp->width);
+                w.Key("height"); w.Uint(vp->height);
+                w.EndObject();
+            }
+            if (const auto* ec = registry.try_get<EditorCamControlComponent>(entity)) {
+                w.Key("EditorCamControl");
+                w.StartObject();
+                w.Key("mode"); w.Int(static_cast<int>(ec->mode));
+                w.Key("moveSpeed"); w.Double(ec->moveSpeed);
+                w.Key("lookSensitivity"); w.Double(ec->lookSensitivity);
+                w.Key("sprintMultiplier"); w.Double(ec->sprintMultiplier);
+                w.Key("yaw"); w.Double(ec->yaw);
+                w.Key("pitch"); w.Double(ec->pitch);
+                w.EndObject();
+            }
+            if (const auto* rb = registry.try_get<RigidBodyComponent>(entity)) {
+                w.Key("RigidBody");
+                w.StartObject();
+                w.Key("active"); w.Bool(!registry.all_of<ComponentDisabledTag<RigidBodyComponent>>(entity));
+                w.Key("shape"); w.Int(static_cast<int>(rb->shape));
+                w.Key("motion"); w.Int(static_cast<int>(rb->motionType));
+                w.Key("mass"); w.Double(rb->mass);
+                w.Key("friction"); w.Double(rb->friction);
+                w.Key("restitution"); w.Double(rb->restitution);
+                w.Key("linearDamping"); w.Double(rb->linearDamping);
+                WriteFloats(w, "halfExtent", &rb->halfExtent.x, 3);
+                w.Key("radius"); w.Double(rb->radius);
+                w.Key("height"); w.Double(rb->height);
+                w.Key("mesh"); w.Int(rb->meshID);
+                w.EndObject();
+            }
+
+            w.EndObject();
+        }
+
+
+        bool SaveJson(Engine::Scene& scene, const std::string& path)
+        {
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file)
+            {
+                std::fprintf(stderr, "SceneSerializer: cannot write %s\n", path.c_str());
+                return false;
+            }
+
+            // Streamed straight to the file through a fixed buffer
+            std::vector<char> buffer(64 * 1024);
+            rapidjson::FileWriteStream stream(file, buffer.data(), buffer.size());
+            JsonWriter w(stream);
+
+            // Id order keeps diffs of re-saved scenes small
+            std::vector<entt::entity> entities;
+            for (auto entity : scene.registry.view<entt::entity>())
+                entities.push_back(entity);
+            std::sort(entities.begin(), entities.end(),
+                [](entt::entity a, entt::entity b) { return entt::to_integral(a) < entt::to_integral(b); });
+
+            w.StartObject();
+            w.Key("format"); w.String(kJsonFormat);
+            w.Key("version"); w.Uint(kJsonVersion);
+            w.Key("entities");
+            w.StartArray();
+            for (entt::entity entity : entities)
+                WriteEntity(w, scene.registry, entity);
+            w.EndArray();
+            w.EndObject();
+
+            stream.Flush();
+            const bool ok = std::ferror(file) == 0;
+            std::fclose(file);
+            return ok;
+        }
+
+
+        // ---- JSON reading (missing fields keep the component defaults) ----
+
+        static void ReadFloats(const JsonValue& obj, const char* key, float* out, rapidjson::SizeType count)
+        {
+            auto it = obj.FindMember(key);
+            if (it == obj.MemberEnd() || !it->value.IsArray() || it->value.Size() != count) return;
+            for (rapidjson::SizeType i = 0; i < count; ++i)
+                if (it->value[i].IsNumber()) out[i] = it->value[i].GetFloat();
+        }
+
+        static void ReadFloat(const JsonValue& obj, const char* key, float& out)
+        {
+            auto it = obj.FindMember(key);
+            if (it != obj.MemberEnd() && it->value.IsNumber()) out = it->value.GetFloat();
+        }
+
+        static void ReadInt(const JsonValue& obj, const char* key, int& out)
+        {
+            auto it = obj.FindMember(key);
+            if (it != obj.MemberEnd() && it->value.IsInt()) out = it->value.GetInt();
+        }
+
+        static void ReadUint(const JsonValue& obj, const char* key, unsigned& out)
+        {
+            auto it = obj.FindMember(key);
+            if (it != obj.MemberEnd() && it->value.IsUint()) out = it->value.GetUint();
+        }
+
+        static void ReadBool(const JsonValue& obj, const char* key, bool& out)
+        {
+            auto it = obj.FindMember(key);
+            if (it != obj.MemberEnd() && it->value.IsBool()) out = it->value.GetBool();
+        }
+
+        // "active": false becomes the activation tag
+        template<typename Tag>
+        static void ReadActiveTag(const JsonValue& obj, entt::registry& registry, entt::entity entity)
+        {
+            bool active = true;
+            ReadBool(obj, "active", active);
+            if (!active) registry.emplace<Tag>(entity);
+        }
+
+        // Component object of an entity, nullptr if absent
+        static const JsonValue* FindComponent(const JsonValue& entity, const char* key)
+        {
+            auto it = entity.FindMember(key);
+            return (it != entity.MemberEnd() && it->value.IsObject()) ? &it->value : nullptr;
+        }
+
+
+        static void ReadEntity(const JsonValue& obj, entt::registry& registry, entt::entity entity)
+        {
+            if (auto it = obj.FindMember("id"); it != obj.MemberEnd() && it->value.IsUint64())
+                registry.emplace<IDComponent>(entity, IDComponent{ it->value.GetUint64() });
+
+            if (auto it = obj.FindMember("name"); it != obj.MemberEnd() && it->value.IsString())
+            {
+                NameComponent name;
+                name.name = GetNameTable().Intern(std::string_view(it->value.GetString(), it->value.GetStringLength()));
+                registry.emplace<NameComponent>(entity, name);
+            }
+            ReadActiveTag<DisabledTag>(obj, registry, entity);
+
+            if (const JsonValue* c = FindComponent(obj, "Transform"))
+            {
+                TransformComponent tc;
+                ReadFloats(*c, "position", &tc.position.x, 3);
+                ReadFloats(*c, "rotation", &tc.rotation.x, 4);
+                ReadFloats(*c, "scale", &tc.scale.x, 3);
+                registry.emplace<TransformComponent>(entity, tc);
+            }
+
+            if (const JsonValue* c = FindComponent(obj, "MeshRenderer"))
+            {
+                MeshRendererComponent mr;
+                ReadActiveTag<ComponentDisabledTag<MeshRendererComponent>>(*c, registry, entity);
+                ReadInt(*c, "mesh", mr.meshID);
+                ReadInt(*c, "material", mr.materialID);
+                ReadFloat(*c, "roughness", mr.roughness);
+                ReadFloat(*c, "metallic", mr.metallic);
+                registry.emplace<MeshRendererComponent>(entity, mr);
+            }
+
+            if (const JsonValue* c = FindComponent(obj, "Light"))
+            {
+                LightComponent lc;
+                unsigned type = static_cast<unsigned>(lc.type);
+                ReadActiveTag<ComponentDisabledTag<LightComponent>>(*c, registry, entity);
+                ReadUint(*c, "type", type);
+                lc.type = static_cast<LightType>(type <= static_cast<unsigned>(LightType::Spot) ? type : 0u);
+                ReadFloats(*c, "color", &lc.color.x, 3);
+                ReadFloat(*c, "intensity", lc.intensity);
+                ReadFloat(*c, "range", lc.range);
+                ReadFloat(*c, "spotAngle", lc.spotAngle);
+                registry.emplace<LightComponent>(entity, lc);
+            }
+
+            if (const JsonValue* c = FindComponent(obj, "Camera"))
+            {
+                CameraComponent cam;
+                ReadFloat(*c, "fov", cam.FOV);
+                ReadFloat(*c, "near", cam.nearClip);
+                ReadFloat(*c, "far", cam.farClip);
+                ReadBool(*c, "invertY", cam.invertY);
+                registry.emplace<CameraComponent>(entity, cam);
+            }
+
+            if (const JsonValue* c = FindComponent(obj, "Viewport"))
+            {
+                ViewportComponent vp;
+                ReadUint(*c, "width", vp.width);
+                ReadUint(*c, "height", vp.height);
+                registry.emplace<ViewportComponent>(entity, vp);
+            }
+
+            if (const JsonValue* c = FindComponent(obj, "EditorCamControl"))
+            {
+                EditorCamControlComponent ec;
+                int mode = static_cast<int>(ec.mode);
+                ReadInt(*c, "mode", mode);
+                ec.mode = static_cast<CameraControlMode>(mode);
+                ReadFloat(*c, "moveSpeed", ec.moveSpeed);
+                ReadFloat(*c, "lookSensitivity", ec.lookSensitivity);
+                ReadFloat(*c, "sprintMultiplier", ec.sprintMultiplier);
+                ReadFloat(*c, "yaw", ec.yaw);
+                ReadFloat(*c, "pitch", ec.pitch);
+                registry.emplace<EditorCamControlComponent>(entity, ec);
+            }
+
+            if (const JsonValue* c = FindComponent(obj, "RigidBody"))
+            {
+                RigidBodyComponent rb;
+                int shape = static_cast<int>(rb.shape);
+                int motion = static_cast<int>(rb.motionType);
+                ReadActiveTag<ComponentDisabledTag<RigidBodyComponent>>(*c, registry, entity);
+                ReadInt(*c, "shape", shape);
+                ReadInt(*c, "motion", motion);
+                rb.shape = static_cast<RBShape>(shape);
+                rb.motionType = static_cast<RBMotion>(motion);
+                ReadFloat(*c, "mass", rb.mass);
+                ReadFloat(*c, "friction", rb.friction);
+                ReadFloat(*c, "restitution", rb.restitution);
+                ReadFloat(*c, "linearDamping", rb.linearDamping);
+                ReadFloats(*c, "halfExtent", &rb.halfExtent.x, 3);
+                ReadFloat(*c, "radius", rb.radius);
+                ReadFloat(*c, "height", rb.height);
+                ReadInt(*c, "mesh", rb.meshID);
+                registry.emplace<RigidBodyComponent>(entity, rb);
+            }
+        }
+
+
+        bool LoadJson(Engine::Scene& scene, const std::string& path, Engine::PhysicsManager& physicsManager)
+        {
+            MappedFile file;
+            if (!file.Open(path))
+            {
+                std::fprintf(stderr, "SceneSerializer: cannot read %s\n", path.c_str());
+                return false;
+            }
+
+            rapidjson::Document doc;
+            doc.Parse(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+            if (doc.HasParseError() || !doc.IsObject())
+            {
+                std::fprintf(stderr, "SceneSerializer: %s: %s (offset %zu)\n", path.c_str(),
+                    rapidjson::GetParseError_En(doc.GetParseError()), doc.GetErrorOffset());
+                return false;
+            }
+
+            auto format = doc.FindMember("format");
+            auto version = doc.FindMember("version");
+            auto entities = doc.FindMember("entities");
+            if (format == doc.MemberEnd() || !format->value.IsString() || std::string(format->value.GetString()) != kJsonFormat ||
+                version == doc.MemberEnd() || !version->value.IsUint() || version->value.GetUint() != kJsonVersion ||
+                entities == doc.MemberEnd() || !entities->value.IsArray())
+            {
+                std::fprintf(stderr, "SceneSerializer: %s is not a version %u scene file\n", path.c_str(), kJsonVersion);
+                return false;
+            }
+
+            scene.Clear(physicsManager);
+
+            // Pass 1: entities and components; file keys map to the new entities
+            std::unordered_map<uint32_t, entt::entity> keyToEntity;
+            std::vector<std::pair<entt::entity, uint32_t>> parentLinks;
+            for (const JsonValue& obj : entities->value.GetArray())
+            {
+                if (!obj.IsObject()) continue;
+
+                const entt::entity entity = scene.registry.create();
+                if (auto key = obj.FindMember("entity"); key != obj.MemberEnd() && key->value.IsUint())
+                    keyToEntity[key->value.GetUint()] = entity;
+                if (auto parent = obj.FindMember("parent"); parent != obj.MemberEnd() && parent->value.IsUint())
+                    parentLinks.emplace_back(entity, parent->value.GetUint());
+
+                ReadEntity(obj, scene.registry, entity);
+            }
+
+            // Pass 2: parent links. SetParent prepends, so walking backwards keeps the saved sibling order.
+            for (auto it = parentLinks.rbegin(); it != parentLinks.rend(); ++it)
+            {
+                auto parent = keyToEntity.find(it->second);
+                if (parent != keyToEntity.end())
+                    scene.SetParent(it->first, parent->second, false);
+            }
+
+            SelectActiveCamera(scene);
+            return true;
+        }
+
+
+        // ---- Cooked ----
+
+        // File: header | name strings (handle, length, chars) | padding to 16 | SceneSnapshot blob
+        struct CookedHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t nameCount;
+            uint32_t reserved;
+            uint64_t snapshotOffset;
+            uint64_t snapshotSize;
+        };
+        static constexpr uint32_t kCookedMagic = 0x444B4353;   // 'SCKD'
+        static constexpr uint32_t kCookedVersion = 1;
+
+        bool SaveCooked(Engine::Scene& scene, const std::string& path)
+        {
+            // Names in the snapshot are NameTable handles; store the strings of the ones in use, sorted by handle
+            std::vector<NameHandle> handles;
+            for (auto [entity, nc] : scene.registry.view<NameComponent>().each())
+                handles.push_back(nc.name);
+            std::sort(handles.begin(), handles.end());
+            handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+
+            std::vector<uint8_t> head;
+            BinaryWriter writer(head);
+            writer.Write(CookedHeader{});
+            for (NameHandle handle : handles)
+            {
+                const std::string_view text = GetNameTable().Resolve(handle);
+                writer.Write(handle);
+                writer.Write(static_cast<uint32_t>(text.size()));
+                writer.Write(text.data(), text.size());
+            }
+            writer.Align(16);
+
+            std::vector<uint8_t> blob;
+            scene.SaveSnapshot(blob);
+
+            const CookedHeader header{ kCookedMagic, kCookedVersion, static_cast<uint32_t>(handles.size()), 0,
+                                       static_cast<uint64_t>(head.size()), static_cast<uint64_t>(blob.size()) };
+            std::memcpy(head.data(), &header, sizeof(header));
+
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file)
+            {
+                std::fprintf(stderr, "SceneSerializer: cannot write %s\n", path.c_str());
+                return false;
+            }
+            const bool ok = std::fwrite(head.data(), 1, head.size(), file) == head.size() &&
+                            std::fwrite(blob.data(), 1, blob.size(), file) == blob.size();
+            std::fclose(file);
+            return ok;
+        }
+
+
+        // Interns the stored names; remap holds (file handle, handle in this process) sorted by file handle
+        static bool ReadCookedNames(BinaryReader& in, uint32_t count, std::vector<std::pair<NameHandle, NameHandle>>& remap)
+        {
+            remap.clear();
+            remap.reserve(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                NameHandle handle = 0;
+                uint32_t length = 0;
+                if (!in.Read(handle) || !in.Read(length)) return false;
+                const uint8_t* text = in.Skip(length);
+                if (!text || (!remap.empty() && remap.back().first >= handle)) return false;
+                remap.emplace_back(handle, GetNameTable().Intern(std::string_view(reinterpret_cast<const char*>(text), length)));
+            }
+            return true;
+        }
+
+
+        bool LoadCooked(Engine::Scene& scene, const std::string& path, Engine::PhysicsManager& physicsManager)
+        {
+            // The mapping is page-aligned and the snapshot starts on a 16-byte boundary, as its in-place reads require
+            MappedFile file;
+            CookedHeader header{};
+            std::vector<std::pair<NameHandle, NameHandle>> remap;
+            bool ok = file.Open(path);
+            if (ok)
+            {
+                BinaryReader reader(file.GetData(), file.GetSize());
+                ok = reader.Read(header) && header.magic == kCookedMagic && header.version == kCookedVersion &&
+                     ReadCookedNames(reader, header.nameCount, remap) &&
+                     header.snapshotOffset % 16 == 0 && header.snapshotOffset <= file.GetSize() &&
+                     header.snapshotSize <= file.GetSize() - header.snapshotOffset &&
+                     scene.LoadSnapshot(file.GetData() + header.snapshotOffset, static_cast<size_t>(header.snapshotSize), physicsManager, true);
+            }
+            if (!ok)
+            {
+                std::fprintf(stderr, "SceneSerializer: cannot load cooked scene %s\n", path.c_str());
+                return false;
+            }
+
+            // File handles -> handles of this process (unknown ones become the empty name)
+            for (auto [entity, nc] : scene.registry.view<NameComponent>().each())
+            {
+                auto it = std::lower_bound(remap.begin(), remap.end(), nc.name,
+                    [](const std::pair<NameHandle, NameHandle>& r, NameHandle h) { return r.first < h; });
+                nc.name = (it != remap.end() && it->first == nc.name) ? it->second : 0;
+            }
+
+            // Texture pointers in the file belong to the process that cooked it
+            for (auto [entity, mr] : scene.registry.view<MeshRendererComponent>().each())
+                mr.texture = nullptr;
+
+            // Same fallback as the JSON reader for light types this build does not know
+            for (auto [entity, lc] : scene.registry.view<LightComponent>().each())
+            {
+                if (static_cast<unsigned>(lc.type) > static_cast<unsigned>(LightType::Spot))
+                    lc.type = LightType::Directional;
+            }
+
+            SelectActiveCamera(scene);
+            return true;
+        }
+
+
+        bool Load(Engine::Scene& scene, const std::string& path, Engine::PhysicsManager& physicsManager)
+        {
+            const bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+            return json ? LoadJson(scene, path, physicsManager) : LoadCooked(scene, path, physicsManager);
+        }
+    }
+}
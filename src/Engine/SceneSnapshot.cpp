@@ -0,0 +1,179 @@
+#include "Engine/SceneSnapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+namespace Engine
+{
+    void SceneSnapshot::WriteEntities(BinaryWriter& out, const entt::entity* entities, uint32_t count)
+    {
+        out.Write(count);
+        out.Align(alignof(entt::entity));
+        out.Write(entities, static_cast<size_t>(count) * sizeof(entt::entity));
+    }
+
+
+    // Entity ids are read in place (the writer aligned them)
+    static const entt::entity* ReadEntities(BinaryReader& in, uint32_t& count)
+    {
+        if (!in.Read(count) || !in.Align(alignof(entt::entity))) return nullptr;
+        const uint8_t* data = in.Skip(static_cast<size_t>(count) * sizeof(entt::entity));
+        return reinterpret_cast<const entt::entity*>(data);
+    }
+
+
+    void SceneSnapshot::Save(entt::registry& registry, std::vector<uint8_t>& out) const
+    {
+        out.clear();
+        BinaryWriter writer(out);
+        writer.Write(kMagic);
+        writer.Write(kVersion);
+
+        // Entity ids go straight into the blob; the count is patched once they are written
+        const size_t countAt = writer.Tell();
+        writer.Write(uint32_t{ 0 });
+        writer.Align(alignof(entt::entity));
+        uint32_t entityCount = 0;
+        for (auto entity : registry.view<entt::entity>())
+        {
+            writer.Write(entity);
+            ++entityCount;
+        }
+        std::memcpy(writer.At(countAt), &entityCount, sizeof(entityCount));
+
+        writer.Write(static_cast<uint32_t>(m_types.size()));
+        for (const ComponentType& type : m_types)
+        {
+            writer.Write(type.id);
+            type.save(registry, writer);
+        }
+
+        // Anything else holding data would be lost on restore: say so (once per type)
+        for (auto [id, pool] : registry.storage())
+        {
+            if (pool.empty() || id == entt::type_hash<entt::entity>::value()) continue;
+
+            const bool known =
+                std::any_of(m_types.begin(), m_types.end(), [id = id](const ComponentType& t) { return t.poolId == id; }) ||
+                std::find(m_transient.begin(), m_transient.end(), id) != m_transient.end();
+            if (known || std::find(m_reported.begin(), m_reported.end(), id) != m_reported.end()) continue;
+
+            m_reported.push_back(id);
+            const auto typeName = pool.type().name();
+            std::fprintf(stderr, "SceneSnapshot: component '%.*s' is not registered and is not saved\n",
+                static_cast<int>(typeName.size()), typeName.data());
+        }
+    }
+
+
+    bool SceneSnapshot::Validate(const uint8_t* data, size_t size) const
+    {
+        if (!data || reinterpret_cast<uintptr_t>(data) % kPayloadAlignment != 0) return false;
+        BinaryReader reader(data, size);
+
+        uint32_t magic = 0, version = 0;
+        if (!reader.Read(magic) || !reader.Read(version) || magic != kMagic || version != kVersion)
+            return false;
+
+        // Saved ids by entity index: two ids sharing an index could not both be recreated
+        uint32_t entityCount = 0;
+        const entt::entity* entities = ReadEntities(reader, entityCount);
+        if (!entities) return false;
+        std::vector<entt::entity> byIndex;
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            const entt::entity e = entities[i];
+            if (e == entt::null || e == entt::tombstone) return false;
+            const size_t index = static_cast<size_t>(entt::to_entity(e));
+            if (index >= byIndex.size()) byIndex.resize(index + 1, entt::null);
+            if (byIndex[index] != entt::null) return false;
+            byIndex[index] = e;
+        }
+
+        // Per index, the last component entry that claimed it (an owner listed twice would hit EnTT's insert assert)
+        std::vector<uint32_t> claimedBy(byIndex.size(), 0);
+        std::vector<entt::id_type> typeIds;
+
+        uint32_t typeCount = 0;
+        if (!reader.Read(typeCount)) return false;
+        for (uint32_t t = 0; t < typeCount; ++t)
+        {
+            entt::id_type id = 0;
+            uint32_t count = 0;
+            uint64_t payloadSize = 0;
+            if (!reader.Read(id)) return false;
+            const entt::entity* owners = ReadEntities(reader, count);
+            if (!owners || !reader.Read(payloadSize)) return false;
+
+            // Same for a type listed twice
+            if (std::find(typeIds.begin(), typeIds.end(), id) != typeIds.end()) return false;
+            typeIds.push_back(id);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const size_t index = static_cast<size_t>(entt::to_entity(owners[i]));
+                if (index >= byIndex.size() || byIndex[index] != owners[i] || claimedBy[index] == t + 1) return false;
+                claimedBy[index] = t + 1;
+            }
+
+            const auto type = std::find_if(m_types.begin(), m_types.end(), [id](const ComponentType& c) { return c.id == id; });
+            const bool payloadOk = type == m_types.end()
+                ? reader.Align(kPayloadAlignment) && reader.Skip(static_cast<size_t>(payloadSize)) != nullptr
+                : type->check(reader, count, payloadSize);
+            if (!payloadOk)
+            {
+                if (type != m_types.end())
+                    std::fprintf(stderr, "SceneSnapshot: corrupt data for component '%s'\n", type->name.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    bool SceneSnapshot::Restore(const uint8_t* data, size_t size, entt::registry& registry) const
+    {
+        if (!Validate(data, size)) return false;
+        BinaryReader reader(data, size);
+
+        uint32_t magic = 0, version = 0;
+        reader.Read(magic);
+        reader.Read(version);
+
+        // Entities first, with their original ids (component entries refer to them)
+        uint32_t entityCount = 0;
+        const entt::entity* entities = ReadEntities(reader, entityCount);
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            // Only fails if the registry was not empty
+            if (registry.create(entities[i]) != entities[i])
+                return false;
+        }
+
+        uint32_t typeCount = 0;
+        reader.Read(typeCount);
+        for (uint32_t t = 0; t < typeCount; ++t)
+        {
+            entt::id_type id = 0;
+            uint32_t count = 0;
+            uint64_t payloadSize = 0;
+            reader.Read(id);
+            const entt::entity* owners = ReadEntities(reader, count);
+            reader.Read(payloadSize);
+
+            const auto type = std::find_if(m_types.begin(), m_types.end(), [id](const ComponentType& c) { return c.id == id; });
+            if (type == m_types.end())
+            {
+                // Type no longer registered: skip its entry
+                reader.Align(kPayloadAlignment);
+                reader.Skip(static_cast<size_t>(payloadSize));
+                continue;
+            }
+
+            if (!type->load(registry, reader, owners, count, payloadSize))
+                return false;
+        }
+        return true;
+    }
+}
@@ -1,4 +1,6 @@
 #include "Engine/ShaderManager.h"
+#include "Engine/Profiler.h"
+#include "Engine/RenderDevice.h"
 #include <d3dcompiler.h>
 #include <stdexcept>
 
@@ -7,8 +9,9 @@ using Microsoft::WRL::ComPtr;
 namespace Engine
 {
     // Helper compile function (already declared in header)
-    ComPtr<ID3DBlob> ShaderManager::Compile(const std::wstring& path, const std::string& entry, const std::string& target)
+    ComPtr<ID3DBlob> ShaderManager::Compile(const std::wstring& path, const std::string& entry, const std::string& target, const D3D_SHADER_MACRO* defines)
     {
+        ENGINE_PROFILE_FUNCTION();
         UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
     #if defined(_DEBUG)
         flags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
@@ -18,7 +21,7 @@ namespace Engine
         ComPtr<ID3DBlob> errors;
         HRESULT hr = D3DCompileFromFile(
             path.c_str(),
-            nullptr, nullptr,
+            defines, nullptr,
             entry.c_str(), target.c_str(),
             flags, 0,
             bytecode.GetAddressOf(),
@@ -99,15 +102,94 @@ namespace Engine
         return 2;
     }
 
-    void ShaderManager::Bind(int shaderID, ID3D11DeviceContext* context) const
+    namespace
+    {
+        // Slot 0: Engine::Vertex (stride 32). Slot 1: Engine::InstanceData (world rows + material, stride 80)
+        const D3D11_INPUT_ELEMENT_DESC kBasicInstancedLayout[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT,    0,  0,                 D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT,    0,  sizeof(float)*3,   D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,       0,  sizeof(float)*6,   D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "WORLD",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  0,                 D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  sizeof(float)*4,   D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  sizeof(float)*8,   D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  sizeof(float)*12,  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "MATERIAL", 0, DXGI_FORMAT_R32G32_FLOAT,       1,  sizeof(float)*16,  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        };
+
+        // Engine::CompactVertex (stride 16): the IA unpacks unorm/snorm/half to float
+        const D3D11_INPUT_ELEMENT_DESC kCompactLayout[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0,  0,   D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "NORMAL",   0, DXGI_FORMAT_R16G16_SNORM,       0,  8,   D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT,       0,  12,  D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        };
+
+        // Slot 0: Engine::CompactVertex (stride 16). Slot 1: Engine::InstanceData (stride 80)
+        const D3D11_INPUT_ELEMENT_DESC kCompactInstancedLayout[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0,  0,                 D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "NORMAL",   0, DXGI_FORMAT_R16G16_SNORM,       0,  8,                 D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT,       0,  12,                D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "WORLD",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  0,                 D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  sizeof(float)*4,   D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  sizeof(float)*8,   D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  sizeof(float)*12,  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "MATERIAL", 0, DXGI_FORMAT_R32G32_FLOAT,       1,  sizeof(float)*16,  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        };
+    }
+
+    int ShaderManager::LoadBasicVariant(ID3D11Device* device, int shaderID, const D3D_SHADER_MACRO* defines,
+                                        const D3D11_INPUT_ELEMENT_DESC* layout, UINT layoutCount, const char* name)
+    {
+        // Same sources as the basic shaders, compiled with the variant's defines
+        ComPtr<ID3DBlob> vsBytecode = Compile(L"shaders/BasicVS.hlsl", "main", "vs_5_0", defines);
+        ComPtr<ID3DBlob> psBytecode = Compile(L"shaders/BasicPS.hlsl", "main", "ps_5_0", defines);
+
+        // Create shader objects
+        ShaderData sd{};
+        HRESULT hr = device->CreateVertexShader(vsBytecode->GetBufferPointer(), vsBytecode->GetBufferSize(), nullptr, sd.vs.GetAddressOf());
+        if (FAILED(hr)) throw std::runtime_error(std::string("CreateVertexShader failed (") + name + ")");
+        hr = device->CreatePixelShader(psBytecode->GetBufferPointer(), psBytecode->GetBufferSize(), nullptr, sd.ps.GetAddressOf());
+        if (FAILED(hr)) throw std::runtime_error(std::string("CreatePixelShader failed (") + name + ")");
+
+        hr = device->CreateInputLayout(
+            layout, layoutCount,
+            vsBytecode->GetBufferPointer(),
+            vsBytecode->GetBufferSize(),
+            sd.inputLayout.GetAddressOf());
+        if (FAILED(hr)) throw std::runtime_error(std::string("CreateInputLayout failed (") + name + ")");
+
+        m_shaders[shaderID] = std::move(sd);
+        return shaderID;
+    }
+
+    int ShaderManager::LoadBasicInstancedShaders(ID3D11Device* device)
+    {
+        const D3D_SHADER_MACRO defines[] = { { "INSTANCED", "1" }, { nullptr, nullptr } };
+        return LoadBasicVariant(device, 3, defines, kBasicInstancedLayout, _countof(kBasicInstancedLayout), "BasicInstanced");
+    }
+
+    int ShaderManager::LoadBasicCompactShaders(ID3D11Device* device)
+    {
+        const D3D_SHADER_MACRO defines[] = { { "COMPACT_VERTEX", "1" }, { nullptr, nullptr } };
+        return LoadBasicVariant(device, 4, defines, kCompactLayout, _countof(kCompactLayout), "BasicCompact");
+    }
+
+    int ShaderManager::LoadBasicInstancedCompactShaders(ID3D11Device* device)
+    {
+        const D3D_SHADER_MACRO defines[] = { { "INSTANCED", "1" }, { "COMPACT_VERTEX", "1" }, { nullptr, nullptr } };
+        return LoadBasicVariant(device, 5, defines, kCompactInstancedLayout, _countof(kCompactInstancedLayout), "BasicInstancedCompact");
+    }
+
+    void ShaderManager::Bind(int shaderID, IRenderDevice& device) const
     {
         auto it = m_shaders.find(shaderID);
         if (it == m_shaders.end()) return;
 
         const ShaderData& sd = it->second;
-        if (sd.vs) context->VSSetShader(sd.vs.Get(), nullptr, 0);
-        if (sd.ps) context->PSSetShader(sd.ps.Get(), nullptr, 0);
-        if (sd.inputLayout) context->IASetInputLayout(sd.inputLayout.Get());
+        device.SetShaders(sd.vs.Get(), sd.ps.Get());
+        if (sd.inputLayout) device.SetInputLayout(sd.inputLayout.Get());
     }
 
     ID3D11InputLayout* ShaderManager::GetInputLayout(int shaderID) const
@@ -0,0 +1,173 @@
+#include "Engine/SystemScheduler.h"
+#include "Engine/Profiler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace Engine
+{
+    static bool Intersects(const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b)
+    {
+        for (entt::id_type id : a)
+            if (std::find(b.begin(), b.end(), id) != b.end()) return true;
+        return false;
+    }
+
+
+    bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+    {
+        if (m_exclusive || other.m_exclusive) return true;
+
+        // Write/write and read/write overlaps must be ordered, read/read may overlap
+        return Intersects(m_writes, other.m_writes) ||
+               Intersects(m_writes, other.m_reads) ||
+               Intersects(other.m_writes, m_reads);
+    }
+
+
+    uint32_t SystemScheduler::Register(const char* name, const SystemAccess& access, SystemFn fn)
+    {
+        System system;
+        system.name = name;
+        system.access = access;
+        system.fn = std::move(fn);
+        m_systems.push_back(std::move(system));
+
+        SystemTiming timing;
+        timing.name = name;
+        timing.mainThread = access.m_mainThread;
+        m_timings.push_back(timing);
+
+        m_graphDirty = true;
+        return static_cast<uint32_t>(m_systems.size() - 1);
+    }
+
+
+    void SystemScheduler::BuildGraph()
+    {
+        // Edges only point from earlier to later registrations, so the graph is acyclic by construction
+        const uint32_t count = static_cast<uint32_t>(m_systems.size());
+        for (auto& s : m_systems)
+        {
+            s.dependents.clear();
+            s.dependencyCount = 0;
+        }
+
+        for (uint32_t later = 0; later < count; ++later)
+        {
+            for (uint32_t earlier = 0; earlier < later; ++earlier)
+            {
+                const SystemAccess& a = m_systems[earlier].access;
+                const SystemAccess& b = m_systems[later].access;
+
+                // Two main-thread systems are already serialized by running on the same thread
+                const bool bothMain = a.m_mainThread && b.m_mainThread;
+                if (a.ConflictsWith(b) && !(bothMain && !a.m_exclusive && !b.m_exclusive))
+                {
+                    m_systems[earlier].dependents.push_back(later);
+                    ++m_systems[later].dependencyCount;
+                }
+            }
+        }
+
+        m_remaining.reset(new std::atomic<uint32_t>[count]);
+        m_graphDirty = false;
+    }
+
+
+    void SystemScheduler::RunSystem(uint32_t index, float dt)
+    {
+        ENGINE_PROFILE_SCOPE(m_systems[index].name.c_str());
+        const auto start = std::chrono::steady_clock::now();
+        m_systems[index].fn(dt);
+        const auto end = std::chrono::steady_clock::now();
+        m_timings[index].ms = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+
+    void SystemScheduler::Schedule(uint32_t index, JobSystem& jobs, JobCounter& counter, float dt)
+    {
+        if (m_systems[index].access.m_mainThread)
+        {
+            std::lock_guard<std::mutex> lock(m_mainReadyMutex);
+            m_mainReady.push_back(index);
+            return;
+        }
+
+        jobs.Run(counter, [this, index, &jobs, &counter, dt]() {
+            RunSystem(index, dt);
+            Finish(index, jobs, counter, dt);
+        });
+    }
+
+
+    void SystemScheduler::Finish(uint32_t index, JobSystem& jobs, JobCounter& counter, float dt)
+    {
+        // Dependents are queued before this task returns, so the counter cannot hit zero in between
+        for (uint32_t dependent : m_systems[index].dependents)
+        {
+            if (m_remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                Schedule(dependent, jobs, counter, dt);
+        }
+    }
+
+
+    void SystemScheduler::Run(JobSystem& jobs, entt::registry& registry, float dt)
+    {
+        const auto frameStart = std::chrono::steady_clock::now();
+        const uint32_t count = static_cast<uint32_t>(m_systems.size());
+
+        // Create every declared pool on this thread; systems running concurrently only look them up
+        for (const auto& s : m_systems)
+            for (auto assure : s.access.m_assurePools) assure(registry);
+
+        if (m_serial || jobs.GetWorkerCount() == 0)
+        {
+            for (uint32_t i = 0; i < count; ++i) RunSystem(i, dt);
+        }
+        else
+        {
+            if (m_graphDirty) BuildGraph();
+
+            m_mainReady.clear();
+            for (uint32_t i = 0; i < count; ++i)
+                m_remaining[i].store(m_systems[i].dependencyCount, std::memory_order_relaxed);
+
+            JobCounter counter;
+            for (uint32_t i = 0; i < count; ++i)
+                if (m_systems[i].dependencyCount == 0) Schedule(i, jobs, counter, dt);
+
+            // The calling thread runs main-thread systems as they become ready and otherwise helps the workers
+            uint32_t mainRemaining = 0;
+            for (const auto& s : m_systems) mainRemaining += s.access.m_mainThread ? 1u : 0u;
+
+            while (true)
+            {
+                uint32_t next = UINT32_MAX;
+                {
+                    std::lock_guard<std::mutex> lock(m_mainReadyMutex);
+                    if (!m_mainReady.empty())
+                    {
+                        next = m_mainReady.front();
+                        m_mainReady.erase(m_mainReady.begin());
+                    }
+                }
+
+                if (next != UINT32_MAX)
+                {
+                    RunSystem(next, dt);
+                    Finish(next, jobs, counter, dt);
+                    --mainRemaining;
+                    continue;
+                }
+
+                // No main-thread work ready: wait for the worker systems in flight (they may release more)
+                jobs.Wait(counter);
+
+                std::lock_guard<std::mutex> lock(m_mainReadyMutex);
+                if (mainRemaining == 0 && m_mainReady.empty()) break;
+            }
+        }
+
+        m_lastFrameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+    }
+}
@@ -3,7 +3,11 @@
 #include "Engine/Renderer.h"
 #include "Engine/MeshManager.h"
 #include "Engine/PhysicsManager.h"
+#include "Engine/InstanceBatcher.h"
+#include "Engine/Culling.h"
+#include "Engine/LightClustering.h"
 #include <DirectXMath.h>
+#include <cfloat>
 #include <Jolt/Physics/Body/BodyInterface.h>
 
 using namespace DirectX;
@@ -33,13 +37,27 @@ namespace Engine
     }
 
 
+    // Editor camera basis from yaw/pitch (LH, yaw=0 looks +Z)
+    static void EditorCameraBasis(const EditorCamControlComponent& fc, XMVECTOR& forward, XMVECTOR& right, XMVECTOR& up)
+    {
+        const float cy = cosf(fc.yaw);
+        const float sy = sinf(fc.yaw);
+        const float cp = cosf(fc.pitch);
+        const float sp = sinf(fc.pitch);
+
+        forward = XMVector3Normalize(XMVectorSet(sy * cp, sp, cy * cp, 0.0f));
+        const XMVECTOR worldUp = XMVectorSet(0, 1, 0, 0);
+        right = XMVector3Normalize(XMVector3Cross(worldUp, forward));
+        up = XMVector3Normalize(XMVector3Cross(forward, right));
+    }
+
+
     void EditorCameraInputSystem(Engine::Scene& scene, const Engine::InputManager& input, float dt, bool isSceneFocused)
     {
-        // Iterate all entities with Transform + FlyCamControl
-        auto view = scene.registry.view<TransformComponent, EditorCamControlComponent>();
+        // Only the control state is touched here; the Transform is written by EditorCameraTransformSystem
+        auto view = scene.registry.view<EditorCamControlComponent>();
         for (auto ent : view)
         {
-            auto& tf = view.get<TransformComponent>(ent);           // transform
 			auto& fc = view.get<EditorCamControlComponent>(ent);    // flycam control
 
             if (fc.mode != CameraControlMode::EditorCam)
@@ -60,25 +78,19 @@ namespace Engine
                 if (fc.yaw < -XM_PI) fc.yaw += XM_2PI;
             }
 
-            // Recompute basis from yaw/pitch (LH, yaw=0 looks +Z)
-            const float cy = cosf(fc.yaw);
-            const float sy = sinf(fc.yaw);
-            const float cp = cosf(fc.pitch);
-            const float sp = sinf(fc.pitch);
+            XMVECTOR forward, right, up;
+            EditorCameraBasis(fc, forward, right, up);
 
-            XMVECTOR forward = XMVector3Normalize(XMVectorSet(sy * cp, sp, cy * cp, 0.0f));
-            XMVECTOR worldUp = XMVectorSet(0, 1, 0, 0);
-            XMVECTOR right = XMVector3Normalize(XMVector3Cross(worldUp, forward));
-            XMVECTOR up = XMVector3Normalize(XMVector3Cross(forward, right));
+            // Only this system touches the motion pool, so adding it here races with nothing
+            auto& motion = scene.registry.get_or_emplace<EditorCamMotionComponent>(ent);
+            XMVECTOR pending = XMLoadFloat3(&motion.move);
 
             float scroll = static_cast<float>(input.GetMouseDelta().wheelY);
             if (isSceneFocused && scroll != 0.0f)
             {
                 // Multiply by a factor (e.g., 5.0f) so the scroll movement is noticeable
                 float scrollSpeed = fc.moveSpeed * dt * 5.0f; 
-                XMVECTOR move = XMVectorScale(forward, scroll * scrollSpeed);
-                XMVECTOR pos = XMVectorAdd(XMLoadFloat3(&tf.position), move);
-                XMStoreFloat3(&tf.position, pos);
+                pending = XMVectorAdd(pending, XMVectorScale(forward, scroll * scrollSpeed));
             }
 
             if (input.IsMouseCaptured() || (isSceneFocused && input.IsKeyDown(Key::LShift)))
@@ -97,14 +109,37 @@ namespace Engine
                 if (!XMVector3Equal(move, XMVectorZero()))
                 {
                     move = XMVector3Normalize(move);
-                    move = XMVectorScale(move, speed);
-                    XMVECTOR pos = XMVectorAdd(XMLoadFloat3(&tf.position), move);
-                    XMStoreFloat3(&tf.position, pos);
+                    pending = XMVectorAdd(pending, XMVectorScale(move, speed));
                 }
             }
 
+            XMStoreFloat3(&motion.move, pending);
+        }
+    }
+
+
+    void EditorCameraTransformSystem(Engine::Scene& scene)
+    {
+        auto view = scene.registry.view<TransformComponent, EditorCamControlComponent>();
+        for (auto ent : view)
+        {
+            auto& tf = view.get<TransformComponent>(ent);
+            const auto& fc = view.get<EditorCamControlComponent>(ent);
+            if (fc.mode != CameraControlMode::EditorCam)
+                continue;
+
+            // Movement gathered by EditorCameraInputSystem
+            if (auto* motion = scene.registry.try_get<EditorCamMotionComponent>(ent))
+            {
+                XMStoreFloat3(&tf.position, XMVectorAdd(XMLoadFloat3(&tf.position), XMLoadFloat3(&motion->move)));
+                motion->move = XMFLOAT3(0.0f, 0.0f, 0.0f);
+            }
+
             // Store rotation in TransformComponent as quaternion from basis
             // Build quaternion from forward (look) and up: derive rotation matrix then quaternion
+            XMVECTOR forward, right, up;
+            EditorCameraBasis(fc, forward, right, up);
+
             XMMATRIX basis;
             basis.r[0] = XMVectorSet(XMVectorGetX(right), XMVectorGetY(right), XMVectorGetZ(right), 0.0f);
             basis.r[1] = XMVectorSet(XMVectorGetX(up), XMVectorGetY(up), XMVectorGetZ(up), 0.0f);
@@ -119,14 +154,33 @@ namespace Engine
     }
 
 
-    void CameraMatrixSystem(Engine::Scene& scene, Engine::Renderer& renderer)
+    // World-space pose of an entity: parented entities decompose their propagated world matrix
+    static TransformComponent GetWorldPose(const entt::registry& registry, entt::entity entity)
+    {
+        const auto& local = registry.get<TransformComponent>(entity);
+        const auto* node = registry.try_get<HierarchyComponent>(entity);
+        const auto* wt = registry.try_get<WorldTransformComponent>(entity);
+        if (!node || node->parent == entt::null || !wt) return local;
+
+        TransformComponent pose;
+        XMVECTOR scale, rotation, translation;
+        if (!XMMatrixDecompose(&scale, &rotation, &translation, XMLoadFloat4x4(&wt->world))) return local;
+        XMStoreFloat3(&pose.scale, scale);
+        XMStoreFloat4(&pose.rotation, rotation);
+        XMStoreFloat3(&pose.position, translation);
+        return pose;
+    }
+
+
+    // Builds view/projection for the active render camera; false if there is no usable camera
+    static bool BuildActiveCameraMatrices(Engine::Scene& scene, XMMATRIX& outView, XMMATRIX& outProj)
     {
         // Get active camera entity
         const entt::entity cam = scene.m_activeRenderCamera;
-        if (cam == entt::null || !scene.registry.valid(cam)) return;
-        if (!scene.registry.all_of<TransformComponent, CameraComponent, ViewportComponent>(cam)) return;
+        if (cam == entt::null || !scene.registry.valid(cam)) return false;
+        if (!scene.registry.all_of<TransformComponent, CameraComponent, ViewportComponent>(cam)) return false;
 
-        const auto& tf = scene.registry.get<TransformComponent>(cam);   // camera transfor
+        const TransformComponent tf = GetWorldPose(scene.registry, cam);   // camera transform (world space)
         const auto& camc = scene.registry.get<CameraComponent>(cam);    // camera component
         const auto& vp = scene.registry.get<ViewportComponent>(cam);    // viewport component
 
@@ -139,68 +193,163 @@ namespace Engine
         const XMMATRIX world = S * R * T;
 
         // View matrix (LH): look-to using basis and position
-        const XMMATRIX view = XMMatrixInverse(nullptr, world);
+        outView = XMMatrixInverse(nullptr, world);
 
         // Projection matrix (LH)
         const float aspect = static_cast<float>(vp.width) / static_cast<float>(vp.height ? vp.height : 1u);
-        const XMMATRIX proj = XMMatrixPerspectiveFovLH(camc.FOV, aspect, camc.nearClip, camc.farClip);
-
-		// Upload to renderer
-        renderer.UpdateViewMatrix(view);
-        renderer.UpdateProjectionMatrix(proj);
+        outProj = XMMatrixPerspectiveFovLH(camc.FOV, aspect, camc.nearClip, camc.farClip);
+        return true;
     }
 
 
     namespace RenderSystem
     {
-        void DrawEntities(Engine::Scene& scene, MeshManager& meshManager, ShaderManager& shaderManager, Engine::Renderer& renderer, Engine::TextureManager& textureManager)
+        // Basic lit shader (temporary ID 1, see ShaderManager::LoadBasicShaders)
+        constexpr uint32_t kBasicShaderID = 1;
+        // Instanced variant of the basic shader (ID 3, see ShaderManager::LoadBasicInstancedShaders)
+        constexpr uint32_t kBasicInstancedShaderID = 3;
+        // COMPACT_VERTEX variants for meshes stored as CompactVertex (IDs 4/5, see ShaderManager::LoadBasicCompactShaders)
+        constexpr uint32_t kCompactShaderID = 4;
+        constexpr uint32_t kCompactInstancedShaderID = 5;
+        // Runs with fewer items than this are cheaper as plain draws than as an instanced draw
+        constexpr uint32_t kMinInstanceCount = 2;
+        // Vertex input layouts, used for the sort key's layout field and for RenderQueue::ChangeLayout
+        // (a numbering of their own, independent of shader and material IDs)
+        enum class LayoutKey : uint32_t
         {
-            auto* context = renderer.GetContext();
+            Basic = 0,          // Vertex
+            Compact,            // CompactVertex
+            BasicInstanced,     // Vertex + per-instance data
+            CompactInstanced,   // CompactVertex + per-instance data
+        };
 
-            // Bind basic shaders (temporary ID 1)
-            renderer.BindShader(shaderManager, 1);
+        void ExtractSnapshot(Engine::Scene& scene, const MeshManager& meshManager, Engine::RenderSnapshot& out, uint64_t frame)
+        {
+            out.Clear();
+            out.frame = frame;
 
-            // Bind sampler to PS s0 once per frame
-            ID3D11SamplerState* sampler = renderer.GetSamplerState();
-            if (sampler)
+            // Camera: matrices + the components the render side needs (skybox, clusters)
+            XMMATRIX camView, camProj;
+            if (BuildActiveCameraMatrices(scene, camView, camProj))
+            {
+                out.camera.valid = true;
+                XMStoreFloat4x4(&out.camera.view, camView);
+                XMStoreFloat4x4(&out.camera.proj, camProj);
+                out.camera.transform = GetWorldPose(scene.registry, scene.m_activeRenderCamera);
+                out.camera.camera = scene.registry.get<CameraComponent>(scene.m_activeRenderCamera);
+            }
+            else if (scene.m_activeRenderCamera != entt::null &&
+                     scene.registry.valid(scene.m_activeRenderCamera) &&
+                     scene.registry.all_of<TransformComponent>(scene.m_activeRenderCamera))
             {
-                context->PSSetSamplers(0, 1, &sampler);
+                // No frustum (missing camera/viewport), but the position still drives specular and sorting
+                out.camera.transform = GetWorldPose(scene.registry, scene.m_activeRenderCamera);
+                if (scene.registry.all_of<CameraComponent>(scene.m_activeRenderCamera))
+                    out.camera.camera = scene.registry.get<CameraComponent>(scene.m_activeRenderCamera);
+            }
+            else
+            {
+                out.camera.transform.position = XMFLOAT3(0.0f, 0.0f, -100.0f);
             }
 
-            // Global lights update: collect up to MAX_LIGHTS
+            // Lights (switched-off entities and lights are excluded by the view)
+            auto lightView = scene.registry.view<TransformComponent, LightComponent>(
+                entt::exclude<DisabledTag, ComponentDisabledTag<LightComponent>>);
+            for (auto [lightEnt, tc, lt] : lightView.each())
             {
-                Engine::LightConstants lc{};
-                lc.lightCount = 0;
+                out.lights.push_back(RenderSnapshot::Light{ GetWorldPose(scene.registry, lightEnt), lt });
+            }
 
-                // Camera position for specular calculations
-                if (scene.m_activeRenderCamera != entt::null &&
-                    scene.registry.valid(scene.m_activeRenderCamera) &&
-                    scene.registry.all_of<TransformComponent>(scene.m_activeRenderCamera))
+            // LOD selection: projected bounding-sphere diameter as a fraction of the viewport height
+            const bool selectLods = out.camera.valid;
+            const XMVECTOR lodEye = XMLoadFloat3(&out.camera.transform.position);
+            const float projScaleY = out.camera.proj._22;
+
+            // Renderables: refresh cached world bounds of active renderables and copy what submission needs
+            // (world matrices come from TransformHierarchy, which runs right before extraction).
+            // The owning group walks the packed active renderers and their world matrices in lockstep.
+            for (auto [entity, mr, wt] : GetRenderableGroup(scene.registry).each())
+            {
+                auto& wb = scene.registry.get_or_emplace<WorldBoundsComponent>(entity);
+                if (wb.cachedMeshID != mr.meshID || wb.cachedWorldVersion != wt.version)
                 {
-                    const auto& camTf = scene.registry.get<TransformComponent>(scene.m_activeRenderCamera);
-                    lc.cameraPos = camTf.position;
+                    MeshBounds local{};
+                    if (!meshManager.GetMeshBounds(mr.meshID, local))
+                        continue;
+
+                    Culling::TransformBounds(local.center, local.extents, local.radius, XMLoadFloat4x4(&wt.world), wb.center, wb.extents, wb.radius);
+
+                    wb.cachedWorldVersion = wt.version;
+                    wb.cachedMeshID = mr.meshID;
                 }
-                else
+
+                RenderSnapshot::Renderable r;
+                r.world = wt.world;
+                r.meshID = mr.meshID;
+                r.materialID = mr.materialID;
+                r.texture = mr.texture;
+                r.roughness = mr.roughness;
+                r.metallic = mr.metallic;
+                r.boundsCenter = wb.center;
+                r.boundsExtents = wb.extents;
+                r.boundsRadius = wb.radius;
+
+                // Relative to last frame's level, so a size hovering at a threshold does not flip every frame
+                const uint32_t lodCount = selectLods ? meshManager.GetMeshLodCount(mr.meshID) : 0;
+                if (lodCount > 0)
                 {
-                    lc.cameraPos = XMFLOAT3(0.0f, 0.0f, -100.0f);
+                    auto& lod = scene.registry.get_or_emplace<MeshLodComponent>(entity);
+                    const float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&wb.center), lodEye)));
+                    const float screenSize = distance > wb.radius ? wb.radius * projScaleY / distance : FLT_MAX;
+                    lod.level = static_cast<uint8_t>(MeshLodSelect::Select(screenSize, lod.level, lodCount));
+                    r.lod = lod.level;
                 }
+                out.renderables.push_back(r);
+            }
+        }
 
-                // Search for light entities and extract info
-                auto lightView = scene.registry.view<TransformComponent, LightComponent>();
-                for (auto lightEnt : lightView)
-                {
-                    if (lc.lightCount >= MAX_LIGHTS) break;
 
-                    // Respect master entity toggle (skip inactive entities entirely)
-                    if (scene.registry.all_of<NameComponent>(lightEnt)) {
-                        if (!scene.registry.get<NameComponent>(lightEnt).isActive) continue;
-                    }
+        void DrawEntities(const Engine::RenderSnapshot& snapshot, MeshManager& meshManager, ShaderManager& shaderManager, Engine::Renderer& renderer, Engine::TextureManager& textureManager, Engine::RenderQueue& renderQueue, FrameScratch& scratch, Engine::JobSystem& jobSystem)
+        {
+            // Bind sampler to PS s0 once per frame
+            ID3D11SamplerState* sampler = renderer.GetSamplerState();
+            if (sampler)
+            {
+                renderer.BindPSSampler(0, sampler);
+            }
 
-                    const auto& ltTf = lightView.get<TransformComponent>(lightEnt);
-                    const auto& lt = lightView.get<LightComponent>(lightEnt);
+            // Camera position (specular + sort depth), forward (view depth) and clip planes (depth normalization, clusters)
+            const RenderSnapshot::Camera& cam = snapshot.camera;
+            const XMFLOAT3 cameraPos = cam.transform.position;
+            XMFLOAT3 cameraForward(0.0f, 0.0f, 1.0f);
+            {
+                const XMVECTOR q = XMQuaternionNormalize(XMLoadFloat4(&cam.transform.rotation));
+                XMStoreFloat3(&cameraForward, XMVector3Normalize(XMVector3Rotate(XMVectorSet(0, 0, 1, 0), q)));
+            }
+            const float nearClip = cam.camera.nearClip;
+            const float farClip = cam.camera.farClip;
+
+            // View/projection of the snapshot camera (uploaded here so they always match the rendered state)
+            const bool hasFrustum = cam.valid;
+            const XMMATRIX camView = XMLoadFloat4x4(&cam.view);
+            const XMMATRIX camProj = XMLoadFloat4x4(&cam.proj);
+            if (hasFrustum)
+            {
+                renderer.UpdateViewMatrix(camView);
+                renderer.UpdateProjectionMatrix(camProj);
+            }
+            const Frustum frustum = hasFrustum ? Culling::ExtractFrustum(camView * camProj) : Frustum{};
+
+            // Global lights update: directional lights first (applied everywhere), then point/spot lights binned into clusters
+            {
+                scratch.directional.clear();
+                scratch.localLights.clear();
+                scratch.localBounds.clear();
 
-                    // Respect component active toggle
-                    if (!lt.isActive) continue;
+                for (const RenderSnapshot::Light& snapLight : snapshot.lights)
+                {
+                    const auto& ltTf = snapLight.transform;
+                    const auto& lt = snapLight.light;
 
                     // Direction: forward vector from quaternion rotated +Z (LH)
 					// forward is used because directional light shines along its forward axis
@@ -221,12 +370,23 @@ namespace Engine
                     ld.type      = static_cast<unsigned int>(lt.type);
                     ld.padding   = XMFLOAT3(0.0f, 0.0f, 0.0f);
 
-                    lc.lights[lc.lightCount] = ld;
-                    lc.lightCount++;
+                    if (lt.type == LightType::Directional)
+                    {
+                        scratch.directional.push_back(ld);
+                        continue;
+                    }
+
+                    ClusterLightBounds bounds{};
+                    bounds.position = ld.position;
+                    bounds.range = ld.range;
+                    bounds.direction = ld.direction;
+                    bounds.spotAngle = (lt.type == LightType::Spot) ? lt.spotAngle : 0.0f;
+                    scratch.localLights.push_back(ld);
+                    scratch.localBounds.push_back(bounds);
                 }
 
                 // If no light present, push a default directional light
-                if (lc.lightCount == 0)
+                if (scratch.directional.empty() && scratch.localLights.empty())
                 {
                     Engine::LightData ld{};
                     ld.position  = XMFLOAT3(0,0,0);
@@ -237,64 +397,198 @@ namespace Engine
                     ld.intensity = 1.0f;
                     ld.type      = static_cast<unsigned int>(Engine::LightType::Directional);
                     ld.padding   = XMFLOAT3(0.0f, 0.0f, 0.0f);
-                    lc.lights[0] = ld;
-                    lc.lightCount = 1;
+                    scratch.directional.push_back(ld);
                 }
 
-                // Upload & bind PS b3
-                renderer.UpdateLightConstants(lc);
+                // Local lights are indexed after the directional ones in the shared light buffer
+                const uint32_t directionalCount = static_cast<uint32_t>(scratch.directional.size());
+                ClusterCamera clusterCam{};
+                XMStoreFloat4x4(&clusterCam.view, hasFrustum ? camView : XMMatrixIdentity());
+                clusterCam.projScaleX = hasFrustum ? XMVectorGetX(camProj.r[0]) : 1.0f;
+                clusterCam.projScaleY = hasFrustum ? XMVectorGetY(camProj.r[1]) : 1.0f;
+                clusterCam.nearZ = nearClip;
+                clusterCam.farZ = farClip;
+                scratch.clusterer.Build(scratch.localBounds, clusterCam, directionalCount, &jobSystem);
+
+                scratch.directional.insert(scratch.directional.end(), scratch.localLights.begin(), scratch.localLights.end());
+
+                Engine::LightConstants lc{};
+                lc.cameraPos = cameraPos;
+                lc.directionalCount = directionalCount;
+                lc.cameraForward = cameraForward;
+                lc.lightCount = static_cast<uint32_t>(scratch.directional.size());
+                lc.clusterDimX = scratch.clusterer.GetDimX();
+                lc.clusterDimY = scratch.clusterer.GetDimY();
+                lc.clusterDimZ = scratch.clusterer.GetDimZ();
+                lc.clusterSliceScale = scratch.clusterer.GetSliceScale();
+                lc.clusterSliceBias = scratch.clusterer.GetSliceBias();
+                lc.invViewportSize = XMFLOAT2(
+                    1.0f / static_cast<float>(renderer.GetViewportWidth() ? renderer.GetViewportWidth() : 1u),
+                    1.0f / static_cast<float>(renderer.GetViewportHeight() ? renderer.GetViewportHeight() : 1u));
+
+                // Upload & bind PS t1-t3 + b3
+                const auto& indices = scratch.clusterer.GetIndexList();
+                const auto& ranges = scratch.clusterer.GetClusterRanges();
+                renderer.UpdateClusteredLights(lc,
+                    scratch.directional.data(), static_cast<UINT>(scratch.directional.size()),
+                    indices.data(), static_cast<UINT>(indices.size()),
+                    ranges.data(), scratch.clusterer.GetClusterCount());
             }
 
-            // Iterate renderable entities (assuming MeshRendererComponent and TransformComponent exist)
-            auto view = scene.registry.view<MeshRendererComponent, TransformComponent>();
-            for (auto entity : view)
+            // Candidate pass: pack the snapshot's world bounds for the SIMD cull
+            scratch.bounds.Clear();
+            for (const RenderSnapshot::Renderable& r : snapshot.renderables)
+                scratch.bounds.Push(r.boundsCenter, r.boundsExtents, r.boundsRadius);
+
+            if (hasFrustum)
             {
-                // Respect master entity toggle (skip inactive entities entirely)
-                if (scene.registry.all_of<NameComponent>(entity)) {
-                    if (!scene.registry.get<NameComponent>(entity).isActive) continue;
-                }
+                Culling::CullBounds(frustum, scratch.bounds, scratch.visible);
+            }
+            else
+            {
+                // No camera to cull against: keep everything
+                scratch.visible.resize(snapshot.renderables.size());
+                for (uint32_t i = 0; i < scratch.visible.size(); ++i) scratch.visible[i] = i;
+            }
+
+            // Gather pass: collect visible renderables into the queue as sort keys (shader | layout | texture | mesh | depth)
+            scratch.packets.clear();
+            renderQueue.Clear();
+
+            const XMVECTOR camPos = XMLoadFloat3(&cameraPos);
+            const float invFar = 1.0f / (farClip > 0.0f ? farClip : 1.0f);
+
+            for (uint32_t visibleIndex : scratch.visible)
+            {
+                const RenderSnapshot::Renderable& mr = snapshot.renderables[visibleIndex];
+
+                DrawPacket packet{};
+                if (!meshManager.GetMesh(mr.meshID, packet.mesh, mr.lod))
+                    continue;
+
+                // Compact meshes need the decoding shader and its 16-byte layout (skipped if it is not loaded)
+                const bool compact = packet.mesh.vertexFormat == VertexFormat::Compact;
+                const uint32_t shaderID = compact ? kCompactShaderID : kBasicShaderID;
+                const LayoutKey layoutKey = compact ? LayoutKey::Compact : LayoutKey::Basic;
+
+                // The layout follows the shader that draws the mesh, not the material
+                packet.renderable = visibleIndex;
+                packet.layout = shaderManager.GetInputLayout(static_cast<int>(shaderID));
+                if (!packet.layout)
+                    continue;
+                // Fall back to the default texture so the slot never leaks a previous draw's SRV
+                packet.texture = mr.texture ? mr.texture : textureManager.GetDefaultTexture();
 
-                auto& mr = view.get<MeshRendererComponent>(entity);
-                auto& tr = view.get<TransformComponent>(entity);
+                // Front-to-back within a state bucket
+                const float dist = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMVectorSet(mr.world._41, mr.world._42, mr.world._43, 1.0f), camPos)));
 
-                // Respect component active toggle
-                if (!mr.isActive) continue;
+                const uint64_t key = SortKey::Make(
+                    shaderID,
+                    static_cast<uint32_t>(layoutKey),
+                    renderQueue.GetTextureKey(packet.texture),
+                    renderQueue.GetMeshKey(mr.meshID, mr.lod),
+                    dist * invFar);
 
-                // Per-entity material constants (PS b4)
+                renderQueue.Submit(key, static_cast<uint32_t>(scratch.packets.size()));
+                scratch.packets.push_back(packet);
+            }
+
+            renderQueue.Sort();
+
+            // Batching: consecutive sorted items with identical shader/layout/texture/mesh become one instanced draw
+            const bool canInstance = shaderManager.GetInputLayout(kBasicInstancedShaderID) != nullptr &&
+                                     shaderManager.GetInputLayout(kCompactInstancedShaderID) != nullptr;
+            scratch.batcher.Build(renderQueue.GetItems(), canInstance ? kMinInstanceCount : UINT32_MAX,
+                [&](const DrawItem& item, InstanceData& inst)
                 {
-                    Engine::MaterialConstants mat{};
-                    mat.roughness = mr.roughness;
-                    mat.metallic = mr.metallic;
-                    renderer.UpdateMaterialConstants(mat);
-                }
+                    const DrawPacket& packet = scratch.packets[item.index];
+                    const RenderSnapshot::Renderable& mr = snapshot.renderables[packet.renderable];
+
+                    // Row-major, same as the world cbuffer (rows become WORLD0..3)
+                    inst.world = mr.world;
+                    inst.roughness = mr.roughness;
+                    inst.metallic = mr.metallic;
+                    inst.padding[0] = inst.padding[1] = 0.0f;
+                });
+
+            // One upload for every instanced batch of the frame
+            const auto& instances = scratch.batcher.GetInstances();
+            if (!instances.empty() &&
+                !renderer.UploadInstanceData(instances.data(), static_cast<UINT>(instances.size())))
+            {
+                // Upload failed: fall back to per-draw submission for everything
+                scratch.batcher.Build(renderQueue.GetItems(), UINT32_MAX, [](const DrawItem&, InstanceData&) {});
+            }
 
-                // World matrix from transform (position, rotation, scale)
-                XMMATRIX world =
-                    XMMatrixScaling(tr.scale.x, tr.scale.y, tr.scale.z) *
-                    XMMatrixRotationQuaternion(XMLoadFloat4(&tr.rotation)) *
-                    XMMatrixTranslation(tr.position.x, tr.position.y, tr.position.z);
-                renderer.UpdateWorldMatrix(world);
+            // Submission pass: walk sorted batches and only emit binds whose key field changed
+            const auto& items = renderQueue.GetItems();
+            renderQueue.ResetState();
+            for (const InstanceBatch& batch : scratch.batcher.GetBatches())
+            {
+                // Every item of a batch shares texture and mesh, so bind them from the first one
+                const DrawItem& first = items[batch.firstItem];
+                const DrawPacket& firstPacket = scratch.packets[first.index];
 
-                // Bind texture if present to PS t0, otherwise unbind to prevent state leakage
-                if (mr.texture)
+                if (batch.instanced)
                 {
-                    context->PSSetShaderResources(0, 1, &mr.texture);
+                    // Instanced variant reads world/material from IA slot 1 and binds its own layout
+                    const bool compact = firstPacket.mesh.vertexFormat == VertexFormat::Compact;
+                    const uint32_t shaderID = compact ? kCompactInstancedShaderID : kBasicInstancedShaderID;
+                    if (renderQueue.ChangeShader(shaderID))
+                        renderer.BindShader(shaderManager, static_cast<int>(shaderID));
+
+                    if (renderQueue.ChangeLayout(static_cast<uint32_t>(compact ? LayoutKey::CompactInstanced : LayoutKey::BasicInstanced)))
+                        renderer.BindInputLayout(shaderManager.GetInputLayout(static_cast<int>(shaderID)));
                 }
                 else
                 {
-                    ID3D11ShaderResourceView* defaultTex = textureManager.GetDefaultTexture();
-                    context->PSSetShaderResources(0, 1, &defaultTex);
+                    if (renderQueue.ChangeShader(SortKey::Shader(first.key)))
+                        renderer.BindShader(shaderManager, static_cast<int>(SortKey::Shader(first.key)));
+
+                    if (renderQueue.ChangeLayout(SortKey::Layout(first.key)))
+                        renderer.BindInputLayout(firstPacket.layout);
                 }
 
-                // Fetch mesh buffers
-                MeshBuffers buffers{};
-                if (!meshManager.GetMesh(mr.meshID, buffers))
+                if (renderQueue.ChangeTexture(SortKey::Texture(first.key)))
+                {
+                    renderer.BindPSTexture(0, firstPacket.texture);
+                }
+
+                // Meshes share arena buffers: the IA only changes with the arena pair, per-mesh constants with the mesh
+                if (renderQueue.ChangeGeometry(firstPacket.mesh.geometry))
+                    renderer.BindMeshBuffers(firstPacket.mesh);
+
+                if (renderQueue.ChangeMesh(SortKey::Mesh(first.key)))
+                    renderer.BindMeshConstants(firstPacket.mesh);
+
+                if (batch.instanced)
+                {
+                    renderer.DrawIndexedInstanced(firstPacket.mesh.indexCount, batch.itemCount, batch.firstInstance,
+                                                  firstPacket.mesh.startIndex, firstPacket.mesh.baseVertex);
+                    renderQueue.CountDraw(uint64_t(firstPacket.mesh.indexCount / 3) * batch.itemCount);
                     continue;
+                }
 
-                // Submit and draw
-                ID3D11InputLayout* layout = shaderManager.GetInputLayout(mr.materialID);
-                renderer.SubmitMesh(buffers, layout);
-                renderer.DrawIndexed(buffers.indexCount);
+                for (uint32_t i = batch.firstItem; i < batch.firstItem + batch.itemCount; ++i)
+                {
+                    const DrawPacket& packet = scratch.packets[items[i].index];
+                    const RenderSnapshot::Renderable& mr = snapshot.renderables[packet.renderable];
+
+                    // Per-entity material constants (PS b4), only uploaded when they differ from the previous draw
+                    if (renderQueue.ChangeMaterial(mr.roughness, mr.metallic))
+                    {
+                        Engine::MaterialConstants mat{};
+                        mat.roughness = mr.roughness;
+                        mat.metallic = mr.metallic;
+                        renderer.UpdateMaterialConstants(mat);
+                    }
+
+                    // Propagated world matrix (hierarchy already applied)
+                    renderer.UpdateWorldMatrix(XMLoadFloat4x4(&mr.world));
+
+                    renderer.DrawIndexed(packet.mesh.indexCount, packet.mesh.startIndex, packet.mesh.baseVertex);
+                    renderQueue.CountDraw(packet.mesh.indexCount / 3);
+                }
             }
         }
     }
@@ -308,82 +602,156 @@ namespace Engine
         return XMFLOAT4(q.GetX(), q.GetY(), q.GetZ(), q.GetW());
     }
 
-    void PhysicsSystem(Engine::Scene& scene, Engine::PhysicsManager& physicsManager, const Engine::MeshManager& meshManager, float dt, bool isPlaying)
-    {
-        // Phase 1: Initialization (Create Bodies) + Maintenance (Destroy bodies for inactive entities/components)
-        auto physView = scene.registry.view<TransformComponent, RigidBodyComponent>();
-        for (auto ent : physView)
-        {
-            auto& tc = physView.get<TransformComponent>(ent);
-            auto& rb = physView.get<RigidBodyComponent>(ent);
+    // New-body batches at least this large are followed by a broadphase rebuild
+    constexpr size_t kOptimizeBroadPhaseThreshold = 256;
 
-            bool isEntityActive = scene.registry.all_of<NameComponent>(ent) ? scene.registry.get<NameComponent>(ent).isActive : true;
+    // Snap both interpolation poses to the current transform (new bodies, edit mode)
+    static void ResetInterpolation(const TransformComponent& tc, RigidBodyComponent& rb)
+    {
+        rb.prevPosition = rb.currPosition = tc.position;
+        rb.prevRotation = rb.currRotation = tc.rotation;
+    }
 
-            // If either the entity is off, or the component is off, destroy the Jolt body
-            if (!rb.isActive || !isEntityActive) {
-                if (!rb.bodyID.IsInvalid()) {
-                    physicsManager.RemoveRigidBody(rb.bodyID);
-                    rb.bodyID = JPH::BodyID();
-                    rb.bodyCreated = false;
-                }
-                continue;
-            }
 
+    void PhysicsSystem(Engine::Scene& scene, Engine::PhysicsManager& physicsManager, const Engine::MeshManager& meshManager, float dt, bool isPlaying)
+    {
+        PhysicsStats& stats = physicsManager.GetStats();
+        stats = PhysicsStats{};
+
+        // Phase 1a: Maintenance: switched-off entities/components lose their Jolt body
+        // (only the tagged entities are visited, through the tag pools)
+        auto removeBody = [&](RigidBodyComponent& rb) {
+            if (rb.bodyID.IsInvalid()) return;
+            physicsManager.RemoveRigidBody(rb.bodyID);
+            rb.bodyID = JPH::BodyID();
+            rb.bodyCreated = false;
+        };
+        for (auto [ent, rb] : scene.registry.view<RigidBodyComponent, DisabledTag>().each()) removeBody(rb);
+        for (auto [ent, rb] : scene.registry.view<RigidBodyComponent, ComponentDisabledTag<RigidBodyComponent>>().each()) removeBody(rb);
+
+        // Phase 1b: Initialization (Create Bodies) for active bodies (owning group: packed, no per-entity checks)
+        auto physGroup = GetPhysicsBodyGroup(scene.registry);
+        for (auto [ent, rb, tc] : physGroup.each())
+        {
             // Auto-wire meshID if missing
             if (rb.shape == RBShape::Mesh && rb.meshID == 0 && scene.registry.all_of<MeshRendererComponent>(ent)) {
                 rb.meshID = scene.registry.get<MeshRendererComponent>(ent).meshID;
             }
 
             if (rb.bodyID.IsInvalid()) {
-                JPH::BodyID id = physicsManager.CreateRigidBody(tc, rb, meshManager);
+                // Created now, inserted below together with every other new body of this frame
+                JPH::BodyID id = physicsManager.QueueRigidBody(ent, tc, rb, meshManager);
                 rb.bodyID = id;
                 rb.bodyCreated = !id.IsInvalid();
+                rb.syncedTransform = tc;
+                ResetInterpolation(tc, rb);
             }
         }
 
+        // Batched broadphase insertion; big batches (level load, leaving Play mode) also rebuild the broadphase tree
+        stats.bodiesCreated = physicsManager.FlushPendingBodies(physicsManager.GetPendingBodyCount() >= kOptimizeBroadPhaseThreshold);
+
 		// Only update physics and sync transforms if we're in Play mode. 
         // In Edit mode, we allow free Transform editing without physics interference, and we push those changes to Jolt so colliders stay in sync with gizmo movements.
         if (isPlaying)
         {
-            // Phase 2: Simulation
-            physicsManager.Update(dt);
+            // Only awake bodies move, so only they are visited (sleeping debris costs nothing).
+            // Reads go through the lock-free interface: nothing else touches the bodies between steps.
+            const JPH::BodyInterface& bi = physicsManager.GetBodyInterfaceNoLock();
+            const std::vector<JPH::BodyID>* awake = nullptr;
 
-            // Phase 3: Synchronization (Jolt -> ECS)
-            JPH::BodyInterface& bi = physicsManager.GetBodyInterface();
-            for (auto ent : physView)
+            // Owning entity from the body's user data (null if the body is stale or was removed)
+            auto resolve = [&](const JPH::BodyID& id) -> entt::entity
             {
-                auto& tc = physView.get<TransformComponent>(ent);
-                auto& rb = physView.get<RigidBodyComponent>(ent);
+                const entt::entity ent = static_cast<entt::entity>(static_cast<entt::id_type>(bi.GetUserData(id)));
+                if (!scene.registry.valid(ent)) return entt::null;
+                const RigidBodyComponent* rb = scene.registry.try_get<RigidBodyComponent>(ent);
+                return (rb && rb->bodyID == id && scene.registry.all_of<TransformComponent>(ent)) ? ent : entt::null;
+            };
+
+            // Collects the Jolt pose of every awake body into either end of its interpolation pair
+            auto capturePoses = [&](bool intoPrevious)
+            {
+                awake = &physicsManager.GetAwakeBodies();
+                for (const JPH::BodyID& id : *awake)
+                {
+                    const entt::entity ent = resolve(id);
+                    if (ent == entt::null) continue;
+                    auto& rb = scene.registry.get<RigidBodyComponent>(ent);
+
+                    JPH::RVec3 pos;
+                    JPH::Quat rot;
+                    bi.GetPositionAndRotation(id, pos, rot);
+                    if (intoPrevious) {
+                        rb.prevPosition = FromJolt(pos);
+                        rb.prevRotation = FromJolt(rot);
+                    } else {
+                        rb.currPosition = FromJolt(pos);
+                        rb.currRotation = FromJolt(rot);
+                    }
+                }
+            };
 
-                bool isEntityActive = scene.registry.all_of<NameComponent>(ent) ? scene.registry.get<NameComponent>(ent).isActive : true;
-                if (!rb.isActive || !isEntityActive) continue;
+            // Phase 2: Simulation at a fixed rate; the pose before the final step becomes the interpolation start
+            // (bodies asleep at that point already hold prev == curr == their resting pose)
+            const int steps = physicsManager.ConsumeSteps(dt);
+            stats.steps = static_cast<uint32_t>(steps);
+            for (int i = 0; i < steps; ++i)
+            {
+                if (i == steps - 1) capturePoses(true);
+                physicsManager.Step();
+            }
+            if (steps > 0) capturePoses(false);
 
-                // Skip statics and invalid bodies
-                if (rb.motionType == RBMotion::Static) continue;
-                if (rb.bodyID.IsInvalid()) continue;
+            // Bodies that fell asleep: settle them on their final pose so they stop blending
+            for (const JPH::BodyID& id : physicsManager.TakeDeactivatedBodies())
+            {
+                const entt::entity ent = resolve(id);
+                if (ent == entt::null) continue;
+                auto& rb = scene.registry.get<RigidBodyComponent>(ent);
+                auto& tc = scene.registry.get<TransformComponent>(ent);
+
+                JPH::RVec3 pos;
+                JPH::Quat rot;
+                bi.GetPositionAndRotation(id, pos, rot);
+                tc.position = rb.prevPosition = rb.currPosition = FromJolt(pos);
+                tc.rotation = rb.prevRotation = rb.currRotation = FromJolt(rot);
+            }
 
-                const JPH::Vec3 pos = bi.GetPosition(rb.bodyID);
-                const JPH::Quat rot = bi.GetRotation(rb.bodyID);
+            // Phase 3: Synchronization (Jolt -> ECS), blended by the time left in the accumulator
+            if (steps == 0) awake = &physicsManager.GetAwakeBodies();
+            const float alpha = physicsManager.GetInterpolationAlpha();
+            for (const JPH::BodyID& id : *awake)
+            {
+                const entt::entity ent = resolve(id);
+                if (ent == entt::null) continue;
+                const auto& rb = scene.registry.get<RigidBodyComponent>(ent);
+                auto& tc = scene.registry.get<TransformComponent>(ent);
 
-                tc.position = FromJolt(pos);
-                tc.rotation = FromJolt(rot);
+                XMStoreFloat3(&tc.position, XMVectorLerp(XMLoadFloat3(&rb.prevPosition), XMLoadFloat3(&rb.currPosition), alpha));
+                XMStoreFloat4(&tc.rotation, XMQuaternionSlerp(XMLoadFloat4(&rb.prevRotation), XMLoadFloat4(&rb.currRotation), alpha));
             }
+            stats.awakeBodiesSynced = static_cast<uint32_t>(awake->size());
         }
         else
         {
+            // No simulated time carries over into the next Play session
+            physicsManager.ResetAccumulator();
+
+            // Sleep notifications only matter while simulating
+            physicsManager.TakeDeactivatedBodies();
+
             // Edit Mode: Sync ECS -> Jolt (Push Gizmo movements to physics colliders)
-            for (auto ent : physView)
+            // Only Transforms that differ from what was last pushed reach Jolt; untouched bodies cost one compare
+            for (auto [ent, rb, tc] : physGroup.each())
             {
-                auto& tc = physView.get<TransformComponent>(ent);
-                auto& rb = physView.get<RigidBodyComponent>(ent);
-
-                bool isEntityActive = scene.registry.all_of<NameComponent>(ent) ? scene.registry.get<NameComponent>(ent).isActive : true;
-                if (!rb.isActive || !isEntityActive) continue;
+                if (rb.bodyID.IsInvalid() || TransformEquals(rb.syncedTransform, tc)) continue;
 
-                if (!rb.bodyID.IsInvalid()) {
-                    physicsManager.ResetBodyTransform(tc, rb, meshManager);
-                }
+                physicsManager.ResetBodyTransform(tc, rb, meshManager);
+                rb.syncedTransform = tc;
+                ResetInterpolation(tc, rb);
+                ++stats.editSyncedBodies;
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #include "stb_image.h"
 
 #include "Engine/TextureManager.h"
+#include "Engine/Profiler.h"
 #include <vector>
 #include <sstream>
 
@@ -11,6 +12,7 @@ namespace Engine
 {
     ID3D11ShaderResourceView* TextureManager::LoadTexture(ID3D11Device* device, const std::string& filename)
     {
+        ENGINE_PROFILE_FUNCTION();
 		// Check Cache, return if found
         auto it = m_textureCache.find(filename);
         if (it != m_textureCache.end())
@@ -122,6 +124,7 @@ namespace Engine
 
     ID3D11ShaderResourceView* TextureManager::LoadCubemap(ID3D11Device* device, const std::vector<std::string>& filenames)
     {
+        ENGINE_PROFILE_FUNCTION();
         // Expect exactly 6 faces: +X, -X, +Y, -Y, +Z, -Z
         if (filenames.size() != 6)
             return nullptr;
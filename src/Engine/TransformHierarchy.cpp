@@ -0,0 +1,194 @@
+#include "Engine/TransformHierarchy.h"
+#include "Engine/JobSystem.h"
+#include <atomic>
+#include <chrono>
+
+using namespace DirectX;
+
+namespace Engine
+{
+    void TransformHierarchy::Connect(entt::registry& registry)
+    {
+        registry.on_construct<TransformComponent>().connect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_destroy<TransformComponent>().connect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_construct<HierarchyComponent>().connect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_update<HierarchyComponent>().connect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_destroy<HierarchyComponent>().connect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_destroy<WorldTransformComponent>().connect<&TransformHierarchy::OnStructureChanged>(*this);
+
+        // The owning groups move Transform/WorldTransform elements when entities enter or leave them, which
+        // invalidates the cached storage pointers: create them now and treat membership changes as structural
+        GetRenderableGroup(registry);
+        GetPhysicsBodyGroup(registry);
+        ConnectMembership<MeshRendererComponent>(registry, true);
+        ConnectMembership<RigidBodyComponent>(registry, true);
+        ConnectMembership<DisabledTag>(registry, true);
+        ConnectMembership<ComponentDisabledTag<MeshRendererComponent>>(registry, true);
+        ConnectMembership<ComponentDisabledTag<RigidBodyComponent>>(registry, true);
+        m_structureDirty = true;
+    }
+
+
+    void TransformHierarchy::Disconnect(entt::registry& registry)
+    {
+        registry.on_construct<TransformComponent>().disconnect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_destroy<TransformComponent>().disconnect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_construct<HierarchyComponent>().disconnect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_update<HierarchyComponent>().disconnect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_destroy<HierarchyComponent>().disconnect<&TransformHierarchy::OnStructureChanged>(*this);
+        registry.on_destroy<WorldTransformComponent>().disconnect<&TransformHierarchy::OnStructureChanged>(*this);
+        ConnectMembership<MeshRendererComponent>(registry, false);
+        ConnectMembership<RigidBodyComponent>(registry, false);
+        ConnectMembership<DisabledTag>(registry, false);
+        ConnectMembership<ComponentDisabledTag<MeshRendererComponent>>(registry, false);
+        ConnectMembership<ComponentDisabledTag<RigidBodyComponent>>(registry, false);
+    }
+
+
+    void TransformHierarchy::Rebuild(entt::registry& registry)
+    {
+        m_structureDirty = false;
+
+        m_parent.clear();
+        m_local.clear();
+        m_worldOut.clear();
+        m_batchStart.clear();
+
+        m_entities.clear();
+        m_depth.clear();
+
+        uint32_t trees = 0;
+        uint32_t maxDepth = 0;
+        uint32_t batchNodes = 0;
+
+        // A forest follows each sibling link once; more steps than links means the links loop (damaged data)
+        size_t linkSteps = registry.storage<HierarchyComponent>().size();
+
+        auto view = registry.view<TransformComponent>();
+        for (auto root : view)
+        {
+            // Roots: no parent, or a parent that is gone / has no transform to inherit
+            if (const auto* h = registry.try_get<HierarchyComponent>(root))
+            {
+                if (h->parent != entt::null && registry.valid(h->parent) && registry.all_of<TransformComponent>(h->parent))
+                    continue;
+            }
+
+            // Trees are never split, so a batch can propagate without waiting on another one
+            if (batchNodes == 0)
+                m_batchStart.push_back(static_cast<uint32_t>(m_entities.size()));
+
+            const uint32_t treeStart = static_cast<uint32_t>(m_entities.size());
+            m_entities.push_back(root);
+            m_parent.push_back(kNoParent);
+            m_depth.push_back(0);
+
+            // Breadth-first: the node list itself is the queue, so parents always precede their children
+            for (uint32_t node = treeStart; node < m_entities.size(); ++node)
+            {
+                const auto* h = registry.try_get<HierarchyComponent>(m_entities[node]);
+                for (entt::entity next = h ? h->firstChild : entt::null; next != entt::null && linkSteps > 0; --linkSteps)
+                {
+                    const entt::entity child = next;
+                    const auto* ch = registry.try_get<HierarchyComponent>(child);
+                    next = ch ? ch->nextSibling : entt::null;
+                    if (!registry.all_of<TransformComponent>(child)) continue;
+
+                    m_entities.push_back(child);
+                    m_parent.push_back(node);
+                    m_depth.push_back(m_depth[node] + 1);
+                    maxDepth = (m_depth.back() > maxDepth) ? m_depth.back() : maxDepth;
+                }
+            }
+
+            ++trees;
+            batchNodes += static_cast<uint32_t>(m_entities.size()) - treeStart;
+            if (batchNodes >= kBatchNodes) batchNodes = 0;
+        }
+
+        const uint32_t count = static_cast<uint32_t>(m_entities.size());
+        m_batchStart.push_back(count);
+
+        // Add missing world transforms first: an emplace can move other elements (owning group), so no pointer
+        // is taken until all are in place
+        for (uint32_t i = 0; i < count; ++i)
+            registry.get_or_emplace<WorldTransformComponent>(m_entities[i]);
+
+        // Cache storage pointers; they stay valid until the next structural change triggers another rebuild
+        m_local.resize(count);
+        m_worldOut.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            m_local[i] = &registry.get<TransformComponent>(m_entities[i]);
+            m_worldOut[i] = &registry.get<WorldTransformComponent>(m_entities[i]);
+        }
+
+        m_cachedLocal.resize(count);
+        m_world.resize(count);
+        m_changed.assign(count, 0);
+
+        m_stats.nodes = count;
+        m_stats.trees = trees;
+        m_stats.batches = static_cast<uint32_t>(m_batchStart.size() - 1);
+        m_stats.maxDepth = maxDepth;
+    }
+
+
+    uint32_t TransformHierarchy::PropagateRange(uint32_t begin, uint32_t end, bool force)
+    {
+        uint32_t recomputed = 0;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const TransformComponent& local = *m_local[i];
+            const uint32_t parent = m_parent[i];
+            const bool parentChanged = parent != kNoParent && m_changed[parent];
+
+            // Untouched subtrees cost one compare per node
+            if (!force && !parentChanged && TransformEquals(local, m_cachedLocal[i]))
+            {
+                m_changed[i] = 0;
+                continue;
+            }
+
+            XMMATRIX world =
+                XMMatrixScaling(local.scale.x, local.scale.y, local.scale.z) *
+                XMMatrixRotationQuaternion(XMLoadFloat4(&local.rotation)) *
+                XMMatrixTranslation(local.position.x, local.position.y, local.position.z);
+            if (parent != kNoParent)
+                world = world * XMLoadFloat4x4(&m_world[parent]);
+
+            XMStoreFloat4x4(&m_world[i], world);
+            m_cachedLocal[i] = local;
+            m_worldOut[i]->world = m_world[i];
+            ++m_worldOut[i]->version;
+
+            m_changed[i] = 1;
+            ++recomputed;
+        }
+        return recomputed;
+    }
+
+
+    void TransformHierarchy::Update(entt::registry& registry, JobSystem& jobs)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        // A rebuild invalidates every cached local transform, so everything is recomputed once
+        const bool rebuild = m_structureDirty;
+        if (rebuild)
+            Rebuild(registry);
+
+        // One batch per task: batches hold whole trees, so no task reads another task's nodes
+        std::atomic<uint32_t> recomputed{ 0 };
+        jobs.ParallelFor(m_stats.batches, 1, [&](uint32_t begin, uint32_t end) {
+            uint32_t count = 0;
+            for (uint32_t b = begin; b < end; ++b)
+                count += PropagateRange(m_batchStart[b], m_batchStart[b + 1], rebuild);
+            recomputed.fetch_add(count, std::memory_order_relaxed);
+        });
+
+        m_stats.recomputed = recomputed.load(std::memory_order_relaxed);
+        m_stats.rebuilt = rebuild;
+        m_stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
@@ -2,12 +2,26 @@
 #include "Engine/Renderer.h"
 #include "Engine/InputManager.h"
 #include "Engine/Scene.h"
+#include "Engine/MeshCache.h"
 #include "Engine/MeshManager.h"
+#include "Engine/OffsetAllocator.h"
 #include "Engine/ShaderManager.h"
 #include "Engine/Systems.h"
 #include "Engine/TextureManager.h"
 #include "Engine/ImGuiManager.h"
 #include "Engine/EditorUI.h"
+#include "Engine/Profiler.h"
+#include "Engine/TransformHierarchy.h"
+#include "Engine/SceneSerializer.h"
+#include "Engine/SceneSnapshot.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <utility>
 
 // Common Usings
 using namespace DirectX;
@@ -26,12 +40,31 @@ Uint64 g_lastCounter = 0;
 bool g_running = true;
 bool g_vSync = true; // can toggle later
 
+// Headless mode (--headless [frames] [--render-log file]): hidden window, null render device, fixed dt, prints CPU cost
+bool g_headless = false;
+int g_headlessFrames = 300;
+const char* g_renderLogPath = nullptr;
+float g_physicsHz = 60.0f;          // fixed physics step rate (--physics-hz)
+int g_physicsMaxSubsteps = 4;       // fixed steps allowed per frame before time is dropped
+int g_hierarchyNodes = 0;           // --hierarchy-nodes N: adds an N-node transform tree (propagation benchmark)
+int g_snapshotBenchEntities = 0;    // --snapshot-bench N: Play/Stop backup round trip of an N-entity scene
+int g_cookBenchEntities = 0;        // --cook-bench N: cooked scene file save/load of an N-entity scene
+int g_iterationBenchEntities = 0;   // --iteration-bench N: hot-path iteration, per-entity activation checks vs groups
+const char* g_meshCacheBenchPath = nullptr; // --mesh-cache-bench model: Assimp import vs cooked mesh cache load
+int g_arenaBenchOps = 0;            // --arena-bench N: geometry arena allocator churn + mesh release/defragment
+int g_raycastBenchBodies = 0;       // --raycast-bench N: one ray per body over N static bodies, CastRay loop vs CastRays
+int g_spawnBenchBodies = 0;         // --spawn-bench N: N rigid bodies inserted one by one vs batched (AddBodiesPrepare/Finalize)
+int g_jobsBenchWorkers = 0;         // --jobs-bench N: physics step with 1..N worker threads
+const char* g_scenePath = nullptr;  // --scene file: replaces the LoadContent scene (.json or cooked)
+const char* g_tracePath = nullptr;  // --trace file: Chrome trace JSON written at exit (ENGINE_ENABLE_PROFILER builds)
+
 // Input manager
 Engine::InputManager g_input;
 
 // ECS: Scene and a sample 3d entity
 Engine::Scene g_scene;
 entt::entity g_sampleEntity = entt::null;
+Engine::TransformHierarchy g_transformHierarchy; // parent/child world matrix propagation
 
 // Managers
 Engine::MeshManager g_meshManager;
@@ -40,6 +73,19 @@ Engine::TextureManager g_textureManager; // global texture manager instance
 
 // Renderer
 Engine::Renderer g_renderer;
+Engine::RenderQueue g_renderQueue; // sorted draw submission (reused every frame)
+Engine::RenderSystem::FrameScratch g_renderScratch; // DrawEntities working buffers (reused every frame)
+
+// Worker threads shared by physics and engine systems
+Engine::JobSystem g_jobSystem;
+Engine::SystemScheduler g_systemScheduler; // per-frame update systems (DAG from declared component access)
+bool g_serialSystems = false;              // --serial-systems: deterministic registration-order execution
+
+// Render snapshots: rendering reads a copy of the scene, so simulation may run alongside it
+Engine::RenderSnapshotBuffer g_renderSnapshots;
+bool g_pipelined = false;                  // --pipelined: frame N+1 simulates while frame N is submitted
+uint64_t g_simFrame = 0;                   // completed Update() calls
+int64_t g_lastRenderLag = 0;               // simulation frames the last rendered snapshot was behind
 
 // Physics
 Engine::PhysicsManager g_physicsManager;
@@ -52,11 +98,24 @@ Engine::EditorUI g_editorUI;
 
 // Forward declarations
 static void LoadContent();
+static void RegisterSystems();
+static bool RunHeadless(int frames);
+static void RunSnapshotBenchmark(int entityCount);
+static void RunNameStorageComparison(int entityCount, size_t internedTableBytes);
+static void RunSceneIoBenchmark(int entityCount);
+static void RunIterationBenchmark(int entityCount);
+static void RunMeshCacheBenchmark(const char* modelPath);
+static void RunArenaBenchmark(int opCount);
+static void RunRaycastBenchmark(int bodyCount);
+static void RunSpawnBenchmark(int bodyCount);
+static void RunJobsBenchmark(int maxWorkers);
 void Update(float deltaTime);
-void Render();
+void Render(float deltaTime);
 
 static void LoadContent()
 {
+    ENGINE_PROFILE_FUNCTION();
+
     // Create the default 1x1 fallback texture
     g_textureManager.CreateDefaultTexture(g_renderer.GetDevice());
 
@@ -65,14 +124,21 @@ static void LoadContent()
 
     // Ensure skybox cube mesh (ID 101) always exists for DrawSkybox
     // Note: keep this unconditional to guarantee Mesh 101 availability
-    const int cubeMeshID = g_meshManager.InitializeCube(g_renderer.GetDevice()); // temporary ID 101
+    const int cubeMeshID = g_meshManager.InitializeCube(g_renderer.GetDevice(), g_renderer.GetRenderDevice()); // temporary ID 101
 
     // Compile & load skybox shaders (assign temporary ID 2 inside ShaderManager implementation)
     const int skyboxShaderID = g_shaderManager.LoadSkyboxShaders(g_renderer.GetDevice());
 
+    // Instanced variant of the basic shader (temporary ID 3), used by DrawEntities for repeated mesh/texture runs
+    g_shaderManager.LoadBasicInstancedShaders(g_renderer.GetDevice());
+
+    // Variants for meshes stored as 16-byte CompactVertex (IDs 4/5); MeshManager picks the format per mesh
+    g_shaderManager.LoadBasicCompactShaders(g_renderer.GetDevice());
+    g_shaderManager.LoadBasicInstancedCompactShaders(g_renderer.GetDevice());
+
     // Create shared primitive meshes for editor-spawned entities
-    const int sphereMeshID = g_meshManager.CreateSphere(g_renderer.GetDevice(), 0.5f, 32, 32);
-    const int capsuleMeshID = g_meshManager.CreateCapsule(g_renderer.GetDevice(), 0.5f, 1.0f, 32, 32);
+    const int sphereMeshID = g_meshManager.CreateSphere(g_renderer.GetDevice(), g_renderer.GetRenderDevice(), 0.5f, 32, 32);
+    const int capsuleMeshID = g_meshManager.CreateCapsule(g_renderer.GetDevice(), g_renderer.GetRenderDevice(), 0.5f, 1.0f, 32, 32);
 
     // Cache default assets on the Scene so EditorUI can autonomously spawn primitives
     g_scene.SetDefaultAssets(shaderID, cubeMeshID, sphereMeshID, capsuleMeshID);
@@ -115,7 +181,7 @@ static void LoadContent()
         );
     }
 
-    auto meshIDs = g_meshManager.LoadModel(g_renderer.GetDevice(), "assets/Models/MyModel.obj");
+    auto meshIDs = g_meshManager.LoadModel(g_renderer.GetDevice(), g_renderer.GetRenderDevice(), "assets/Models/MyModel.obj");
     // Create the sample entity
     {
         g_sampleEntity = g_scene.CreateSampleEntity("Sample 3D Model");
@@ -261,11 +327,102 @@ static void LoadContent()
         rend.metallic = 0.2f;
         g_scene.registry.emplace<Engine::MeshRendererComponent>(capsule, rend);
     }
+
+    // Propagation benchmark: a 4-ary tree of empty entities under one root
+    if (g_hierarchyNodes > 0)
+    {
+        std::vector<entt::entity> nodes;
+        nodes.reserve(static_cast<size_t>(g_hierarchyNodes));
+        for (int i = 0; i < g_hierarchyNodes; ++i)
+        {
+            const entt::entity node = g_scene.registry.create();
+            auto& tc = g_scene.registry.emplace<Engine::TransformComponent>(node);
+            tc.position = XMFLOAT3(0.5f, 0.0f, 0.0f);
+            if (i > 0) g_scene.SetParent(node, nodes[(i - 1) / 4], false);
+            nodes.push_back(node);
+        }
+    }
 }
 
 // Main entry point
 int main(int argc, char** argv)
 {
+    int exitCode = 0;
+
+    ENGINE_PROFILE_THREAD("Main");
+
+    // Command line
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            g_headless = true;
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+                g_headlessFrames = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--render-log") == 0 && i + 1 < argc)
+        {
+            g_renderLogPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--pipelined") == 0)
+        {
+            g_pipelined = true;
+        }
+        else if (std::strcmp(argv[i], "--serial-systems") == 0)
+        {
+            g_serialSystems = true;
+        }
+        else if (std::strcmp(argv[i], "--snapshot-bench") == 0 && i + 1 < argc)
+        {
+            g_snapshotBenchEntities = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--cook-bench") == 0 && i + 1 < argc)
+        {
+            g_cookBenchEntities = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--iteration-bench") == 0 && i + 1 < argc)
+        {
+            g_iterationBenchEntities = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--mesh-cache-bench") == 0 && i + 1 < argc)
+        {
+            g_meshCacheBenchPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--arena-bench") == 0 && i + 1 < argc)
+        {
+            g_arenaBenchOps = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--raycast-bench") == 0 && i + 1 < argc)
+        {
+            g_raycastBenchBodies = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--spawn-bench") == 0 && i + 1 < argc)
+        {
+            g_spawnBenchBodies = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--jobs-bench") == 0 && i + 1 < argc)
+        {
+            g_jobsBenchWorkers = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--scene") == 0 && i + 1 < argc)
+        {
+            g_scenePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            g_tracePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--hierarchy-nodes") == 0 && i + 1 < argc)
+        {
+            g_hierarchyNodes = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--physics-hz") == 0 && i + 1 < argc)
+        {
+            const float hz = static_cast<float>(std::atof(argv[++i]));
+            if (hz > 0.0f) g_physicsHz = hz;
+        }
+    }
+
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0)
     {
@@ -278,7 +435,7 @@ int main(int argc, char** argv)
         "DX11GameEngine",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
         g_windowWidth, g_windowHeight,
-        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI
+        (g_headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN) | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI
     );
     if (!g_SDLWindow)
     {
@@ -300,7 +457,8 @@ int main(int argc, char** argv)
     g_Hwnd = wmInfo.info.win.window;
 
     // Initialize DirectX 11 via Renderer
-    if (!g_renderer.InitD3D11(g_Hwnd, (UINT)g_windowWidth, (UINT)g_windowHeight))
+    const Engine::RenderBackend backend = g_headless ? Engine::RenderBackend::Null : Engine::RenderBackend::D3D11;
+    if (!g_renderer.InitD3D11(g_Hwnd, (UINT)g_windowWidth, (UINT)g_windowHeight, backend))
     {
         std::fprintf(stderr, "Renderer initialization failed\n");
         SDL_DestroyWindow(g_SDLWindow);
@@ -321,10 +479,18 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    // Headless: the UI is still built every frame, but its draw data never reaches the GPU
+    if (g_headless)
+        g_imGuiManager.SetSubmitDrawData(false);
+
+    // Initialize the job system first, physics schedules its jobs on it
+    g_jobSystem.Initialize();
+
     // Initialize physics (Jolt)
-    if (!g_physicsManager.Initialize())
+    if (!g_physicsManager.Initialize(g_jobSystem))
     {
         std::fprintf(stderr, "PhysicsManager initialization failed\n");
+        g_jobSystem.Shutdown();
         g_imGuiManager.Shutdown();
         g_renderer.Shutdown();
         if (g_SDLWindow) {
@@ -334,14 +500,23 @@ int main(int argc, char** argv)
         SDL_Quit();
         return -1;
     }
+    g_physicsManager.SetFixedTimestep(g_physicsHz, g_physicsMaxSubsteps);
+
+    g_transformHierarchy.Connect(g_scene.registry);
 
     try {
         LoadContent();
+        RegisterSystems();
+
+        // A scene file replaces the built-in scene (meshes/shaders from LoadContent stay loaded)
+        if (g_scenePath && !Engine::SceneSerializer::Load(g_scene, g_scenePath, g_physicsManager))
+            throw std::runtime_error(std::string("cannot load scene ") + g_scenePath);
     }
     catch (const std::exception& e)
     {
         std::fprintf(stderr, "Content load failed: %s\n", e.what());
         g_physicsManager.Shutdown();
+        g_jobSystem.Shutdown();
         g_imGuiManager.Shutdown();
         g_renderer.Shutdown();
         if (g_SDLWindow) {
@@ -352,12 +527,28 @@ int main(int argc, char** argv)
         return -1;
     }
 
+#ifdef ENGINE_ENABLE_PROFILER
+    // Calibrate once up front, the editor panel and the headless overhead check read the cached value
+    Engine::Profiler::Get().GetScopeCostNs();
+#endif
+
     // Main loop
     g_perfFreq = SDL_GetPerformanceFrequency();
     g_lastCounter = SDL_GetPerformanceCounter();
 
+    // Headless runs a fixed number of frames instead of the interactive loop
+    if (g_headless)
+    {
+        if (!RunHeadless(g_headlessFrames))
+            exitCode = 1;
+        g_running = false;
+    }
+
     while (g_running)
     {
+        ENGINE_PROFILE_FRAME();
+        ENGINE_PROFILE_SCOPE("Frame");
+
         // Begin input frame
         g_input.BeginFrame();
 
@@ -392,14 +583,28 @@ int main(int argc, char** argv)
         float dt = float(double(currentCounter - g_lastCounter) / double(g_perfFreq));    // delta time in seconds
         g_lastCounter = currentCounter;
 
-        Update(dt);
+        // Work handed back to the main thread by jobs (D3D context access etc.)
+        g_jobSystem.ExecuteMainThreadTasks();
+
+        // Pipelined mode runs Update inside Render, alongside submission of the previous frame's snapshot
+        if (!g_pipelined)
+            Update(dt);
 
         // Render & present
-        Render();
+        Render(dt);
     }
 
+#ifdef ENGINE_ENABLE_PROFILER
+    if (g_tracePath && !Engine::Profiler::Get().WriteChromeTrace(g_tracePath))
+        exitCode = 1;
+#else
+    if (g_tracePath)
+        std::fprintf(stderr, "--trace ignored: built without ENGINE_ENABLE_PROFILER\n");
+#endif
+
     // Shutdown and cleanup
     g_physicsManager.Shutdown();
+    g_jobSystem.Shutdown();
     g_imGuiManager.Shutdown();
     g_renderer.Shutdown();
     if (g_SDLWindow) {
@@ -407,23 +612,706 @@ int main(int argc, char** argv)
         g_SDLWindow = nullptr;
     }
     SDL_Quit();
-    return 0;
+    return exitCode;
 }
 
-void Update(float deltaTime) {
+static bool RunHeadless(int frames)
+{
+    // Null backend: every renderer command lands in the NullRenderDevice counters
+    auto& device = static_cast<Engine::NullRenderDevice&>(g_renderer.GetRenderDevice());
+
+    std::FILE* log = g_renderLogPath ? std::fopen(g_renderLogPath, "w") : nullptr;
+    device.SetLog(log);
+
+    // Fixed dt so runs are comparable
+    const float dt = 1.0f / 60.0f;
+    double totalMs = 0.0, minMs = 1e30, maxMs = 0.0;
+    uint64_t totalDraws = 0, totalBinds = 0, totalUploads = 0, totalUploadBytes = 0;
+    uint64_t totalSyncedBodies = 0, totalTriangles = 0;
+    std::vector<double> systemMs(g_systemScheduler.GetTimings().size(), 0.0);
+    double scheduleMs = 0.0; // wall time of the whole system graph (less than the sum when systems overlap)
+    double hierarchyMs = 0.0, hierarchyMaxMs = 0.0;
+    uint64_t hierarchyRecomputed = 0;
+    int64_t minLag = INT64_MAX, maxLag = INT64_MIN;
+#ifdef ENGINE_ENABLE_PROFILER
+    const uint64_t eventsBefore = Engine::Profiler::Get().GetEventCount();
+#endif
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        ENGINE_PROFILE_FRAME();
+        ENGINE_PROFILE_SCOPE("Frame");
+
+        // Keep SDL's event queue drained (hidden window), input stays idle
+        g_input.BeginFrame();
+        SDL_Event e;
+        while (SDL_PollEvent(&e)) {}
+
+        if (log) std::fprintf(log, "--- frame %d\n", frame);
+        device.ResetStats();
+
+        g_jobSystem.ExecuteMainThreadTasks();
+
+        const Uint64 start = SDL_GetPerformanceCounter();
+        if (!g_pipelined)
+            Update(dt);
+        Render(dt);
+        const double ms = double(SDL_GetPerformanceCounter() - start) * 1000.0 / double(g_perfFreq);
+
+        const Engine::RenderDeviceStats& st = device.GetStats();
+        totalMs += ms;
+        minMs = (ms < minMs) ? ms : minMs;
+        maxMs = (ms > maxMs) ? ms : maxMs;
+        totalDraws += st.draws;
+        totalBinds += st.shaderBinds + st.layoutBinds + st.vertexBufferBinds + st.indexBufferBinds +
+                      st.constantBufferBinds + st.textureBinds + st.samplerBinds + st.stateBinds;
+        totalUploads += st.uploads;
+        totalUploadBytes += st.uploadBytes;
+        totalSyncedBodies += g_physicsManager.GetStats().editSyncedBodies;
+        totalTriangles += g_renderQueue.GetStats().triangles;
+        for (size_t i = 0; i < systemMs.size(); ++i) systemMs[i] += g_systemScheduler.GetTimings()[i].ms;
+        scheduleMs += g_systemScheduler.GetLastFrameMs();
+
+        // Frame 0 includes the initial order build; steady state is what matters
+        const Engine::TransformHierarchyStats& hs = g_transformHierarchy.GetStats();
+        if (frame > 0)
+        {
+            hierarchyMs += hs.ms;
+            hierarchyMaxMs = (hs.ms > hierarchyMaxMs) ? hs.ms : hierarchyMaxMs;
+            hierarchyRecomputed += hs.recomputed;
+        }
+
+        // The rendered snapshot must be exactly one simulation frame old when pipelined, current otherwise
+        minLag = (g_lastRenderLag < minLag) ? g_lastRenderLag : minLag;
+        maxLag = (g_lastRenderLag > maxLag) ? g_lastRenderLag : maxLag;
+    }
+
+    device.SetLog(nullptr);
+    if (log) std::fclose(log);
+
+    // One machine-readable line for CI
+    const double n = frames > 0 ? double(frames) : 1.0;
+    std::printf("headless frames=%d cpu_ms_avg=%.3f cpu_ms_min=%.3f cpu_ms_max=%.3f draws_per_frame=%.1f binds_per_frame=%.1f uploads_per_frame=%.1f upload_kb_per_frame=%.2f physics_synced_per_frame=%.1f\n",
+        frames, totalMs / n, frames > 0 ? minMs : 0.0, maxMs,
+        double(totalDraws) / n, double(totalBinds) / n, double(totalUploads) / n, double(totalUploadBytes) / 1024.0 / n,
+        double(totalSyncedBodies) / n);
+
+    // Per-system average cost
+    double systemSumMs = 0.0;
+    std::printf("headless systems serial=%d", g_systemScheduler.IsSerial() ? 1 : 0);
+    for (size_t i = 0; i < systemMs.size(); ++i)
+    {
+        std::printf(" %s_ms=%.3f", g_systemScheduler.GetTimings()[i].name.c_str(), systemMs[i] / n);
+        systemSumMs += systemMs[i];
+    }
+    std::printf(" sum_ms=%.3f graph_ms=%.3f overlap=%.2f\n", systemSumMs / n, scheduleMs / n, scheduleMs > 0.0 ? systemSumMs / scheduleMs : 1.0);
+
+    // Transform propagation (steady state, frame 0 excluded)
+    const Engine::TransformHierarchyStats& hs = g_transformHierarchy.GetStats();
+    const double hn = frames > 1 ? double(frames - 1) : 1.0;
+    std::printf("headless hierarchy nodes=%u trees=%u batches=%u max_depth=%u propagate_ms_avg=%.3f propagate_ms_max=%.3f recomputed_per_frame=%.1f\n",
+        hs.nodes, hs.trees, hs.batches, hs.maxDepth, hierarchyMs / hn, hierarchyMaxMs, double(hierarchyRecomputed) / hn);
+
+    // Mesh memory: compact vertices + 16-bit indices against 32-byte vertices + 32-bit indices
+    const Engine::MeshMemoryStats& mm = g_meshManager.GetMemoryStats();
+    const uint64_t meshBytes = mm.vertexBytes + mm.indexBytes;
+    std::printf("headless mesh_memory meshes=%u compact=%u index16=%u vertex_kb=%.1f index_kb=%.1f uncompressed_kb=%.1f ratio=%.3f\n",
+        mm.meshes, mm.compactMeshes, mm.index16Meshes, double(mm.vertexBytes) / 1024.0, double(mm.indexBytes) / 1024.0,
+        double(mm.uncompressedBytes) / 1024.0, mm.uncompressedBytes ? double(meshBytes) / double(mm.uncompressedBytes) : 1.0);
+
+    // Geometry arenas: every mesh shares a few vertex/index buffers
+    const Engine::MeshArenaStats as = g_meshManager.GetArenaStats();
+    std::printf("headless mesh_arena capacity_kb=%.1f used_kb=%.1f free_ranges=%u largest_free_kb=%.1f grows=%u\n",
+        double(as.capacityBytes) / 1024.0, double(as.usedBytes) / 1024.0, as.freeRanges, double(as.largestFreeBytes) / 1024.0, as.grows);
+
+    // LOD chains of the default primitives, and the scene triangles actually submitted after LOD selection
+    std::printf("headless mesh_lod triangles_per_frame=%.1f", double(totalTriangles) / n);
+    const std::pair<const char*, int> lodMeshes[] = { { "sphere", g_scene.GetSphereMeshID() }, { "capsule", g_scene.GetCapsuleMeshID() } };
+    for (const auto& [name, meshID] : lodMeshes)
+    {
+        const uint32_t levels = g_meshManager.GetMeshLodCount(meshID);
+        std::printf(" %s_levels=%u %s_tris=", name, levels, name);
+        for (uint32_t lod = 0; lod <= levels; ++lod)
+        {
+            Engine::MeshBuffers mb{};
+            g_meshManager.GetMesh(meshID, mb, lod);
+            std::printf(lod ? "/%u" : "%u", mb.indexCount / 3);
+        }
+    }
+    std::printf("\n");
+
+    // Pipelining check: fails the run (non-zero exit) if any frame rendered other than the expected state
+    const int64_t expectedLag = g_pipelined ? 1 : 0;
+    const bool lagOk = frames <= 0 || (minLag == expectedLag && maxLag == expectedLag);
+    std::printf("headless pipelined=%d render_lag_min=%lld render_lag_max=%lld lag_check=%s\n",
+        g_pipelined ? 1 : 0, frames > 0 ? (long long)minLag : 0LL, frames > 0 ? (long long)maxLag : 0LL, lagOk ? "pass" : "FAIL");
+
+    // Profiler overhead: recorded scopes per frame times the calibrated cost of one scope, against the frame time
+#ifdef ENGINE_ENABLE_PROFILER
+    const double eventsPerFrame = double(Engine::Profiler::Get().GetEventCount() - eventsBefore) / n;
+    const double scopeNs = Engine::Profiler::Get().GetScopeCostNs();
+    const double overheadPct = totalMs > 0.0 ? eventsPerFrame * scopeNs / (totalMs / n * 1e6) * 100.0 : 0.0;
+    // The overhead is a wall-clock ratio and only reported; the frames must have recorded scopes at all
+    const bool profilerOk = frames <= 0 || eventsPerFrame > 0.0;
+    std::printf("headless profiler enabled=1 events_per_frame=%.1f scope_ns=%.1f overhead_pct=%.3f recording=%s\n",
+        eventsPerFrame, scopeNs, overheadPct, profilerOk ? "pass" : "FAIL");
+#else
+    const bool profilerOk = true;
+    std::printf("headless profiler enabled=0\n");
+#endif
+
+    if (g_snapshotBenchEntities > 0) RunSnapshotBenchmark(g_snapshotBenchEntities);
+    RunSceneIoBenchmark(g_cookBenchEntities);
+    if (g_iterationBenchEntities > 0) RunIterationBenchmark(g_iterationBenchEntities);
+    if (g_meshCacheBenchPath) RunMeshCacheBenchmark(g_meshCacheBenchPath);
+    if (g_arenaBenchOps > 0) RunArenaBenchmark(g_arenaBenchOps);
+    if (g_raycastBenchBodies > 0) RunRaycastBenchmark(g_raycastBenchBodies);
+    if (g_spawnBenchBodies > 0) RunSpawnBenchmark(g_spawnBenchBodies);
+    if (g_jobsBenchWorkers > 0) RunJobsBenchmark(g_jobsBenchWorkers);
+    return lagOk && profilerOk;
+}
+
+// Edit->Play->Stop on a separate scene: backup, mutate everything, restore (save/restore cost of the backup)
+static void RunSnapshotBenchmark(int entityCount)
+{
+    auto scene = std::make_unique<Engine::Scene>();
+    const size_t nameBytesBefore = Engine::GetNameTable().GetMemoryBytes();
+    entt::entity parent = entt::null, destroyed = entt::null;
+    for (int i = 0; i < entityCount; ++i)
+    {
+        const entt::entity e = (i % 100 == 0)
+            ? scene->CreatePointLight("Light", XMFLOAT3(float(i), 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f), 1.0f, 5.0f)
+            : scene->CreateCube("Cube " + std::to_string(i));
+        scene->registry.get<Engine::TransformComponent>(e).position = XMFLOAT3(float(i), float(i % 7), 0.0f);
+        if (parent == entt::null) parent = e;
+        else if (i % 10 == 1) scene->SetParent(e, parent, false);
+        if (i == 2) destroyed = e;
+    }
+
+    const Uint64 saveStart = SDL_GetPerformanceCounter();
+    scene->CopyToBackup();
+    const double saveMs = double(SDL_GetPerformanceCounter() - saveStart) * 1000.0 / double(g_perfFreq);
+
+    // "Play": move, rename, destroy and create
+    for (auto [e, tc] : scene->registry.view<Engine::TransformComponent>().each()) tc.position.y += 10.0f;
+    for (auto [e, nc] : scene->registry.view<Engine::NameComponent>().each()) nc.name = Engine::GetNameTable().Intern("Played");
+    for (int i = 0; i < 16; ++i) scene->CreateSphere("Spawned");
+    if (destroyed != entt::null) scene->DestroyEntity(destroyed, g_physicsManager);
+
+    const Uint64 restoreStart = SDL_GetPerformanceCounter();
+    scene->RestoreFromBackup(g_physicsManager);
+    const double restoreMs = double(SDL_GetPerformanceCounter() - restoreStart) * 1000.0 / double(g_perfFreq);
+
+    std::printf("headless snapshot entities=%d bytes=%zu save_ms=%.3f restore_ms=%.3f\n",
+        entityCount, scene->GetBackupSize(), saveMs, restoreMs);
+
+    RunNameStorageComparison(entityCount, Engine::GetNameTable().GetMemoryBytes() - nameBytesBefore);
+}
+
+// Name storage before/after interning: the same names as a std::string component (the old NameComponent, saved
+// per entity through save/load functions) and as NameTable handles (raw column copy). Only the name column is timed.
+static void RunNameStorageComparison(int entityCount, size_t internedTableBytes)
+{
+    struct StringNameComponent
+    {
+        std::string name;
+        bool isActive = true;
+    };
+
+    Engine::SceneSnapshot stringFormat;
+    stringFormat.Register<StringNameComponent>("StringName",
+        [](Engine::BinaryWriter& out, const StringNameComponent& c) { out.WriteString(c.name); out.Write(static_cast<uint8_t>(c.isActive)); },
+        [](Engine::BinaryReader& in, StringNameComponent& c) {
+            uint8_t active = 0;
+            if (!in.ReadString(c.name) || !in.Read(active)) return false;
+            c.isActive = active != 0;
+            return true;
+        });
+    Engine::SceneSnapshot handleFormat;
+    handleFormat.Register<Engine::NameComponent>("Name");
+
+    // Same names as the snapshot scene; heap bytes count strings past the small-string buffer
+    entt::registry stringRegistry, handleRegistry;
+    const size_t inlineCapacity = std::string().capacity();
+    size_t stringHeapBytes = 0;
+    for (int i = 0; i < entityCount; ++i)
+    {
+        std::string name = (i % 100 == 0) ? "Light" : "Cube " + std::to_string(i);
+        stringRegistry.emplace<StringNameComponent>(stringRegistry.create(), StringNameComponent{ name });
+        handleRegistry.emplace<Engine::NameComponent>(handleRegistry.create(), Engine::NameComponent{ Engine::GetNameTable().Intern(name) });
+        stringHeapBytes += name.size() > inlineCapacity ? name.size() + 1 : 0;
+    }
+
+    // Save + restore into an empty registry, as CopyToBackup/RestoreFromBackup do
+    auto timeRoundTrip = [](const Engine::SceneSnapshot& format, entt::registry& registry, double& saveMs, double& restoreMs) {
+        std::vector<uint8_t> blob;
+        const Uint64 saveStart = SDL_GetPerformanceCounter();
+        format.Save(registry, blob);
+        saveMs = double(SDL_GetPerformanceCounter() - saveStart) * 1000.0 / double(g_perfFreq);
+        registry.clear();
+        const Uint64 restoreStart = SDL_GetPerformanceCounter();
+        format.Restore(blob, registry);
+        restoreMs = double(SDL_GetPerformanceCounter() - restoreStart) * 1000.0 / double(g_perfFreq);
+    };
+    double stringSaveMs = 0.0, stringRestoreMs = 0.0, handleSaveMs = 0.0, handleRestoreMs = 0.0;
+    timeRoundTrip(stringFormat, stringRegistry, stringSaveMs, stringRestoreMs);
+    timeRoundTrip(handleFormat, handleRegistry, handleSaveMs, handleRestoreMs);
+
+    const double n = entityCount > 0 ? double(entityCount) : 1.0;
+    std::printf("headless names entities=%d string_bytes_per_entity=%.1f interned_bytes_per_entity=%.1f "
+                "string_save_ms=%.3f string_restore_ms=%.3f interned_save_ms=%.3f interned_restore_ms=%.3f\n",
+        entityCount, double(sizeof(StringNameComponent)) + double(stringHeapBytes) / n,
+        double(sizeof(Engine::NameComponent)) + double(internedTableBytes) / n,
+        stringSaveMs, stringRestoreMs, handleSaveMs, handleRestoreMs);
+}
+
+// Scene files: JSON size of the current scene, then (entityCount > 0) cooked save/load times of a large scene.
+// The cooked file is read right after being written, so load_MBps is page-cache bandwidth, the upper bound for disk loads.
+static void RunSceneIoBenchmark(int entityCount)
+{
+    std::error_code ec;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+    const std::string jsonPath = (dir / "dx11engine_scene_io.json").string();
+    const std::string cookedPath = (dir / "dx11engine_scene_io.cooked").string();
+
+    auto countEntities = [](const Engine::Scene& scene) {
+        auto all = scene.registry.view<entt::entity>();
+        return static_cast<size_t>(std::distance(all.begin(), all.end()));
+    };
+
+    const uintmax_t jsonBytes = Engine::SceneSerializer::SaveJson(g_scene, jsonPath) ? std::filesystem::file_size(jsonPath, ec) : 0;
+    std::filesystem::remove(jsonPath, ec);
+    std::printf("headless scene_json entities=%zu bytes=%llu\n", countEntities(g_scene), (unsigned long long)jsonBytes);
+
+    if (entityCount <= 0)
+        return;
+
+    auto source = std::make_unique<Engine::Scene>();
+    source->SetDefaultAssets(g_scene.GetDefaultShaderID(), g_scene.GetCubeMeshID(), g_scene.GetSphereMeshID(), g_scene.GetCapsuleMeshID());
+    for (int i = 0; i < entityCount; ++i)
+    {
+        const entt::entity e = (i % 100 == 0)
+            ? source->CreatePointLight("Light", XMFLOAT3(float(i), 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f), 1.0f, 5.0f)
+            : source->CreateCube("Cube " + std::to_string(i));
+        source->registry.get<Engine::TransformComponent>(e).position = XMFLOAT3(float(i), float(i % 7), 0.0f);
+    }
+
+    const Uint64 saveStart = SDL_GetPerformanceCounter();
+    const bool saved = Engine::SceneSerializer::SaveCooked(*source, cookedPath);
+    const double saveMs = double(SDL_GetPerformanceCounter() - saveStart) * 1000.0 / double(g_perfFreq);
+    const uintmax_t cookedBytes = std::filesystem::file_size(cookedPath, ec);
+
+    auto loaded = std::make_unique<Engine::Scene>();
+    const Uint64 loadStart = SDL_GetPerformanceCounter();
+    const bool loadedOk = saved && Engine::SceneSerializer::LoadCooked(*loaded, cookedPath, g_physicsManager);
+    const double loadMs = double(SDL_GetPerformanceCounter() - loadStart) * 1000.0 / double(g_perfFreq);
+    std::filesystem::remove(cookedPath, ec);
+
+    const double loadMBps = loadMs > 0.0 ? double(cookedBytes) / (1024.0 * 1024.0) / (loadMs / 1000.0) : 0.0;
+    std::printf("headless scene_cooked entities=%d bytes=%llu save_ms=%.3f load_ms=%.3f load_MBps=%.1f loaded=%zu\n",
+        entityCount, (unsigned long long)cookedBytes, saveMs, loadMs, loadMBps, loadedOk ? countEntities(*loaded) : size_t(0));
+}
+
+// Render and physics hot loops over the same N-entity scene (10% of entities, 5% of renderers and 5% of bodies switched
+// off), once as before (view over all entities, activation looked up per entity) and once through the owning groups.
+// ns_per_entity is per scene entity, best of several passes.
+static void RunIterationBenchmark(int entityCount)
+{
+    auto populate = [entityCount](Engine::Scene& scene) {
+        for (int i = 0; i < entityCount; ++i)
+        {
+            const entt::entity e = scene.CreateCube("Cube");
+            scene.registry.emplace<Engine::WorldTransformComponent>(e);
+            scene.registry.emplace<Engine::RigidBodyComponent>(e);
+            if (i % 10 == 3) scene.SetEntityActive(e, false);
+            if (i % 20 == 7) scene.SetComponentActive<Engine::MeshRendererComponent>(e, false);
+            if (i % 20 == 11) scene.SetComponentActive<Engine::RigidBodyComponent>(e, false);
+        }
+    };
+    auto viewScene = std::make_unique<Engine::Scene>();
+    auto groupScene = std::make_unique<Engine::Scene>();
+    populate(*viewScene);
+    Engine::GetRenderableGroup(groupScene->registry);
+    Engine::GetPhysicsBodyGroup(groupScene->registry);
+    populate(*groupScene);
+
+    // Each loop reads what the real one reads (renderer ids + world matrix, body state + transform) into a checksum
+    struct Result { double ms = 1e30; size_t visited = 0; double checksum = 0.0; };
+    auto measure = [](Result& r, auto&& loop) {
+        for (int pass = 0; pass < 5; ++pass)
+        {
+            size_t visited = 0;
+            double checksum = 0.0;
+            const Uint64 start = SDL_GetPerformanceCounter();
+            loop(visited, checksum);
+            const double ms = double(SDL_GetPerformanceCounter() - start) * 1000.0 / double(g_perfFreq);
+            r.ms = (ms < r.ms) ? ms : r.ms;
+            r.visited = visited;
+            r.checksum = checksum;
+        }
+    };
+
+    Result renderView, renderGroup, physicsView, physicsGroup;
+    measure(renderView, [&](size_t& visited, double& checksum) {
+        const entt::registry& reg = viewScene->registry;
+        auto view = reg.view<Engine::MeshRendererComponent, Engine::WorldTransformComponent>();
+        for (auto entity : view)
+        {
+            if (reg.all_of<Engine::DisabledTag>(entity)) continue;
+            if (reg.all_of<Engine::ComponentDisabledTag<Engine::MeshRendererComponent>>(entity)) continue;
+            const auto& mr = view.get<Engine::MeshRendererComponent>(entity);
+            const auto& wt = view.get<Engine::WorldTransformComponent>(entity);
+            checksum += mr.meshID + wt.world._11;
+            ++visited;
+        }
+    });
+    measure(renderGroup, [&](size_t& visited, double& checksum) {
+        for (auto [entity, mr, wt] : Engine::GetRenderableGroup(groupScene->registry).each())
+        {
+            checksum += mr.meshID + wt.world._11;
+            ++visited;
+        }
+    });
+    measure(physicsView, [&](size_t& visited, double& checksum) {
+        const entt::registry& reg = viewScene->registry;
+        auto view = reg.view<Engine::TransformComponent, Engine::RigidBodyComponent>();
+        for (auto entity : view)
+        {
+            if (reg.all_of<Engine::DisabledTag>(entity)) continue;
+            if (reg.all_of<Engine::ComponentDisabledTag<Engine::RigidBodyComponent>>(entity)) continue;
+            const auto& tc = view.get<Engine::TransformComponent>(entity);
+            const auto& rb = view.get<Engine::RigidBodyComponent>(entity);
+            checksum += tc.position.x + (rb.bodyID.IsInvalid() ? 1.0 : 0.0);
+            ++visited;
+        }
+    });
+    measure(physicsGroup, [&](size_t& visited, double& checksum) {
+        for (auto [entity, rb, tc] : Engine::GetPhysicsBodyGroup(groupScene->registry).each())
+        {
+            checksum += tc.position.x + (rb.bodyID.IsInvalid() ? 1.0 : 0.0);
+            ++visited;
+        }
+    });
+
+    const double toNs = 1e6 / (entityCount > 0 ? double(entityCount) : 1.0);
+    std::printf("headless iteration entities=%d render_active=%zu physics_active=%zu render_view_ns_per_entity=%.2f render_group_ns_per_entity=%.2f "
+                "physics_view_ns_per_entity=%.2f physics_group_ns_per_entity=%.2f\n",
+        entityCount, renderGroup.visited, physicsGroup.visited, renderView.ms * toNs, renderGroup.ms * toNs,
+        physicsView.ms * toNs, physicsGroup.ms * toNs);
+}
+
+// Cold: cache removed, Assimp import + cook. Warm: the same model from the cooked file.
+static void RunMeshCacheBenchmark(const char* modelPath)
+{
+    std::error_code ec;
+    std::filesystem::remove(Engine::MeshCache::GetCachePath(modelPath), ec);
+
+    auto timeLoad = [modelPath](Engine::MeshManager& meshes, std::vector<int>& ids) {
+        const Uint64 start = SDL_GetPerformanceCounter();
+        ids = meshes.LoadModel(g_renderer.GetDevice(), g_renderer.GetRenderDevice(), modelPath);
+        return double(SDL_GetPerformanceCounter() - start) * 1000.0 / double(g_perfFreq);
+    };
+    Engine::MeshManager coldMeshes, warmMeshes;
+    std::vector<int> coldIds, warmIds;
+    const double coldMs = timeLoad(coldMeshes, coldIds);
+    const double warmMs = timeLoad(warmMeshes, warmIds);
+    const Engine::MeshLoadStats& warm = warmMeshes.GetLastLoadStats();
+
+    std::printf("headless mesh_cache model=%s meshes=%zu vertices=%llu indices=%llu cold_ms=%.3f warm_ms=%.3f speedup=%.1f warm_from_cache=%d\n",
+        modelPath, warmIds.size(), (unsigned long long)warm.vertices, (unsigned long long)warm.indices,
+        coldMs, warmMs, warmMs > 0.0 ? coldMs / warmMs : 0.0, warm.fromCache ? 1 : 0);
+}
+
+// Allocate/free churn with mesh-like sizes on OffsetAllocator (ns/op, fragmentation, one Defragment), then the same on
+// MeshManager with real meshes (release every other one, defragment) and on a GeometryArena over its own NullRenderDevice
+// (grows, moves and copied bytes). The correctness checks live in tests/OffsetAllocatorTests.cpp.
+static void RunArenaBenchmark(int opCount)
+{
+    Engine::OffsetAllocator allocator;
+    allocator.Initialize(1u << 20);
+    std::vector<uint32_t> live;
+    uint32_t seed = 12345u;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+    uint32_t grows = 0;
+    const Uint64 start = SDL_GetPerformanceCounter();
+    for (int op = 0; op < opCount; ++op)
+    {
+        // Slightly more allocations than frees (up to a cap), so the space fills and fragments
+        if (live.empty() || (live.size() < 4096 && next() % 8 < 5))
+        {
+            Engine::OffsetAllocator::Allocation alloc;
+            const uint32_t size = 1u + next() % 4096u;
+            if (!allocator.Allocate(size, alloc))
+            {
+                allocator.Grow(allocator.GetCapacity() * 2);
+                ++grows;
+                allocator.Allocate(size, alloc);
+            }
+            live.push_back(alloc.offset);
+        }
+        else
+        {
+            const size_t pick = next() % live.size();
+            allocator.Free(live[pick]);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+    const double churnMs = double(SDL_GetPerformanceCounter() - start) * 1000.0 / double(g_perfFreq);
+
+    const uint32_t freeBefore = allocator.GetCapacity() - allocator.GetUsed();
+    const double fragmentation = freeBefore ? 1.0 - double(allocator.GetLargestFreeRange()) / double(freeBefore) : 0.0;
+    const uint32_t rangesBefore = allocator.GetFreeRangeCount();
+
+    std::vector<Engine::OffsetAllocator::Move> moves;
+    const Uint64 defragStart = SDL_GetPerformanceCounter();
+    allocator.Defragment(moves);
+    const double defragMs = double(SDL_GetPerformanceCounter() - defragStart) * 1000.0 / double(g_perfFreq);
+
+    std::printf("headless arena_alloc ops=%d live=%zu grows=%u ns_per_op=%.1f free_ranges=%u fragmentation=%.3f moves=%zu defrag_ms=%.3f\n",
+        opCount, live.size(), grows, opCount > 0 ? churnMs * 1e6 / opCount : 0.0, rangesBefore, fragmentation, moves.size(), defragMs);
+
+    // MeshManager: spheres of varying size, every other one released, then defragmented
+    ID3D11Device* device = g_renderer.GetDevice();
+    Engine::IRenderDevice& renderDevice = g_renderer.GetRenderDevice();
+    std::vector<int> meshes;
+    for (int i = 0; i < 64; ++i)
+        meshes.push_back(g_meshManager.CreateSphere(device, renderDevice, 0.5f, 8 + (i % 7) * 4, 6 + (i % 5) * 3));
+    for (size_t i = 0; i < meshes.size(); i += 2)
+        g_meshManager.ReleaseMesh(meshes[i]);
+    const uint32_t meshRangesBefore = g_meshManager.GetArenaStats().freeRanges;
+    const Uint64 meshStart = SDL_GetPerformanceCounter();
+    g_meshManager.DefragmentGeometry(device, renderDevice);
+    const double meshDefragMs = double(SDL_GetPerformanceCounter() - meshStart) * 1000.0 / double(g_perfFreq);
+    const Engine::MeshArenaStats after = g_meshManager.GetArenaStats();
+    for (size_t i = 1; i < meshes.size(); i += 2)
+        g_meshManager.ReleaseMesh(meshes[i]);
+
+    std::printf("headless arena_meshes meshes=%zu free_ranges_before=%u free_ranges_after=%u defrag_ms=%.3f\n",
+        meshes.size(), meshRangesBefore, after.freeRanges, meshDefragMs);
+
+    // GeometryArena: starts small so the blocks force several grows, then every other block is freed and packed
+    Engine::NullRenderDevice arenaDevice;
+    Engine::GeometryArena arena(sizeof(uint32_t), D3D11_BIND_VERTEX_BUFFER, 256);
+    std::vector<uint32_t> offsets, data;
+    for (uint32_t b = 0; b < 96; ++b)
+    {
+        data.resize(1u + next() % 200u);
+        for (uint32_t i = 0; i < data.size(); ++i) data[i] = (b << 16) | i;
+        uint32_t offset = 0;
+        if (arena.Allocate(device, arenaDevice, data.data(), uint32_t(data.size()), offset)) offsets.push_back(offset);
+    }
+    const uint32_t arenaGrows = arena.GetGrowCount();
+    for (size_t i = 0; i < offsets.size(); i += 2)
+        arena.Free(offsets[i]);
+
+    std::vector<Engine::OffsetAllocator::Move> arenaMoves;
+    arena.Defragment(device, arenaDevice, arenaMoves);
+
+    const Engine::RenderDeviceStats& arenaStats = arenaDevice.GetStats();
+    std::printf("headless arena_gpu blocks=%zu grows=%u moves=%zu uploads=%u copies=%u copy_bytes=%llu free_ranges=%u\n",
+        offsets.size(), arenaGrows, arenaMoves.size(), arenaStats.uploads, arenaStats.copies,
+        static_cast<unsigned long long>(arenaStats.copyBytes), arena.GetAllocator().GetFreeRangeCount());
+}
+
+// Raycasts against a grid of N static boxes beside the scene, one ray per box straight down onto it:
+// CastRay per ray vs one CastRays batch (best of 5 each)
+static void RunRaycastBenchmark(int bodyCount)
+{
+    const int side = int(std::ceil(std::sqrt(double(bodyCount))));
+    constexpr float kOriginX = 1000.0f, kSpacing = 2.0f, kRayHeight = 10.0f;
+
+    Engine::Scene scene;
+    std::vector<JPH::BodyID> bodies(bodyCount);
+    std::vector<Engine::Math::Ray> rays(bodyCount);
+    for (int i = 0; i < bodyCount; ++i)
+    {
+        const float x = kOriginX + float(i % side) * kSpacing, z = float(i / side) * kSpacing;
+        const entt::entity e = scene.registry.create();
+        Engine::TransformComponent& tc = scene.registry.emplace<Engine::TransformComponent>(e);
+        tc.position = XMFLOAT3(x, 0.0f, z);
+        Engine::RigidBodyComponent& rb = scene.registry.emplace<Engine::RigidBodyComponent>(e);
+        rb.bodyID = bodies[i] = g_physicsManager.QueueRigidBody(e, tc, rb, g_meshManager);
+        rays[i] = Engine::Math::Ray{ XMFLOAT3(x, kRayHeight, z), XMFLOAT3(0.0f, -1.0f, 0.0f) };
+    }
+    g_physicsManager.FlushPendingBodies(true);
+
+    std::vector<Engine::RayHit> hits;
+    double singleMs = 1e30, batchMs = 1e30;
+    for (int pass = 0; pass < 5; ++pass)
+    {
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int i = 0; i < bodyCount; ++i) g_physicsManager.CastRay(rays[i], scene.registry);
+        singleMs = std::min(singleMs, double(SDL_GetPerformanceCounter() - start) * 1000.0 / double(g_perfFreq));
+
+        start = SDL_GetPerformanceCounter();
+        g_physicsManager.CastRays(rays, scene.registry, hits);
+        batchMs = std::min(batchMs, double(SDL_GetPerformanceCounter() - start) * 1000.0 / double(g_perfFreq));
+    }
+
+    for (const JPH::BodyID& id : bodies)
+        g_physicsManager.RemoveRigidBody(id);
+
+    std::printf("headless raycast_bench bodies=%d cast_ray_ms=%.3f cast_rays_ms=%.3f threads=%u ns_per_ray_single=%.1f ns_per_ray_batched=%.1f\n",
+        bodyCount, singleMs, batchMs, g_jobSystem.GetConcurrency(), singleMs * 1e6 / double(bodyCount), batchMs * 1e6 / double(bodyCount));
+}
+
+// Level-load style spawn of N dynamic boxes: AddBody per body, one AddBodiesPrepare/Finalize batch, and the batch plus the
+// broadphase rebuild PhysicsSystem does for big batches. Reports the spawn and the first step after it (best of 3 each).
+static void RunSpawnBenchmark(int bodyCount)
+{
+    const int side = int(std::ceil(std::cbrt(double(bodyCount))));
+    Engine::Scene scene;
+    std::vector<entt::entity> entities(bodyCount);
+    for (int i = 0; i < bodyCount; ++i)
+    {
+        entities[i] = scene.registry.create();
+        Engine::TransformComponent& tc = scene.registry.emplace<Engine::TransformComponent>(entities[i]);
+        tc.position = XMFLOAT3(-1000.0f - float(i % side) * 2.0f, 100.0f + float((i / side) % side) * 2.0f, float(i / (side * side)) * 2.0f);
+        Engine::RigidBodyComponent& rb = scene.registry.emplace<Engine::RigidBodyComponent>(entities[i]);
+        rb.motionType = Engine::RBMotion::Dynamic;
+    }
+
+    std::vector<JPH::BodyID> bodies(bodyCount);
+
+    const char* modes[] = { "single", "batched", "batched_optimized" };
+    std::printf("headless spawn_bench bodies=%d", bodyCount);
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        double spawnMs = 1e30, stepMs = 1e30;
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            const Uint64 start = SDL_GetPerformanceCounter();
+            for (int i = 0; i < bodyCount; ++i)
+            {
+                const Engine::TransformComponent& tc = scene.registry.get<Engine::TransformComponent>(entities[i]);
+                const Engine::RigidBodyComponent& rb = scene.registry.get<Engine::RigidBodyComponent>(entities[i]);
+                bodies[i] = mode == 0 ? g_physicsManager.CreateRigidBody(entities[i], tc, rb, g_meshManager)
+                                      : g_physicsManager.QueueRigidBody(entities[i], tc, rb, g_meshManager);
+            }
+            if (mode > 0)
+                g_physicsManager.FlushPendingBodies(mode == 2);
+            const Uint64 spawned = SDL_GetPerformanceCounter();
+            g_physicsManager.Step();
+            const Uint64 stepped = SDL_GetPerformanceCounter();
+
+            spawnMs = std::min(spawnMs, double(spawned - start) * 1000.0 / double(g_perfFreq));
+            stepMs = std::min(stepMs, double(stepped - spawned) * 1000.0 / double(g_perfFreq));
+
+            for (const JPH::BodyID& id : bodies)
+                g_physicsManager.RemoveRigidBody(id);
+        }
+        std::printf(" %s_spawn_ms=%.3f %s_first_step_ms=%.3f", modes[mode], spawnMs, modes[mode], stepMs);
+    }
+    std::printf("\n");
+}
+
+// Worker-count sweep: the job system is restarted with 1..maxWorkers workers, and for each count 60 physics steps of a
+// falling box pile (rebuilt identically every time) are timed. Restores the original workers after.
+static void RunJobsBenchmark(int maxWorkers)
+{
+    constexpr int kBoxes = 2000, kSteps = 60;
+    const uint32_t originalWorkers = g_jobSystem.GetWorkerCount();
+
+    Engine::Scene scene;
+    std::vector<entt::entity> entities;
+    auto addBody = [&](const XMFLOAT3& position, const XMFLOAT3& scale, Engine::RBMotion motion) {
+        const entt::entity e = scene.registry.create();
+        Engine::TransformComponent& tc = scene.registry.emplace<Engine::TransformComponent>(e);
+        tc.position = position;
+        tc.scale = scale;
+        scene.registry.emplace<Engine::RigidBodyComponent>(e).motionType = motion;
+        entities.push_back(e);
+    };
+    addBody(XMFLOAT3(-2000.0f, 0.0f, 0.0f), XMFLOAT3(60.0f, 1.0f, 60.0f), Engine::RBMotion::Static);
+    for (int i = 0; i < kBoxes; ++i)
+        addBody(XMFLOAT3(-2020.0f + float(i % 20) * 2.0f, 2.0f + float(i / 400) * 1.5f, -20.0f + float((i / 20) % 20) * 2.0f),
+                XMFLOAT3(1.0f, 1.0f, 1.0f), Engine::RBMotion::Dynamic);
+
+    double baseStepMs = 0.0;
+    for (int workers = 1; workers <= maxWorkers; ++workers)
+    {
+        g_jobSystem.Shutdown();
+        g_jobSystem.Initialize(uint32_t(workers));
+
+        // Same pile from scratch, Jolt schedules its jobs on the restarted workers
+        std::vector<JPH::BodyID> bodies;
+        for (entt::entity e : entities)
+            bodies.push_back(g_physicsManager.QueueRigidBody(e, scene.registry.get<Engine::TransformComponent>(e),
+                                                             scene.registry.get<Engine::RigidBodyComponent>(e), g_meshManager));
+        g_physicsManager.FlushPendingBodies(true);
+        const Uint64 start = SDL_GetPerformanceCounter();
+        for (int step = 0; step < kSteps; ++step)
+            g_physicsManager.Step();
+        const double stepMs = double(SDL_GetPerformanceCounter() - start) * 1000.0 / double(g_perfFreq) / double(kSteps);
+        for (const JPH::BodyID& id : bodies)
+            g_physicsManager.RemoveRigidBody(id);
+
+        baseStepMs = workers == 1 ? stepMs : baseStepMs;
+        std::printf("headless jobs_bench workers=%d threads=%u hardware_threads=%u physics_step_ms=%.3f physics_step_speedup=%.2f\n",
+            workers, g_jobSystem.GetConcurrency(), std::thread::hardware_concurrency(), stepMs, baseStepMs / stepMs);
+    }
+
+    g_jobSystem.Shutdown();
+    g_jobSystem.Initialize(originalWorkers);
+}
+
+static void RegisterSystems()
+{
+    using Engine::SystemAccess;
+
     // Physics step and sync (Play: simulate + pull. Edit: push gizmo transforms to colliders)
-    Engine::PhysicsSystem(g_scene, g_physicsManager, g_meshManager, deltaTime, g_editorUI.GetState() == Engine::EditorState::Play);
+    g_systemScheduler.Register("Physics",
+        SystemAccess()
+            .Read<Engine::DisabledTag, Engine::ComponentDisabledTag<Engine::RigidBodyComponent>, Engine::MeshRendererComponent>()
+            .Write<Engine::TransformComponent, Engine::RigidBodyComponent>()
+            .WriteResource<Engine::PhysicsManager>()
+            .ReadResource<Engine::MeshManager>(),
+        [](float dt) {
+            Engine::PhysicsSystem(g_scene, g_physicsManager, g_meshManager, dt, g_editorUI.GetState() == Engine::EditorState::Play);
+        });
+
+    // only process editor camera in Edit mode.
+    // Input only touches the camera control state, so it runs alongside Physics; the Transform write comes after both
+    g_systemScheduler.Register("EditorCameraInput",
+        SystemAccess()
+            .Write<Engine::EditorCamControlComponent, Engine::EditorCamMotionComponent>()
+            .ReadResource<Engine::InputManager>(),
+        [](float dt) {
+            if (g_editorUI.GetState() == Engine::EditorState::Edit)
+                Engine::EditorCameraInputSystem(g_scene, g_input, dt, g_editorUI.IsSceneFocused());
+        });
+
+    g_systemScheduler.Register("EditorCameraTransform",
+        SystemAccess()
+            .Read<Engine::EditorCamControlComponent>()
+            .Write<Engine::TransformComponent, Engine::EditorCamMotionComponent>(),
+        [](float) {
+            if (g_editorUI.GetState() == Engine::EditorState::Edit)
+                Engine::EditorCameraTransformSystem(g_scene);
+        });
+
+    // View/projection are uploaded by DrawEntities from the render snapshot, so no system touches D3D
+    // (in pipelined mode Update runs on a worker thread)
+
+    g_systemScheduler.SetSerial(g_serialSystems);
+}
 
-    // only process editor camera in Edit mode
-	if (g_editorUI.GetState() == Engine::EditorState::Edit)
-        Engine::EditorCameraInputSystem(g_scene, g_input, deltaTime, g_editorUI.IsSceneFocused());
+void Update(float deltaTime) {
+    ENGINE_PROFILE_FUNCTION();
 
-    Engine::CameraMatrixSystem(g_scene, g_renderer);
+    // Systems run as a dependency graph over the worker threads (see RegisterSystems)
+    g_systemScheduler.Run(g_jobSystem, g_scene.registry, deltaTime);
     //Engine::DemoRotationSystem(g_scene, g_sampleEntity, deltaTime);
+
+    ++g_simFrame;
 }
 
-void Render()
+void Render(float deltaTime)
 {
+    ENGINE_PROFILE_FUNCTION();
+
     // Start the ImGui frame (after processing input and before rendering)
     g_imGuiManager.BeginFrame();
 
@@ -442,19 +1330,37 @@ void Render()
 	// Render the editor UI (ImGui panels, etc.) first to set up the framebuffer and any UI state
     g_editorUI.Render(g_scene, g_renderer, g_input, g_physicsManager, g_SDLWindow);
 
+    // World matrices after every writer of this frame (systems, editor gizmo)
+    {
+        ENGINE_PROFILE_SCOPE("TransformHierarchy");
+        g_transformHierarchy.Update(g_scene.registry, g_jobSystem);
+    }
+
+    // Snapshot the simulated state; from here on rendering only reads the snapshot
+    {
+        ENGINE_PROFILE_SCOPE("ExtractSnapshot");
+        Engine::RenderSystem::ExtractSnapshot(g_scene, g_meshManager, g_renderSnapshots.GetWrite(), g_simFrame);
+    }
+    g_renderSnapshots.Publish();
+    const Engine::RenderSnapshot& snapshot = g_renderSnapshots.GetRead();
+
+    // Pipelined: the next frame's simulation runs while this snapshot is submitted
+    Engine::JobCounter simulation;
+    if (g_pipelined)
+        g_jobSystem.Run(simulation, [deltaTime]() { Update(deltaTime); });
+
     // Render the 3D scene into the off-screen framebuffer (Render-to-Texture)
     g_renderer.BindFramebuffer();
 
-    Engine::RenderSystem::DrawEntities(g_scene, g_meshManager, g_shaderManager, g_renderer, g_textureManager);
+    {
+        ENGINE_PROFILE_SCOPE("DrawEntities");
+        Engine::RenderSystem::DrawEntities(snapshot, g_meshManager, g_shaderManager, g_renderer, g_textureManager, g_renderQueue, g_renderScratch, g_jobSystem);
+    }
 
     // Draw skybox last: z=w ensures it renders only where nothing else drew
-    if (g_scene.m_activeRenderCamera != entt::null &&
-        g_scene.registry.valid(g_scene.m_activeRenderCamera) &&
-        g_scene.registry.all_of<Engine::TransformComponent, Engine::CameraComponent>(g_scene.m_activeRenderCamera))
+    if (snapshot.camera.valid)
     {
-        const auto& camTrans = g_scene.registry.get<Engine::TransformComponent>(g_scene.m_activeRenderCamera);
-        const auto& camComp = g_scene.registry.get<Engine::CameraComponent>(g_scene.m_activeRenderCamera);
-        g_renderer.DrawSkybox(g_meshManager, g_shaderManager, camComp, camTrans);
+        g_renderer.DrawSkybox(g_meshManager, g_shaderManager, snapshot.camera.camera, snapshot.camera.transform);
     }
 
     // Now bind the real swapchain back buffer.
@@ -464,5 +1370,12 @@ void Render()
     // Draw the UI data to the cleared backbuffer
     g_imGuiManager.EndFrame();
 
-    g_renderer.Present(g_vSync);
+    {
+        ENGINE_PROFILE_SCOPE("Present");
+        g_renderer.Present(g_vSync);
+    }
+
+    // The simulation must be done before the next frame's input and UI touch the scene
+    g_jobSystem.Wait(simulation);
+    g_lastRenderLag = static_cast<int64_t>(g_simFrame) - static_cast<int64_t>(snapshot.frame);
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "TestFramework.h"
+#include "Engine/Culling.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    Engine::Frustum TestFrustum()
+    {
+        using namespace DirectX;
+        const XMMATRIX view = XMMatrixLookToLH(XMVectorSet(0.0f, 2.0f, -10.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        const XMMATRIX proj = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f);
+        return Engine::Culling::ExtractFrustum(view * proj);
+    }
+
+    // Centers spread well past the frustum on every side, so all outcomes occur
+    void FillBounds(Engine::BoundsSoA& bounds, EngineTest::Random& random, size_t count)
+    {
+        bounds.Clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const DirectX::XMFLOAT3 center(random.Next01() * 400.0f - 200.0f, random.Next01() * 200.0f - 100.0f, random.Next01() * 400.0f - 200.0f);
+            const DirectX::XMFLOAT3 extents(0.1f + random.Next01() * 4.0f, 0.1f + random.Next01() * 4.0f, 0.1f + random.Next01() * 4.0f);
+            bounds.Push(center, extents, std::sqrt(extents.x * extents.x + extents.y * extents.y + extents.z * extents.z));
+        }
+    }
+}
+
+// The 4-wide test agrees with a plane-by-plane scalar reference (sphere and AABB); objects within a small margin of a
+// plane may go either way. 4099 bounds is not a multiple of 4, so the padded tail lanes are exercised.
+ENGINE_TEST(CullingMatchesScalarReference)
+{
+    const Engine::Frustum frustum = TestFrustum();
+    EngineTest::Random random(777u);
+    Engine::BoundsSoA bounds;
+    FillBounds(bounds, random, 4099);
+
+    std::vector<uint32_t> visible;
+    ENGINE_CHECK(Engine::Culling::CullBounds(frustum, bounds, visible) == visible.size());
+    ENGINE_CHECK(std::is_sorted(visible.begin(), visible.end()));
+
+    size_t expected = 0, mismatches = 0, cursor = 0;
+    for (size_t i = 0; i < bounds.Size(); ++i)
+    {
+        float margin = 1e30f;
+        for (const DirectX::XMFLOAT4& pl : frustum.planes)
+        {
+            const float dist = pl.x * bounds.cx[i] + pl.y * bounds.cy[i] + pl.z * bounds.cz[i] + pl.w;
+            const float box = std::fabs(pl.x) * bounds.ex[i] + std::fabs(pl.y) * bounds.ey[i] + std::fabs(pl.z) * bounds.ez[i];
+            margin = std::min(margin, dist + std::min(bounds.radius[i], box));
+        }
+        const bool reported = cursor < visible.size() && visible[cursor] == i;
+        cursor += reported ? 1 : 0;
+        expected += margin >= 0.0f ? 1 : 0;
+        mismatches += (reported != (margin >= 0.0f) && std::fabs(margin) > 1e-3f) ? 1 : 0;
+    }
+    ENGINE_CHECK(mismatches == 0);
+    ENGINE_CHECK(cursor == visible.size());
+    ENGINE_CHECK(expected > 0 && expected < bounds.Size());
+}
+
+// Identity keeps the bounds; a scale grows extents per axis and the radius by the largest axis scale
+ENGINE_TEST(CullingTransformBounds)
+{
+    using namespace DirectX;
+    XMFLOAT3 center, extents;
+    float radius = 0.0f;
+    Engine::Culling::TransformBounds(XMFLOAT3(1.0f, 2.0f, 3.0f), XMFLOAT3(1.0f, 1.0f, 1.0f), 1.5f, XMMatrixIdentity(), center, extents, radius);
+    ENGINE_CHECK(center.x == 1.0f && center.y == 2.0f && center.z == 3.0f);
+    ENGINE_CHECK(extents.x == 1.0f && extents.y == 1.0f && extents.z == 1.0f);
+    ENGINE_CHECK(std::fabs(radius - 1.5f) < 1e-5f);
+
+    const XMMATRIX world = XMMatrixScaling(2.0f, 3.0f, 1.0f) * XMMatrixTranslation(10.0f, 0.0f, 0.0f);
+    Engine::Culling::TransformBounds(XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f), 1.5f, world, center, extents, radius);
+    ENGINE_CHECK(std::fabs(center.x - 12.0f) < 1e-5f && std::fabs(center.y) < 1e-5f && std::fabs(center.z) < 1e-5f);
+    ENGINE_CHECK(std::fabs(extents.x - 2.0f) < 1e-5f && std::fabs(extents.y - 3.0f) < 1e-5f && std::fabs(extents.z - 1.0f) < 1e-5f);
+    ENGINE_CHECK(std::fabs(radius - 4.5f) < 1e-4f);
+}
+
+// 1M random bounds against the same frustum, best of 5
+ENGINE_BENCH(CullingBench)
+{
+    constexpr size_t kObjects = 1000000;
+    const Engine::Frustum frustum = TestFrustum();
+    EngineTest::Random random(777u);
+    Engine::BoundsSoA bounds;
+    FillBounds(bounds, random, kObjects);
+
+    std::vector<uint32_t> visible;
+    const double bestMs = EngineTest::BestMs(5, [&]() { Engine::Culling::CullBounds(frustum, bounds, visible); });
+    std::printf("bench culling objects=%zu visible=%zu cull_ms=%.3f ns_per_object=%.2f\n",
+        kObjects, visible.size(), bestMs, bestMs * 1e6 / double(kObjects));
+}
@@ -0,0 +1,140 @@
+#include "TestFramework.h"
+#include "Engine/InstanceBatcher.h"
+#include "Engine/RenderQueue.h"
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t kMinInstances = 2;
+
+    // Instance i carries its item index in world._41, so every instance can be traced back to the item that filled it
+    void FillIndex(const Engine::DrawItem& item, Engine::InstanceData& inst)
+    {
+        inst = Engine::InstanceData{};
+        inst.world._41 = float(item.index);
+    }
+
+    const void* FakeTexture(uint32_t id) { return reinterpret_cast<const void*>(uintptr_t(id)); }
+}
+
+// A shuffled mix of mesh/texture runs comes out as one batch per (mesh, texture) pair, instanced from kMinInstances on
+ENGINE_TEST(InstanceBatcherGroupsMixedRuns)
+{
+    EngineTest::Random random(12345u);
+
+    // 4 meshes x 3 textures, pair p gets p % 5 items (0: absent, 1: plain draw, 2+: instanced)
+    struct Item { uint32_t mesh, texture; };
+    std::vector<Item> items;
+    uint32_t expectedBatches = 0, expectedInstanced = 0, expectedInstances = 0;
+    for (uint32_t p = 0; p < 12; ++p)
+    {
+        const uint32_t count = p % 5;
+        for (uint32_t k = 0; k < count; ++k) items.push_back({ p / 3, p % 3 });
+        expectedBatches += count ? 1 : 0;
+        expectedInstanced += count >= kMinInstances ? 1 : 0;
+        expectedInstances += count >= kMinInstances ? count : 0;
+    }
+    for (size_t i = items.size(); i > 1; --i) std::swap(items[i - 1], items[random.Next() % i]);
+
+    Engine::RenderQueue queue;
+    queue.Clear();
+    for (uint32_t i = 0; i < items.size(); ++i)
+    {
+        const uint32_t texture = queue.GetTextureKey(FakeTexture(items[i].texture + 1));
+        queue.Submit(Engine::SortKey::Make(1, 1, texture, queue.GetMeshKey(int(items[i].mesh), 0), float(random.Next() % 1000) / 1000.0f), i);
+    }
+    queue.Sort();
+
+    Engine::InstanceBatcher batcher;
+    batcher.Build(queue.GetItems(), kMinInstances, FillIndex);
+    ENGINE_CHECK(batcher.GetBatches().size() == expectedBatches);
+
+    uint32_t instanced = 0;
+    for (const Engine::InstanceBatch& batch : batcher.GetBatches())
+    {
+        const Engine::DrawItem& first = queue.GetItems()[batch.firstItem];
+        for (uint32_t i = batch.firstItem; i < batch.firstItem + batch.itemCount; ++i)
+        {
+            const Engine::DrawItem& item = queue.GetItems()[i];
+            ENGINE_CHECK(items[item.index].mesh == items[first.index].mesh);
+            ENGINE_CHECK(items[item.index].texture == items[first.index].texture);
+            if (batch.instanced)
+                ENGINE_CHECK(batcher.GetInstances()[batch.firstInstance + (i - batch.firstItem)].world._41 == float(item.index));
+        }
+        ENGINE_CHECK(batch.instanced == (batch.itemCount >= kMinInstances));
+        instanced += batch.instanced ? 1 : 0;
+    }
+    ENGINE_CHECK(instanced == expectedInstanced);
+    ENGINE_CHECK(batcher.GetInstances().size() == expectedInstances);
+}
+
+// Key space exhausted: the overflow key is shared by many textures, so its items must neither batch nor skip binds
+ENGINE_TEST(InstanceBatcherNeverBatchesOverflowKeys)
+{
+    Engine::RenderQueue queue;
+    queue.Clear();
+    for (uint32_t t = 0; t < Engine::SortKey::kTextureOverflow; ++t)
+        queue.GetTextureKey(FakeTexture(t + 1));
+    const uint32_t mesh = queue.GetMeshKey(1, 0);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        const uint32_t texture = queue.GetTextureKey(FakeTexture(0x100000 + i));
+        queue.Submit(Engine::SortKey::Make(1, 1, texture, mesh, 0.5f), i);
+    }
+    queue.Sort();
+
+    Engine::InstanceBatcher batcher;
+    batcher.Build(queue.GetItems(), kMinInstances, FillIndex);
+    ENGINE_CHECK(queue.GetStats().keyOverflows == 3);
+    ENGINE_CHECK(batcher.GetBatches().size() == 3);
+    ENGINE_CHECK(batcher.GetInstances().empty());
+
+    queue.ResetState();
+    for (const Engine::DrawItem& item : queue.GetItems())
+        ENGINE_CHECK(queue.ChangeTexture(Engine::SortKey::Texture(item.key)));
+}
+
+// 100k entities over 48 meshes and 16 textures, as DrawEntities builds them: submit, sort and batch cost per entity
+ENGINE_BENCH(InstanceBatcherBench)
+{
+    constexpr int kEntities = 100000;
+    EngineTest::Random random(12345u);
+    std::vector<uint32_t> meshOf(kEntities), textureOf(kEntities);
+    std::vector<float> depthOf(kEntities);
+    for (int i = 0; i < kEntities; ++i)
+    {
+        meshOf[i] = random.Next() % 48;
+        textureOf[i] = random.Next() % 16;
+        depthOf[i] = float(random.Next() % 100000) / 100000.0f;
+    }
+
+    Engine::RenderQueue queue;
+    Engine::InstanceBatcher batcher;
+    double submitMs = 1e30, sortMs = 1e30, batchMs = 1e30;
+    for (int pass = 0; pass < 5; ++pass)
+    {
+        const double start = EngineTest::NowMs();
+        queue.Clear();
+        for (int i = 0; i < kEntities; ++i)
+        {
+            const uint32_t texture = queue.GetTextureKey(FakeTexture(textureOf[i] + 1));
+            queue.Submit(Engine::SortKey::Make(1, 1, texture, queue.GetMeshKey(int(meshOf[i]), 0), depthOf[i]), uint32_t(i));
+        }
+        const double submitted = EngineTest::NowMs();
+        queue.Sort();
+        const double sorted = EngineTest::NowMs();
+        batcher.Build(queue.GetItems(), kMinInstances, FillIndex);
+        const double batched = EngineTest::NowMs();
+
+        submitMs = std::min(submitMs, submitted - start);
+        sortMs = std::min(sortMs, sorted - submitted);
+        batchMs = std::min(batchMs, batched - sorted);
+    }
+
+    const double toNs = 1e6 / double(kEntities);
+    std::printf("bench batching entities=%d batches=%zu instances=%zu submit_ns_per_entity=%.2f sort_ns_per_entity=%.2f batch_ns_per_entity=%.2f\n",
+        kEntities, batcher.GetBatches().size(), batcher.GetInstances().size(), submitMs * toNs, sortMs * toNs, batchMs * toNs);
+}
@@ -0,0 +1,121 @@
+#include "TestFramework.h"
+#include "Engine/JobSystem.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Every index of [0, count) is visited exactly once, whatever the count/grain split
+ENGINE_TEST(JobSystemParallelForCoversEveryIndexOnce)
+{
+    Engine::JobSystem jobs;
+    ENGINE_CHECK(jobs.Initialize(3));
+    for (uint32_t count : { 1u, 7u, 1000u, 65536u })
+    {
+        for (uint32_t grain : { 0u, 1u, 64u, 5000u })
+        {
+            std::unique_ptr<std::atomic<uint32_t>[]> visits(new std::atomic<uint32_t>[count]);
+            for (uint32_t i = 0; i < count; ++i) visits[i] = 0;
+            jobs.ParallelFor(count, grain, [&visits](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) visits[i].fetch_add(1, std::memory_order_relaxed);
+            });
+
+            bool once = true;
+            for (uint32_t i = 0; i < count; ++i) once = once && visits[i] == 1;
+            ENGINE_CHECK(once);
+        }
+    }
+    jobs.Shutdown();
+}
+
+// Tasks that queue and wait for their own subtasks finish without deadlocking (waits help with their group only)
+ENGINE_TEST(JobSystemNestedWaits)
+{
+    Engine::JobSystem jobs;
+    ENGINE_CHECK(jobs.Initialize(2));
+    std::atomic<uint32_t> leaves{ 0 };
+    Engine::JobCounter outer;
+    for (int i = 0; i < 16; ++i)
+    {
+        jobs.Run(outer, [&jobs, &leaves]() {
+            Engine::JobCounter inner;
+            for (int k = 0; k < 16; ++k)
+                jobs.Run(inner, [&leaves]() { leaves.fetch_add(1, std::memory_order_relaxed); });
+            jobs.Wait(inner);
+        });
+    }
+    jobs.Wait(outer);
+    ENGINE_CHECK(outer.pending == 0);
+    ENGINE_CHECK(leaves == 16u * 16u);
+    jobs.Shutdown();
+}
+
+// Before Initialize (and after Shutdown) tasks and ParallelFor run inline on the caller
+ENGINE_TEST(JobSystemRunsInlineWithoutWorkers)
+{
+    Engine::JobSystem jobs;
+    uint32_t ran = 0;
+    Engine::JobCounter counter;
+    jobs.Run(counter, [&ran]() { ++ran; });
+    ENGINE_CHECK(ran == 1);
+    ENGINE_CHECK(counter.pending == 0);
+
+    uint32_t chunks = 0, items = 0;
+    jobs.ParallelFor(100, 1, [&](uint32_t begin, uint32_t end) { ++chunks; items += end - begin; });
+    ENGINE_CHECK(chunks == 1);
+    ENGINE_CHECK(items == 100);
+}
+
+// Main-thread tasks queued from workers wait for ExecuteMainThreadTasks and then run on the main thread
+ENGINE_TEST(JobSystemMainThreadTasks)
+{
+    Engine::JobSystem jobs;
+    ENGINE_CHECK(jobs.Initialize(2));
+    ENGINE_CHECK(jobs.IsMainThread());
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+    std::atomic<uint32_t> ranOnMain{ 0 }, ranElsewhere{ 0 };
+    Engine::JobCounter counter;
+    for (int i = 0; i < 8; ++i)
+    {
+        jobs.Run(counter, [&]() {
+            jobs.RunOnMainThread([&]() {
+                (std::this_thread::get_id() == mainThread ? ranOnMain : ranElsewhere).fetch_add(1);
+            });
+        });
+    }
+    jobs.Wait(counter);
+
+    // Tasks the waiting (main) thread ran itself executed their main-thread work inline; the rest were queued
+    jobs.ExecuteMainThreadTasks();
+    ENGINE_CHECK(ranOnMain == 8u);
+    ENGINE_CHECK(ranElsewhere == 0u);
+    jobs.Shutdown();
+}
+
+// ParallelFor throughput with 1..hardware-1 workers over 1M independent items (best of 5 per worker count)
+ENGINE_BENCH(JobSystemParallelForBench)
+{
+    constexpr uint32_t kItems = 1u << 20;
+    std::vector<float> values(kItems);
+    const uint32_t hardware = std::thread::hardware_concurrency();
+    const uint32_t maxWorkers = hardware > 2 ? hardware - 1 : 1;
+
+    double baseMs = 0.0;
+    for (uint32_t workers = 1; workers <= maxWorkers; ++workers)
+    {
+        Engine::JobSystem jobs;
+        jobs.Initialize(workers);
+        const double ms = EngineTest::BestMs(5, [&]() {
+            jobs.ParallelFor(kItems, 1024, [&values](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i)
+                    values[i] = std::sqrt(float(i)) * std::sin(float(i)) * std::sin(float(i)) + std::sqrt(float(i)) * std::cos(float(i)) * std::cos(float(i));
+            });
+        });
+        baseMs = workers == 1 ? ms : baseMs;
+        std::printf("bench jobs workers=%u threads=%u parallel_for_ms=%.3f speedup=%.2f\n", workers, jobs.GetConcurrency(), ms, baseMs / ms);
+        jobs.Shutdown();
+    }
+}
@@ -0,0 +1,148 @@
+#include "TestFramework.h"
+#include "Engine/JobSystem.h"
+#include "Engine/LightClustering.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    // Camera at the origin looking down +Z (view = identity), 60 degree vertical fov, 16:9
+    Engine::ClusterCamera TestCamera()
+    {
+        Engine::ClusterCamera camera{};
+        DirectX::XMStoreFloat4x4(&camera.view, DirectX::XMMatrixIdentity());
+        camera.projScaleY = 1.0f / std::tan(DirectX::XM_PI / 6.0f);
+        camera.projScaleX = camera.projScaleY * 9.0f / 16.0f;
+        camera.nearZ = 0.1f;
+        camera.farZ = 200.0f;
+        return camera;
+    }
+
+    // Point and spot lights scattered around and beyond the frustum
+    std::vector<Engine::ClusterLightBounds> MakeLights(EngineTest::Random& random, size_t count, float minRange, float maxRange)
+    {
+        std::vector<Engine::ClusterLightBounds> lights(count);
+        for (Engine::ClusterLightBounds& l : lights)
+        {
+            l.position = DirectX::XMFLOAT3(random.Next01() * 240.0f - 120.0f, random.Next01() * 120.0f - 60.0f, random.Next01() * 210.0f - 5.0f);
+            l.range = minRange + random.Next01() * (maxRange - minRange);
+            if (random.Next01() < 0.25f)
+            {
+                l.direction = DirectX::XMFLOAT3(0.0f, -1.0f, 0.0f);
+                l.spotAngle = 0.2f + random.Next01();
+            }
+        }
+        return lights;
+    }
+
+    void ConfigureDefault(Engine::LightClusterer& clusterer, uint32_t maxLightsPerCluster)
+    {
+        clusterer.Configure(Engine::LightClusterer::kDefaultDimX, Engine::LightClusterer::kDefaultDimY, Engine::LightClusterer::kDefaultDimZ, maxLightsPerCluster);
+    }
+}
+
+// Slices binned on the job system produce exactly the serial index list and ranges
+ENGINE_TEST(LightClusteringParallelMatchesSerial)
+{
+    const Engine::ClusterCamera camera = TestCamera();
+    EngineTest::Random random(4242u);
+    const std::vector<Engine::ClusterLightBounds> lights = MakeLights(random, 2000, 0.5f, 8.0f);
+
+    Engine::JobSystem jobs;
+    ENGINE_CHECK(jobs.Initialize(3));
+    Engine::LightClusterer serial, parallel;
+    ConfigureDefault(serial, 256);
+    ConfigureDefault(parallel, 256);
+    serial.Build(lights, camera, 1);
+    parallel.Build(lights, camera, 1, &jobs);
+    jobs.Shutdown();
+
+    ENGINE_CHECK(!serial.GetIndexList().empty());
+    ENGINE_CHECK(serial.GetIndexList() == parallel.GetIndexList());
+    ENGINE_CHECK(serial.GetClusterRanges() == parallel.GetClusterRanges());
+    ENGINE_CHECK(serial.GetOverflowCount() == parallel.GetOverflowCount());
+}
+
+// A light's own position lies inside its bounding sphere, so the cluster containing it must list the light
+ENGINE_TEST(LightClusteringBinsLightsIntoOwnCluster)
+{
+    const Engine::ClusterCamera camera = TestCamera();
+    EngineTest::Random random(4242u);
+    const std::vector<Engine::ClusterLightBounds> lights = MakeLights(random, 256, 0.5f, 4.0f);
+
+    Engine::LightClusterer clusterer;
+    ConfigureDefault(clusterer, 256);
+    clusterer.Build(lights, camera, 1);
+    ENGINE_CHECK(clusterer.GetOverflowCount() == 0);
+    ENGINE_CHECK(clusterer.GetClusterRanges().size() == size_t(clusterer.GetClusterCount()) * 2);
+
+    uint32_t visibleLights = 0, missing = 0;
+    for (uint32_t li = 0; li < uint32_t(lights.size()); ++li)
+    {
+        const DirectX::XMFLOAT3& p = lights[li].position;
+        if (p.z <= camera.nearZ || p.z >= camera.farZ) continue;
+        const float ndcX = camera.projScaleX * p.x / p.z, ndcY = camera.projScaleY * p.y / p.z;
+        if (std::fabs(ndcX) >= 1.0f || std::fabs(ndcY) >= 1.0f) continue;
+
+        const uint32_t tz = std::min(uint32_t(std::max(0.0f, std::log(p.z) * clusterer.GetSliceScale() + clusterer.GetSliceBias())), clusterer.GetDimZ() - 1);
+        const uint32_t tx = std::min(uint32_t((ndcX * 0.5f + 0.5f) * float(clusterer.GetDimX())), clusterer.GetDimX() - 1);
+        const uint32_t ty = std::min(uint32_t((0.5f - ndcY * 0.5f) * float(clusterer.GetDimY())), clusterer.GetDimY() - 1);
+        const uint32_t cluster = (tz * clusterer.GetDimY() + ty) * clusterer.GetDimX() + tx;
+        const uint32_t offset = clusterer.GetClusterRanges()[cluster * 2], count = clusterer.GetClusterRanges()[cluster * 2 + 1];
+        const auto first = clusterer.GetIndexList().begin() + offset;
+        missing += std::find(first, first + count, li + 1) == first + count ? 1 : 0;
+        ++visibleLights;
+    }
+    ENGINE_CHECK(visibleLights > 0);
+    ENGINE_CHECK(missing == 0);
+}
+
+// Clusters stop at their capacity and every dropped reference is counted
+ENGINE_TEST(LightClusteringCountsOverflow)
+{
+    const Engine::ClusterCamera camera = TestCamera();
+    std::vector<Engine::ClusterLightBounds> lights(8);
+    for (Engine::ClusterLightBounds& l : lights)
+    {
+        l.position = DirectX::XMFLOAT3(0.0f, 0.0f, 20.0f);
+        l.range = 1.0f;
+    }
+
+    Engine::LightClusterer clusterer;
+    ConfigureDefault(clusterer, 2);
+    clusterer.Build(lights, camera, 0);
+
+    uint32_t references = 0;
+    for (uint32_t c = 0; c < clusterer.GetClusterCount(); ++c)
+    {
+        const uint32_t count = clusterer.GetClusterRanges()[c * 2 + 1];
+        ENGINE_CHECK(count <= 2);
+        references += count;
+    }
+    ENGINE_CHECK(references > 0);
+    ENGINE_CHECK(references == clusterer.GetIndexList().size());
+    ENGINE_CHECK(clusterer.GetOverflowCount() == references / 2 * 6); // every touched cluster holds 2 of the 8 lights
+}
+
+// Serial and parallel Build cost from 1000 to 10000 lights with the renderer's grid and capacity
+ENGINE_BENCH(LightClusteringBench)
+{
+    const Engine::ClusterCamera camera = TestCamera();
+    EngineTest::Random random(4242u);
+    Engine::JobSystem jobs;
+    jobs.Initialize();
+
+    Engine::LightClusterer clusterer;
+    for (int count = 1000; count <= 10000; count += 1000)
+    {
+        const std::vector<Engine::ClusterLightBounds> lights = MakeLights(random, size_t(count), 2.0f, 10.0f);
+        const double serialMs = EngineTest::BestMs(5, [&]() { clusterer.Build(lights, camera, 0); });
+        const double parallelMs = EngineTest::BestMs(5, [&]() { clusterer.Build(lights, camera, 0, &jobs); });
+        std::printf("bench light_clusters lights=%d clusters=%u refs=%zu overflow=%u serial_ms=%.3f parallel_ms=%.3f threads=%u\n",
+            count, clusterer.GetClusterCount(), clusterer.GetIndexList().size(), clusterer.GetOverflowCount(), serialMs, parallelMs,
+            jobs.GetConcurrency());
+    }
+    jobs.Shutdown();
+}
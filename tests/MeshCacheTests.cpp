@@ -0,0 +1,170 @@
+#include "TestFramework.h"
+#include "Engine/MappedFile.h"
+#include "Engine/MeshCache.h"
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+    // A vertex grid with its triangles, collision positions and a two-level LOD chain (full list + every other quad)
+    struct TestMesh
+    {
+        std::vector<Engine::Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<DirectX::XMFLOAT3> positions;
+        std::vector<uint32_t> lodIndices;
+        std::vector<Engine::MeshLod> lods;
+        Engine::MeshBounds bounds;
+
+        Engine::MeshCacheMesh View() const
+        {
+            Engine::MeshCacheMesh m;
+            m.vertices = vertices.data();
+            m.vertexCount = uint32_t(vertices.size());
+            m.indices = indices.data();
+            m.indexCount = uint32_t(indices.size());
+            m.positions = positions.data();
+            m.bounds = bounds;
+            m.lodIndices = lodIndices.data();
+            m.lodIndexCount = uint32_t(lodIndices.size());
+            m.lods = lods.data();
+            m.lodCount = uint32_t(lods.size());
+            return m;
+        }
+    };
+
+    TestMesh MakeGrid(uint32_t size, float height)
+    {
+        TestMesh mesh;
+        for (uint32_t y = 0; y <= size; ++y)
+        {
+            for (uint32_t x = 0; x <= size; ++x)
+            {
+                const DirectX::XMFLOAT3 p(float(x), height, float(y));
+                mesh.vertices.push_back({ p, DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f), DirectX::XMFLOAT2(float(x) / size, float(y) / size) });
+                mesh.positions.push_back(p);
+            }
+        }
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t v = y * (size + 1) + x;
+                const uint32_t quad[6] = { v, v + size + 1, v + 1, v + 1, v + size + 1, v + size + 2 };
+                mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+                if ((x + y) % 2 == 0) mesh.lodIndices.insert(mesh.lodIndices.end(), quad, quad + 6);
+            }
+        }
+        mesh.lods.push_back({ 0, uint32_t(mesh.lodIndices.size()), 0.25f });
+        mesh.bounds.center = DirectX::XMFLOAT3(size * 0.5f, height, size * 0.5f);
+        mesh.bounds.extents = DirectX::XMFLOAT3(size * 0.5f, 0.0f, size * 0.5f);
+        mesh.bounds.radius = size * 0.71f;
+        return mesh;
+    }
+
+    template<typename T>
+    bool SameBytes(const T* a, const std::vector<T>& b)
+    {
+        return b.empty() || std::memcmp(a, b.data(), b.size() * sizeof(T)) == 0;
+    }
+
+    bool SameMesh(const Engine::MeshCacheMesh& read, const TestMesh& written)
+    {
+        return read.vertexCount == written.vertices.size() && read.indexCount == written.indices.size() &&
+               read.lodIndexCount == written.lodIndices.size() && read.lodCount == written.lods.size() &&
+               SameBytes(read.vertices, written.vertices) && SameBytes(read.indices, written.indices) &&
+               SameBytes(read.positions, written.positions) && SameBytes(read.lodIndices, written.lodIndices) &&
+               SameBytes(read.lods, written.lods) && std::memcmp(&read.bounds, &written.bounds, sizeof(read.bounds)) == 0;
+    }
+
+    // Writes the meshes through MeshCache::Write and returns the file contents
+    bool WriteTestCache(const Engine::MeshCacheKey& key, const std::vector<TestMesh>& meshes, std::vector<uint8_t>& file)
+    {
+        std::error_code ec;
+        const std::string path = (std::filesystem::temp_directory_path(ec) / "engine_tests_mesh_cache.mesh").string();
+        std::vector<Engine::MeshCacheMesh> views;
+        for (const TestMesh& m : meshes) views.push_back(m.View());
+        if (!Engine::MeshCache::Write(path, key, views)) return false;
+
+        Engine::MappedFile mapped;
+        const bool opened = mapped.Open(path);
+        if (opened) file.assign(mapped.GetData(), mapped.GetData() + mapped.GetSize());
+        mapped.Close();
+        std::filesystem::remove(path, ec);
+        return opened;
+    }
+
+    Engine::MeshCacheKey TestKey()
+    {
+        Engine::MeshCacheKey key;
+        key.sourcePath = "models/test_grid.fbx";
+        key.sourceMtime = 1234567;
+        key.sourceSize = 4096;
+        key.importFlags = 0x8B;
+        return key;
+    }
+}
+
+// Write -> map -> Read gives back every blob byte for byte; a key that differs in any field is stale
+ENGINE_TEST(MeshCacheRoundTrip)
+{
+    const std::vector<TestMesh> meshes = { MakeGrid(8, 0.0f), MakeGrid(3, 2.0f) };
+    const Engine::MeshCacheKey key = TestKey();
+    std::vector<uint8_t> file;
+    ENGINE_CHECK(WriteTestCache(key, meshes, file));
+
+    std::vector<Engine::MeshCacheMesh> read;
+    ENGINE_CHECK(Engine::MeshCache::Read(file.data(), file.size(), key, read));
+    ENGINE_CHECK(read.size() == meshes.size());
+    for (size_t i = 0; i < read.size() && i < meshes.size(); ++i)
+        ENGINE_CHECK(SameMesh(read[i], meshes[i]));
+
+    Engine::MeshCacheKey stale = key;
+    stale.sourceMtime += 1;
+    ENGINE_CHECK(!Engine::MeshCache::Read(file.data(), file.size(), stale, read) && read.empty());
+    stale = key;
+    stale.sourceSize += 1;
+    ENGINE_CHECK(!Engine::MeshCache::Read(file.data(), file.size(), stale, read));
+    stale = key;
+    stale.importFlags ^= 1u;
+    ENGINE_CHECK(!Engine::MeshCache::Read(file.data(), file.size(), stale, read));
+    stale = key;
+    stale.sourcePath = "models/test_grif.fbx";
+    ENGINE_CHECK(!Engine::MeshCache::Read(file.data(), file.size(), stale, read));
+}
+
+// Truncated files and damaged blobs (vertices, indices, LOD ranges) are rejected with nothing returned, so the caller
+// re-imports instead of uploading bad data
+ENGINE_TEST(MeshCacheRejectsDamage)
+{
+    const std::vector<TestMesh> meshes = { MakeGrid(8, 0.0f), MakeGrid(3, 2.0f) };
+    const Engine::MeshCacheKey key = TestKey();
+    std::vector<uint8_t> file;
+    ENGINE_CHECK(WriteTestCache(key, meshes, file));
+
+    std::vector<Engine::MeshCacheMesh> read;
+    bool truncationRejected = true;
+    for (size_t size = 0; size < file.size(); ++size)
+        truncationRejected = truncationRejected && !Engine::MeshCache::Read(file.data(), size, key, read) && read.empty();
+    ENGINE_CHECK(truncationRejected);
+
+    // Offsets of the written blobs, found from a good read
+    ENGINE_CHECK(Engine::MeshCache::Read(file.data(), file.size(), key, read) && read.size() == 2);
+    if (read.size() != 2) return;
+    auto offsetOf = [&file](const void* p) { return size_t(static_cast<const uint8_t*>(p) - file.data()); };
+    const size_t blobs[] = {
+        offsetOf(read[0].vertices) + 7,
+        offsetOf(read[0].indices) + 4 * 10,
+        offsetOf(read[1].positions) + 5,
+        offsetOf(read[1].lods),
+        offsetOf(read[1].lodIndices) + 3,
+    };
+    for (size_t at : blobs)
+    {
+        std::vector<uint8_t> damaged = file;
+        damaged[at] ^= 0x40;
+        ENGINE_CHECK(!Engine::MeshCache::Read(damaged.data(), damaged.size(), key, read) && read.empty());
+    }
+}
@@ -0,0 +1,187 @@
+#include "TestFramework.h"
+#include "Engine/MeshOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct TestMesh
+    {
+        const char* name = "";
+        std::vector<DirectX::XMFLOAT3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // Row-major order, as simple generators produce it
+    TestMesh MakeGrid(uint32_t size)
+    {
+        TestMesh mesh;
+        mesh.name = "grid";
+        for (uint32_t y = 0; y <= size; ++y)
+            for (uint32_t x = 0; x <= size; ++x)
+                mesh.positions.push_back(DirectX::XMFLOAT3(float(x), float(y), 0.0f));
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t a = y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, c, b, b, c, d });
+            }
+        }
+        return mesh;
+    }
+
+    // Stacks x slices UV sphere with a seam column, like MeshManager::CreateSphere
+    TestMesh MakeSphere(uint32_t slices, uint32_t stacks)
+    {
+        TestMesh mesh;
+        mesh.name = "sphere";
+        for (uint32_t i = 0; i <= stacks; ++i)
+        {
+            const float phi = DirectX::XM_PI * float(i) / float(stacks);
+            for (uint32_t j = 0; j <= slices; ++j)
+            {
+                const float theta = DirectX::XM_2PI * float(j) / float(slices);
+                mesh.positions.push_back(DirectX::XMFLOAT3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)));
+            }
+        }
+        for (uint32_t i = 0; i < stacks; ++i)
+        {
+            for (uint32_t j = 0; j < slices; ++j)
+            {
+                const uint32_t a = i * (slices + 1) + j, b = a + slices + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+            }
+        }
+        return mesh;
+    }
+
+    // Whole triangles in a deterministic random order (worst case for the cache)
+    std::vector<uint32_t> ShuffleTriangles(const std::vector<uint32_t>& indices, uint32_t seed)
+    {
+        EngineTest::Random random(seed);
+        std::vector<uint32_t> order(indices.size() / 3);
+        for (size_t t = 0; t < order.size(); ++t) order[t] = uint32_t(t);
+        for (size_t t = order.size(); t > 1; --t)
+            std::swap(order[t - 1], order[random.Next() % t]);
+
+        std::vector<uint32_t> shuffled(indices.size());
+        for (size_t t = 0; t < order.size(); ++t)
+            std::copy_n(indices.begin() + order[t] * 3, 3, shuffled.begin() + t * 3);
+        return shuffled;
+    }
+
+    // Triangles rotated to start at their smallest index (keeps the winding), sorted
+    std::vector<std::array<uint32_t, 3>> Canonical(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> tris(indices.size() / 3);
+        for (size_t t = 0; t < tris.size(); ++t)
+        {
+            tris[t] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+            std::rotate(tris[t].begin(), std::min_element(tris[t].begin(), tris[t].end()), tris[t].end());
+        }
+        std::sort(tris.begin(), tris.end());
+        return tris;
+    }
+
+    float Acmr(const std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        return Engine::MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount).acmr;
+    }
+
+    void Optimize(std::vector<uint32_t>& indices, const std::vector<DirectX::XMFLOAT3>& positions)
+    {
+        Engine::MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), positions.size());
+        Engine::MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), positions.data(), positions.size());
+    }
+}
+
+// Cache + overdraw passes on shuffled triangles keep the exact triangle set (and winding), beat the shuffled order
+// clearly and end up about as good as the generators' own orders
+ENGINE_TEST(MeshOptimizerReordersTriangles)
+{
+    for (const TestMesh& mesh : { MakeGrid(32), MakeSphere(24, 16) })
+    {
+        const float generated = Acmr(mesh.indices, mesh.positions.size());
+        std::vector<uint32_t> indices = ShuffleTriangles(mesh.indices, 12345u);
+        const float shuffled = Acmr(indices, mesh.positions.size());
+        Optimize(indices, mesh.positions);
+        const float optimized = Acmr(indices, mesh.positions.size());
+
+        ENGINE_CHECK(Canonical(indices) == Canonical(mesh.indices));
+        ENGINE_CHECK(optimized < shuffled * 0.6f);
+        ENGINE_CHECK(optimized <= generated + 0.05f);
+    }
+}
+
+// The fetch remap is a permutation that numbers vertices in first-use order; every corner keeps its position and the
+// cache behavior is unchanged by the renaming
+ENGINE_TEST(MeshOptimizerVertexFetchRemap)
+{
+    for (TestMesh mesh : { MakeGrid(16), MakeSphere(12, 8) })
+    {
+        // An unreferenced vertex goes last
+        mesh.positions.insert(mesh.positions.begin(), DirectX::XMFLOAT3(9.0f, 9.0f, 9.0f));
+        for (uint32_t& i : mesh.indices) ++i;
+
+        std::vector<uint32_t> original = ShuffleTriangles(mesh.indices, 777u);
+        Optimize(original, mesh.positions);
+        std::vector<uint32_t> fetched = original;
+        std::vector<uint32_t> remap;
+        Engine::MeshOptimizer::BuildVertexFetchRemap(fetched.data(), fetched.size(), mesh.positions.size(), remap);
+
+        ENGINE_CHECK(remap.size() == mesh.positions.size());
+        if (remap.size() != mesh.positions.size()) continue;
+        std::vector<uint8_t> taken(remap.size(), 0);
+        bool permutation = true;
+        for (uint32_t r : remap)
+        {
+            permutation = permutation && r < remap.size() && !taken[r];
+            if (permutation) taken[r] = 1;
+        }
+        ENGINE_CHECK(permutation);
+        if (!permutation) continue;
+        ENGINE_CHECK(remap[0] == remap.size() - 1);
+
+        std::vector<DirectX::XMFLOAT3> positions(mesh.positions.size());
+        for (size_t v = 0; v < remap.size(); ++v) positions[remap[v]] = mesh.positions[v];
+
+        bool firstUse = true, samePositions = true;
+        uint32_t next = 0;
+        for (size_t i = 0; i < fetched.size(); ++i)
+        {
+            firstUse = firstUse && fetched[i] == remap[original[i]] && fetched[i] <= next;
+            samePositions = samePositions && std::memcmp(&positions[fetched[i]], &mesh.positions[original[i]], sizeof(DirectX::XMFLOAT3)) == 0;
+            if (fetched[i] == next) ++next;
+        }
+        ENGINE_CHECK(firstUse);
+        ENGINE_CHECK(samePositions);
+        ENGINE_CHECK(Acmr(fetched, mesh.positions.size()) == Acmr(original, mesh.positions.size()));
+    }
+}
+
+// Reorder cost and ACMR (shuffled -> optimized) for growing grids and spheres, best of 3
+ENGINE_BENCH(MeshOptimizerBench)
+{
+    std::vector<TestMesh> meshes;
+    for (uint32_t size : { 64u, 128u, 256u }) meshes.push_back(MakeGrid(size));
+    for (uint32_t slices : { 64u, 256u }) meshes.push_back(MakeSphere(slices, slices / 2));
+
+    for (const TestMesh& mesh : meshes)
+    {
+        const std::vector<uint32_t> shuffled = ShuffleTriangles(mesh.indices, 12345u);
+        std::vector<uint32_t> indices;
+        const double ms = EngineTest::BestMs(3, [&]() {
+            indices = shuffled;
+            Optimize(indices, mesh.positions);
+        });
+        std::printf("bench mesh_opt mesh=%s triangles=%zu acmr_shuffled=%.3f acmr_after=%.3f acmr_generated=%.3f ms=%.3f\n",
+            mesh.name, mesh.indices.size() / 3, Acmr(shuffled, mesh.positions.size()), Acmr(indices, mesh.positions.size()),
+            Acmr(mesh.indices, mesh.positions.size()), ms);
+    }
+}
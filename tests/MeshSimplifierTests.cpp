@@ -0,0 +1,214 @@
+#include "TestFramework.h"
+#include "Engine/MeshSimplifier.h"
+#include "Engine/MeshTypes.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<DirectX::XMFLOAT3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // Stacks x slices UV sphere with a seam column and collapsed poles, like MeshManager::CreateSphere
+    TestMesh MakeSphere(uint32_t slices, uint32_t stacks)
+    {
+        TestMesh mesh;
+        for (uint32_t i = 0; i <= stacks; ++i)
+        {
+            const float phi = DirectX::XM_PI * float(i) / float(stacks);
+            for (uint32_t j = 0; j <= slices; ++j)
+            {
+                const float theta = DirectX::XM_2PI * float(j) / float(slices);
+                mesh.positions.push_back(DirectX::XMFLOAT3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)));
+            }
+        }
+        for (uint32_t i = 0; i < stacks; ++i)
+        {
+            for (uint32_t j = 0; j < slices; ++j)
+            {
+                const uint32_t a = i * (slices + 1) + j, b = a + slices + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+            }
+        }
+        return mesh;
+    }
+
+    // Flat size x size quad grid in the XY plane (open border all around)
+    TestMesh MakeGrid(uint32_t size)
+    {
+        TestMesh mesh;
+        for (uint32_t y = 0; y <= size; ++y)
+            for (uint32_t x = 0; x <= size; ++x)
+                mesh.positions.push_back(DirectX::XMFLOAT3(float(x), float(y), 0.0f));
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t a = y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, b, c, b, d, c });
+            }
+        }
+        return mesh;
+    }
+
+    // Every index in range and no triangle with a repeated vertex
+    bool ValidTriangles(const std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        if (indices.size() % 3 != 0) return false;
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            const uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+            if (a >= vertexCount || b >= vertexCount || c >= vertexCount || a == b || b == c || a == c) return false;
+        }
+        return true;
+    }
+
+    // Sum of the triangles' signed areas in the XY plane
+    double PlanarArea(const TestMesh& mesh, const std::vector<uint32_t>& indices)
+    {
+        double area = 0.0;
+        for (size_t t = 0; t + 2 < indices.size(); t += 3)
+        {
+            const DirectX::XMFLOAT3& a = mesh.positions[indices[t]];
+            const DirectX::XMFLOAT3& b = mesh.positions[indices[t + 1]];
+            const DirectX::XMFLOAT3& c = mesh.positions[indices[t + 2]];
+            area += 0.5 * (double(b.x - a.x) * (c.y - a.y) - double(b.y - a.y) * (c.x - a.x));
+        }
+        return area;
+    }
+
+    size_t Simplify(std::vector<uint32_t>& out, const TestMesh& mesh, const std::vector<uint32_t>& indices,
+                    size_t target, float targetError, float* resultError = nullptr)
+    {
+        out.resize(indices.size());
+        const size_t count = Engine::MeshSimplifier::Simplify(out.data(), indices.data(), indices.size(),
+                                                             mesh.positions.data(), mesh.positions.size(), target, targetError, resultError);
+        out.resize(count);
+        return count;
+    }
+}
+
+// A LOD chain built like MeshManager::BuildLods (half the triangles per level, error budget shared by the chain) gives
+// strictly fewer triangles per level, valid triangles over the base vertices, and only vertices the previous level used
+ENGINE_TEST(MeshSimplifierLodChain)
+{
+    const TestMesh mesh = MakeSphere(48, 32);
+    constexpr float kMaxError = 0.05f;
+
+    std::vector<uint32_t> previous = mesh.indices, level;
+    std::vector<size_t> triangles = { previous.size() / 3 };
+    float error = 0.0f;
+    bool valid = true, decreasing = true, withinBudget = true, subset = true;
+    while (triangles.size() <= Engine::MeshLodSelect::kMaxLods && error < kMaxError)
+    {
+        float levelError = 0.0f;
+        const size_t count = Simplify(level, mesh, previous, previous.size() / 6 * 3, kMaxError - error, &levelError);
+        if (count == 0 || count * 5 > previous.size() * 4) break;
+
+        std::vector<uint8_t> used(mesh.positions.size(), 0);
+        for (uint32_t i : previous) used[i] = 1;
+        for (uint32_t i : level) subset = subset && i < used.size() && used[i];
+
+        valid = valid && ValidTriangles(level, mesh.positions.size());
+        decreasing = decreasing && count < previous.size();
+        withinBudget = withinBudget && levelError >= 0.0f && levelError <= kMaxError - error;
+        error += levelError;
+        triangles.push_back(count / 3);
+        previous.swap(level);
+    }
+
+    ENGINE_CHECK(triangles.size() >= 3);
+    ENGINE_CHECK(valid);
+    ENGINE_CHECK(decreasing);
+    ENGINE_CHECK(withinBudget);
+    ENGINE_CHECK(subset);
+}
+
+// A flat grid simplifies to far fewer triangles at (almost) no error; its outline only slides along itself, so the
+// covered area stays the same
+ENGINE_TEST(MeshSimplifierKeepsFlatOutline)
+{
+    const TestMesh mesh = MakeGrid(16);
+    std::vector<uint32_t> out;
+    float resultError = -1.0f;
+    const size_t count = Simplify(out, mesh, mesh.indices, 6, 1e-4f, &resultError);
+
+    ENGINE_CHECK(count < mesh.indices.size() / 4);
+    ENGINE_CHECK(ValidTriangles(out, mesh.positions.size()));
+    ENGINE_CHECK(resultError >= 0.0f && resultError <= 1e-4f);
+    ENGINE_CHECK(std::fabs(PlanarArea(mesh, out) - 256.0) < 1e-3);
+}
+
+// The target count is an upper bound that stops the collapses, a zero target count is limited by the error bound alone,
+// and simplifying in place gives the same result as into a separate buffer
+ENGINE_TEST(MeshSimplifierTargetsAndInPlace)
+{
+    const TestMesh mesh = MakeSphere(32, 16);
+    std::vector<uint32_t> out;
+    const size_t half = mesh.indices.size() / 6 * 3;
+    const size_t count = Simplify(out, mesh, mesh.indices, half, 1.0f);
+    ENGINE_CHECK(count <= half && count > half / 2);
+    ENGINE_CHECK(ValidTriangles(out, mesh.positions.size()));
+
+    std::vector<uint32_t> tight;
+    float tightError = -1.0f;
+    Simplify(tight, mesh, mesh.indices, 0, 0.001f, &tightError);
+    ENGINE_CHECK(tight.size() > count && tightError <= 0.001f);
+
+    std::vector<uint32_t> inPlace = mesh.indices;
+    const size_t inPlaceCount = Engine::MeshSimplifier::Simplify(inPlace.data(), inPlace.data(), inPlace.size(),
+                                                                 mesh.positions.data(), mesh.positions.size(), half, 1.0f);
+    inPlace.resize(inPlaceCount);
+    ENGINE_CHECK(inPlace == out);
+}
+
+// Shrinking then growing again switches exactly once per threshold each way; a size wobbling within the hysteresis
+// band around a threshold keeps its level
+ENGINE_TEST(MeshLodSelectHysteresis)
+{
+    using Engine::MeshLodSelect::Select;
+    using Engine::MeshLodSelect::kMaxLods;
+    using Engine::MeshLodSelect::kScreenSize;
+
+    uint32_t switches = 0, lod = 0, deepest = 0;
+    for (int step = 0; step < 400; ++step)
+    {
+        const float t = step < 200 ? float(step) / 199.0f : float(399 - step) / 199.0f;
+        const uint32_t next = Select(std::pow(0.01f, t), lod, kMaxLods);
+        switches += next != lod ? 1 : 0;
+        lod = next;
+        deepest = std::max(deepest, lod);
+    }
+    ENGINE_CHECK(switches == 2 * kMaxLods);
+    ENGINE_CHECK(deepest == kMaxLods && lod == 0);
+
+    for (uint32_t level = 0; level < kMaxLods; ++level)
+    {
+        const float below = kScreenSize[level] * 0.95f, above = kScreenSize[level] * 1.05f;
+        ENGINE_CHECK(Select(below, level, kMaxLods) == level && Select(above, level + 1, kMaxLods) == level + 1);
+        ENGINE_CHECK(Select(kScreenSize[level] * 0.5f, level, kMaxLods) > level);
+    }
+
+    ENGINE_CHECK(Select(0.001f, 0, 2) == 2);
+    ENGINE_CHECK(Select(0.001f, 0, 0) == 0);
+    ENGINE_CHECK(Select(1.0f, 7, kMaxLods) == 0);
+}
+
+// Cost of one half-the-triangles Simplify on growing spheres, best of 3
+ENGINE_BENCH(MeshSimplifierBench)
+{
+    for (uint32_t slices : { 64u, 128u, 256u })
+    {
+        const TestMesh mesh = MakeSphere(slices, slices / 2);
+        std::vector<uint32_t> out;
+        float error = 0.0f;
+        const double ms = EngineTest::BestMs(3, [&]() { Simplify(out, mesh, mesh.indices, mesh.indices.size() / 6 * 3, 0.05f, &error); });
+        std::printf("bench mesh_simplify triangles=%zu result=%zu error=%.4f ms=%.3f\n",
+            mesh.indices.size() / 3, out.size() / 3, error, ms);
+    }
+}
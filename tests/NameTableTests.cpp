@@ -0,0 +1,61 @@
+#include "TestFramework.h"
+#include "Engine/NameTable.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Equal strings share one handle, distinct ones get distinct handles; handle 0 is the empty string
+ENGINE_TEST(NameTableInternsOncePerString)
+{
+    Engine::NameTable table;
+    ENGINE_CHECK(table.GetCount() == 1);
+    ENGINE_CHECK(table.Intern("") == 0);
+    ENGINE_CHECK(table.Intern(std::string_view()) == 0);
+
+    const Engine::NameHandle cube = table.Intern("Cube");
+    const Engine::NameHandle light = table.Intern("Light");
+    ENGINE_CHECK(cube != 0 && light != 0 && cube != light);
+    ENGINE_CHECK(table.Intern(std::string("Cube")) == cube);
+    ENGINE_CHECK(table.Intern(std::string_view("Cube 12", 4)) == cube);
+    ENGINE_CHECK(table.Intern("cube") != cube);
+    ENGINE_CHECK(table.GetCount() == 4);
+
+    ENGINE_CHECK(table.Resolve(cube) == "Cube");
+    ENGINE_CHECK(std::strcmp(table.CStr(light), "Light") == 0);
+}
+
+// Unknown handles (e.g. from another process) resolve to the empty string instead of reading out of range
+ENGINE_TEST(NameTableUnknownHandleIsEmpty)
+{
+    Engine::NameTable table;
+    table.Intern("Cube");
+    ENGINE_CHECK(table.Resolve(12345).empty());
+    ENGINE_CHECK(std::strcmp(table.CStr(12345), "") == 0);
+    ENGINE_CHECK(table.Resolve(0).empty());
+}
+
+// Strings spanning many arena blocks (and larger than one block) keep their handle and address, null-terminated
+ENGINE_TEST(NameTableStorageIsStable)
+{
+    Engine::NameTable table;
+    std::vector<std::string> names;
+    std::vector<Engine::NameHandle> handles;
+    std::vector<const char*> pointers;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        names.push_back("Entity " + std::to_string(i));
+        if (i % 5000 == 0) names.back().append(100000, 'x');
+        handles.push_back(table.Intern(names.back()));
+        pointers.push_back(table.CStr(handles.back()));
+    }
+    ENGINE_CHECK(table.GetCount() == names.size() + 1);
+    ENGINE_CHECK(table.GetMemoryBytes() > 4 * 100000);
+
+    bool stable = true;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        stable = stable && table.Intern(names[i]) == handles[i] && table.CStr(handles[i]) == pointers[i] &&
+                 table.Resolve(handles[i]) == names[i] && pointers[i][names[i].size()] == '\0';
+    }
+    ENGINE_CHECK(stable);
+}
@@ -0,0 +1,185 @@
+#include "TestFramework.h"
+#include "Engine/OffsetAllocator.h"
+#include <cstdio>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // Random allocate/free churn with mesh-like sizes, slightly more allocations than frees (up to a cap) so the space
+    // fills and fragments; grows by doubling when nothing fits. live: (offset, size) in allocation order.
+    struct Churn
+    {
+        Engine::OffsetAllocator allocator;
+        std::vector<std::pair<uint32_t, uint32_t>> live;
+        EngineTest::Random random{ 12345u };
+        uint32_t grows = 0;
+        bool ok = true;
+
+        explicit Churn(uint32_t capacity) { allocator.Initialize(capacity); }
+
+        void Step()
+        {
+            if (live.empty() || (live.size() < 4096 && random.Next() % 8 < 5))
+            {
+                Engine::OffsetAllocator::Allocation alloc;
+                const uint32_t size = 1u + random.Next() % 4096u;
+                if (!allocator.Allocate(size, alloc))
+                {
+                    allocator.Grow(allocator.GetCapacity() * 2);
+                    ++grows;
+                    ok = ok && allocator.Allocate(size, alloc);
+                }
+                ok = ok && alloc.size == size;
+                live.emplace_back(alloc.offset, alloc.size);
+            }
+            else
+            {
+                const size_t i = random.Next() % live.size();
+                ok = ok && allocator.Free(live[i].first);
+                live[i] = live.back();
+                live.pop_back();
+            }
+        }
+
+        std::map<uint32_t, uint32_t> SortedLive() const { return std::map<uint32_t, uint32_t>(live.begin(), live.end()); }
+
+        // Live ranges stay inside the capacity and never overlap; the used count is their sum
+        bool LiveRangesConsistent() const
+        {
+            const std::map<uint32_t, uint32_t> sorted = SortedLive();
+            uint64_t used = 0, end = 0;
+            for (const auto& [offset, size] : sorted)
+            {
+                if (offset < end) return false;
+                end = uint64_t(offset) + size;
+                used += size;
+            }
+            return sorted.size() == live.size() && end <= allocator.GetCapacity() && used == allocator.GetUsed() &&
+                   live.size() == allocator.GetAllocationCount();
+        }
+    };
+}
+
+// Best fit picks the smallest hole, freed neighbours coalesce, and bad requests are refused without side effects
+ENGINE_TEST(OffsetAllocatorBestFitAndCoalesce)
+{
+    Engine::OffsetAllocator allocator;
+    allocator.Initialize(100);
+    Engine::OffsetAllocator::Allocation a, b, c, d, e;
+    ENGINE_CHECK(allocator.Allocate(10, a) && a.offset == 0);
+    ENGINE_CHECK(allocator.Allocate(20, b) && b.offset == 10);
+    ENGINE_CHECK(allocator.Allocate(5, c) && c.offset == 30);
+    ENGINE_CHECK(allocator.Allocate(40, d) && d.offset == 35);
+    ENGINE_CHECK(allocator.Free(b.offset));     // holes: [10, 30) and [75, 100)
+    ENGINE_CHECK(allocator.Allocate(15, e) && e.offset == 10);
+    ENGINE_CHECK(allocator.GetFreeRangeCount() == 2 && allocator.GetLargestFreeRange() == 25);
+
+    ENGINE_CHECK(!allocator.Allocate(0, e));
+    ENGINE_CHECK(!allocator.Allocate(26, e));
+    ENGINE_CHECK(!allocator.Free(11));
+    ENGINE_CHECK(!allocator.Free(b.offset + 50));
+    ENGINE_CHECK(allocator.Validate());
+
+    for (uint32_t offset : { 10u, 0u, 35u, 30u })
+        ENGINE_CHECK(allocator.Free(offset));
+    ENGINE_CHECK(!allocator.Free(0));
+    ENGINE_CHECK(allocator.GetUsed() == 0 && allocator.GetFreeRangeCount() == 1 && allocator.GetLargestFreeRange() == 100);
+
+    allocator.Grow(160);
+    ENGINE_CHECK(allocator.GetFreeRangeCount() == 1 && allocator.GetLargestFreeRange() == 160 && allocator.Validate());
+}
+
+// Long churn with grows: the allocator stays internally consistent and agrees with an independent record of live ranges
+ENGINE_TEST(OffsetAllocatorChurnStaysValid)
+{
+    Churn churn(1u << 16);
+    bool valid = true, consistent = true;
+    for (int op = 0; op < 200000; ++op)
+    {
+        churn.Step();
+        if (op % 4096 == 0)
+        {
+            valid = valid && churn.allocator.Validate();
+            consistent = consistent && churn.LiveRangesConsistent();
+        }
+    }
+    ENGINE_CHECK(churn.ok);
+    ENGINE_CHECK(churn.grows > 0);
+    ENGINE_CHECK(valid && churn.allocator.Validate());
+    ENGINE_CHECK(consistent && churn.LiveRangesConsistent());
+    ENGINE_CHECK(churn.allocator.GetFreeRangeCount() > 1);
+}
+
+// Defragment moves ranges down in ascending order; copying in that order keeps every allocation's data, and the
+// result is packed at the front with one free range behind it
+ENGINE_TEST(OffsetAllocatorDefragmentPacks)
+{
+    Churn churn(1u << 16);
+    for (int op = 0; op < 50000; ++op) churn.Step();
+    ENGINE_CHECK(churn.ok);
+    const std::map<uint32_t, uint32_t> live = churn.SortedLive();
+
+    // Tag every element with its allocation's offset, then replay the moves on that "buffer"
+    std::vector<uint32_t> buffer(churn.allocator.GetCapacity(), ~0u);
+    for (const auto& [offset, size] : live)
+        for (uint32_t i = 0; i < size; ++i) buffer[offset + i] = offset;
+
+    std::vector<Engine::OffsetAllocator::Move> moves;
+    churn.allocator.Defragment(moves);
+    ENGINE_CHECK(!moves.empty());
+
+    bool ordered = true;
+    std::map<uint32_t, uint32_t> moved = live;
+    for (size_t i = 0; i < moves.size(); ++i)
+    {
+        const Engine::OffsetAllocator::Move& m = moves[i];
+        auto it = moved.find(m.from);
+        ordered = ordered && m.to < m.from && (i == 0 || moves[i - 1].from < m.from) && it != moved.end() && it->second == m.size;
+        if (!ordered) break;
+        for (uint32_t k = 0; k < m.size; ++k) buffer[m.to + k] = buffer[m.from + k];
+        moved.erase(it);
+        moved.emplace(m.to, m.size);
+    }
+    ENGINE_CHECK(ordered);
+
+    uint32_t end = 0;
+    bool packed = true, intact = true;
+    for (const auto& [offset, size] : moved)
+    {
+        packed = packed && offset == end;
+        end = offset + size;
+    }
+    // Allocations keep their relative order, so the n-th packed range holds the n-th original one's data
+    auto original = live.begin();
+    for (const auto& [offset, size] : moved)
+    {
+        for (uint32_t i = 0; i < size; ++i) intact = intact && buffer[offset + i] == original->first;
+        ++original;
+    }
+    ENGINE_CHECK(packed && end == churn.allocator.GetUsed());
+    ENGINE_CHECK(intact);
+    ENGINE_CHECK(churn.allocator.Validate());
+    ENGINE_CHECK(churn.allocator.GetFreeRangeCount() <= 1);
+    ENGINE_CHECK(churn.allocator.GetLargestFreeRange() == churn.allocator.GetCapacity() - churn.allocator.GetUsed());
+}
+
+// Allocate/free cost under churn, fragmentation before and cost of one Defragment after
+ENGINE_BENCH(OffsetAllocatorChurnBench)
+{
+    for (int opCount : { 100000, 1000000 })
+    {
+        Churn churn(1u << 20);
+        const double churnMs = EngineTest::BestMs(1, [&]() { for (int op = 0; op < opCount; ++op) churn.Step(); });
+
+        const uint32_t freeSpace = churn.allocator.GetCapacity() - churn.allocator.GetUsed();
+        const double fragmentation = freeSpace ? 1.0 - double(churn.allocator.GetLargestFreeRange()) / double(freeSpace) : 0.0;
+        const uint32_t freeRanges = churn.allocator.GetFreeRangeCount();
+        std::vector<Engine::OffsetAllocator::Move> moves;
+        const double defragMs = EngineTest::BestMs(1, [&]() { churn.allocator.Defragment(moves); });
+
+        std::printf("bench offset_alloc ops=%d live=%zu grows=%u ns_per_op=%.1f free_ranges=%u fragmentation=%.3f moves=%zu defrag_ms=%.3f\n",
+            opCount, churn.live.size(), churn.grows, churnMs * 1e6 / opCount, freeRanges, fragmentation, moves.size(), defragMs);
+    }
+}
@@ -0,0 +1,150 @@
+#include "TestFramework.h"
+#include "Engine/RenderQueue.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    const void* FakeTexture(uint32_t id) { return reinterpret_cast<const void*>(uintptr_t(id)); }
+
+    // Random keys over a few shaders/textures/meshes, so equal keys (stability) and uniform bytes (skipped passes) both occur
+    std::vector<Engine::DrawItem> RandomItems(EngineTest::Random& random, uint32_t count)
+    {
+        std::vector<Engine::DrawItem> items(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t shader = random.Next() % 3, texture = random.Next() % 7, mesh = random.Next() % 11;
+            items[i] = { Engine::SortKey::Make(shader, 1, texture, mesh, float(random.Next() % 4) / 4.0f), i };
+        }
+        return items;
+    }
+}
+
+// Every field reads back what Make packed, depth is clamped instead of wrapping, and the shader field orders first
+ENGINE_TEST(RenderQueueSortKeyFields)
+{
+    using namespace Engine::SortKey;
+    const uint64_t key = Make(3, 2, 100, 4000, 0.5f);
+    ENGINE_CHECK(Shader(key) == 3);
+    ENGINE_CHECK(Layout(key) == 2);
+    ENGINE_CHECK(Texture(key) == 100);
+    ENGINE_CHECK(Mesh(key) == 4000);
+    ENGINE_CHECK(!Overflowed(key));
+
+    ENGINE_CHECK(Depth(Make(0, 0, 0, 0, -1.0f)) == 0);
+    ENGINE_CHECK(Depth(Make(0, 0, 0, 0, 2.0f)) == (1u << kDepthBits) - 1u);
+    ENGINE_CHECK(Make(1, 0, 0, 0, 0.0f) > Make(0, 255, kTextureOverflow, kMeshOverflow, 1.0f));
+    ENGINE_CHECK(Make(0, 0, 0, 0, 0.25f) < Make(0, 0, 0, 0, 0.75f));
+}
+
+// Both Sort paths (stable_sort below 64 items, radix above) give exactly the stable key order
+ENGINE_TEST(RenderQueueSortIsStable)
+{
+    EngineTest::Random random(777u);
+    for (uint32_t count : { 2u, 17u, 63u, 64u, 65u, 1000u, 20000u })
+    {
+        const std::vector<Engine::DrawItem> items = RandomItems(random, count);
+        std::vector<Engine::DrawItem> expected = items;
+        std::stable_sort(expected.begin(), expected.end(),
+            [](const Engine::DrawItem& a, const Engine::DrawItem& b) { return a.key < b.key; });
+
+        Engine::RenderQueue queue;
+        queue.Clear();
+        for (const Engine::DrawItem& item : items) queue.Submit(item.key, item.index);
+        queue.Sort();
+
+        const std::vector<Engine::DrawItem>& sorted = queue.GetItems();
+        ENGINE_CHECK(sorted.size() == expected.size());
+        bool same = sorted.size() == expected.size();
+        for (size_t i = 0; same && i < sorted.size(); ++i)
+            same = sorted[i].key == expected[i].key && sorted[i].index == expected[i].index;
+        ENGINE_CHECK(same);
+    }
+}
+
+// Walking a sorted queue binds each state once per run of equal values; a shader bind invalidates the bound layout
+ENGINE_TEST(RenderQueueSkipsRedundantBinds)
+{
+    EngineTest::Random random(4242u);
+    Engine::RenderQueue queue;
+    queue.Clear();
+    for (const Engine::DrawItem& item : RandomItems(random, 5000)) queue.Submit(item.key, item.index);
+    queue.Sort();
+
+    uint32_t shaderRuns = 0, textureRuns = 0, meshRuns = 0;
+    uint64_t previous = ~0ull;
+    queue.ResetState();
+    for (const Engine::DrawItem& item : queue.GetItems())
+    {
+        const bool first = previous == ~0ull;
+        shaderRuns += first || Engine::SortKey::Shader(item.key) != Engine::SortKey::Shader(previous) ? 1 : 0;
+        textureRuns += first || Engine::SortKey::Texture(item.key) != Engine::SortKey::Texture(previous) ? 1 : 0;
+        meshRuns += first || Engine::SortKey::Mesh(item.key) != Engine::SortKey::Mesh(previous) ? 1 : 0;
+        previous = item.key;
+
+        queue.ChangeShader(Engine::SortKey::Shader(item.key));
+        queue.ChangeLayout(Engine::SortKey::Layout(item.key));
+        queue.ChangeTexture(Engine::SortKey::Texture(item.key));
+        queue.ChangeMesh(Engine::SortKey::Mesh(item.key));
+        queue.CountDraw(12);
+    }
+
+    const Engine::RenderQueueStats& stats = queue.GetStats();
+    ENGINE_CHECK(stats.draws == 5000);
+    ENGINE_CHECK(stats.triangles == 5000ull * 12ull);
+    ENGINE_CHECK(stats.shaderBinds == shaderRuns);
+    ENGINE_CHECK(stats.layoutBinds == shaderRuns);
+    ENGINE_CHECK(stats.textureBinds == textureRuns);
+    ENGINE_CHECK(stats.meshBinds == meshRuns);
+
+    queue.ResetState();
+    ENGINE_CHECK(queue.ChangeShader(0));
+    ENGINE_CHECK(queue.ChangeLayout(1));
+    ENGINE_CHECK(!queue.ChangeLayout(1));
+    ENGINE_CHECK(!queue.ChangeShader(0));
+    ENGINE_CHECK(queue.ChangeShader(1));
+    ENGINE_CHECK(queue.ChangeLayout(1));
+    ENGINE_CHECK(queue.ChangeMaterial(0.5f, 0.0f));
+    ENGINE_CHECK(!queue.ChangeMaterial(0.5f, 0.0f));
+    ENGINE_CHECK(queue.ChangeGeometry(2));
+    ENGINE_CHECK(!queue.ChangeGeometry(2));
+}
+
+// Dense keys are handed out in first-use order; past the field size every new texture/mesh gets the overflow key,
+// which counts as a lookup overflow and always rebinds
+ENGINE_TEST(RenderQueueKeysSaturate)
+{
+    Engine::RenderQueue queue;
+    queue.Clear();
+    ENGINE_CHECK(queue.GetTextureKey(FakeTexture(10)) == 0);
+    ENGINE_CHECK(queue.GetTextureKey(FakeTexture(20)) == 1);
+    ENGINE_CHECK(queue.GetTextureKey(FakeTexture(10)) == 0);
+    ENGINE_CHECK(queue.GetMeshKey(5, 0) == 0);
+    ENGINE_CHECK(queue.GetMeshKey(5, 1) == 1);
+    ENGINE_CHECK(queue.GetMeshKey(5, 0) == 0);
+
+    queue.Clear();
+    for (uint32_t t = 0; t < Engine::SortKey::kTextureOverflow; ++t)
+        ENGINE_CHECK(queue.GetTextureKey(FakeTexture(t + 1)) == t);
+    for (int m = 0; m < int(Engine::SortKey::kMeshOverflow); ++m)
+        queue.GetMeshKey(m, 0);
+    ENGINE_CHECK(queue.GetStats().keyOverflows == 0);
+
+    ENGINE_CHECK(queue.GetTextureKey(FakeTexture(0x100000)) == Engine::SortKey::kTextureOverflow);
+    ENGINE_CHECK(queue.GetMeshKey(1 << 20, 0) == Engine::SortKey::kMeshOverflow);
+    ENGINE_CHECK(queue.GetTextureKey(FakeTexture(1)) == 0);
+    ENGINE_CHECK(queue.GetStats().keyOverflows == 2);
+    ENGINE_CHECK(Engine::SortKey::Overflowed(Engine::SortKey::Make(0, 0, 0, Engine::SortKey::kMeshOverflow, 0.0f)));
+
+    queue.ResetState();
+    ENGINE_CHECK(queue.ChangeTexture(Engine::SortKey::kTextureOverflow));
+    ENGINE_CHECK(queue.ChangeTexture(Engine::SortKey::kTextureOverflow));
+    ENGINE_CHECK(queue.ChangeMesh(Engine::SortKey::kMeshOverflow));
+    ENGINE_CHECK(queue.ChangeMesh(Engine::SortKey::kMeshOverflow));
+    ENGINE_CHECK(queue.ChangeMesh(3));
+    ENGINE_CHECK(!queue.ChangeMesh(3));
+
+    queue.Clear();
+    ENGINE_CHECK(queue.GetStats().keyOverflows == 0);
+    ENGINE_CHECK(queue.GetTextureKey(FakeTexture(0x100000)) == 0);
+}
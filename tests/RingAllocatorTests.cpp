@@ -0,0 +1,132 @@
+#include "TestFramework.h"
+#include "Engine/RingAllocator.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t kCapacity = 1024, kAlign = 256;
+
+    // Drives a ring like Renderer::WriteRingConstants/AdvanceConstantRing, with a fake GPU that finishes each frame
+    // `latency` frames after it was signaled. Tracks every closed range still in flight to catch overwrites.
+    struct RingHarness
+    {
+        struct Range { uint64_t fence; uint32_t offset, size; };
+
+        Engine::RingAllocator ring;
+        uint64_t fence = 0;
+        uint32_t latency = 0;
+        uint32_t discardWrites = 0;
+        bool overlapOk = true;
+        std::vector<Range> inFlight; // closed frames the "GPU" has not finished yet
+        std::vector<Range> frame;    // allocations of the open frame
+
+        RingHarness(bool allowDiscard, uint32_t fenceLatency) : latency(fenceLatency)
+        {
+            ring.Initialize(kCapacity, kAlign, allowDiscard);
+        }
+
+        // One allocation + upload; a non-DISCARD write must not touch any range still in flight
+        bool Write(uint32_t size, Engine::RingAllocator::Allocation& alloc)
+        {
+            if (!ring.Allocate(size, alloc)) return false;
+            if (alloc.discard)
+            {
+                // The driver renamed the buffer: nothing written before can be overwritten any more
+                ++discardWrites;
+                inFlight.clear();
+                frame.clear();
+            }
+            for (const Range& r : inFlight)
+                overlapOk = overlapOk && (alloc.offset + alloc.size <= r.offset || r.offset + r.size <= alloc.offset);
+            overlapOk = overlapOk && alloc.offset + alloc.size <= kCapacity;
+            frame.push_back({ 0, alloc.offset, alloc.size });
+            return true;
+        }
+
+        void EndFrame()
+        {
+            ring.EndFrame(++fence);
+            for (Range& r : frame) { r.fence = fence; inFlight.push_back(r); }
+            frame.clear();
+            const uint64_t completed = fence > latency ? fence - latency : 0;
+            ring.Retire(completed);
+            inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(), [completed](const Range& r) { return r.fence <= completed; }), inFlight.end());
+        }
+    };
+}
+
+// Two frames in flight, one block per frame: the ring wraps every 4 frames and used stays at 2 blocks
+ENGINE_TEST(RingAllocatorRecyclesOnFence)
+{
+    RingHarness h(false, 2);
+    Engine::RingAllocator::Allocation a{};
+    for (uint32_t f = 0; f < 12; ++f)
+    {
+        ENGINE_CHECK(h.Write(100, a));
+        ENGINE_CHECK(a.offset == (f % 4) * kAlign && a.size == kAlign && a.discard == (f == 0));
+        h.EndFrame();
+        ENGINE_CHECK(h.ring.GetUsed() == std::min(f + 1, 2u) * kAlign);
+    }
+    ENGINE_CHECK(h.overlapOk);
+}
+
+// The tail end does not fit, so the block goes to 0 and the skipped bytes stay used until retired
+ENGINE_TEST(RingAllocatorWrapsAround)
+{
+    RingHarness h(false, 1);
+    Engine::RingAllocator::Allocation a{};
+    ENGINE_CHECK(h.Write(512, a));
+    h.EndFrame();                                // fence 1 in flight
+    ENGINE_CHECK(h.Write(256, a) && a.offset == 512);
+    h.EndFrame();                                // fence 1 retired: tail 512, head 768
+    ENGINE_CHECK(h.Write(512, a) && a.offset == 0);
+    ENGINE_CHECK(h.ring.GetUsed() == kCapacity);
+    h.EndFrame();
+    h.latency = 0;
+    h.EndFrame();
+    ENGINE_CHECK(h.ring.GetUsed() == 0);
+    ENGINE_CHECK(h.overlapOk);
+}
+
+// Without discard a full ring fails until the fence completes; with discard (the renderer's setting) it restarts at 0
+// under a DISCARD map instead
+ENGINE_TEST(RingAllocatorFullRing)
+{
+    Engine::RingAllocator::Allocation a{};
+    {
+        RingHarness h(false, 8);
+        for (uint32_t f = 0; f < 4; ++f) { ENGINE_CHECK(h.Write(kAlign, a)); h.EndFrame(); }
+        ENGINE_CHECK(h.ring.GetUsed() == kCapacity);
+        ENGINE_CHECK(!h.Write(1, a));
+        h.latency = 0;
+        h.EndFrame();
+        ENGINE_CHECK(h.ring.GetUsed() == 0);
+        ENGINE_CHECK(h.Write(1, a) && a.offset == 0 && !a.discard);
+    }
+    {
+        RingHarness h(true, 8);
+        for (uint32_t f = 0; f < 4; ++f) { ENGINE_CHECK(h.Write(kAlign, a)); h.EndFrame(); }
+        ENGINE_CHECK(h.Write(kAlign, a) && a.offset == 0 && a.discard);
+        ENGINE_CHECK(h.ring.GetDiscardCount() == 1);
+        ENGINE_CHECK(h.discardWrites == 2); // first map of the fresh buffer + the restart
+        ENGINE_CHECK(!h.Write(kCapacity + 1, a));
+    }
+}
+
+// Mixed sizes and latencies: no NO_OVERWRITE write may land on a range the GPU still reads
+ENGINE_TEST(RingAllocatorNeverOverwritesInFlight)
+{
+    RingHarness h(true, 3);
+    EngineTest::Random random(99u);
+    Engine::RingAllocator::Allocation a{};
+    for (int i = 0; i < 20000; ++i)
+    {
+        const uint32_t r = random.Next();
+        h.Write(1 + r % 300, a);
+        if ((r >> 4) % 3 == 0) h.EndFrame();
+        if (i % 4000 == 0) h.latency = (r >> 12) % 4;
+    }
+    ENGINE_CHECK(h.overlapOk);
+    ENGINE_CHECK(h.ring.GetDiscardCount() > 0);
+}
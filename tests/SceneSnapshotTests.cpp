@@ -0,0 +1,234 @@
+#include "TestFramework.h"
+#include "Engine/SceneSnapshot.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct TestPosition { float x, y, z; };                 // trivially copyable: raw page copy
+    struct TestLabel { std::string text; uint32_t id = 0; }; // owned data: save/load functions
+    struct TestTag {};                                       // empty: owner ids only
+
+    void RegisterTestTypes(Engine::SceneSnapshot& format)
+    {
+        format.Register<TestPosition>("TestPosition");
+        format.Register<TestLabel>("TestLabel",
+            [](Engine::BinaryWriter& out, const TestLabel& c) { out.WriteString(c.text); out.Write(c.id); },
+            [](Engine::BinaryReader& in, TestLabel& c) { return in.ReadString(c.text) && in.Read(c.id); });
+        format.RegisterTag<TestTag>("TestTag");
+    }
+
+    // More entities than one storage page, with destroyed ones in between so recycled ids carry a version
+    void FillRegistry(entt::registry& registry, std::vector<entt::entity>& alive)
+    {
+        std::vector<entt::entity> created;
+        for (uint32_t i = 0; i < 3000; ++i) created.push_back(registry.create());
+        for (uint32_t i = 0; i < 3000; i += 5) registry.destroy(created[i]);
+        for (uint32_t i = 0; i < 200; ++i) created.push_back(registry.create());
+
+        alive.clear();
+        for (uint32_t i = 0; i < created.size(); ++i)
+        {
+            const entt::entity e = created[i];
+            if (!registry.valid(e)) continue;
+            alive.push_back(e);
+            registry.emplace<TestPosition>(e, TestPosition{ float(i), float(i % 7), -float(i) });
+            if (i % 3 == 0) registry.emplace<TestLabel>(e, TestLabel{ "Entity " + std::to_string(i), i });
+            if (i % 4 == 0) registry.emplace<TestTag>(e);
+        }
+    }
+
+    bool IsEmpty(entt::registry& registry)
+    {
+        auto all = registry.view<entt::entity>();
+        return all.begin() == all.end() && registry.storage<TestPosition>().size() == 0 &&
+               registry.storage<TestLabel>().size() == 0 && registry.storage<TestTag>().size() == 0;
+    }
+
+    // Offsets of one component entry in a blob (header | entity ids | per type: { id, count, owner ids, payload size, payload })
+    struct BlobEntry
+    {
+        size_t idAt = 0;
+        size_t ownersAt = 0;
+        uint32_t count = 0;
+    };
+
+    std::vector<BlobEntry> FindEntries(const std::vector<uint8_t>& blob)
+    {
+        Engine::BinaryReader in(blob.data(), blob.size());
+        uint32_t magic = 0, version = 0, entityCount = 0, typeCount = 0;
+        in.Read(magic);
+        in.Read(version);
+        in.Read(entityCount);
+        in.Align(alignof(entt::entity));
+        in.Skip(size_t(entityCount) * sizeof(entt::entity));
+        in.Read(typeCount);
+
+        std::vector<BlobEntry> entries(typeCount);
+        for (BlobEntry& entry : entries)
+        {
+            entry.idAt = in.Tell();
+            entt::id_type id = 0;
+            uint64_t payloadSize = 0;
+            in.Read(id);
+            in.Read(entry.count);
+            in.Align(alignof(entt::entity));
+            entry.ownersAt = in.Tell();
+            in.Skip(size_t(entry.count) * sizeof(entt::entity));
+            in.Read(payloadSize);
+            in.Align(16);
+            in.Skip(size_t(payloadSize));
+        }
+        return entries;
+    }
+}
+
+// Save -> Restore into an empty registry recreates the same entity ids and every component value
+ENGINE_TEST(SceneSnapshotRoundTrip)
+{
+    Engine::SceneSnapshot format;
+    RegisterTestTypes(format);
+
+    entt::registry source;
+    std::vector<entt::entity> alive;
+    FillRegistry(source, alive);
+    std::vector<uint8_t> blob;
+    format.Save(source, blob);
+    ENGINE_CHECK(format.Validate(blob.data(), blob.size()));
+
+    entt::registry restored;
+    ENGINE_CHECK(format.Restore(blob, restored));
+    ENGINE_CHECK(restored.storage<TestPosition>().size() == source.storage<TestPosition>().size());
+    ENGINE_CHECK(restored.storage<TestLabel>().size() == source.storage<TestLabel>().size());
+    ENGINE_CHECK(restored.storage<TestTag>().size() == source.storage<TestTag>().size());
+
+    bool same = true;
+    for (entt::entity e : alive)
+    {
+        same = same && restored.valid(e) && restored.all_of<TestPosition>(e);
+        if (!same) break;
+        const TestPosition& a = source.get<TestPosition>(e);
+        const TestPosition& b = restored.get<TestPosition>(e);
+        same = a.x == b.x && a.y == b.y && a.z == b.z;
+        same = same && source.all_of<TestLabel>(e) == restored.all_of<TestLabel>(e) && source.all_of<TestTag>(e) == restored.all_of<TestTag>(e);
+        if (same && source.all_of<TestLabel>(e))
+            same = source.get<TestLabel>(e).text == restored.get<TestLabel>(e).text && source.get<TestLabel>(e).id == restored.get<TestLabel>(e).id;
+    }
+    ENGINE_CHECK(same);
+
+    // Restoring into a registry that already holds entities is refused
+    entt::registry occupied;
+    FillRegistry(occupied, alive);
+    ENGINE_CHECK(!format.Restore(blob, occupied));
+}
+
+// Every truncation of a blob is rejected, and Restore leaves the target registry untouched
+ENGINE_TEST(SceneSnapshotRejectsTruncation)
+{
+    Engine::SceneSnapshot format;
+    RegisterTestTypes(format);
+
+    entt::registry source;
+    const entt::entity a = source.create(), b = source.create();
+    source.emplace<TestPosition>(a, TestPosition{ 1.0f, 2.0f, 3.0f });
+    source.emplace<TestLabel>(b, TestLabel{ "label", 7 });
+    source.emplace<TestTag>(a);
+    std::vector<uint8_t> blob;
+    format.Save(source, blob);
+
+    bool rejected = true, untouched = true;
+    for (size_t size = 0; size < blob.size(); ++size)
+    {
+        entt::registry target;
+        rejected = rejected && !format.Validate(blob.data(), size) && !format.Restore(blob.data(), size, target);
+        untouched = untouched && IsEmpty(target);
+    }
+    ENGINE_CHECK(rejected);
+    ENGINE_CHECK(untouched);
+}
+
+// Damaged blobs that would trip EnTT asserts on insert (an owner listed twice, a type listed twice, an owner that was
+// never saved) or hold undecodable payloads fail Validate and leave the registry untouched
+ENGINE_TEST(SceneSnapshotRejectsInconsistentEntries)
+{
+    Engine::SceneSnapshot format;
+    RegisterTestTypes(format);
+
+    entt::registry source;
+    std::vector<entt::entity> alive;
+    FillRegistry(source, alive);
+    std::vector<uint8_t> blob;
+    format.Save(source, blob);
+
+    const std::vector<BlobEntry> entries = FindEntries(blob);
+    ENGINE_CHECK(entries.size() == 3);
+    if (entries.size() != 3) return;
+    const BlobEntry& positions = entries[0];
+    const BlobEntry& labels = entries[1];
+    ENGINE_CHECK(positions.count == alive.size());
+
+    auto rejects = [&format](std::vector<uint8_t>& damaged) {
+        entt::registry target;
+        return !format.Validate(damaged.data(), damaged.size()) && !format.Restore(damaged, target) && IsEmpty(target);
+    };
+
+    std::vector<uint8_t> duplicateOwner = blob;
+    std::memcpy(duplicateOwner.data() + positions.ownersAt + sizeof(entt::entity), duplicateOwner.data() + positions.ownersAt, sizeof(entt::entity));
+    ENGINE_CHECK(rejects(duplicateOwner));
+
+    std::vector<uint8_t> duplicateType = blob;
+    std::memcpy(duplicateType.data() + labels.idAt, duplicateType.data() + positions.idAt, sizeof(entt::id_type));
+    ENGINE_CHECK(rejects(duplicateType));
+
+    std::vector<uint8_t> unknownOwner = blob;
+    const entt::entity stranger = entt::entity{ 0xABCDE };
+    std::memcpy(unknownOwner.data() + positions.ownersAt, &stranger, sizeof(stranger));
+    ENGINE_CHECK(rejects(unknownOwner));
+
+    // First label's string length points far past the end of the blob
+    std::vector<uint8_t> badPayload = blob;
+    const size_t labelPayloadAt = (labels.ownersAt + size_t(labels.count) * sizeof(entt::entity) + sizeof(uint64_t) + 15) / 16 * 16;
+    const uint32_t hugeLength = 0x7FFFFFFFu;
+    std::memcpy(badPayload.data() + labelPayloadAt, &hugeLength, sizeof(hugeLength));
+    ENGINE_CHECK(rejects(badPayload));
+
+    // Blob data must be 16-byte aligned (payloads are read in place)
+    std::vector<uint8_t> shifted(blob.size() + 1);
+    std::memcpy(shifted.data() + 1, blob.data(), blob.size());
+    ENGINE_CHECK(!format.Validate(shifted.data() + 1, blob.size()));
+}
+
+// Random bit flips never get past Validate into an EnTT assert; rejected blobs never touch the registry
+ENGINE_TEST(SceneSnapshotSurvivesBitFlips)
+{
+    Engine::SceneSnapshot format;
+    RegisterTestTypes(format);
+
+    entt::registry source;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const entt::entity e = source.create();
+        source.emplace<TestPosition>(e, TestPosition{ float(i), 0.0f, 0.0f });
+        if (i % 2) source.emplace<TestLabel>(e, TestLabel{ "n" + std::to_string(i), i });
+        if (i % 3) source.emplace<TestTag>(e);
+    }
+    std::vector<uint8_t> blob;
+    format.Save(source, blob);
+
+    EngineTest::Random random(1u);
+    bool untouched = true;
+    for (int k = 0; k < 5000; ++k)
+    {
+        std::vector<uint8_t> damaged = blob;
+        for (int flip = 0; flip <= k % 3; ++flip)
+        {
+            const uint32_t r = random.Next();
+            damaged[r % damaged.size()] ^= uint8_t(1u << ((r >> 16) % 8));
+        }
+        entt::registry target;
+        if (!format.Restore(damaged, target))
+            untouched = untouched && IsEmpty(target);
+    }
+    ENGINE_CHECK(untouched);
+}
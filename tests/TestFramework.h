@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Minimal self-registering test runner for the EngineTests target (no third-party framework).
+// ENGINE_TEST cases run under ctest and fail on any ENGINE_CHECK; ENGINE_BENCH cases only run with "EngineTests --bench"
+// and print their timings as one "bench name key=value ..." line each.
+// Flow: ENGINE_TEST(Name) { ENGINE_CHECK(cond); } -> TestMain runs every registered case -> exit code 1 on any failure
+
+namespace EngineTest
+{
+    using CaseFn = void (*)();
+
+    struct Case
+    {
+        const char* name;
+        CaseFn fn;
+        bool bench;
+    };
+
+    // All registered cases in registration order (function-local, so static registrars may run in any order)
+    std::vector<Case>& GetCases();
+
+    struct Registrar
+    {
+        Registrar(const char* name, CaseFn fn, bool bench) { GetCases().push_back({ name, fn, bench }); }
+    };
+
+    // Records a failed check of the running case and prints where it happened
+    void ReportFailure(const char* expression, const char* file, int line);
+
+    inline double NowMs()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Best of passes runs of fn, in milliseconds
+    template<typename Fn>
+    double BestMs(int passes, Fn&& fn)
+    {
+        double best = 1e30;
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            const double start = NowMs();
+            fn();
+            const double ms = NowMs() - start;
+            best = ms < best ? ms : best;
+        }
+        return best;
+    }
+
+    // Deterministic LCG shared by the fixtures (same constants as the engine's own shuffles)
+    struct Random
+    {
+        uint32_t seed;
+        explicit Random(uint32_t s) : seed(s) {}
+        uint32_t Next() { seed = seed * 1664525u + 1013904223u; return seed >> 8; }
+        float Next01() { return float(Next()) / float(1u << 24); }
+    };
+}
+
+#define ENGINE_TEST_REGISTER(name, bench) \
+    static void name(); \
+    static const ::EngineTest::Registrar name##Registrar(#name, &name, bench); \
+    static void name()
+
+#define ENGINE_TEST(name) ENGINE_TEST_REGISTER(name, false)
+#define ENGINE_BENCH(name) ENGINE_TEST_REGISTER(name, true)
+
+#define ENGINE_CHECK(expression) \
+    do { if (!(expression)) ::EngineTest::ReportFailure(#expression, __FILE__, __LINE__); } while (0)
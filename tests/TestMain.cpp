@@ -0,0 +1,55 @@
+#include "TestFramework.h"
+#include <cstdio>
+#include <cstring>
+
+// EngineTests [--bench] [filter]
+//   no flag: every ENGINE_TEST (what ctest runs); --bench: every ENGINE_BENCH instead
+//   filter:  only cases whose name contains it
+
+namespace EngineTest
+{
+    static uint32_t g_failures = 0;
+
+    std::vector<Case>& GetCases()
+    {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    void ReportFailure(const char* expression, const char* file, int line)
+    {
+        ++g_failures;
+        std::printf("%s:%d: check failed: %s\n", file, line, expression);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool bench = false;
+    const char* filter = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--bench") == 0) bench = true;
+        else filter = argv[i];
+    }
+
+    int ran = 0, failed = 0;
+    for (const EngineTest::Case& c : EngineTest::GetCases())
+    {
+        if (c.bench != bench || (filter && !std::strstr(c.name, filter)))
+            continue;
+
+        std::printf("[ RUN  ] %s\n", c.name);
+        std::fflush(stdout);
+        const uint32_t failuresBefore = EngineTest::g_failures;
+        c.fn();
+        const bool ok = EngineTest::g_failures == failuresBefore;
+        std::printf("[ %s ] %s\n", ok ? " OK " : "FAIL", c.name);
+
+        ++ran;
+        failed += ok ? 0 : 1;
+    }
+
+    std::printf("%d of %d %s passed\n", ran - failed, ran, bench ? "benchmarks" : "tests");
+    return failed == 0 ? 0 : 1;
+}